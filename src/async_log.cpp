@@ -0,0 +1,266 @@
+/**
+ * Asynchronous log
+ *
+ * Ring protocol as in command_queue.cpp: cell i starts with seq = i; a
+ * producer at tail p claims the cell when seq == p, fills it and publishes
+ * seq = p + 1; the drain at head h reads it when seq == h + 1 and returns it
+ * with seq = h + LOG_RING_DEPTH.
+ *
+ * The formatter walks the format string and hands each conversion to
+ * snprintf() with the argument widened to the type the conversion expects,
+ * so a record formats exactly as the original printf() call would have,
+ * whatever integer width the caller passed.
+ */
+
+#include <stdio.h>
+#include "async_log.h"
+
+static_assert((LOG_RING_DEPTH & (LOG_RING_DEPTH - 1)) == 0,
+              "LOG_RING_DEPTH must be a power of two");
+
+LogRing logRing;
+
+void logRingInit(LogRing& ring) {
+    ring.tail.store(0, std::memory_order_relaxed);
+    ring.head = 0;
+    for (uint32_t i = 0; i < LOG_RING_DEPTH; i++) {
+        ring.cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+    ring.stats.dropped.store(0, std::memory_order_relaxed);
+    ring.stats.written = 0;
+    ring.stats.maxDepth = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+// ============================================================================
+// PRODUCERS
+// ============================================================================
+
+LogCell* logClaim(LogRing& ring) {
+    uint32_t pos = ring.tail.load(std::memory_order_relaxed);
+    for (;;) {
+        LogCell* cell = &ring.cells[pos & (LOG_RING_DEPTH - 1)];
+        uint32_t seq = cell->seq.load(std::memory_order_acquire);
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (ring.tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                return cell;
+            }
+            // pos was reloaded by the failed CAS
+        } else if (diff < 0) {
+            ring.stats.dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        } else {
+            pos = ring.tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void logPublish(LogCell* cell) {
+    // The claimed position is the cell's current seq; publishing makes it p + 1
+    cell->seq.store(cell->seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// ============================================================================
+// DRAIN
+// ============================================================================
+
+bool logPop(LogRing& ring, LogRecord& out) {
+    LogCell& cell = ring.cells[ring.head & (LOG_RING_DEPTH - 1)];
+    uint32_t seq = cell.seq.load(std::memory_order_acquire);
+    if ((int32_t)(seq - (ring.head + 1)) < 0) {
+        return false;  // Empty, or the claiming producer hasn't finished writing
+    }
+    uint32_t depth = ring.tail.load(std::memory_order_relaxed) - ring.head;
+    if (depth > ring.stats.maxDepth) {
+        ring.stats.maxDepth = depth;
+    }
+    out = cell.rec;
+    cell.seq.store(ring.head + LOG_RING_DEPTH, std::memory_order_release);
+    ring.head++;
+    ring.stats.written++;
+    return true;
+}
+
+struct ArgReader {
+    const LogRecord& rec;
+    uint8_t pos;
+
+    bool next(uint8_t& type, const uint8_t*& value) {
+        if (pos >= rec.length) {
+            return false;
+        }
+        type = rec.data[pos++];
+        value = &rec.data[pos];
+        switch (type) {
+            case LOG_ARG_I32:
+            case LOG_ARG_U32: pos += 4; break;
+            case LOG_ARG_I64:
+            case LOG_ARG_F64: pos += 8; break;
+            case LOG_ARG_STR: pos += 1 + rec.data[pos]; break;
+            case LOG_ARG_PTR: pos += sizeof(void*); break;
+            default: pos = rec.length; return false;
+        }
+        return true;
+    }
+};
+
+static long long argAsInt(uint8_t type, const uint8_t* v) {
+    switch (type) {
+        case LOG_ARG_I32: { int32_t x; memcpy(&x, v, 4); return x; }
+        case LOG_ARG_U32: { uint32_t x; memcpy(&x, v, 4); return x; }
+        case LOG_ARG_I64: { int64_t x; memcpy(&x, v, 8); return x; }
+        case LOG_ARG_F64: { double x; memcpy(&x, v, 8); return (long long)x; }
+        default: return 0;
+    }
+}
+
+static double argAsDouble(uint8_t type, const uint8_t* v) {
+    if (type == LOG_ARG_F64) {
+        double x;
+        memcpy(&x, v, 8);
+        return x;
+    }
+    return (double)argAsInt(type, v);
+}
+
+size_t logFormat(const LogRecord& rec, char* out, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    ArgReader args = {rec, 0};
+    size_t n = 0;
+    const char* f = rec.fmt;
+
+    auto emit = [&](const char* text, size_t len) {
+        for (size_t i = 0; i < len && n + 1 < size; i++) {
+            out[n++] = text[i];
+        }
+    };
+
+    while (*f && n + 1 < size) {
+        if (*f != '%') {
+            out[n++] = *f++;
+            continue;
+        }
+        if (f[1] == '%') {
+            out[n++] = '%';
+            f += 2;
+            continue;
+        }
+
+        // Rebuild the conversion spec without its length modifier
+        char spec[24];
+        size_t s = 0;
+        spec[s++] = *f++;
+        while (*f && strchr("-+ #0123456789.", *f) && s < sizeof(spec) - 4) {
+            spec[s++] = *f++;
+        }
+        while (*f && strchr("hlLqjzt", *f)) {
+            f++;
+        }
+        char conv = *f ? *f++ : '\0';
+
+        uint8_t type;
+        const uint8_t* value;
+        bool have = args.next(type, value);
+        char piece[64];
+        int len = 0;
+
+        if (conv == '\0') {
+            break;
+        } else if (!have) {
+            len = snprintf(piece, sizeof(piece), "<?>");
+        } else if (strchr("di", conv)) {
+            spec[s++] = 'l'; spec[s++] = 'l'; spec[s++] = conv; spec[s] = '\0';
+            len = snprintf(piece, sizeof(piece), spec, argAsInt(type, value));
+        } else if (strchr("uxXo", conv)) {
+            long long x = argAsInt(type, value);
+            // A negative 32-bit value printed unsigned is its 32-bit pattern
+            unsigned long long u = (type == LOG_ARG_I32) ? (uint32_t)x : (unsigned long long)x;
+            spec[s++] = 'l'; spec[s++] = 'l'; spec[s++] = conv; spec[s] = '\0';
+            len = snprintf(piece, sizeof(piece), spec, u);
+        } else if (conv == 'c') {
+            spec[s++] = 'c'; spec[s] = '\0';
+            len = snprintf(piece, sizeof(piece), spec, (int)argAsInt(type, value));
+        } else if (strchr("fFeEgGaA", conv)) {
+            spec[s++] = conv; spec[s] = '\0';
+            len = snprintf(piece, sizeof(piece), spec, argAsDouble(type, value));
+        } else if (conv == 's' && type == LOG_ARG_STR) {
+            char str[LOG_PAYLOAD_BYTES];
+            uint8_t sl = value[0];
+            memcpy(str, value + 1, sl);
+            str[sl] = '\0';
+            spec[s++] = 's'; spec[s] = '\0';
+            len = snprintf(piece, sizeof(piece), spec, str);
+        } else if (conv == 'p' && type == LOG_ARG_PTR) {
+            void* p;
+            memcpy(&p, value, sizeof(p));
+            len = snprintf(piece, sizeof(piece), "%p", p);
+        } else {
+            len = snprintf(piece, sizeof(piece), "<?>");
+        }
+        if (len > 0) {
+            emit(piece, (size_t)len < sizeof(piece) ? (size_t)len : sizeof(piece) - 1);
+        }
+    }
+    if (rec.flags & LOG_FLAG_TRUNCATED) {
+        bool newline = (n > 0 && out[n - 1] == '\n');
+        n -= newline ? 1 : 0;
+        emit(" [trunc]", 8);
+        if (newline) {
+            emit("\n", 1);
+        }
+    }
+    out[n] = '\0';
+    return n;
+}
+
+// ============================================================================
+// TARGET: DRAIN TASK
+// ============================================================================
+
+#if defined(ARDUINO) && KILN_ASYNC_LOG
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static void logDrainTask(void*) {
+    static char line[LOG_LINE_BYTES];
+    LogRecord rec;
+    uint32_t reportedDrops = 0;
+
+    for (;;) {
+        while (logPop(logRing, rec)) {
+            size_t n;
+            if (LOG_PRINT_TIMESTAMPS) {
+                n = snprintf(line, sizeof(line), "%10.3f ", rec.timeUs / 1000.0);
+                n += logFormat(rec, line + n, sizeof(line) - n);
+            } else {
+                n = logFormat(rec, line, sizeof(line));
+            }
+            Serial.write((const uint8_t*)line, n);  // Blocks only this task
+        }
+        uint32_t drops = logRing.stats.dropped.load(std::memory_order_relaxed);
+        if (drops != reportedDrops) {
+            Serial.printf("[LOG] %lu message(s) dropped, ring full\n",
+                          (unsigned long)(drops - reportedDrops));
+            reportedDrops = drops;
+        }
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_IDLE_MS));
+    }
+}
+
+void logBegin() {
+    logRingInit(logRing);
+    xTaskCreatePinnedToCore(logDrainTask, "log", LOG_DRAIN_STACK, nullptr,
+                            LOG_DRAIN_PRIORITY, nullptr, LOG_DRAIN_CORE);
+}
+
+#else
+
+void logBegin() {
+    logRingInit(logRing);
+}
+
+#endif
@@ -0,0 +1,273 @@
+#ifndef ASYNC_LOG_H
+#define ASYNC_LOG_H
+
+// Asynchronous log
+// With KILN_ASYNC_LOG, the DEBUG_PRINT* and LOG_* macros in config.h don't
+// format anything or touch the UART. A log call stores the format pointer,
+// level, module, timestamp and its arguments in binary (integers, doubles,
+// copied strings) into a bounded lock-free ring. A low-priority drain task
+// formats and writes the records to Serial. When the ring is full the
+// record is dropped and counted, so a log call never blocks.
+//
+// Each record is one cell of a bounded multi-producer / single-consumer
+// ring (Vyukov, as in command_queue.h), so any task may log. Format strings
+// must outlive the record (string literals); %s arguments are copied.
+//
+// Filtering is at compile time: each translation unit sets LOG_MODULE
+// before its includes (default LOG_MOD_MAIN), and a call above the level
+// configured for its module (LOG_LEVEL_<MODULE> in config.h) compiles out.
+//
+// Pure C++ with no Arduino dependencies apart from the clock and the drain
+// task, so the ring and formatter can be tested on host.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include "config.h"
+
+#ifndef LOG_MODULE
+#define LOG_MODULE LOG_MOD_MAIN
+#endif
+
+enum LogModule {
+    LOG_MOD_MAIN,
+    LOG_MOD_PROFILE,
+    LOG_MOD_STORAGE,
+    LOG_MOD_COUNT
+};
+
+enum LogArgType {
+    LOG_ARG_I32,
+    LOG_ARG_U32,
+    LOG_ARG_I64,
+    LOG_ARG_F64,
+    LOG_ARG_STR,                // Length byte, then the bytes (no terminator)
+    LOG_ARG_PTR
+};
+
+#define LOG_FLAG_TRUNCATED 0x01 // An argument didn't fit in the payload
+
+struct LogRecord {
+    uint32_t timeUs;
+    const char* fmt;
+    uint8_t level;
+    uint8_t module;
+    uint8_t length;             // Payload bytes used
+    uint8_t flags;
+    uint8_t data[LOG_PAYLOAD_BYTES];  // Type byte + value, per argument
+};
+
+struct LogCell {
+    std::atomic<uint32_t> seq;
+    LogRecord rec;
+};
+
+struct LogStats {
+    std::atomic<uint32_t> dropped;  // Ring full
+    uint32_t written;
+    uint32_t maxDepth;              // Most records seen waiting at once
+};
+
+struct LogRing {
+    std::atomic<uint32_t> tail;     // Next cell producers claim
+    uint32_t head;                  // Next cell the drain reads
+    LogCell cells[LOG_RING_DEPTH];
+    LogStats stats;
+};
+
+extern LogRing logRing;
+
+void logRingInit(LogRing& ring);
+
+/**
+ * Claim a cell for a record (any task)
+ *
+ * @return The cell, or nullptr if the ring is full (counted as dropped)
+ */
+LogCell* logClaim(LogRing& ring);
+
+/**
+ * Hand a filled cell to the drain
+ */
+void logPublish(LogCell* cell);
+
+/**
+ * Next record, oldest first (drain only)
+ */
+bool logPop(LogRing& ring, LogRecord& out);
+
+/**
+ * Format a record as printf would have
+ *
+ * @return Characters written (output is truncated to size - 1)
+ */
+size_t logFormat(const LogRecord& rec, char* out, size_t size);
+
+/**
+ * Start the drain task (no-op without KILN_ASYNC_LOG)
+ */
+void logBegin();
+
+// ============================================================================
+// PRODUCER SIDE (inline: a log call is a claim, a few stores and a publish)
+// ============================================================================
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+static inline uint32_t logNowUs() {
+    return micros();
+}
+#else
+#include <chrono>
+static inline uint32_t logNowUs() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+static inline void logPutRaw(LogRecord& r, uint8_t type, const void* value, size_t size) {
+    if (r.length + 1 + size > LOG_PAYLOAD_BYTES) {
+        r.flags |= LOG_FLAG_TRUNCATED;
+        return;
+    }
+    r.data[r.length++] = type;
+    memcpy(&r.data[r.length], value, size);
+    r.length += (uint8_t)size;
+}
+
+template <typename T>
+static inline void logPutInt(LogRecord& r, T v) {
+    if (sizeof(T) > 4) {
+        int64_t x = (int64_t)v;
+        logPutRaw(r, LOG_ARG_I64, &x, sizeof(x));
+    } else if ((T)-1 < (T)0) {
+        int32_t x = (int32_t)v;
+        logPutRaw(r, LOG_ARG_I32, &x, sizeof(x));
+    } else {
+        uint32_t x = (uint32_t)v;
+        logPutRaw(r, LOG_ARG_U32, &x, sizeof(x));
+    }
+}
+
+static inline void logPut(LogRecord& r, bool v) { logPutInt(r, (int)v); }
+static inline void logPut(LogRecord& r, char v) { logPutInt(r, (int)v); }
+static inline void logPut(LogRecord& r, signed char v) { logPutInt(r, (int)v); }
+static inline void logPut(LogRecord& r, unsigned char v) { logPutInt(r, (int)v); }
+static inline void logPut(LogRecord& r, short v) { logPutInt(r, (int)v); }
+static inline void logPut(LogRecord& r, unsigned short v) { logPutInt(r, (int)v); }
+static inline void logPut(LogRecord& r, int v) { logPutInt(r, v); }
+static inline void logPut(LogRecord& r, unsigned v) { logPutInt(r, v); }
+static inline void logPut(LogRecord& r, long v) { logPutInt(r, v); }
+static inline void logPut(LogRecord& r, unsigned long v) { logPutInt(r, v); }
+static inline void logPut(LogRecord& r, long long v) { logPutInt(r, v); }
+static inline void logPut(LogRecord& r, unsigned long long v) { logPutInt(r, v); }
+
+static inline void logPut(LogRecord& r, double v) {
+    logPutRaw(r, LOG_ARG_F64, &v, sizeof(v));
+}
+
+static inline void logPut(LogRecord& r, float v) { logPut(r, (double)v); }
+
+static inline void logPut(LogRecord& r, const void* v) {
+    logPutRaw(r, LOG_ARG_PTR, &v, sizeof(v));
+}
+
+static inline void logPut(LogRecord& r, const char* s) {
+    if (s == nullptr) {
+        s = "(null)";
+    }
+    size_t n = strlen(s);
+    size_t room = (r.length + 2 < LOG_PAYLOAD_BYTES) ? LOG_PAYLOAD_BYTES - r.length - 2 : 0;
+    if (room == 0) {
+        r.flags |= LOG_FLAG_TRUNCATED;
+        return;
+    }
+    if (n > room) {
+        n = room;
+        r.flags |= LOG_FLAG_TRUNCATED;
+    }
+    if (n > 255) {
+        n = 255;
+    }
+    r.data[r.length++] = LOG_ARG_STR;
+    r.data[r.length++] = (uint8_t)n;
+    memcpy(&r.data[r.length], s, n);
+    r.length += (uint8_t)n;
+}
+
+static inline void logPut(LogRecord& r, char* s) { logPut(r, (const char*)s); }
+
+// Anything with c_str() (Arduino String)
+template <typename T>
+static inline auto logPut(LogRecord& r, const T& s) -> decltype(s.c_str(), void()) {
+    logPut(r, s.c_str());
+}
+
+template <typename... Args>
+static inline void logWrite(uint8_t level, uint8_t module, const char* fmt, const Args&... args) {
+    LogCell* cell = logClaim(logRing);
+    if (cell == nullptr) {
+        return;
+    }
+    LogRecord& r = cell->rec;
+    r.timeUs = logNowUs();
+    r.fmt = fmt;
+    r.level = level;
+    r.module = module;
+    r.length = 0;
+    r.flags = 0;
+    int expand[] = {0, (logPut(r, args), 0)...};
+    (void)expand;
+    logPublish(cell);
+}
+
+// Serial.print()/println() of one value, in Print's default format
+static inline const char* logValueFormat(int, bool nl) { return nl ? "%d\n" : "%d"; }
+static inline const char* logValueFormat(long, bool nl) { return nl ? "%ld\n" : "%ld"; }
+static inline const char* logValueFormat(long long, bool nl) { return nl ? "%lld\n" : "%lld"; }
+static inline const char* logValueFormat(unsigned char, bool nl) { return nl ? "%u\n" : "%u"; }
+static inline const char* logValueFormat(unsigned, bool nl) { return nl ? "%u\n" : "%u"; }
+static inline const char* logValueFormat(unsigned long, bool nl) { return nl ? "%lu\n" : "%lu"; }
+static inline const char* logValueFormat(unsigned long long, bool nl) { return nl ? "%llu\n" : "%llu"; }
+static inline const char* logValueFormat(double, bool nl) { return nl ? "%.2f\n" : "%.2f"; }
+static inline const char* logValueFormat(char, bool nl) { return nl ? "%c\n" : "%c"; }
+static inline const char* logValueFormat(const char*, bool nl) { return nl ? "%s\n" : "%s"; }
+template <typename T>
+static inline auto logValueFormat(const T&, bool nl) -> decltype(((T*)0)->c_str(), (const char*)0) {
+    return nl ? "%s\n" : "%s";
+}
+
+template <typename T>
+static inline void logValue(uint8_t level, uint8_t module, const T& value, bool newline) {
+    logWrite(level, module, logValueFormat(value, newline), value);
+}
+
+// Never called: lets the compiler check DEBUG_PRINTF formats against their arguments
+static inline void logFormatCheck(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+static inline void logFormatCheck(const char*, ...) {}
+
+static inline constexpr int logModuleLevel(int module) {
+    return module == LOG_MOD_PROFILE ? LOG_LEVEL_PROFILE
+         : module == LOG_MOD_STORAGE ? LOG_LEVEL_STORAGE
+         : LOG_LEVEL_MAIN;
+}
+
+#define LOG_AT(level, ...)                                                  \
+    do {                                                                    \
+        if ((level) <= logModuleLevel(LOG_MODULE)) {                        \
+            logWrite((level), LOG_MODULE, __VA_ARGS__);                     \
+        }                                                                   \
+        if (false) {                                                        \
+            logFormatCheck(__VA_ARGS__);                                    \
+        }                                                                   \
+    } while (0)
+
+#define LOG_VALUE(level, value, newline)                                    \
+    do {                                                                    \
+        if ((level) <= logModuleLevel(LOG_MODULE)) {                        \
+            logValue((level), LOG_MODULE, (value), (newline));              \
+        }                                                                   \
+    } while (0)
+
+#endif // ASYNC_LOG_H
@@ -0,0 +1,183 @@
+/**
+ * Control command queue
+ *
+ * Bounded MPSC ring per lane. Cell i starts with seq = i.
+ *   Producer at tail position p: the cell is free when seq == p. The
+ *     producer claims it by CAS tail p -> p+1, writes the command, then
+ *     publishes it with seq = p+1.
+ *   Consumer at head position h: the cell is ready when seq == h+1. After
+ *     copying the command out, seq = h + CMD_QUEUE_DEPTH hands the cell back
+ *     to the producers for the next lap.
+ * seq < p at the tail means the lane is full. Positions are 32-bit, and the
+ * comparisons are made on the signed difference so they survive wrap-around.
+ */
+
+#include "command_queue.h"
+
+static_assert((CMD_QUEUE_DEPTH & (CMD_QUEUE_DEPTH - 1)) == 0,
+              "CMD_QUEUE_DEPTH must be a power of two");
+
+static const uint8_t commandLanes[CMD_TYPE_COUNT] = {
+    CMD_LANE_SAFETY,    // CMD_ESTOP
+    CMD_LANE_CONTROL,   // CMD_EXIT_TO_MENU
+    CMD_LANE_CONTROL,   // CMD_START_MANUAL
+    CMD_LANE_CONTROL,   // CMD_ENTER_PROFILES
+    CMD_LANE_CONTROL,   // CMD_SET_TARGET
+    CMD_LANE_CONTROL,   // CMD_ADJUST_TARGET
+    CMD_LANE_CONTROL,   // CMD_PROFILE_START
+    CMD_LANE_CONTROL,   // CMD_PROFILE_STOP
+    CMD_LANE_CONTROL,   // CMD_PROFILE_RESUME
+    CMD_LANE_TUNE,      // CMD_SET_TUNINGS
+};
+
+void commandQueueInit(CommandQueue& q) {
+    for (int l = 0; l < CMD_LANE_COUNT; l++) {
+        CommandLaneQueue& lane = q.lanes[l];
+        lane.tail.store(0, std::memory_order_relaxed);
+        lane.head = 0;
+        for (uint32_t i = 0; i < CMD_QUEUE_DEPTH; i++) {
+            lane.cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+        lane.stats.posted.store(0, std::memory_order_relaxed);
+        lane.stats.dropped.store(0, std::memory_order_relaxed);
+        lane.stats.applied = 0;
+        lane.stats.flushed = 0;
+        lane.stats.maxLatencyUs = 0;
+        lane.stats.totalLatencyUs = 0;
+        for (int b = 0; b < CMD_LATENCY_BUCKETS; b++) {
+            lane.stats.histogram[b] = 0;
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+CommandLane commandLane(CommandType type) {
+    return (type < CMD_TYPE_COUNT) ? (CommandLane)commandLanes[type] : CMD_LANE_CONTROL;
+}
+
+// ============================================================================
+// PRODUCERS
+// ============================================================================
+
+bool commandPost(CommandQueue& q, const Command& cmd, uint32_t nowUs) {
+    CommandLaneQueue& lane = q.lanes[commandLane((CommandType)cmd.type)];
+
+    uint32_t pos = lane.tail.load(std::memory_order_relaxed);
+    CommandCell* cell;
+    for (;;) {
+        cell = &lane.cells[pos & (CMD_QUEUE_DEPTH - 1)];
+        uint32_t seq = cell->seq.load(std::memory_order_acquire);
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (lane.tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+            // pos was reloaded by the failed CAS
+        } else if (diff < 0) {
+            lane.stats.dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = lane.tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->cmd = cmd;
+    cell->cmd.postedUs = nowUs;
+    cell->seq.store(pos + 1, std::memory_order_release);
+    lane.stats.posted.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// ============================================================================
+// CONSUMER
+// ============================================================================
+
+static bool popLane(CommandLaneQueue& lane, Command& out) {
+    CommandCell& cell = lane.cells[lane.head & (CMD_QUEUE_DEPTH - 1)];
+    uint32_t seq = cell.seq.load(std::memory_order_acquire);
+    if ((int32_t)(seq - (lane.head + 1)) < 0) {
+        return false;  // Empty, or the claiming producer hasn't finished writing
+    }
+    out = cell.cmd;
+    cell.seq.store(lane.head + CMD_QUEUE_DEPTH, std::memory_order_release);
+    lane.head++;
+    return true;
+}
+
+bool commandPop(CommandQueue& q, Command& out) {
+    for (int l = 0; l < CMD_LANE_COUNT; l++) {
+        if (popLane(q.lanes[l], out)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t commandFlushBelow(CommandQueue& q, CommandLane lane) {
+    uint32_t total = 0;
+    Command discard;
+    for (int l = lane + 1; l < CMD_LANE_COUNT; l++) {
+        while (popLane(q.lanes[l], discard)) {
+            q.lanes[l].stats.flushed++;
+            total++;
+        }
+    }
+    return total;
+}
+
+void commandNoteApplied(CommandQueue& q, const Command& cmd, uint32_t nowUs) {
+    CommandLaneStats& s = q.lanes[commandLane((CommandType)cmd.type)].stats;
+    uint32_t latency = nowUs - cmd.postedUs;
+    s.applied++;
+    s.totalLatencyUs += latency;
+    if (latency > s.maxLatencyUs) {
+        s.maxLatencyUs = latency;
+    }
+    int bucket = 0;
+    while (bucket < CMD_LATENCY_BUCKETS - 1 && latency >= (1UL << bucket)) {
+        bucket++;
+    }
+    s.histogram[bucket]++;
+}
+
+uint32_t commandLatencyPercentile(const CommandLaneStats& s, float percentile) {
+    if (s.applied == 0) {
+        return 0;
+    }
+    uint32_t rank = (uint32_t)(s.applied * percentile / 100.0f);
+    uint32_t seen = 0;
+    for (int b = 0; b < CMD_LATENCY_BUCKETS; b++) {
+        seen += s.histogram[b];
+        if (seen > rank) {
+            return (b == CMD_LATENCY_BUCKETS - 1) ? s.maxLatencyUs : (1UL << b);
+        }
+    }
+    return s.maxLatencyUs;
+}
+
+const char* commandName(CommandType type) {
+    switch (type) {
+        case CMD_ESTOP:          return "estop";
+        case CMD_EXIT_TO_MENU:   return "menu";
+        case CMD_START_MANUAL:   return "manual";
+        case CMD_ENTER_PROFILES: return "profiles";
+        case CMD_SET_TARGET:     return "target";
+        case CMD_ADJUST_TARGET:  return "adjust";
+        case CMD_PROFILE_START:  return "start";
+        case CMD_PROFILE_STOP:   return "stop";
+        case CMD_PROFILE_RESUME: return "resume";
+        case CMD_SET_TUNINGS:    return "tune";
+        case CMD_TYPE_COUNT:     break;
+    }
+    return "?";
+}
+
+const char* commandLaneName(CommandLane lane) {
+    switch (lane) {
+        case CMD_LANE_SAFETY:  return "safety";
+        case CMD_LANE_CONTROL: return "control";
+        case CMD_LANE_TUNE:    return "tune";
+        case CMD_LANE_COUNT:   break;
+    }
+    return "?";
+}
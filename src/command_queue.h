@@ -0,0 +1,128 @@
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+// Control command queue
+// Inputs (encoders today, serial and web later) never change control state
+// themselves. They post typed commands, and the control job applies them at
+// one point per tick. Each priority lane is a bounded lock-free
+// multi-producer / single-consumer ring (Vyukov). A producer claims a cell
+// with one compare-and-swap on the lane's tail, so posting is safe from any
+// task. The consumer drains lanes in priority order:
+//   SAFETY   E-stop
+//   CONTROL  mode, setpoint and profile commands (FIFO among themselves)
+//   TUNE     PID tunings
+// Stops and starts share a lane so they can't overtake each other. An
+// E-stop jumps ahead of both, and applying it flushes whatever the lower
+// lanes still hold, so a start queued just before the E-stop can't re-arm
+// the kiln after it.
+//
+// Commands carry their post time. Enqueue-to-apply latency is recorded per
+// lane in a log2 histogram.
+//
+// Pure C++ with no Arduino dependencies so multi-producer runs can be
+// stress-tested on host.
+
+#include <stdint.h>
+#include <atomic>
+#include "config.h"
+
+enum CommandType {
+    CMD_ESTOP,              // Cut power, stop everything
+    CMD_EXIT_TO_MENU,       // Stop heating and return to the main menu
+    CMD_START_MANUAL,       // Manual mode at the default setpoint
+    CMD_ENTER_PROFILES,     // Profile selection screen
+    CMD_SET_TARGET,         // value[0] = setpoint (°C)
+    CMD_ADJUST_TARGET,      // value[0] = setpoint change (°C)
+    CMD_PROFILE_START,      // arg = builtin profile index
+    CMD_PROFILE_STOP,
+    CMD_PROFILE_RESUME,
+    CMD_SET_TUNINGS,        // value[] = Kp, Ki, Kd
+    CMD_TYPE_COUNT
+};
+
+enum CommandSource {
+    CMD_SOURCE_ENCODER,
+    CMD_SOURCE_SERIAL,
+    CMD_SOURCE_WEB
+};
+
+enum CommandLane {
+    CMD_LANE_SAFETY,
+    CMD_LANE_CONTROL,
+    CMD_LANE_TUNE,
+    CMD_LANE_COUNT
+};
+
+struct Command {
+    uint8_t type;           // CommandType
+    uint8_t source;         // CommandSource
+    int16_t arg;
+    float value[3];
+    uint32_t postedUs;      // Set by commandPost()
+};
+
+#define CMD_LATENCY_BUCKETS 16  // Bucket b counts latencies below 2^b µs
+
+struct CommandLaneStats {
+    std::atomic<uint32_t> posted;
+    std::atomic<uint32_t> dropped;      // Lane full
+    uint32_t applied;
+    uint32_t flushed;                   // Discarded by an E-stop
+    uint32_t maxLatencyUs;
+    uint64_t totalLatencyUs;
+    uint32_t histogram[CMD_LATENCY_BUCKETS];
+};
+
+struct CommandCell {
+    std::atomic<uint32_t> seq;
+    Command cmd;
+};
+
+struct CommandLaneQueue {
+    std::atomic<uint32_t> tail;         // Next cell producers claim
+    uint32_t head;                      // Next cell the consumer reads
+    CommandCell cells[CMD_QUEUE_DEPTH];
+    CommandLaneStats stats;
+};
+
+struct CommandQueue {
+    CommandLaneQueue lanes[CMD_LANE_COUNT];
+};
+
+void commandQueueInit(CommandQueue& q);
+
+CommandLane commandLane(CommandType type);
+
+/**
+ * Post a command (any task, any number of producers)
+ *
+ * @return False if its lane is full (counted as dropped)
+ */
+bool commandPost(CommandQueue& q, const Command& cmd, uint32_t nowUs);
+
+/**
+ * Next command, highest-priority lane first (consumer only)
+ */
+bool commandPop(CommandQueue& q, Command& out);
+
+/**
+ * Discard everything queued in lanes below `lane` (consumer only)
+ *
+ * @return Commands discarded
+ */
+uint32_t commandFlushBelow(CommandQueue& q, CommandLane lane);
+
+/**
+ * Record a popped command's enqueue-to-apply latency once it has been applied
+ */
+void commandNoteApplied(CommandQueue& q, const Command& cmd, uint32_t nowUs);
+
+/**
+ * Upper bound of the bucket holding the given percentile (µs)
+ */
+uint32_t commandLatencyPercentile(const CommandLaneStats& s, float percentile);
+
+const char* commandName(CommandType type);
+const char* commandLaneName(CommandLane lane);
+
+#endif // COMMAND_QUEUE_H
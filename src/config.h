@@ -21,6 +21,19 @@
 // SSR Control
 #define SSR_PIN             25
 
+// Heating zones: one MAX31855 and one SSR per zone, thermocouples share the
+// SPI bus. Zone 0 uses the pins above. For a top/bottom kiln, e.g.:
+//   #define KILN_ZONE_COUNT     2
+//   #define ZONE_TC_CS_PINS     { MAX31855_CS_PIN, 17 }
+//   #define ZONE_SSR_PINS       { SSR_PIN, 16 }
+#define KILN_ZONE_COUNT     1
+#define ZONE_TC_CS_PINS     { MAX31855_CS_PIN }
+#define ZONE_SSR_PINS       { SSR_PIN }
+
+// Optional second MAX31855 per zone for redundant sensing, -1 = none
+// (see tc_vote.h), e.g. { 13 } puts a backup thermocouple in zone 0
+#define ZONE_TC_BACKUP_CS_PINS  { -1 }
+
 // SPI pins for LCD Display (ST7920)
 // Note: ST7920 and MAX31855 share SPI bus (SCK on GPIO 18)
 #define LCD_CS_PIN          15  // Chip Select for LCD
@@ -64,32 +77,111 @@
 // ============================================================================
 
 // Temperature limits
-#define MAX_TEMP_LIMIT      1320.0  // Maximum temperature (°C) - HARD CODED
+#define MAX_TEMP_LIMIT      1320.0  // Maximum temperature (°C) - HARD CODED; settings max_temp can only lower it
 #define MIN_VALID_TEMP      -50.0   // Minimum valid temperature reading
 #define MAX_VALID_TEMP      1400.0  // Maximum valid temperature reading
 #define MAX_RAMP_RATE       600.0   // Maximum ramp rate (°C/hour)
 #define TEMP_ERROR_VALUE    -999.0  // Error indicator value
 
-// PID defaults
+// PID defaults (first boot; the gains in use are in the settings store, shell: config)
 #define DEFAULT_KP          5.0     // Proportional gain
 #define DEFAULT_KI          0.5     // Integral gain
 #define DEFAULT_KD          1.0     // Derivative gain
 #define PID_SAMPLE_TIME     1000    // PID sample time (ms)
 
 // SSR control
-#define SSR_CYCLE_TIME_MS   2000    // SSR cycle time (2 seconds)
+#define SSR_CYCLE_TIME_MS   2000    // Default SSR cycle time (settings: ssr_cycle)
 
 // Safety timing
 #define MAX_FIRING_DURATION (48UL * 60UL * 60UL * 1000UL)  // 48 hours in ms
 #define SAFETY_CHECK_INTERVAL_MS    500   // Safety check every 500ms
 #define WATCHDOG_TIMEOUT_SEC        10    // Watchdog timeout
 
-// Task timing
+// Task timing (scheduler job periods, see scheduler.h)
 #define TEMP_READ_INTERVAL_MS       100   // Temperature reading every 100ms
 #define PID_UPDATE_INTERVAL_MS      1000  // PID update every 1 second
 #define DISPLAY_UPDATE_INTERVAL_MS  250   // Display update every 250ms
-#define INPUT_CHECK_INTERVAL_MS     50    // Input check every 50ms
+#define INPUT_CHECK_INTERVAL_MS     10    // Encoders are polled; slower misses detents
 #define ENERGY_UPDATE_INTERVAL_MS   1000  // Energy tracking every 1 second
+#define STATUS_PRINT_INTERVAL_MS    2000  // Serial status line
+
+// Cooperative scheduler
+#define SCHED_MAX_JOBS              16
+#define SCHED_TICK_MS               1     // Wheel resolution
+#define SCHED_WHEEL_SLOTS           64    // One revolution = 64 ticks
+#define SCHED_LATE_TOLERANCE_MS     5     // Starting later than this counts as late
+#define SCHED_REPORT_INTERVAL_MS    (5UL * 60UL * 1000UL)  // Per-job lateness/overrun report
+
+// Control telemetry sample bus (see sample_bus.h)
+#define SAMPLE_BUS_CAPACITY         32    // Samples kept (power of two), ~3 s at 10 Hz
+#define SAMPLE_BUS_ALIGN            64    // Slot alignment: host cache line, two ESP32 cache lines
+
+// Control command queue (see command_queue.h)
+#define CMD_QUEUE_DEPTH             16    // Commands per priority lane (power of two)
+
+// Hot-path profiler (see profiler.h; shell: prof, prof trace, prof reset)
+#define PROFILER_MAX_ZONES          16
+#define PROFILER_MAX_PERIODS        4
+#define PROFILER_TRACE_EVENTS       128   // Last scopes kept for the Chrome trace dump
+
+// Input-to-photon latency (see ui_latency.h; shell: ui)
+#define UI_LATENCY_PENDING          8     // Input events awaiting a frame
+#define UI_LATENCY_TIMEOUT_MS       2000  // Drop an event no tracked screen has drawn by then
+
+// Memory monitor (see memory_monitor.h; shell: mem)
+#define MEM_MONITOR_INTERVAL_MS     10000 // Heap and stack high-water poll
+#define MEM_MONITOR_SITES           16    // Post-init allocation call sites kept
+#define MEM_MONITOR_TASKS           6     // Tasks whose stacks are watched
+
+// Asynchronous log (see async_log.h; on when built with -DKILN_ASYNC_LOG=1)
+#define LOG_RING_DEPTH              64    // Records (power of two)
+#define LOG_PAYLOAD_BYTES           48    // Binary arguments per record
+#define LOG_LINE_BYTES              192   // Longest formatted line
+#define LOG_DRAIN_STACK             3072
+#define LOG_DRAIN_PRIORITY          1
+#define LOG_DRAIN_CORE              0     // loop() runs on core 1
+#define LOG_DRAIN_IDLE_MS           5     // Drain poll period when the ring is empty
+#define LOG_PRINT_TIMESTAMPS        false // Prefix lines with the ms they were logged at
+
+// Log levels: a call above its module's level compiles out
+#define LOG_LEVEL_NONE              0
+#define LOG_LEVEL_ERROR             1
+#define LOG_LEVEL_WARN              2
+#define LOG_LEVEL_INFO              3
+#define LOG_LEVEL_DEBUG             4
+#define LOG_LEVEL_MAIN              LOG_LEVEL_DEBUG
+#define LOG_LEVEL_PROFILE           LOG_LEVEL_DEBUG
+#define LOG_LEVEL_STORAGE           LOG_LEVEL_DEBUG
+
+// Binary serial telemetry (see telemetry_protocol.h; shell: tlm on|off)
+#define TELEMETRY_INTERVAL_MS       100   // Frame period; one frame per new control sample at most
+#define TELEMETRY_START_STREAMING   false // Stream from boot instead of waiting for "tlm on"
+
+// Firing log download over serial (see log_transfer.h; host tool tools/telemetry/firing_log_fetch)
+#define XFER_MAX_BAUD               921600 // Fastest rate a host may ask for
+#define XFER_MAX_BLOCK              512   // Log bytes per data frame
+#define XFER_MAX_WINDOW             32    // Blocks sent ahead of the last ACK
+#define XFER_POLL_MS                5     // Sender job period
+#define XFER_FRAMES_PER_POLL        2     // Flash reads per run (bounds the job's run time)
+#define XFER_ACK_TIMEOUT_MS         500   // No ACK progress: resend from the last ACK
+#define XFER_IDLE_TIMEOUT_MS        3000  // Host silent this long: abort, back to SERIAL_BAUD_RATE
+
+// Serial command shell (see serial_shell.h; "help" lists the commands)
+#define SHELL_LINE_BYTES            64    // Longest command line, with its terminator
+#define SHELL_MAX_ARGS              6     // Words per line
+#define SHELL_REPLY_BYTES           96    // Longest reply line
+#define SHELL_OUT_BYTES             1024  // Reply ring; input waits while it can't take a reply
+#define SHELL_LINES_PER_POLL        8     // Commands run per input job pass
+#define SHELL_REPORT_POLL_MS        1000  // Report job period (queued reports also run it at once)
+#define REPORT_LINE_BYTES           192   // TX buffer room needed before a report prints its next line
+#define REPORT_RESUME_MS            20    // A report waiting for TX buffer room resumes this much later
+
+// Flight recorder in RTC memory (see flight_recorder.h; archives in /flight)
+#define FLIGHT_EVENT_SLOTS          64    // Rare events: modes, commands, faults, profile steps
+#define FLIGHT_TICK_SLOTS           192   // Control ticks and SSR edges (~15 s at 10 Hz plus edges)
+#define FLIGHT_ARCHIVE_KEEP         8     // Newest archives kept in flash
+#define FLIGHT_DUMP_LINES_PER_RUN   4     // Hex lines per report job run ("flight" shell command)
+#define FLIGHT_DUMP_INTERVAL_MS     20    // Report job period while an archive is being dumped
 
 // Rotary Encoder
 #define ENCODER_PULSES_PER_REV      20    // Detents per full rotation
@@ -100,17 +192,118 @@
 
 // Serial
 #define SERIAL_BAUD_RATE    115200
+#define SERIAL_TX_BUFFER_BYTES 2048  // UART TX ring: frames queue without blocking the writer
 
 // WiFi
 #define WIFI_AP_SSID_PREFIX "KilnController"
 #define WIFI_AP_PASSWORD    "kiln1234"
 #define WEB_SERVER_PORT     80
 
-// Energy defaults
+// Energy defaults (first boot; settings: watts, rate)
 #define DEFAULT_KILN_WATTAGE        1800   // Watts
 #define DEFAULT_ELECTRICITY_RATE    0.12   // $/kWh
 #define DEFAULT_CURRENCY_SYMBOL     "$"
 
+// Profile engine
+#define PROFILE_MAX_SEGMENTS        8     // Maximum segments per profile
+#define PROFILE_AT_TARGET_TOLERANCE 5.0   // "At target" band to start a soak (°C)
+
+// Ware temperature observer (two-node thermal model: kiln air <-> ware)
+#define OBSERVER_AIR_CAPACITY       15000.0  // Kiln air/wall heat capacity (J/°C)
+#define OBSERVER_WARE_CAPACITY      6000.0   // Ware load heat capacity (J/°C)
+#define OBSERVER_AIR_WARE_COUPLING  6.0      // Air-to-ware conductance (W/°C)
+#define OBSERVER_LOSS_COUPLING      1.0      // Air-to-ambient loss conductance (W/°C)
+#define OBSERVER_AMBIENT_TEMP       20.0     // Assumed room temperature (°C)
+#define OBSERVER_GAIN_AIR           0.5      // Air-node correction gain (1/s)
+#define OBSERVER_GAIN_WARE          0.05     // Ware-node correction gain (1/s)
+#define WARE_SOAK_TOLERANCE         3.0      // Ware within this of target counts as soaked (°C)
+#define WARE_SOAK_HOLD_MS           (5UL * 60UL * 1000UL)  // Ware must stay in tolerance 5 minutes
+
+// Step-response analyzer
+#define STEP_DETECT_MIN             2.0   // Reference change that counts as a new step (°C)
+#define STEP_MERGE_MS               3000  // Changes this close together merge into one step
+#define STEP_SETTLE_BAND            2.0   // Minimum settling band (°C); grows to 5% of large steps
+#define STEP_SETTLE_CONFIRM_MS      (10UL * 60UL * 1000UL)  // In band this long = settled
+#define STEP_MAX_DURATION_MS        (4UL * 60UL * 60UL * 1000UL)  // Give up on a step after 4 h
+
+// Shadow controller (candidate evaluated alongside the zone PIDs, never drives an SSR)
+#define SHADOW_KP                   4.0   // Candidate proportional gain
+#define SHADOW_KI                   0.3   // Candidate integral gain
+#define SHADOW_KD                   2.0   // Candidate derivative gain
+#define SHADOW_REPORT_INTERVAL_MS   30000 // Divergence/cost report period
+
+// Heat-work accumulator (Arrhenius cone equivalent)
+#define HEATWORK_ACTIVATION_K       100000.0f  // Activation energy / R (K), fitted to Orton chart
+
+// Remaining-time / end-temperature predictor
+#define PREDICTOR_FIT_WINDOW_MS     60000 // Heating-rate fit sample window
+#define PREDICTOR_INTERVAL_MS       5000  // Re-run forward simulation this often
+#define PREDICTOR_SIM_STEP_S        60.0f // Simulation step (s)
+#define PREDICTOR_MAX_STEPS         2000  // Step budget per simulation run (3 runs per update)
+#define PREDICTOR_LOG_INTERVAL_MS   (10UL * 60UL * 1000UL)  // Prediction snapshot in firing log
+
+// Element health tracking
+#define ELEMENT_HEALTH_MIN_DUTY     0.5f  // Only windows at/above this duty feed the band fits
+#define ELEMENT_HEALTH_MIN_RATE     60.0f // Rate needed to finish a cone (°C/hour, Orton final ramp)
+#define ELEMENT_HEALTH_TARGET_CONE  "6"   // Warn when this cone becomes unreachable
+#define ELEMENT_HEALTH_WARN_FIRINGS 10    // ...or is projected to within this many firings
+#define ELEMENT_HEALTH_MAX_EXTRAPOLATION 200.0f  // Skip firings whose highest measured band ends further below the cone (°C)
+
+// Model-residual fault observer (CUSUMs in °C*s of innovation beyond the slack)
+#define FAULT_OBSERVER_GAIN         0.02f // Correction toward measurement (1/s, ~50 s memory)
+#define FAULT_STUCK_MAX_DUTY        5.0   // "Commanded off" for stuck-SSR detection (%)
+#define FAULT_STUCK_K               2.0f  // Slack: rise above prediction while off (°C)
+#define FAULT_STUCK_H               60.0f // Alarm threshold (°C*s)
+#define FAULT_FAST_K                6.0f  // Slack: sudden drop below prediction (°C)
+#define FAULT_FAST_H                60.0f
+#define FAULT_SLOW_GAIN             0.002f // Drift model correction (1/s, ~8 min memory)
+#define FAULT_SLOW_K                3.0f  // Slack: persistent shortfall vs drift model (°C)
+#define FAULT_SLOW_H                1800.0f
+
+// Thermocouple linearization
+#define TC_MAX31855_SEEBECK_UV      41.276f // Chip's fixed K-type sensitivity (µV/°C)
+
+// Ice-point calibration
+#define ICE_CAL_TOLERANCE           0.2   // Stop when the 95% CI half-width is below this (°C)
+#define ICE_CAL_BLOCK_SAMPLES       10    // Readings averaged per block (~1 s)
+#define ICE_CAL_MIN_BLOCKS          5     // Never stop before this many blocks
+#define ICE_CAL_RESOLUTION          0.25  // MAX31855 LSB (°C), sets the noise floor
+#define ICE_CAL_TREND_T             3.0   // Drift significance threshold (t-statistic)
+#define ICE_CAL_MAX_DRIFT_PER_MIN   0.5   // Settled: drift bound below this (°C/min)
+#define ICE_CAL_MAX_OFFSET          5.0   // Larger offsets indicate a wiring fault (°C)
+#define ICE_CAL_TIMEOUT_MS          (5UL * 60UL * 1000UL)
+
+// SSR-synchronous thermocouple sampling
+#define TC_SAMPLE_INTERVAL_MS       TEMP_READ_INTERVAL_MS  // Nominal read period
+#define TC_CONVERSION_MS            100   // MAX31855 conversion time (max, datasheet)
+#define TC_EDGE_SETTLE_MS           20    // Switching transient after an SSR edge
+#define TC_EDGE_GUARD_MS            10    // Margin for edge timing jitter (loop period)
+#define TC_MAX_DEFER_MS             200   // Read anyway if no quiet slot within this
+#define TC_NOISE_REPORT_INTERVAL_MS 60000 // Per-state noise report period
+
+// Dual-thermocouple voting (zones with a backup thermocouple)
+#define TC_VOTE_BAND                10.0  // Max |primary - backup| (°C)...
+#define TC_VOTE_BAND_FRACTION       0.01  // ...plus this fraction of the reading
+#define TC_VOTE_RATE_WINDOW_MS      60000 // Divergence rate measured over this window
+#define TC_VOTE_RATE_BAND           60.0  // Max divergence rate (°C/hour)
+#define TC_VOTE_BIAS_GAIN           0.02f // Offset tracking per agreeing read (~5 s at 10 Hz)
+#define TC_VOTE_RECOVER_READS       50    // Agreeing primary reads before failing back (~5 s)
+#define TC_VOTE_DRIFT_MS            (5UL * 60UL * 1000UL)  // Disagreement this long = drift warning
+
+// Multi-zone balancing (see zone_control.h)
+#define ZONE_BALANCE_GAIN           2.0   // Setpoint cut per °C a zone leads the coldest
+#define ZONE_BALANCE_MAX            50.0  // Largest setpoint cut (°C)
+#define ZONE_READ_STAGGER_MS        (TC_SAMPLE_INTERVAL_MS / KILN_ZONE_COUNT)  // Spacing of reads on the bus
+
+// Thermocouple noise spectrum (hardware test)
+#define NOISE_FFT_SIZE              128   // Burst length (power of two)
+#define NOISE_SPECTRUM_PEAKS        3     // Dominant components reported
+#define NOISE_SSR_MAX_RISE          10.0  // SSR burst stops this far above its start (°C)
+#define NOISE_CONFIRM_TIMEOUT_MS    15000 // SSR burst skipped if not confirmed in time
+
+// Firing log
+#define FIRING_LOG_SAMPLE_MS        60000 // Temperature trend line every minute
+
 // ============================================================================
 // FEATURE FLAGS
 // ============================================================================
@@ -120,16 +313,40 @@
 #define ENABLE_COST_TRACKING true
 #define ENABLE_DATA_LOGGING true
 #define ENABLE_DEBUG_OUTPUT true
+#define ENABLE_SHADOW_CONTROLLER true
+#define ENABLE_TC_LINEARIZATION true
+#define ENABLE_PROFILER     true
+#define ENABLE_TELEMETRY    true
+#define ENABLE_WARE_SOAK_END false  // End soakEndOnWare soaks on the ware estimate (calibrate OBSERVER_* first)
+#define ENABLE_ALLOC_TRAP   false   // Release builds: abort on any allocation after setup()
+
+#ifndef KILN_ASYNC_LOG
+#define KILN_ASYNC_LOG      0       // Set by platformio.ini for the main firmware
+#endif
 
 // ============================================================================
 // MACROS
 // ============================================================================
 
-#if ENABLE_DEBUG_OUTPUT
+#if ENABLE_DEBUG_OUTPUT && KILN_ASYNC_LOG
+    // Deferred to the log drain task; include async_log.h where these are used
+    #define LOG_ERROR(...)      LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+    #define LOG_WARN(...)       LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+    #define LOG_INFO(...)       LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+    #define DEBUG_PRINT(x)      LOG_VALUE(LOG_LEVEL_DEBUG, x, false)
+    #define DEBUG_PRINTLN(x)    LOG_VALUE(LOG_LEVEL_DEBUG, x, true)
+    #define DEBUG_PRINTF(...)   LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#elif ENABLE_DEBUG_OUTPUT
+    #define LOG_ERROR(...)      Serial.printf(__VA_ARGS__)
+    #define LOG_WARN(...)       Serial.printf(__VA_ARGS__)
+    #define LOG_INFO(...)       Serial.printf(__VA_ARGS__)
     #define DEBUG_PRINT(x)      Serial.print(x)
     #define DEBUG_PRINTLN(x)    Serial.println(x)
     #define DEBUG_PRINTF(...)   Serial.printf(__VA_ARGS__)
 #else
+    #define LOG_ERROR(...)
+    #define LOG_WARN(...)
+    #define LOG_INFO(...)
     #define DEBUG_PRINT(x)
     #define DEBUG_PRINTLN(x)
     #define DEBUG_PRINTF(...)
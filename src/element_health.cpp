@@ -0,0 +1,290 @@
+/**
+ * Element-health tracker
+ *
+ * Each band keeps running sums for a least-squares fit of heating rate
+ * against SSR duty (rate = alpha + beta * duty) using only windows at or
+ * above ELEMENT_HEALTH_MIN_DUTY; evaluating the fit at duty = 1 gives the
+ * full-power rate even when the controller never quite saturated. Memory is
+ * fixed: five sums per band, no sample history.
+ *
+ * Records live in NVS as one blob (oldest first, HEALTH_MAX_RECORDS deep).
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "element_health.h"
+#include "heat_work.h"
+
+#define HEALTH_MAX_RECORDS   16
+#define HEALTH_WINDOW_MS     60000   // Rate/duty sample window
+#define HEALTH_MIN_SAMPLES   3       // Windows needed before a band counts
+
+static HealthBandFit bands[HEALTH_NUM_BANDS];
+static float peakTemp = 0.0f;
+
+static float windowStartTemp = 0.0f;
+static unsigned long windowStart = 0;
+static unsigned long windowHeatOnMs = 0;
+static unsigned long lastSample = 0;
+static bool windowOpen = false;
+
+// ============================================================================
+// PER-FIRING ACCUMULATION
+// ============================================================================
+
+void elementHealthStartFiring() {
+    memset(bands, 0, sizeof(bands));
+    peakTemp = 0.0f;
+    windowOpen = false;
+}
+
+void elementHealthSample(float temp, bool heating, unsigned long now) {
+    if (temp > peakTemp) {
+        peakTemp = temp;
+    }
+    if (!windowOpen) {
+        windowOpen = true;
+        windowStartTemp = temp;
+        windowStart = now;
+        windowHeatOnMs = 0;
+        lastSample = now;
+        return;
+    }
+
+    if (heating) {
+        windowHeatOnMs += now - lastSample;
+    }
+    lastSample = now;
+
+    unsigned long windowMs = now - windowStart;
+    if (windowMs < HEALTH_WINDOW_MS) {
+        return;
+    }
+
+    float duty = (float)windowHeatOnMs / windowMs;
+    float rate = (temp - windowStartTemp) / (windowMs / 3600000.0f);
+    float meanTemp = 0.5f * (temp + windowStartTemp);
+    int band = ((int)meanTemp - HEALTH_BAND_MIN_C) / HEALTH_BAND_WIDTH_C;
+
+    if (duty >= ELEMENT_HEALTH_MIN_DUTY && meanTemp >= HEALTH_BAND_MIN_C &&
+        band >= 0 && band < HEALTH_NUM_BANDS) {
+        HealthBandFit& b = bands[band];
+        b.n++;
+        b.sumX += duty;
+        b.sumY += rate;
+        b.sumXX += duty * duty;
+        b.sumXY += duty * rate;
+    }
+
+    windowStartTemp = temp;
+    windowStart = now;
+    windowHeatOnMs = 0;
+}
+
+bool elementHealthSummarize(uint16_t firingNumber, HealthRecord& rec) {
+    rec.firingNumber = firingNumber;
+    rec.peakTemp = (int16_t)peakTemp;
+
+    bool anyData = false;
+    for (int i = 0; i < HEALTH_NUM_BANDS; i++) {
+        rec.bandRate[i] = healthBandFullPowerRate(bands[i]);
+        anyData |= rec.bandRate[i] != HEALTH_NO_DATA;
+    }
+    rec.reachableTemp = healthReachableFromBands(rec.bandRate, healthTargetConeTemp());
+    return anyData;
+}
+
+// ============================================================================
+// FITS
+// ============================================================================
+
+int16_t healthBandFullPowerRate(const HealthBandFit& b) {
+    if (b.n < HEALTH_MIN_SAMPLES) {
+        return HEALTH_NO_DATA;
+    }
+    float meanX = b.sumX / b.n;
+    float meanY = b.sumY / b.n;
+    float varX = b.sumXX / b.n - meanX * meanX;
+    if (varX < 1e-3f) {
+        // Duty barely varied (kiln was saturated): scale the mean to full power
+        return (int16_t)(meanY / meanX);
+    }
+    float beta = (b.sumXY / b.n - meanX * meanY) / varX;
+    float alpha = meanY - beta * meanX;
+    return (int16_t)(alpha + beta);
+}
+
+float healthTargetConeTemp() {
+    int coneIndex = heatWorkFindCone(ELEMENT_HEALTH_TARGET_CONE);
+    return coneIndex >= 0 ? ortonCones[coneIndex].temp60 : MAX_TEMP_LIMIT;
+}
+
+/**
+ * A line through a low or hand-run firing's bands says little about the
+ * elements hundreds of degrees higher: unless the highest measured band
+ * ends within ELEMENT_HEALTH_MAX_EXTRAPOLATION of target, the result is
+ * HEALTH_NO_DATA. The firing's peak doesn't count: a kiln can coast or
+ * crawl well above its last full-power band without measuring anything.
+ */
+int16_t healthReachableFromBands(const int16_t* bandRate, float target) {
+    int n = 0;
+    float top = 0.0f;
+    float sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (int i = 0; i < HEALTH_NUM_BANDS; i++) {
+        if (bandRate[i] == HEALTH_NO_DATA) continue;
+        float x = HEALTH_BAND_MIN_C + (i + 0.5f) * HEALTH_BAND_WIDTH_C;
+        top = x + 0.5f * HEALTH_BAND_WIDTH_C;
+        n++;
+        sx += x;
+        sy += bandRate[i];
+        sxx += x * x;
+        sxy += x * bandRate[i];
+    }
+    if (n < 2) {
+        return HEALTH_NO_DATA;
+    }
+    if (top < target - ELEMENT_HEALTH_MAX_EXTRAPOLATION) {
+        return HEALTH_NO_DATA;  // Too far below the target to extrapolate
+    }
+    float slope = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+    float intercept = (sy - slope * sx) / n;
+    if (slope >= 0.0f) {
+        return HEALTH_NO_DATA;  // Rate not falling with temperature: can't extrapolate
+    }
+    float t = (ELEMENT_HEALTH_MIN_RATE - intercept) / slope;
+    return (int16_t)fminf(fmaxf(t, 0.0f), 2000.0f);
+}
+
+// ============================================================================
+// TREND
+// ============================================================================
+
+void healthComputeTrend(const HealthRecord* records, int count, float targetTemp,
+                        HealthTrend& out) {
+    memset(&out, 0, sizeof(out));
+    out.firingsLeft = -1;
+
+    int n = 0;
+    float sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (int i = 0; i < count; i++) {
+        // Re-derived from the stored bands, so records written before the
+        // extrapolation limit are judged by it too
+        int16_t reachable = healthReachableFromBands(records[i].bandRate, targetTemp);
+        if (reachable == HEALTH_NO_DATA) continue;
+        float x = records[i].firingNumber;
+        float y = reachable;
+        n++;
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+        out.latestReachable = y;
+    }
+    out.records = n;
+    if (n == 0) {
+        return;
+    }
+
+    if (n >= 2 && (n * sxx - sx * sx) > 0.0f) {
+        out.slopePerFiring = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+        if (out.slopePerFiring < 0.0f && out.latestReachable > targetTemp) {
+            out.firingsLeft = (int)((targetTemp - out.latestReachable) / out.slopePerFiring);
+        }
+    }
+
+    if (out.latestReachable < targetTemp) {
+        out.warning = true;
+        snprintf(out.message, sizeof(out.message), "Elements: cone %s unreachable",
+                 ELEMENT_HEALTH_TARGET_CONE);
+    } else if (out.firingsLeft >= 0 && out.firingsLeft <= ELEMENT_HEALTH_WARN_FIRINGS) {
+        out.warning = true;
+        snprintf(out.message, sizeof(out.message), "Elements: cone %s in ~%d firings",
+                 ELEMENT_HEALTH_TARGET_CONE, out.firingsLeft);
+    }
+}
+
+// ============================================================================
+// TARGET
+// ============================================================================
+
+#if defined(ARDUINO)
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+static HealthRecord records[HEALTH_MAX_RECORDS];
+static uint8_t recordCount = 0;
+static uint16_t nextFiringNumber = 1;
+static HealthTrend trend;
+
+static void computeTrend() {
+    healthComputeTrend(records, recordCount, healthTargetConeTemp(), trend);
+}
+
+const HealthTrend& elementHealthTrend() {
+    return trend;
+}
+
+void elementHealthBegin() {
+    Preferences prefs;
+    prefs.begin("kiln-health", true);  // read-only
+    size_t len = prefs.getBytesLength("records");
+    if (len > 0 && len <= sizeof(records) && len % sizeof(HealthRecord) == 0) {
+        prefs.getBytes("records", records, len);
+        recordCount = len / sizeof(HealthRecord);
+    }
+    nextFiringNumber = prefs.getUInt("next", 1);
+    prefs.end();
+
+    computeTrend();
+    elementHealthStartFiring();
+
+    if (trend.records > 0) {
+        Serial.printf("[HEALTH] %d firings on record, reachable %.0f C (%+.1f C/firing)\n",
+                      trend.records, trend.latestReachable, trend.slopePerFiring);
+    }
+    if (trend.warning) {
+        Serial.print("[WARNING] ");
+        Serial.println(trend.message);
+    }
+}
+
+void elementHealthEndFiring() {
+    HealthRecord rec;
+    bool anyData = elementHealthSummarize(nextFiringNumber, rec);
+    elementHealthStartFiring();
+
+    if (!anyData) {
+        return;
+    }
+
+    // Append, dropping the oldest record when full
+    if (recordCount == HEALTH_MAX_RECORDS) {
+        memmove(&records[0], &records[1], sizeof(HealthRecord) * (HEALTH_MAX_RECORDS - 1));
+        recordCount--;
+    }
+    records[recordCount++] = rec;
+    nextFiringNumber++;
+
+    Preferences prefs;
+    prefs.begin("kiln-health", false);
+    prefs.putBytes("records", records, sizeof(HealthRecord) * recordCount);
+    prefs.putUInt("next", nextFiringNumber);
+    prefs.end();
+
+    computeTrend();
+    if (rec.reachableTemp == HEALTH_NO_DATA) {
+        Serial.printf("[HEALTH] Firing %u recorded: reachable unknown (bands too far below cone %s), "
+                      "peak %d C\n", rec.firingNumber, ELEMENT_HEALTH_TARGET_CONE, rec.peakTemp);
+    } else {
+        Serial.printf("[HEALTH] Firing %u recorded: reachable %d C, peak %d C\n",
+                      rec.firingNumber, rec.reachableTemp, rec.peakTemp);
+    }
+    if (trend.warning) {
+        Serial.print("[WARNING] ");
+        Serial.println(trend.message);
+    }
+}
+
+#endif // ARDUINO
@@ -0,0 +1,110 @@
+#ifndef ELEMENT_HEALTH_H
+#define ELEMENT_HEALTH_H
+
+// Element-health tracker
+// Measures the full-power heating rate the kiln achieves in each 100°C
+// temperature band during a firing, stores a compact record per firing in
+// NVS, and trends the highest temperature the elements can still climb
+// through at ELEMENT_HEALTH_MIN_RATE across firings.
+//
+// Accumulation, the band fits and the trend are pure C++ (host-testable);
+// the NVS records and the serial reports are target-only.
+
+#include <stdint.h>
+#include "config.h"
+
+#define HEALTH_BAND_MIN_C   200
+#define HEALTH_BAND_WIDTH_C 100
+#define HEALTH_NUM_BANDS    11      // 200..1300°C
+#define HEALTH_NO_DATA      -1
+
+/**
+ * One firing's summary (28 bytes, persisted)
+ */
+struct HealthRecord {
+    uint16_t firingNumber;
+    int16_t bandRate[HEALTH_NUM_BANDS];  // Full-power rate per band (°C/h), HEALTH_NO_DATA if unseen
+    int16_t reachableTemp;               // Where the full-power rate falls to ELEMENT_HEALTH_MIN_RATE (°C)
+    int16_t peakTemp;                    // Highest temperature seen this firing (°C)
+};
+
+struct HealthTrend {
+    int records;                // Records used for the trend
+    float latestReachable;      // Most recent reachable temperature (°C)
+    float slopePerFiring;       // Change in reachable temperature per firing (°C)
+    int firingsLeft;            // Projected firings until the target cone is out of reach (-1 = n/a)
+    bool warning;               // Target cone unreachable now or within ELEMENT_HEALTH_WARN_FIRINGS
+    char message[48];           // Short warning text for display/serial
+};
+
+/**
+ * Least-squares sums of heating rate against duty for one band
+ */
+struct HealthBandFit {
+    uint16_t n;
+    float sumX, sumY, sumXX, sumXY;
+};
+
+/**
+ * Clear the per-firing band accumulators (start of a firing)
+ */
+void elementHealthStartFiring();
+
+/**
+ * Feed every temperature tick during a firing
+ */
+void elementHealthSample(float temp, bool heating, unsigned long now);
+
+/**
+ * This firing's record from the accumulators (reachableTemp included)
+ *
+ * @return False if no band had enough high-duty windows to count
+ */
+bool elementHealthSummarize(uint16_t firingNumber, HealthRecord& rec);
+
+/**
+ * Full-power rate for one band, HEALTH_NO_DATA if not enough samples
+ */
+int16_t healthBandFullPowerRate(const HealthBandFit& b);
+
+/**
+ * Temperature where the band rates, fitted linearly, fall to
+ * ELEMENT_HEALTH_MIN_RATE, or HEALTH_NO_DATA if that can't be told
+ *
+ * @param target Temperature the elements must reach (°C), see healthTargetConeTemp()
+ */
+int16_t healthReachableFromBands(const int16_t* bandRate, float target);
+
+/**
+ * Bending temperature of ELEMENT_HEALTH_TARGET_CONE at the reference final ramp
+ */
+float healthTargetConeTemp();
+
+/**
+ * Trend of reachable temperature across stored records (oldest first)
+ */
+void healthComputeTrend(const HealthRecord* records, int count, float targetTemp,
+                        HealthTrend& out);
+
+// ============================================================================
+// TARGET
+// ============================================================================
+
+#if defined(ARDUINO)
+
+/**
+ * Load stored records and compute the trend (call once at boot)
+ */
+void elementHealthBegin();
+
+/**
+ * Summarize the firing, persist its record and refresh the trend
+ * Firings that never reached high duty in any band are not stored.
+ */
+void elementHealthEndFiring();
+
+const HealthTrend& elementHealthTrend();
+
+#endif // ARDUINO
+
+#endif // ELEMENT_HEALTH_H
@@ -0,0 +1,126 @@
+/**
+ * Model-residual fault observer
+ *
+ * CUSUMs are time-normalized (°C*s) so thresholds don't depend on the tick
+ * rate. The stuck-SSR detector only accumulates while the controller asks
+ * for (almost) no power, since that's the only time a rise is unexplained.
+ * Priority when several trip together: stuck SSR > lid open > drift. The
+ * CUSUMs keep running whatever is latched.
+ */
+
+#include <math.h>
+#include "config.h"
+#include "fault_observer.h"
+
+FaultObserver faultObserver = {
+    .predicted = 0.0f,
+    .innovation = 0.0f,
+    .predictedSlow = 0.0f,
+    .innovationSlow = 0.0f,
+    .cusumStuck = 0.0f,
+    .cusumFast = 0.0f,
+    .cusumSlow = 0.0f,
+    .initialized = false,
+    .latched = 0,
+    .active = FAULT_NONE,
+    .detectedAt = 0
+};
+
+static void clearStatistics() {
+    faultObserver.innovation = 0.0f;
+    faultObserver.innovationSlow = 0.0f;
+    faultObserver.cusumStuck = 0.0f;
+    faultObserver.cusumFast = 0.0f;
+    faultObserver.cusumSlow = 0.0f;
+}
+
+void faultObserverReset(float temp) {
+    faultObserver.predicted = temp;
+    faultObserver.predictedSlow = temp;
+    faultObserver.initialized = true;
+    faultObserver.latched = 0;
+    faultObserver.active = FAULT_NONE;
+    clearStatistics();
+}
+
+void faultObserverClear(float temp) {
+    // A welded SSR can't be acknowledged away; only a reboot clears it
+    bool stuck = faultObserver.latched & FAULT_BIT(FAULT_STUCK_SSR);
+    faultObserverReset(temp);
+    if (stuck) {
+        faultObserver.latched = FAULT_BIT(FAULT_STUCK_SSR);
+        faultObserver.active = FAULT_STUCK_SSR;
+    }
+}
+
+FaultClass faultObserverUpdate(float measured, bool heating, float commandedDuty,
+                               float a, float b, float dtSeconds, unsigned long now) {
+    FaultObserver& f = faultObserver;
+    if (!f.initialized) {
+        faultObserverReset(measured);
+        return FAULT_NONE;
+    }
+
+    // Predict from applied power, then pull gently toward the measurement
+    float rate = (heating ? a : 0.0f) - b * (f.predicted - OBSERVER_AMBIENT_TEMP);
+    f.predicted += rate * dtSeconds / 3600.0f;
+    float e = measured - f.predicted;
+    f.predicted += FAULT_OBSERVER_GAIN * dtSeconds * e;
+    f.innovation = e;
+
+    // Same model, much weaker correction: a slow sensor drift is tracked away
+    // by the fast prediction but accumulates here
+    float rateSlow = (heating ? a : 0.0f) - b * (f.predictedSlow - OBSERVER_AMBIENT_TEMP);
+    f.predictedSlow += rateSlow * dtSeconds / 3600.0f;
+    float eSlow = measured - f.predictedSlow;
+    f.predictedSlow += FAULT_SLOW_GAIN * dtSeconds * eSlow;
+    f.innovationSlow = eSlow;
+
+    // CUSUM updates
+    if (commandedDuty <= FAULT_STUCK_MAX_DUTY) {
+        f.cusumStuck = fmaxf(0.0f, f.cusumStuck + (e - FAULT_STUCK_K) * dtSeconds);
+    } else {
+        f.cusumStuck = 0.0f;
+    }
+    f.cusumFast = fmaxf(0.0f, f.cusumFast + (-e - FAULT_FAST_K) * dtSeconds);
+    f.cusumSlow = fmaxf(0.0f, f.cusumSlow + (-eSlow - FAULT_SLOW_K) * dtSeconds);
+
+    uint8_t tripped = 0;
+    if (f.cusumStuck > FAULT_STUCK_H) {
+        tripped |= FAULT_BIT(FAULT_STUCK_SSR);
+    }
+    if (f.cusumFast > FAULT_FAST_H) {
+        tripped |= FAULT_BIT(FAULT_LID_OPEN);
+    }
+    if (f.cusumSlow > FAULT_SLOW_H) {
+        tripped |= FAULT_BIT(FAULT_TC_DRIFT);
+    }
+    uint8_t fresh = tripped & ~f.latched;
+    if (fresh == 0) {
+        return FAULT_NONE;
+    }
+
+    f.latched |= fresh;
+    f.detectedAt = now;
+    FaultClass detected = FAULT_NONE;
+    f.active = FAULT_NONE;
+    for (int c = FAULT_TC_DRIFT; c >= FAULT_STUCK_SSR; c--) {   // Most severe last
+        if (fresh & FAULT_BIT(c)) {
+            detected = (FaultClass)c;
+        }
+        if (f.latched & FAULT_BIT(c)) {
+            f.active = (FaultClass)c;
+        }
+    }
+    return detected;
+}
+
+const char* faultClassName(FaultClass f) {
+    switch (f) {
+        case FAULT_NONE:      return "NONE";
+        case FAULT_STUCK_SSR: return "SSR STUCK ON";
+        case FAULT_LID_OPEN:  return "LID OPEN";
+        case FAULT_TC_DRIFT:  return "TC DRIFT";
+    }
+    return "?";
+}
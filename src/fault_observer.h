@@ -0,0 +1,76 @@
+#ifndef FAULT_OBSERVER_H
+#define FAULT_OBSERVER_H
+
+// Model-residual fault observer
+// A low-gain single-node observer predicts kiln temperature from commanded
+// SSR power. Its innovation (measured - predicted) feeds three CUSUM
+// detectors, each tuned to one failure signature (drift uses a second,
+// slower-correcting copy of the model so it isn't tracked away):
+//
+//   STUCK_SSR  - temperature rising while the controller commands ~0% power
+//   LID_OPEN   - sudden large drop below prediction (heat venting)
+//   TC_DRIFT   - small, persistent shortfall (thermocouple reading low)
+//
+// Each class latches on its own: a fault already latched (a warn-only
+// drift, or a lid opened while firing on in manual) doesn't stop a later
+// stuck SSR from being detected and reported. active is the most severe
+// latched class.
+//
+// Per-tick cost is constant: two model steps and three CUSUM updates.
+
+#include <stdint.h>
+
+// In order of severity
+enum FaultClass {
+    FAULT_NONE,
+    FAULT_STUCK_SSR,    // React: cut power, stop firing
+    FAULT_LID_OPEN,     // React: pause profile to save energy
+    FAULT_TC_DRIFT      // React: warn only
+};
+
+#define FAULT_BIT(f)    (1u << (f))
+
+struct FaultObserver {
+    float predicted;        // Model temperature (°C)
+    float innovation;       // measured - predicted (°C)
+    float predictedSlow;    // Low-gain model temperature for drift (°C)
+    float innovationSlow;   // measured - predictedSlow (°C)
+    float cusumStuck;       // Positive CUSUM while commanded off (°C*s)
+    float cusumFast;        // Negative CUSUM, large slack (°C*s)
+    float cusumSlow;        // Negative CUSUM, small slack (°C*s)
+    bool initialized;
+    uint8_t latched;        // FAULT_BIT per class, until faultObserverClear() (stuck SSR: reboot)
+    FaultClass active;      // Most severe latched class
+    unsigned long detectedAt;   // Latest detection
+};
+
+extern FaultObserver faultObserver;
+
+/**
+ * Re-anchor the model on the current reading and clear all statistics
+ */
+void faultObserverReset(float temp);
+
+/**
+ * Advance one tick
+ *
+ * @param measured Thermocouple reading (°C)
+ * @param heating SSR state over the last tick
+ * @param commandedDuty Controller output (0-100%)
+ * @param a Full-power heating coefficient (°C/h)
+ * @param b Loss coefficient (1/h)
+ * @return Most severe class newly detected this tick (FAULT_NONE otherwise),
+ *         even if another class is already latched
+ */
+FaultClass faultObserverUpdate(float measured, bool heating, float commandedDuty,
+                               float a, float b, float dtSeconds, unsigned long now);
+
+/**
+ * Re-anchor and clear a latched fault (user resumed / new firing)
+ * FAULT_STUCK_SSR stays latched until reboot.
+ */
+void faultObserverClear(float temp);
+
+const char* faultClassName(FaultClass f);
+
+#endif // FAULT_OBSERVER_H
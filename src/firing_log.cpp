@@ -0,0 +1,163 @@
+/**
+ * Firing log
+ *
+ * Files are append-only and flushed every FIRING_LOG_FLUSH_MS so a power cut
+ * loses at most a few seconds of history without hammering flash.
+ */
+
+#define LOG_MODULE LOG_MOD_STORAGE
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "config.h"
+#include "firing_log.h"
+#include "async_log.h"
+
+#define FIRING_LOG_DIR      "/logs"
+#define FIRING_LOG_FLUSH_MS 10000
+
+static bool fsReady = false;
+static File logFile;
+static int logIndex = -1;
+static unsigned long logStartTime = 0;
+static unsigned long lastFlush = 0;
+static File readFile;
+static int readIndex = -1;
+
+/**
+ * Find the highest existing log index so numbering survives reboots
+ */
+static void logPath(char* path, size_t size, int index) {
+    snprintf(path, size, FIRING_LOG_DIR "/%04d.log", index);
+}
+
+static int findLastLogIndex() {
+    int last = -1;
+    File dir = LittleFS.open(FIRING_LOG_DIR);
+    if (!dir || !dir.isDirectory()) {
+        return -1;
+    }
+    File entry = dir.openNextFile();
+    while (entry) {
+        int index = atoi(entry.name());
+        if (index > last) {
+            last = index;
+        }
+        entry = dir.openNextFile();
+    }
+    return last;
+}
+
+bool firingLogBegin() {
+    fsReady = LittleFS.begin(true);  // Format on first use
+    if (!fsReady) {
+        LOG_ERROR("[ERROR] LittleFS mount failed - firing log disabled\n");
+        return false;
+    }
+    if (!LittleFS.exists(FIRING_LOG_DIR)) {
+        LittleFS.mkdir(FIRING_LOG_DIR);
+    }
+    logIndex = findLastLogIndex();
+    return true;
+}
+
+void firingLogStart(const char* label) {
+    if (!fsReady) {
+        return;
+    }
+    firingLogStop();
+
+    logIndex++;
+    char path[32];
+    logPath(path, sizeof(path), logIndex);
+    logFile = LittleFS.open(path, "w");
+    if (!logFile) {
+        LOG_ERROR("[ERROR] Could not create %s\n", path);
+        return;
+    }
+
+    logStartTime = millis();
+    lastFlush = logStartTime;
+    logFile.printf("# %s\n", label);
+    DEBUG_PRINT("[LOG] Recording to ");
+    DEBUG_PRINTLN(path);
+}
+
+void firingLogStop() {
+    if (logFile) {
+        logFile.close();
+    }
+}
+
+void firingLogPrintf(const char* fmt, ...) {
+    if (!logFile) {
+        return;
+    }
+
+    char line[160];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+
+    unsigned long now = millis();
+    logFile.printf("%lu %s\n", (now - logStartTime) / 1000UL, line);
+
+    if (now - lastFlush >= FIRING_LOG_FLUSH_MS) {
+        lastFlush = now;
+        logFile.flush();
+    }
+}
+
+bool firingLogIsOpen() {
+    return (bool)logFile;
+}
+
+int firingLogCurrentIndex() {
+    return logIndex;
+}
+
+int32_t firingLogSize(int index) {
+    if (!fsReady || index < 0) {
+        return -1;
+    }
+    if (index == logIndex && logFile) {
+        logFile.flush();
+    }
+    char path[32];
+    logPath(path, sizeof(path), index);
+    File f = LittleFS.open(path, "r");
+    if (!f) {
+        return -1;
+    }
+    int32_t size = (int32_t)f.size();
+    f.close();
+    return size;
+}
+
+int32_t firingLogRead(int index, uint32_t offset, uint8_t* buf, uint32_t len) {
+    if (!fsReady || index < 0) {
+        return -1;
+    }
+    if (index != readIndex || !readFile) {
+        firingLogReadEnd();
+        char path[32];
+        logPath(path, sizeof(path), index);
+        readFile = LittleFS.open(path, "r");
+        if (!readFile) {
+            return -1;
+        }
+        readIndex = index;
+    }
+    if (readFile.position() != offset && !readFile.seek(offset)) {
+        return 0;
+    }
+    return (int32_t)readFile.read(buf, len);
+}
+
+void firingLogReadEnd() {
+    if (readFile) {
+        readFile.close();
+    }
+    readIndex = -1;
+}
@@ -0,0 +1,59 @@
+#ifndef FIRING_LOG_H
+#define FIRING_LOG_H
+
+// Firing log
+// One text file per firing session on LittleFS (/logs/NNNN.log).
+// Lines are "<seconds since start> <message>" so they sort and diff cleanly.
+
+#include <stdint.h>
+
+/**
+ * Mount the filesystem (formats on first boot)
+ * Returns false if the filesystem is unavailable; logging then becomes a no-op.
+ */
+bool firingLogBegin();
+
+/**
+ * Open a new log file for a firing session
+ *
+ * @param label Written as the first line (profile name, "Manual", ...)
+ */
+void firingLogStart(const char* label);
+
+/**
+ * Close the current log file (no-op if none is open)
+ */
+void firingLogStop();
+
+/**
+ * Append a formatted line to the current log (no-op if none is open)
+ */
+void firingLogPrintf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+bool firingLogIsOpen();
+
+/**
+ * Index of the current (or most recent) log file, -1 if none yet
+ */
+int firingLogCurrentIndex();
+
+/**
+ * Size of a log file in bytes, -1 if there is no such log
+ * The file being recorded is flushed first, so its size is current.
+ */
+int32_t firingLogSize(int index);
+
+/**
+ * Read part of a log file straight from flash
+ * The file stays open between calls, for sequential readers.
+ *
+ * @return Bytes read (fewer at end of file), -1 if there is no such log
+ */
+int32_t firingLogRead(int index, uint32_t offset, uint8_t* buf, uint32_t len);
+
+/**
+ * Close the file firingLogRead() keeps open
+ */
+void firingLogReadEnd();
+
+#endif // FIRING_LOG_H
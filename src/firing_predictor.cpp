@@ -0,0 +1,237 @@
+/**
+ * Remaining-time and end-temperature predictor
+ *
+ * Each fit sample is the temperature slope and mean SSR duty over one
+ * PREDICTOR_FIT_WINDOW_MS window. Forward simulation uses PREDICTOR_SIM_STEP_S
+ * steps and stops after PREDICTOR_MAX_STEPS, so one run has a fixed worst-case
+ * cost regardless of how much profile remains.
+ */
+
+#include <math.h>
+#include "config.h"
+#include "firing_predictor.h"
+
+#define PREDICTOR_FORGETTING    0.995f  // RLS forgetting factor per window
+#define PREDICTOR_BAND_SIGMAS   2.0f    // Width of the confidence band
+#define PREDICTOR_STALL_RATE    1.0f    // Achievable rate below this = stalled (°C/h)
+
+// Prior from the observer's lumped model (total capacity = air + ware)
+#define PRIOR_A  (DEFAULT_KILN_WATTAGE * 3600.0f / (OBSERVER_AIR_CAPACITY + OBSERVER_WARE_CAPACITY))
+#define PRIOR_B  (OBSERVER_LOSS_COUPLING * 3600.0f / (OBSERVER_AIR_CAPACITY + OBSERVER_WARE_CAPACITY))
+
+HeatingModel heatingModel;
+
+static float windowStartTemp = 0.0f;
+static unsigned long windowStart = 0;
+static unsigned long windowHeatOnMs = 0;
+static unsigned long lastSample = 0;
+
+// ============================================================================
+// MODEL FIT
+// ============================================================================
+
+void predictorReset(float currentTemp, unsigned long now) {
+    heatingModel.a = PRIOR_A;
+    heatingModel.b = PRIOR_B;
+    // Loose prior: ~50% uncertainty on a, ~100% on b
+    heatingModel.p[0][0] = (PRIOR_A * 0.5f) * (PRIOR_A * 0.5f) / 400.0f;
+    heatingModel.p[0][1] = 0.0f;
+    heatingModel.p[1][0] = 0.0f;
+    heatingModel.p[1][1] = PRIOR_B * PRIOR_B / 400.0f;
+    heatingModel.noiseVar = 400.0f;  // (20°C/h)^2
+    heatingModel.samples = 0;
+
+    windowStartTemp = currentTemp;
+    windowStart = now;
+    windowHeatOnMs = 0;
+    lastSample = now;
+}
+
+/**
+ * One recursive-least-squares step on y = a*u - b*x
+ */
+static void rlsUpdate(float u, float x, float y) {
+    HeatingModel& m = heatingModel;
+    float phi0 = u;
+    float phi1 = -x;
+
+    // P * phi
+    float pp0 = m.p[0][0] * phi0 + m.p[0][1] * phi1;
+    float pp1 = m.p[1][0] * phi0 + m.p[1][1] * phi1;
+    float denom = PREDICTOR_FORGETTING + phi0 * pp0 + phi1 * pp1;
+    float k0 = pp0 / denom;
+    float k1 = pp1 / denom;
+
+    float residual = y - (m.a * phi0 + m.b * phi1);
+    m.a += k0 * residual;
+    m.b += k1 * residual;
+    if (m.b < 0.0f) m.b = 0.0f;     // Kiln can't gain heat from the room
+    if (m.a < 1.0f) m.a = 1.0f;
+
+    // P = (P - k * phi^T * P) / lambda
+    float n00 = m.p[0][0] - k0 * pp0;
+    float n01 = m.p[0][1] - k0 * pp1;
+    float n10 = m.p[1][0] - k1 * pp0;
+    float n11 = m.p[1][1] - k1 * pp1;
+    m.p[0][0] = n00 / PREDICTOR_FORGETTING;
+    m.p[0][1] = n01 / PREDICTOR_FORGETTING;
+    m.p[1][0] = n10 / PREDICTOR_FORGETTING;
+    m.p[1][1] = n11 / PREDICTOR_FORGETTING;
+
+    m.noiseVar += 0.05f * (residual * residual - m.noiseVar);
+    m.samples++;
+}
+
+void predictorSample(float temp, bool heating, unsigned long now) {
+    if (heating) {
+        windowHeatOnMs += now - lastSample;
+    }
+    lastSample = now;
+
+    unsigned long windowMs = now - windowStart;
+    if (windowMs < PREDICTOR_FIT_WINDOW_MS) {
+        return;
+    }
+
+    float hours = windowMs / 3600000.0f;
+    float rate = (temp - windowStartTemp) / hours;
+    float duty = (float)windowHeatOnMs / windowMs;
+    float meanTemp = 0.5f * (temp + windowStartTemp);
+    // With no power commanded the kiln can only cool. A rise is heat the
+    // model can't see (a welded SSR): fitting it would drive b to zero and
+    // hide the fault from the observer, which runs on this model.
+    if (windowHeatOnMs > 0 || rate <= 0.0f) {
+        rlsUpdate(duty, meanTemp - OBSERVER_AMBIENT_TEMP, rate);
+    }
+
+    windowStartTemp = temp;
+    windowStart = now;
+    windowHeatOnMs = 0;
+}
+
+// ============================================================================
+// FORWARD SIMULATION
+// ============================================================================
+
+struct SimResult {
+    float seconds;
+    float kwh;
+    float endTemp;
+    bool stalled;
+    bool truncated;
+};
+
+static SimResult simulate(const ProfileRunner& run, float temp, unsigned long now,
+                          float a, float b, float wattage) {
+    SimResult r = {0.0f, 0.0f, temp, false, false};
+    const float dtHours = PREDICTOR_SIM_STEP_S / 3600.0f;
+    int steps = 0;
+
+    for (uint8_t s = run.segment; s < run.profile->numSegments; s++) {
+        const ProfileSegment& seg = run.profile->segments[s];
+        bool inSoak = (s == run.segment && run.state == PROFILE_SOAKING);
+
+        // Ramp phase: follow the programmed rate, limited by what the kiln can do.
+        // As in the engine, the soak starts once the setpoint has covered the
+        // whole ramp and the kiln is within PROFILE_AT_TARGET_TOLERANCE of it.
+        bool heatingUp = seg.targetTemp > temp;
+        float setpoint = (s == run.segment) ? run.setpoint : temp;
+        while (!inSoak && !(setpoint == seg.targetTemp &&
+                            fabs(seg.targetTemp - temp) <= PROFILE_AT_TARGET_TOLERANCE)) {
+            if (++steps > PREDICTOR_MAX_STEPS) {
+                r.truncated = true;
+                break;
+            }
+            float spStep = seg.rampRate * dtHours;
+            if (seg.rampRate <= 0.0f || fabs(seg.targetTemp - setpoint) <= spStep) {
+                setpoint = seg.targetTemp;
+            } else {
+                setpoint += (seg.targetTemp > setpoint) ? spStep : -spStep;
+            }
+
+            float loss = b * (temp - OBSERVER_AMBIENT_TEMP);
+            float rate = 0.0f;  // Already at target: hold while the setpoint catches up
+            if (fabs(seg.targetTemp - temp) > 0.01f) {
+                if (heatingUp) {
+                    float achievable = a - loss;
+                    if (achievable < PREDICTOR_STALL_RATE) {
+                        r.stalled = true;
+                        break;
+                    }
+                    rate = (seg.rampRate > 0.0f) ? fminf(seg.rampRate, achievable) : achievable;
+                } else {
+                    // Cooling: natural loss, slowed to the programmed rate with heat if needed
+                    rate = (seg.rampRate > 0.0f) ? fmaxf(-seg.rampRate, -loss) : -loss;
+                }
+            }
+            float duty = fminf(fmaxf((rate + loss) / a, 0.0f), 1.0f);
+
+            float stepTemp = rate * dtHours;
+            if (fabs(stepTemp) > fabs(seg.targetTemp - temp)) {
+                stepTemp = seg.targetTemp - temp;  // Last partial step
+            }
+            temp += stepTemp;
+            r.seconds += PREDICTOR_SIM_STEP_S;
+            r.kwh += wattage * duty * dtHours / 1000.0f;
+        }
+        if (r.stalled || r.truncated) {
+            break;
+        }
+        temp = seg.targetTemp;
+
+        // Soak phase: hold against losses for the (remaining) soak time
+        float soakSec = seg.soakMinutes * 60.0f;
+        if (inSoak) {
+            soakSec -= (now - run.soakStartTime) / 1000.0f;
+            if (soakSec < 0.0f) soakSec = 0.0f;
+        }
+        float holdDuty = fminf(b * (temp - OBSERVER_AMBIENT_TEMP) / a, 1.0f);
+        r.seconds += soakSec;
+        r.kwh += wattage * holdDuty * (soakSec / 3600.0f) / 1000.0f;
+    }
+
+    r.endTemp = temp;
+    return r;
+}
+
+bool predictorRun(const ProfileRunner& run, float currentTemp, unsigned long now,
+                  float wattage, FiringPrediction& out) {
+    if (run.profile == nullptr ||
+        (run.state != PROFILE_RAMPING && run.state != PROFILE_SOAKING)) {
+        return false;
+    }
+
+    // Band: shift (a, b) by PREDICTOR_BAND_SIGMAS standard errors of the
+    // achievable rate a - b*x at the hottest remaining target, along the
+    // covariance. A ramp moves duty and temperature together, so the errors
+    // in a and b are strongly correlated (~0.97): moving them independently
+    // and in opposite directions overstates the band many times over.
+    const HeatingModel& m = heatingModel;
+    float hottest = currentTemp;
+    for (uint8_t s = run.segment; s < run.profile->numSegments; s++) {
+        hottest = fmaxf(hottest, run.profile->segments[s].targetTemp);
+    }
+    float x = hottest - OBSERVER_AMBIENT_TEMP;
+    float cov0 = (m.p[0][0] - m.p[0][1] * x) * m.noiseVar;  // Cov(theta) * (1, -x)
+    float cov1 = (m.p[1][0] - m.p[1][1] * x) * m.noiseVar;
+    float sigma = sqrtf(fmaxf(cov0 - cov1 * x, 0.0f));
+    float da = sigma > 0.0f ? PREDICTOR_BAND_SIGMAS * cov0 / sigma : 0.0f;
+    float db = sigma > 0.0f ? PREDICTOR_BAND_SIGMAS * cov1 / sigma : 0.0f;
+
+    SimResult nominal = simulate(run, currentTemp, now, m.a, m.b, wattage);
+    SimResult fast = simulate(run, currentTemp, now, m.a + da, fmaxf(m.b + db, 0.0f), wattage);
+    SimResult slow = simulate(run, currentTemp, now, fmaxf(m.a - da, 1.0f), fmaxf(m.b - db, 0.0f), wattage);
+
+    out.etaSec = nominal.seconds;
+    out.etaLowSec = fminf(fast.seconds, nominal.seconds);
+    // A stalled run stops counting where it stalls: never report it as faster
+    out.etaHighSec = fmaxf(slow.seconds, nominal.seconds);
+    out.kwh = nominal.kwh;
+    out.kwhLow = fminf(fast.kwh, slow.kwh);
+    out.kwhHigh = fmaxf(fast.kwh, slow.kwh);
+    out.endTemp = nominal.endTemp;
+    out.maxReachable = (m.b > 0.0f) ? OBSERVER_AMBIENT_TEMP + m.a / m.b : INFINITY;
+    out.stalled = nominal.stalled;
+    out.truncated = nominal.truncated || fast.truncated || slow.truncated;
+    return true;
+}
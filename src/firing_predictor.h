@@ -0,0 +1,57 @@
+#ifndef FIRING_PREDICTOR_H
+#define FIRING_PREDICTOR_H
+
+// Remaining-time and end-temperature predictor
+// Fits the kiln's heating capability online as
+//     dT/dt = a * duty - b * (T - Tambient)        (°C/hour)
+// with two-parameter recursive least squares, then forward-simulates the
+// rest of the running profile at min(programmed ramp, achievable rate).
+// The simulation is repeated with the parameters pushed +/- two standard
+// errors to give a confidence band on ETA and energy.
+
+#include <stdint.h>
+#include "profile.h"
+
+struct FiringPrediction {
+    float etaSec;           // Nominal time to profile end (s)
+    float etaLowSec;        // Optimistic bound (s)
+    float etaHighSec;       // Pessimistic bound (s)
+    float kwh;              // Nominal energy still to be used (kWh)
+    float kwhLow;
+    float kwhHigh;
+    float endTemp;          // Temperature at the last segment's end (°C)
+    float maxReachable;     // Equilibrium temperature at full power (°C)
+    bool stalled;           // Kiln cannot reach a remaining target
+    bool truncated;         // Simulation hit its step budget
+};
+
+struct HeatingModel {
+    float a;                // Full-power heating rate coefficient (°C/h)
+    float b;                // Loss coefficient (1/h)
+    float p[2][2];          // RLS covariance
+    float noiseVar;         // Residual variance ((°C/h)^2)
+    uint32_t samples;
+};
+
+extern HeatingModel heatingModel;
+
+/**
+ * Reset the fit to the config.h prior (start of a firing)
+ */
+void predictorReset(float currentTemp, unsigned long now);
+
+/**
+ * Feed every temperature tick; refits the model every PREDICTOR_FIT_WINDOW_MS
+ */
+void predictorSample(float temp, bool heating, unsigned long now);
+
+/**
+ * Forward-simulate the remainder of the running profile
+ *
+ * @param wattage Element power for the energy estimate (W)
+ * @return False if no profile is running
+ */
+bool predictorRun(const ProfileRunner& run, float currentTemp, unsigned long now,
+                  float wattage, FiringPrediction& out);
+
+#endif // FIRING_PREDICTOR_H
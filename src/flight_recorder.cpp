@@ -0,0 +1,369 @@
+/**
+ * Flight recorder
+ *
+ * Boot sequence (flightRecorderBegin): if the RTC record is valid, print a
+ * one-line summary of how the last boot ended, dump the raw record as hex,
+ * write it to /flight (keeping the newest FLIGHT_ARCHIVE_KEEP), then start a
+ * new record with a BOOT event. A power-on reset leaves garbage that fails
+ * the header check, and recording simply starts fresh.
+ */
+
+#include "flight_recorder.h"
+
+// ============================================================================
+// RECORD FORMAT
+// ============================================================================
+
+void flightRecordInit(FlightRecord& r, uint32_t bootCount, uint8_t resetReason) {
+    memset(&r, 0, sizeof(r));
+    FlightHeader& h = r.header;
+    h.magic = FLIGHT_MAGIC;
+    h.version = FLIGHT_VERSION;
+    h.eventSlots = FLIGHT_EVENT_SLOTS;
+    h.tickSlots = FLIGHT_TICK_SLOTS;
+    h.bootCount = bootCount;
+    h.resetReason = resetReason;
+    h.runningJob = -1;
+}
+
+bool flightRecordValid(const FlightHeader& h, uint16_t eventSlots, uint16_t tickSlots) {
+    return h.magic == FLIGHT_MAGIC && h.version == FLIGHT_VERSION &&
+           h.eventSlots == eventSlots && h.tickSlots == tickSlots &&
+           h.eventHead < eventSlots && h.tickHead < tickSlots &&
+           h.eventCount <= eventSlots && h.tickCount <= tickSlots;
+}
+
+bool flightEventValid(const FlightEvent& e) {
+    return e.check == flightEventCheck(e) && e.type != FLIGHT_EVT_NONE &&
+           e.type < FLIGHT_EVT_TYPE_COUNT;
+}
+
+/**
+ * a happened before b: by time, then by seq for events in the same millisecond
+ */
+static bool flightBefore(const FlightEvent& a, const FlightEvent& b) {
+    if (a.timeMs != b.timeMs) {
+        return a.timeMs < b.timeMs;
+    }
+    return (int16_t)(a.seq - b.seq) < 0;
+}
+
+/**
+ * Copy the valid, written slots of one ring
+ */
+static int collectRing(const FlightEvent* ring, uint16_t slots, uint16_t head, uint16_t count,
+                       FlightEvent* out, int n, int max, int* torn) {
+    for (uint16_t i = 0; i < count && n < max; i++) {
+        const FlightEvent& e = ring[(head + slots - count + i) % slots];
+        if (!flightEventValid(e)) {
+            (*torn)++;
+            continue;
+        }
+        out[n++] = e;
+    }
+    return n;
+}
+
+int flightCollect(const FlightHeader& h, const FlightEvent* events, const FlightEvent* ticks,
+                  FlightEvent* out, int max, int* torn) {
+    *torn = 0;
+    int n = collectRing(events, h.eventSlots, h.eventHead, h.eventCount, out, 0, max, torn);
+    n = collectRing(ticks, h.tickSlots, h.tickHead, h.tickCount, out, n, max, torn);
+
+    // Oldest first (insertion sort; both rings are already in order, n is a few hundred)
+    for (int i = 1; i < n; i++) {
+        FlightEvent e = out[i];
+        int j = i - 1;
+        while (j >= 0 && flightBefore(e, out[j])) {
+            out[j + 1] = out[j];
+            j--;
+        }
+        out[j + 1] = e;
+    }
+    return n;
+}
+
+const char* flightEventName(uint8_t type) {
+    static const char* const names[FLIGHT_EVT_TYPE_COUNT] = {
+        "NONE", "BOOT", "MODE", "COMMAND", "FAULT", "PROFILE", "SENSOR", "TICK", "SSR"
+    };
+    return type < FLIGHT_EVT_TYPE_COUNT ? names[type] : "?";
+}
+
+const char* flightResetReasonName(uint8_t reason) {
+    // esp_reset_reason_t
+    static const char* const names[] = {
+        "unknown", "power-on", "external pin", "software", "panic", "interrupt watchdog",
+        "task watchdog", "other watchdog", "deep sleep", "brownout", "SDIO"
+    };
+    return reason < sizeof(names) / sizeof(names[0]) ? names[reason] : "unknown";
+}
+
+// ============================================================================
+// TARGET: RTC RECORD, BOOT DUMP AND ARCHIVE
+// ============================================================================
+
+#if defined(ARDUINO)
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <esp_system.h>
+#include <esp_attr.h>
+
+#define FLIGHT_DIR          "/flight"
+#define FLIGHT_HEX_PER_LINE 32
+
+static_assert(sizeof(FlightRecord) <= 6 * 1024, "RTC slow memory is 8 KB, shared with other RTC data");
+
+// Survives every reset except power-on (and a brownout deep enough to clear RTC memory)
+RTC_NOINIT_ATTR static FlightRecord flightRecord;
+
+static bool recording = false;   // The old record is left alone until it is archived
+static uint8_t lastMode = 0xFF;
+static uint8_t lastProfileState = 0xFF;
+static uint8_t lastProfileSegment = 0xFF;
+static bool lastSensorError = false;
+
+static FlightEvent makeEvent(uint8_t type, uint8_t a, uint16_t b, float temp, int16_t value,
+                             uint8_t flags) {
+    FlightEvent e;
+    e.timeMs = millis();
+    e.seq = 0;
+    e.type = type;
+    e.a = a;
+    e.b = b;
+    e.temp = flightTenths(temp);
+    e.value = value;
+    e.flags = flags;
+    e.check = 0;
+    return e;
+}
+
+static void record(const FlightEvent& e) {
+    if (recording) {
+        flightPush(flightRecord, e);
+    }
+}
+
+void flightRecordMode(uint8_t mode) {
+    if (mode != lastMode) {
+        lastMode = mode;
+        record(makeEvent(FLIGHT_EVT_MODE, mode, 0, 0.0f, 0, 0));
+    }
+}
+
+void flightRecordProfile(uint8_t state, uint8_t segment) {
+    if (state != lastProfileState || segment != lastProfileSegment) {
+        lastProfileState = state;
+        lastProfileSegment = segment;
+        record(makeEvent(FLIGHT_EVT_PROFILE, state, segment, 0.0f, 0, 0));
+    }
+}
+
+void flightRecordSensor(bool error, float temp) {
+    if (error != lastSensorError) {
+        lastSensorError = error;
+        record(makeEvent(FLIGHT_EVT_SENSOR, error ? 1 : 0, 0, temp, 0,
+                         error ? FLIGHT_FLAG_SENSOR_ERR : 0));
+    }
+}
+
+void flightRecordCommand(uint8_t type, uint8_t source, float value, float temp) {
+    record(makeEvent(FLIGHT_EVT_COMMAND, type, source, temp, flightTenths(value), 0));
+}
+
+void flightRecordFault(uint8_t fault, float innovation, float temp) {
+    record(makeEvent(FLIGHT_EVT_FAULT, fault, 0, temp, flightTenths(innovation), 0));
+}
+
+void flightRecordTick(float temp, float target, float duty, uint8_t ssrMask, uint8_t flags) {
+    float d = duty < 0.0f ? 0.0f : duty > 100.0f ? 100.0f : duty;
+    record(makeEvent(FLIGHT_EVT_TICK, ssrMask, (uint16_t)(d * 100.0f + 0.5f), temp,
+                     flightTenths(target), flags));
+}
+
+void flightRecordSsr(uint8_t ssrMask, float temp) {
+    record(makeEvent(FLIGHT_EVT_SSR, ssrMask, 0, temp, 0, ssrMask ? FLIGHT_FLAG_HEATING : 0));
+}
+
+void flightHeartbeat() {
+    if (!recording) {
+        return;
+    }
+    flightRecord.header.heartbeats++;
+    flightRecord.header.lastHeartbeatMs = millis();
+}
+
+void flightJobHook(int job) {
+    if (!recording) {
+        return;
+    }
+    flightRecord.header.runningJob = (int8_t)job;
+    if (job >= 0) {
+        flightRecord.header.jobStartMs = millis();
+    }
+}
+
+static void archivePath(char* path, size_t size, int index) {
+    snprintf(path, size, FLIGHT_DIR "/%04d.bin", index);
+}
+
+int flightLastArchive() {
+    int last = -1;
+    File dir = LittleFS.open(FLIGHT_DIR);
+    if (!dir || !dir.isDirectory()) {
+        return -1;
+    }
+    File entry = dir.openNextFile();
+    while (entry) {
+        int index = atoi(entry.name());
+        if (index > last) {
+            last = index;
+        }
+        entry = dir.openNextFile();
+    }
+    return last;
+}
+
+/**
+ * Write the record as the next archive, dropping the oldest past FLIGHT_ARCHIVE_KEEP
+ */
+static int archiveRecord(const FlightRecord& r) {
+    if (!LittleFS.exists(FLIGHT_DIR) && !LittleFS.mkdir(FLIGHT_DIR)) {
+        return -1;
+    }
+    int index = flightLastArchive() + 1;
+    char path[32];
+    archivePath(path, sizeof(path), index);
+    File f = LittleFS.open(path, "w");
+    if (!f) {
+        return -1;
+    }
+    size_t written = f.write((const uint8_t*)&r, sizeof(r));
+    f.close();
+    if (written != sizeof(r)) {
+        LittleFS.remove(path);
+        return -1;
+    }
+    if (index >= FLIGHT_ARCHIVE_KEEP) {
+        archivePath(path, sizeof(path), index - FLIGHT_ARCHIVE_KEEP);
+        LittleFS.remove(path);
+    }
+    return index;
+}
+
+static void printHexLine(uint32_t offset, const uint8_t* data, size_t n) {
+    char line[16 + FLIGHT_HEX_PER_LINE * 2];
+    int len = snprintf(line, sizeof(line), "[FLIGHT] %04lx ", (unsigned long)offset);
+    static const char hex[] = "0123456789abcdef";
+    for (size_t i = 0; i < n; i++) {
+        line[len++] = hex[data[i] >> 4];
+        line[len++] = hex[data[i] & 0x0F];
+    }
+    line[len++] = '\n';
+    Serial.write((const uint8_t*)line, len);
+}
+
+/**
+ * How the last boot ended, from the header and its newest tick
+ */
+static void printSummary(const FlightRecord& r, const char* const* jobNames, int jobCount) {
+    const FlightHeader& h = r.header;
+    int n = 0;
+    int torn = 0;
+    for (uint16_t i = 0; i < h.eventCount; i++) {
+        flightEventValid(r.events[i]) ? n++ : torn++;
+    }
+    for (uint16_t i = 0; i < h.tickCount; i++) {
+        flightEventValid(r.ticks[i]) ? n++ : torn++;
+    }
+    Serial.printf("[FLIGHT] Previous boot %lu (started by %s reset): %d events, %d torn, "
+                  "%lu heartbeats, last at %lums\n", (unsigned long)h.bootCount,
+                  flightResetReasonName(h.resetReason), n, torn, (unsigned long)h.heartbeats,
+                  (unsigned long)h.lastHeartbeatMs);
+    if (h.runningJob >= 0) {
+        Serial.printf("[FLIGHT] Reset while job %s was running (since %lums)\n",
+                      h.runningJob < jobCount && jobNames ? jobNames[h.runningJob] : "?",
+                      (unsigned long)h.jobStartMs);
+    }
+    // Newest first; SSR edges share the ring
+    for (uint16_t i = 1; i <= h.tickCount; i++) {
+        const FlightEvent& e = r.ticks[(h.tickHead + FLIGHT_TICK_SLOTS - i) % FLIGHT_TICK_SLOTS];
+        if (e.type == FLIGHT_EVT_TICK && flightEventValid(e)) {
+            Serial.printf("[FLIGHT] Last tick at %lums: %.1fC target %.1fC duty %.1f%% SSR 0x%02x\n",
+                          (unsigned long)e.timeMs, e.temp / 10.0f, e.value / 10.0f, e.b / 100.0f, e.a);
+            break;
+        }
+    }
+}
+
+void flightRecorderBegin(const char* const* jobNames, int jobCount) {
+    uint8_t reason = (uint8_t)esp_reset_reason();
+    uint32_t bootCount = 0;
+    const FlightHeader& h = flightRecord.header;
+
+    if (flightRecordValid(h, FLIGHT_EVENT_SLOTS, FLIGHT_TICK_SLOTS)) {
+        bootCount = h.bootCount + 1;
+        printSummary(flightRecord, jobNames, jobCount);
+
+        // Blocking is fine here: nothing is being controlled yet
+        const uint8_t* raw = (const uint8_t*)&flightRecord;
+        Serial.printf("[FLIGHT] BEGIN rtc %u\n", (unsigned)sizeof(flightRecord));
+        for (uint32_t off = 0; off < sizeof(flightRecord); off += FLIGHT_HEX_PER_LINE) {
+            uint32_t n = sizeof(flightRecord) - off;
+            printHexLine(off, raw + off, n < FLIGHT_HEX_PER_LINE ? n : FLIGHT_HEX_PER_LINE);
+        }
+        Serial.println("[FLIGHT] END");
+
+        int index = archiveRecord(flightRecord);
+        if (index >= 0) {
+            Serial.printf("[FLIGHT] Archived to " FLIGHT_DIR "/%04d.bin\n", index);
+        } else {
+            Serial.println("[FLIGHT] Archive failed (filesystem unavailable or full)");
+        }
+    } else {
+        Serial.printf("[FLIGHT] No previous record (%s reset)\n", flightResetReasonName(reason));
+    }
+
+    flightRecordInit(flightRecord, bootCount, reason);
+    recording = true;
+    record(makeEvent(FLIGHT_EVT_BOOT, reason, (uint16_t)bootCount, 0.0f, 0, 0));
+}
+
+bool flightDumpArchive(int index, bool start) {
+    static File dumpFile;
+    static uint32_t dumpOffset;
+    if (start) {
+        if (dumpFile) {
+            dumpFile.close();
+        }
+        char path[32];
+        archivePath(path, sizeof(path), index);
+        dumpFile = LittleFS.open(path, "r");
+        if (!dumpFile) {
+            Serial.printf("[FLIGHT] No archive %d\n", index);
+            return false;
+        }
+        dumpOffset = 0;
+        Serial.printf("[FLIGHT] BEGIN %04d %u\n", index, (unsigned)dumpFile.size());
+    }
+    if (!dumpFile) {
+        return false;
+    }
+    // Whole lines only, and only as many as the TX buffer takes now
+    const int lineBytes = 16 + FLIGHT_HEX_PER_LINE * 2;
+    for (int i = 0; i < FLIGHT_DUMP_LINES_PER_RUN && Serial.availableForWrite() >= lineBytes; i++) {
+        uint8_t data[FLIGHT_HEX_PER_LINE];
+        int n = dumpFile.read(data, sizeof(data));
+        if (n <= 0) {
+            dumpFile.close();
+            Serial.println("[FLIGHT] END");
+            return false;
+        }
+        printHexLine(dumpOffset, data, n);
+        dumpOffset += n;
+    }
+    return true;
+}
+
+#endif // ARDUINO
@@ -0,0 +1,218 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+// Flight recorder
+// The last few hundred control events, kept in RTC slow memory
+// (RTC_NOINIT_ATTR). The C runtime doesn't clear that memory at startup, so
+// the record is still there after a watchdog reset, a panic, a software
+// restart or a brownout that didn't take the RTC domain down. On the next
+// boot it is printed to serial as hex ("[FLIGHT]" lines), archived to
+// /flight/NNNN.bin, and started over. Host decoder:
+// tools/telemetry/flight_decode.cpp.
+//
+// Two rings of fixed 16-byte events:
+//   events  rare: boot, mode change, command applied, fault, profile step,
+//           sensor error (FLIGHT_EVENT_SLOTS)
+//   ticks   every control tick and SSR edge: temperature, target, duty, SSR
+//           states (FLIGHT_TICK_SLOTS, roughly the last
+//           FLIGHT_TICK_SLOTS / 10 seconds)
+// so the tick stream can't push the rare events out. Each write is a fixed
+// 16-byte copy, a check byte and a head update: constant time, no branches
+// on history, cheap enough for every tick.
+//
+// The header also holds the scheduler heartbeat (one per pass, the point
+// where a watchdog would be fed) and the job running right now, so a
+// record that ends in a hang names the job that never returned.
+//
+// Nothing here is zeroed by a reset, so a record is trusted only if its
+// magic, version and slot counts match, and each event carries its own
+// check byte: a slot half-written when the reset hit, or power-on garbage,
+// is dropped by the decoder rather than misread.
+//
+// Record layout (little-endian, as in RAM): FlightHeader, then
+// header.eventSlots events, then header.tickSlots ticks.
+//
+// The format and the event writer are pure C++, shared with the host
+// decoder; placement in RTC memory, boot handling and archiving are
+// target-only.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "config.h"
+
+#define FLIGHT_MAGIC            0x52544C46  // "FLTR"
+#define FLIGHT_VERSION          1
+
+enum FlightEventType {
+    FLIGHT_EVT_NONE,
+    // events ring
+    FLIGHT_EVT_BOOT,            // a: reset reason (esp_reset_reason_t), b: boot count
+    FLIGHT_EVT_MODE,            // a: SystemMode
+    FLIGHT_EVT_COMMAND,         // a: CommandType, b: CommandSource, value: value[0] x10
+    FLIGHT_EVT_FAULT,           // a: FaultClass, value: innovation x10
+    FLIGHT_EVT_PROFILE,         // a: ProfileState, b: segment
+    FLIGHT_EVT_SENSOR,          // a: 1 = sensor error began, 0 = cleared
+    // ticks ring
+    FLIGHT_EVT_TICK,            // a: SSR mask (bit per zone), b: duty x100, value: target
+    FLIGHT_EVT_SSR,             // a: SSR mask after the edge
+    FLIGHT_EVT_TYPE_COUNT
+};
+
+#define FLIGHT_FLAG_HEATING     0x01
+#define FLIGHT_FLAG_SENSOR_ERR  0x02
+
+/**
+ * One event; temperatures in 0.1 °C
+ */
+struct FlightEvent {
+    uint32_t timeMs;            // millis() in the boot that wrote it (orders the two rings)
+    uint16_t seq;               // Event number across both rings (orders events in the same ms)
+    uint8_t type;               // FlightEventType
+    uint8_t a;
+    uint16_t b;
+    int16_t temp;               // Control temperature
+    int16_t value;
+    uint8_t flags;              // FLIGHT_FLAG_*
+    uint8_t check;              // flightEventCheck(); a torn slot fails it
+};
+
+struct FlightHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t eventSlots;
+    uint16_t tickSlots;
+    uint16_t nextSeq;
+    uint16_t eventHead;         // Next slot to write
+    uint16_t tickHead;
+    uint16_t eventCount;        // Slots written (saturates at the slot count)
+    uint16_t tickCount;
+    uint32_t bootCount;         // Boots since the record was last found invalid
+    uint8_t resetReason;        // Reset that started this boot
+    int8_t runningJob;          // Scheduler job running now (-1 = between jobs)
+    uint16_t reserved;
+    uint32_t jobStartMs;        // When runningJob started
+    uint32_t heartbeats;        // Scheduler passes this boot
+    uint32_t lastHeartbeatMs;
+};
+
+struct FlightRecord {
+    FlightHeader header;
+    FlightEvent events[FLIGHT_EVENT_SLOTS];
+    FlightEvent ticks[FLIGHT_TICK_SLOTS];
+};
+
+static_assert(sizeof(FlightEvent) == 16, "FlightEvent is a fixed 16-byte record");
+static_assert(sizeof(FlightHeader) == 40, "FlightHeader layout is part of the archive format");
+
+static inline uint8_t flightEventCheck(const FlightEvent& e) {
+    const uint8_t* p = (const uint8_t*)&e;
+    uint8_t c = 0xA5;
+    for (size_t i = 0; i < sizeof(FlightEvent) - 1; i++) {
+        c = (uint8_t)((c << 1 | c >> 7) ^ p[i]);
+    }
+    return c;
+}
+
+static inline int16_t flightTenths(float v) {
+    float t = v * 10.0f;
+    return t > 32767.0f ? 32767 : t < -32768.0f ? -32768 : (int16_t)(t < 0 ? t - 0.5f : t + 0.5f);
+}
+
+static inline bool flightIsTick(uint8_t type) {
+    return type == FLIGHT_EVT_TICK || type == FLIGHT_EVT_SSR;
+}
+
+/**
+ * Start an empty record
+ */
+void flightRecordInit(FlightRecord& r, uint32_t bootCount, uint8_t resetReason);
+
+/**
+ * Header matches this format and build (events are checked one by one)
+ */
+bool flightRecordValid(const FlightHeader& h, uint16_t eventSlots, uint16_t tickSlots);
+
+/**
+ * Written slot whose check byte matches
+ */
+bool flightEventValid(const FlightEvent& e);
+
+/**
+ * Append an event to its ring, overwriting the oldest (constant time)
+ */
+static inline void flightPush(FlightRecord& r, FlightEvent e) {
+    FlightHeader& h = r.header;
+    e.seq = h.nextSeq++;
+    e.check = flightEventCheck(e);
+    if (flightIsTick(e.type)) {
+        r.ticks[h.tickHead] = e;
+        h.tickHead = (uint16_t)((h.tickHead + 1) % FLIGHT_TICK_SLOTS);
+        h.tickCount += h.tickCount < FLIGHT_TICK_SLOTS;
+    } else {
+        r.events[h.eventHead] = e;
+        h.eventHead = (uint16_t)((h.eventHead + 1) % FLIGHT_EVENT_SLOTS);
+        h.eventCount += h.eventCount < FLIGHT_EVENT_SLOTS;
+    }
+}
+
+/**
+ * Valid events of a record, oldest first (both rings merged by time)
+ *
+ * @param events header.eventSlots slots, then ticks header.tickSlots slots
+ * @return Events copied to out; *torn counts written slots that failed the check
+ */
+int flightCollect(const FlightHeader& h, const FlightEvent* events, const FlightEvent* ticks,
+                  FlightEvent* out, int max, int* torn);
+
+const char* flightEventName(uint8_t type);
+
+const char* flightResetReasonName(uint8_t reason);
+
+// ============================================================================
+// TARGET
+// ============================================================================
+
+#if defined(ARDUINO)
+
+/**
+ * Dump and archive what the last boot recorded, then start a new record
+ * Call once LittleFS is mounted, before the scheduler starts.
+ *
+ * @param jobNames Scheduler job names by id, to name a job that hung (may be null)
+ */
+void flightRecorderBegin(const char* const* jobNames, int jobCount);
+
+void flightRecordMode(uint8_t mode);                 // Logs only changes
+void flightRecordProfile(uint8_t state, uint8_t segment);   // Logs only changes
+void flightRecordSensor(bool error, float temp);     // Logs only changes
+void flightRecordCommand(uint8_t type, uint8_t source, float value, float temp);
+void flightRecordFault(uint8_t fault, float innovation, float temp);
+void flightRecordTick(float temp, float target, float duty, uint8_t ssrMask, uint8_t flags);
+void flightRecordSsr(uint8_t ssrMask, float temp);
+
+/**
+ * Scheduler pass completed (the watchdog-feed point)
+ */
+void flightHeartbeat();
+
+/**
+ * Scheduler run hook: job id before a job runs, -1 after
+ */
+void flightJobHook(int job);
+
+/**
+ * Print archive n as [FLIGHT] hex lines, a few lines per call
+ *
+ * @return False once the dump is finished (or there is no such archive)
+ */
+bool flightDumpArchive(int index, bool start);
+
+/**
+ * Newest archive index, -1 if none
+ */
+int flightLastArchive();
+
+#endif // ARDUINO
+
+#endif // FLIGHT_RECORDER_H
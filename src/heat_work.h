@@ -0,0 +1,79 @@
+#ifndef HEAT_WORK_H
+#define HEAT_WORK_H
+
+// Heat-work (cone-equivalent) accumulator
+// Integrates an Arrhenius rate exp(-Ea/R * (1/T - 1/Tref)) over the firing,
+// so the result is "equivalent seconds at Tref". Orton cones are mapped onto
+// the same scale by integrating their published 60°C/hour endpoints.
+//
+// Pure C++ (no Arduino dependencies) so it can be validated on the host.
+
+#include <stdint.h>
+
+struct OrtonCone {
+    const char* name;
+    float temp60;   // Bending temperature at 60°C/hour final ramp (°C)
+    float temp150;  // Bending temperature at 150°C/hour final ramp (°C)
+};
+
+extern const OrtonCone ortonCones[];
+extern const int numOrtonCones;
+
+/**
+ * Build the rate lookup table and cone heat-work thresholds
+ * Must be called once before any other heatWork function.
+ */
+void heatWorkBegin();
+
+/**
+ * Clear the accumulator (start of a firing)
+ */
+void heatWorkReset();
+
+/**
+ * Accumulate one control tick
+ *
+ * @param tempC Kiln temperature over the tick (°C)
+ * @param dtSeconds Tick length (s)
+ */
+void heatWorkUpdate(float tempC, float dtSeconds);
+
+/**
+ * Accumulated heat-work (equivalent seconds at the reference temperature)
+ */
+double heatWorkTotal();
+
+/**
+ * Heat-work needed to bend a cone at the 60°C/hour reference rate
+ */
+double heatWorkForCone(int coneIndex);
+
+/**
+ * Equivalent cone reached so far
+ *
+ * @param fraction Set to progress toward the next cone (0..1)
+ * @return Index into ortonCones of the last cone fully reached, -1 if none
+ */
+int heatWorkEquivalentCone(float* fraction);
+
+/**
+ * Rate-table lookup (exposed for validation and cost measurement)
+ */
+float heatWorkRate(float tempC);
+
+/**
+ * Look up a cone by name (e.g. "04", "6"), -1 if unknown
+ */
+int heatWorkFindCone(const char* name);
+
+/**
+ * Temperature at which a cone bends when fired to it at rampRate
+ * Interpolated between the chart's 60 and 150°C/hour columns (clamped to
+ * them; 0 = full power uses the 150 column). Profiles take their
+ * cone-terminated targets from here, so the table is the only source.
+ *
+ * @return °C, NAN if the cone is unknown
+ */
+float heatWorkConeTemp(const char* name, float rampRate);
+
+#endif // HEAT_WORK_H
@@ -0,0 +1,146 @@
+/**
+ * Statistical ice-point calibration
+ *
+ * Readings are grouped into blocks of ICE_CAL_BLOCK_SAMPLES. Block means are
+ * close to independent, so the usual CI applies to them:
+ *   half-width = t(k-1) * sqrt(var / k)      over k block means
+ * var is floored at the MAX31855 quantization noise of a block mean
+ * (LSB^2 / 12 / block size), so a perfectly steady reading still needs
+ * ICE_CAL_MIN_BLOCKS blocks.
+ *
+ * Drift rule: the least-squares slope of block mean vs time is tested
+ * against its standard error. A slope that is both significant (|t| >
+ * ICE_CAL_TREND_T) and material (> ICE_CAL_MAX_DRIFT_PER_MIN) means the
+ * probe hasn't settled, so the statistics restart from the next block.
+ * Stopping also needs the data to show stability, not merely fail to show
+ * drift: the slope's upper confidence bound must be under the limit too,
+ * otherwise a short window of a slow settling curve would pass.
+ */
+
+#include <math.h>
+#include "config.h"
+#include "ice_calibration.h"
+
+#define ICE_CAL_QUANT_VAR   (ICE_CAL_RESOLUTION * ICE_CAL_RESOLUTION / 12.0 / ICE_CAL_BLOCK_SAMPLES)
+#define ICE_CAL_BLOCK_SEC   (ICE_CAL_BLOCK_SAMPLES * TC_CONVERSION_MS / 1000.0)
+
+// Two-sided 95% Student t quantiles, df 1..30
+static const double T95_TABLE[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+double iceCalTQuantile95(double df) {
+    if (df < 1.0) {
+        return INFINITY;
+    }
+    if (df <= 30.0) {
+        return T95_TABLE[(int)df - 1];
+    }
+    // Cornish-Fisher expansion about the normal quantile, within 0.001 above df 30
+    const double z = 1.959964;
+    double z3 = z * z * z;
+    return z + (z3 + z) / (4.0 * df) + (5.0 * z3 * z * z + 16.0 * z3 + 3.0 * z) / (96.0 * df * df);
+}
+
+static void clearStatistics(IceCalibration& c) {
+    c.blockSum = 0.0;
+    c.blockFill = 0;
+    c.blocks = 0;
+    c.mean = 0.0;
+    c.m2 = 0.0;
+    c.shift = 0.0;
+    c.sumI = 0.0;
+    c.sumII = 0.0;
+    c.sumIX = 0.0;
+    c.samples = 0;
+}
+
+void iceCalReset(IceCalibration& c, unsigned long now) {
+    clearStatistics(c);
+    c.startMs = now;
+    c.restarts = 0;
+    c.offset = 0.0f;
+    c.halfWidth = INFINITY;
+    c.slopePerMin = 0.0f;
+    c.status = ICE_CAL_RUNNING;
+}
+
+/**
+ * Fold one completed block mean into the statistics and re-evaluate
+ */
+static void addBlock(IceCalibration& c, double x) {
+    if (c.blocks == 0) {
+        c.shift = x;
+    }
+    double i = c.blocks;
+    double d = x - c.shift;
+
+    c.blocks++;
+    double delta = x - c.mean;
+    c.mean += delta / c.blocks;
+    c.m2 += delta * (x - c.mean);
+
+    c.sumI += i;
+    c.sumII += i * i;
+    c.sumIX += i * d;
+
+    c.offset = (float)(0.0 - c.mean);
+    if (c.blocks < ICE_CAL_MIN_BLOCKS) {
+        return;
+    }
+
+    double k = c.blocks;
+    double var = fmax(c.m2 / (k - 1), ICE_CAL_QUANT_VAR);
+    c.halfWidth = (float)(iceCalTQuantile95(k - 1) * sqrt(var / k));
+
+    // Trend test
+    double meanD = c.mean - c.shift;
+    double sii = c.sumII - c.sumI * c.sumI / k;
+    double slope = (c.sumIX - c.sumI * meanD) / sii;    // °C per block
+    double se = sqrt(var / sii);
+    c.slopePerMin = (float)(slope * 60.0 / ICE_CAL_BLOCK_SEC);
+    if (fabs(slope) > ICE_CAL_TREND_T * se &&
+        fabs(c.slopePerMin) > ICE_CAL_MAX_DRIFT_PER_MIN) {
+        c.restarts++;
+        clearStatistics(c);
+        c.halfWidth = INFINITY;
+        return;
+    }
+
+    double slopeBoundPerMin = (fabs(slope) + iceCalTQuantile95(k - 2) * se) * 60.0 / ICE_CAL_BLOCK_SEC;
+    if (c.halfWidth <= ICE_CAL_TOLERANCE && slopeBoundPerMin <= ICE_CAL_MAX_DRIFT_PER_MIN) {
+        c.status = (fabs(c.offset) > ICE_CAL_MAX_OFFSET) ? ICE_CAL_OUT_OF_RANGE
+                                                          : ICE_CAL_CONVERGED;
+    }
+}
+
+IceCalStatus iceCalAddSample(IceCalibration& c, float reading, unsigned long now) {
+    if (c.status != ICE_CAL_RUNNING) {
+        return c.status;
+    }
+
+    c.samples++;
+    c.blockSum += reading;
+    if (++c.blockFill == ICE_CAL_BLOCK_SAMPLES) {
+        addBlock(c, c.blockSum / ICE_CAL_BLOCK_SAMPLES);
+        c.blockSum = 0.0;
+        c.blockFill = 0;
+    }
+
+    if (c.status == ICE_CAL_RUNNING && now - c.startMs > ICE_CAL_TIMEOUT_MS) {
+        c.status = ICE_CAL_TIMEOUT;
+    }
+    return c.status;
+}
+
+const char* iceCalStatusName(IceCalStatus s) {
+    switch (s) {
+        case ICE_CAL_RUNNING:      return "Measuring";
+        case ICE_CAL_CONVERGED:    return "Converged";
+        case ICE_CAL_OUT_OF_RANGE: return "Offset too large";
+        case ICE_CAL_TIMEOUT:      return "Timed out";
+    }
+    return "?";
+}
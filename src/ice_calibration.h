@@ -0,0 +1,68 @@
+#ifndef ICE_CALIBRATION_H
+#define ICE_CALIBRATION_H
+
+// Statistical ice-point calibration
+// Streams readings from a thermocouple in an ice bath through Welford
+// mean/variance and stops as soon as the confidence interval on the offset
+// is inside ICE_CAL_TOLERANCE. Readings are averaged in short blocks first
+// (batch means), since consecutive 10 Hz readings are correlated. A running
+// least-squares trend test rejects a bath (or probe) that is still settling:
+// significant drift restarts the statistics instead of averaging it in.
+// All state is O(1).
+//
+// Pure C++ with no Arduino dependencies so it runs unchanged on host.
+
+#include <stdint.h>
+
+enum IceCalStatus {
+    ICE_CAL_RUNNING,        // Collecting, not converged yet
+    ICE_CAL_CONVERGED,      // Offset known to within tolerance
+    ICE_CAL_OUT_OF_RANGE,   // Converged, but |offset| > ICE_CAL_MAX_OFFSET (check wiring)
+    ICE_CAL_TIMEOUT         // Never converged within ICE_CAL_TIMEOUT_MS
+};
+
+struct IceCalibration {
+    // Current block of raw readings
+    double blockSum;
+    uint16_t blockFill;
+
+    // Welford over block means
+    uint32_t blocks;
+    double mean;
+    double m2;
+
+    // Trend: regression of block mean on block index
+    double shift;           // First block mean, keeps the sums well conditioned
+    double sumI, sumII, sumIX;
+
+    uint32_t samples;       // Raw readings since the last restart
+    unsigned long startMs;
+    uint16_t restarts;      // Statistics discarded because of drift
+
+    // Latest evaluation
+    float offset;           // 0 - mean (°C)
+    float halfWidth;        // Confidence half-width on the offset (°C)
+    float slopePerMin;      // Fitted drift (°C/min)
+    IceCalStatus status;
+};
+
+void iceCalReset(IceCalibration& c, unsigned long now);
+
+/**
+ * Add one reading (linearized, without any stored offset)
+ *
+ * @return Status after this sample
+ */
+IceCalStatus iceCalAddSample(IceCalibration& c, float reading, unsigned long now);
+
+const char* iceCalStatusName(IceCalStatus s);
+
+/**
+ * Two-sided 95% Student t quantile (exposed for validation)
+ * Exact to 30 degrees of freedom, asymptotic above.
+ *
+ * @return Quantile, INFINITY below 1 degree of freedom
+ */
+double iceCalTQuantile95(double df);
+
+#endif // ICE_CALIBRATION_H
@@ -0,0 +1,391 @@
+/**
+ * Firing log transfer
+ *
+ * The controller side is a small state machine run by logTransferPoll():
+ *   IDLE -> LISTING (ENTRY frames as the TX buffer has room) -> IDLE
+ *   IDLE -> SWITCHING (INFO sent; wait for the UART to drain, change baud)
+ *        -> SYNC (first ACK) -> SENDING -> CLOSING (DONE sent, drain,
+ *           restore baud) -> IDLE
+ * Replies go through a one-frame pending buffer and are written only when
+ * the whole frame fits in the UART TX buffer, so neither the input job that
+ * parses requests nor the poll job ever waits on the port.
+ */
+
+#include "log_transfer.h"
+
+// ============================================================================
+// SENDER WINDOW
+// ============================================================================
+
+void xferWindowStart(XferWindow& w, uint32_t size, uint32_t offset, uint16_t blockSize,
+                     uint8_t window, uint32_t nowMs) {
+    memset(&w, 0, sizeof(w));
+    w.size = size;
+    w.acked = offset < size ? offset : size;
+    w.next = w.acked;
+    w.highWater = w.acked;
+    w.blockSize = blockSize;
+    w.window = window;
+    w.lastProgressMs = nowMs;
+}
+
+void xferWindowAck(XferWindow& w, uint32_t offset, bool resend, uint32_t nowMs) {
+    if (offset > w.highWater) {
+        return;  // Never sent: corrupt or stale
+    }
+    if (offset > w.acked) {
+        w.acked = offset;
+        w.lastProgressMs = nowMs;
+    }
+    if (w.next < w.acked) {
+        w.next = w.acked;
+    }
+    if (resend && w.next > w.acked) {
+        w.next = w.acked;
+        w.lastProgressMs = nowMs;
+        w.rewinds++;
+    }
+}
+
+bool xferWindowNext(XferWindow& w, uint32_t nowMs, uint32_t& offset, uint16_t& length) {
+    if (w.next > w.acked && nowMs - w.lastProgressMs >= XFER_ACK_TIMEOUT_MS) {
+        w.next = w.acked;
+        w.lastProgressMs = nowMs;
+        w.timeouts++;
+    }
+    if (w.next >= w.size || w.next - w.acked >= (uint32_t)w.blockSize * w.window) {
+        return false;
+    }
+    offset = w.next;
+    uint32_t left = w.size - w.next;
+    length = left < w.blockSize ? (uint16_t)left : w.blockSize;
+    w.next += length;
+    if (offset < w.highWater) {
+        w.resentBytes += length;
+    }
+    if (w.next > w.highWater) {
+        w.highWater = w.next;
+    }
+    w.frames++;
+    w.bytes += length;
+    return true;
+}
+
+// ============================================================================
+// RECEIVER RULE
+// ============================================================================
+
+void xferReceiverStart(XferReceiver& r, uint32_t offset) {
+    memset(&r, 0, sizeof(r));
+    r.expected = offset;
+}
+
+XferVerdict xferReceive(XferReceiver& r, uint32_t offset, uint16_t length) {
+    if (offset == r.expected && length > 0) {
+        r.expected += length;
+        r.gapReported = false;
+        r.accepted++;
+        return XFER_ACCEPT;
+    }
+    if (offset < r.expected) {
+        r.duplicates++;
+        return XFER_DISCARD;
+    }
+    r.outOfOrder++;
+    if (offset > r.expected && !r.gapReported) {
+        r.gapReported = true;
+        r.resendRequests++;
+        return XFER_DISCARD_RESEND;
+    }
+    return XFER_DISCARD;
+}
+
+// ============================================================================
+// TARGET: SERIAL AND FLASH SIDE
+// ============================================================================
+
+#if defined(ARDUINO)
+
+#include <Arduino.h>
+#include <driver/uart.h>
+#include "firing_log.h"
+
+#define XFER_RX_FRAME   32      // Longest host request, COBS-encoded
+
+enum XferState {
+    XFER_IDLE,
+    XFER_LISTING,
+    XFER_SWITCHING,
+    XFER_SYNC,
+    XFER_SENDING,
+    XFER_CLOSING
+};
+
+static XferState xferState = XFER_IDLE;
+static XferWindow xferWindow;
+static uint16_t xferIndex;
+static uint32_t xferBaud = SERIAL_BAUD_RATE;     // Rate the port runs at
+static uint32_t targetBaud;                     // Agreed in INFO, applied once it has left
+static uint32_t lastHeardMs;
+static int listNext;
+static uint16_t listCount;
+static uint16_t txSeq;
+
+static uint8_t rxFrame[XFER_RX_FRAME];
+static uint8_t rxLen;
+static bool rxInFrame = false;
+
+static uint8_t txFrame[XFER_MAX_ENCODED];
+static size_t pendingLen = 0;   // Reply in txFrame not yet written
+
+static bool queueReply(XferMessage& m) {
+    if (pendingLen > 0) {
+        return false;
+    }
+    m.seq = txSeq++;
+    pendingLen = xferEncode(m, txFrame);
+    return true;
+}
+
+/**
+ * Write the pending reply if the TX buffer takes all of it
+ */
+static bool flushReply() {
+    if (pendingLen == 0) {
+        return true;
+    }
+    if ((size_t)Serial.availableForWrite() < pendingLen) {
+        return false;
+    }
+    Serial.write(txFrame, pendingLen);
+    pendingLen = 0;
+    return true;
+}
+
+static bool txDrained() {
+    return uart_wait_tx_done(UART_NUM_0, 0) == ESP_OK;
+}
+
+static void setBaud(uint32_t baud) {
+    Serial.updateBaudRate(baud);
+    xferBaud = baud;
+}
+
+static uint32_t acceptBaud(uint32_t requested) {
+    static const uint32_t rates[] = {921600, 460800, 230400, 115200};
+    for (uint32_t rate : rates) {
+        if (rate <= XFER_MAX_BAUD && rate == requested) {
+            return rate;
+        }
+    }
+    return SERIAL_BAUD_RATE;
+}
+
+static void endTransfer() {
+    firingLogReadEnd();
+    if (xferBaud != SERIAL_BAUD_RATE) {
+        setBaud(SERIAL_BAUD_RATE);
+    }
+    xferState = XFER_IDLE;
+}
+
+static void handleOpen(const XferMessage& req, uint32_t now) {
+    XferMessage info = {};
+    info.type = TLM_MSG_XFER_INFO;
+    info.index = req.index;
+    if (xferState != XFER_IDLE) {
+        info.status = XFER_BUSY;
+        queueReply(info);
+        return;
+    }
+    int32_t size = firingLogSize(req.index);
+    if (size < 0) {
+        info.status = XFER_NO_SUCH_LOG;
+        queueReply(info);
+        return;
+    }
+    uint16_t block = req.blockSize < 64 ? 64 : req.blockSize > XFER_MAX_BLOCK ? XFER_MAX_BLOCK : req.blockSize;
+    uint8_t window = req.window < 1 ? 1 : req.window > XFER_MAX_WINDOW ? XFER_MAX_WINDOW : req.window;
+    xferIndex = req.index;
+    xferWindowStart(xferWindow, (uint32_t)size, req.offset, block, window, now);
+
+    info.status = XFER_OK;
+    info.size = (uint32_t)size;
+    info.offset = xferWindow.acked;
+    info.baud = acceptBaud(req.baud);
+    info.blockSize = block;
+    info.window = window;
+    if (queueReply(info)) {
+        targetBaud = info.baud;
+        xferState = XFER_SWITCHING;
+        lastHeardMs = now;
+    }
+}
+
+static void handleFrame(const uint8_t* frame, size_t len) {
+    XferMessage m;
+    if (!xferDecode(frame, len, m)) {
+        return;
+    }
+    uint32_t now = millis();
+    switch (m.type) {
+        case TLM_MSG_XFER_LIST:
+            if (xferState == XFER_IDLE) {
+                listNext = 0;
+                listCount = 0;
+                xferState = XFER_LISTING;
+            }
+            break;
+        case TLM_MSG_XFER_OPEN:
+            handleOpen(m, now);
+            break;
+        case TLM_MSG_XFER_ACK:
+            if (xferState == XFER_SYNC || xferState == XFER_SENDING) {
+                lastHeardMs = now;
+                xferWindowAck(xferWindow, m.offset, m.flags & XFER_ACK_RESEND, now);
+                xferState = XFER_SENDING;
+            }
+            break;
+        case TLM_MSG_XFER_CLOSE:
+            if (xferState == XFER_SYNC || xferState == XFER_SENDING) {
+                XferMessage done = {};
+                done.type = TLM_MSG_XFER_DONE;
+                done.size = xferWindow.bytes;
+                done.frames = xferWindow.frames;
+                done.resent = xferWindow.resentBytes;
+                queueReply(done);
+                xferState = XFER_CLOSING;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+bool logTransferRxByte(uint8_t b) {
+    if (b == 0) {
+        if (rxInFrame && rxLen > 0) {
+            uint8_t frame[XFER_RX_FRAME];
+            size_t n = tlmCobsDecode(rxFrame, rxLen, frame);
+            rxInFrame = false;
+            if (n > 0) {
+                handleFrame(frame, n);
+            }
+        } else {
+            rxInFrame = true;       // Opening delimiter (or a run of them)
+            rxLen = 0;
+        }
+        return true;
+    }
+    if (rxInFrame) {
+        if (rxLen < sizeof(rxFrame)) {
+            rxFrame[rxLen++] = b;
+        } else {
+            rxInFrame = false;      // Too long for a request: not one
+        }
+        return true;
+    }
+    // Bytes outside frames at the transfer baud are noise, not shell input
+    return xferState != XFER_IDLE && xferState != XFER_LISTING;
+}
+
+bool logTransferActive() {
+    return xferState != XFER_IDLE;
+}
+
+void logTransferPoll() {
+    if (!flushReply() || xferState == XFER_IDLE) {
+        return;  // A refusal (no such log, busy) is sent from IDLE too
+    }
+    uint32_t now = millis();
+
+    switch (xferState) {
+        case XFER_LISTING: {
+            int last = firingLogCurrentIndex();
+            while (listNext <= last) {
+                int32_t size = firingLogSize(listNext);
+                if (size >= 0) {
+                    XferMessage entry = {};
+                    entry.type = TLM_MSG_XFER_ENTRY;
+                    entry.index = (uint16_t)listNext;
+                    entry.size = (uint32_t)size;
+                    queueReply(entry);
+                    listCount++;
+                }
+                listNext++;
+                if (!flushReply()) {
+                    return;
+                }
+            }
+            XferMessage end = {};
+            end.type = TLM_MSG_XFER_ENTRY;
+            end.index = XFER_LIST_END;
+            end.size = listCount;
+            queueReply(end);
+            xferState = XFER_IDLE;
+            flushReply();
+            break;
+        }
+
+        case XFER_SWITCHING:
+            if (txDrained()) {
+                if (targetBaud != xferBaud) {
+                    setBaud(targetBaud);
+                }
+                xferState = XFER_SYNC;
+                lastHeardMs = now;
+            }
+            break;
+
+        case XFER_SYNC:
+        case XFER_SENDING:
+            if (now - lastHeardMs >= XFER_IDLE_TIMEOUT_MS) {
+                endTransfer();
+                Serial.printf("[XFER] Log %u: host silent, aborted at %lu/%lu bytes\n", xferIndex,
+                              (unsigned long)xferWindow.acked, (unsigned long)xferWindow.size);
+                break;
+            }
+            if (xferState == XFER_SENDING) {
+                const size_t frameMax = TLM_ENCODED_SIZE(TLM_HEADER_BYTES + XFER_DATA_HEADER +
+                                                         xferWindow.blockSize + TLM_CRC_BYTES);
+                static uint8_t block[XFER_MAX_BLOCK];
+                for (int i = 0; i < XFER_FRAMES_PER_POLL; i++) {
+                    uint32_t offset;
+                    uint16_t length;
+                    if ((size_t)Serial.availableForWrite() < frameMax ||
+                        !xferWindowNext(xferWindow, now, offset, length)) {
+                        break;
+                    }
+                    XferMessage data = {};
+                    data.type = TLM_MSG_XFER_DATA;
+                    data.seq = txSeq++;
+                    data.offset = offset;
+                    data.data = block;
+                    data.length = length;
+                    if (firingLogRead(xferIndex, offset, block, length) != length) {
+                        endTransfer();
+                        Serial.printf("[XFER] Log %u: read failed at %lu, aborted\n", xferIndex,
+                                      (unsigned long)offset);
+                        break;
+                    }
+                    Serial.write(txFrame, xferEncode(data, txFrame));
+                }
+            }
+            break;
+
+        case XFER_CLOSING:
+            if (txDrained()) {
+                endTransfer();
+                Serial.printf("[XFER] Log %u: %lu bytes in %lu frames, %lu resent (%lu timeouts)\n",
+                              xferIndex, (unsigned long)xferWindow.bytes,
+                              (unsigned long)xferWindow.frames, (unsigned long)xferWindow.resentBytes,
+                              (unsigned long)xferWindow.timeouts);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+#endif // ARDUINO
@@ -0,0 +1,278 @@
+#ifndef LOG_TRANSFER_H
+#define LOG_TRANSFER_H
+
+// Firing log transfer
+// Downloads /logs files over the USB serial port, without Wi-Fi. Messages
+// are telemetry frames (telemetry_protocol.h: versioned, CRC-checked, COBS
+// between 0x00 delimiters), so text on the port can't be mistaken for data
+// and a receiver resynchronises at the next delimiter.
+//
+//   host                                      controller
+//   LIST                                  ->
+//                                         <-  ENTRY index size (one per log)
+//                                         <-  ENTRY XFER_LIST_END count
+//   OPEN index offset baud block window   ->
+//                                         <-  INFO status index size offset baud block window
+//   (both sides switch to the agreed baud)
+//   ACK offset                            ->  repeated until DATA arrives
+//                                         <-  DATA offset bytes   (up to window blocks past the ACK)
+//   ACK offset [RESEND]                   ->
+//   ...
+//   CLOSE                                 ->
+//                                         <-  DONE bytes frames resent   (then back to SERIAL_BAUD_RATE)
+//
+// Sliding window, go-back-N: the controller keeps up to `window` blocks in
+// flight past the host's cumulative ACK. The host accepts only the block at
+// the offset it expects. When a block is missing (CRC failure, overrun) it
+// asks once for a resend from that offset and drops anything after the
+// gap. A lost resend request is covered by XFER_ACK_TIMEOUT_MS. Blocks are
+// read straight from flash when sent, and read again for a resend, so the
+// window costs no RAM. OPEN takes a start offset: a partial download
+// resumes where it stopped.
+//
+// The message codecs, the sender window and the receiver rule are plain C++
+// and shared with the host tool (tools/telemetry/firing_log_fetch.cpp); the
+// serial and flash side is target-only.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "config.h"
+#include "telemetry_protocol.h"
+
+#define XFER_LIST_END           0xFFFF  // ENTRY index closing a listing
+#define XFER_ACK_RESEND         0x01    // ACK flag: a block was lost, go back to offset
+#define XFER_DATA_HEADER        4       // DATA payload: u32 offset, then the bytes
+#define XFER_MAX_FRAME          (TLM_HEADER_BYTES + XFER_DATA_HEADER + XFER_MAX_BLOCK + TLM_CRC_BYTES)
+#define XFER_MAX_ENCODED        TLM_ENCODED_SIZE(XFER_MAX_FRAME)
+
+enum XferStatus {
+    XFER_OK,
+    XFER_NO_SUCH_LOG,
+    XFER_BUSY                   // Another transfer is running
+};
+
+/**
+ * Any transfer message; only the fields of its type are used
+ */
+struct XferMessage {
+    uint8_t type;               // TLM_MSG_XFER_*
+    uint16_t seq;
+    uint8_t status;             // INFO: XferStatus
+    uint8_t flags;              // ACK: XFER_ACK_*
+    uint8_t window;             // OPEN, INFO
+    uint16_t index;             // ENTRY, OPEN, INFO
+    uint16_t blockSize;         // OPEN, INFO
+    uint32_t offset;            // OPEN, INFO, DATA, ACK
+    uint32_t size;              // ENTRY (count for XFER_LIST_END), INFO; DONE: bytes sent
+    uint32_t baud;              // OPEN, INFO
+    uint32_t frames;            // DONE
+    uint32_t resent;            // DONE: bytes sent more than once
+    const uint8_t* data;        // DATA: the block (points into the decoded frame)
+    uint16_t length;
+};
+
+/**
+ * Frame a message
+ *
+ * @param out At least XFER_MAX_ENCODED bytes
+ * @return Bytes to send
+ */
+static inline size_t xferEncode(const XferMessage& m, uint8_t* out) {
+    uint8_t frame[XFER_MAX_FRAME];
+    uint8_t* p = tlmBeginFrame(frame, m.type, m.seq);
+    switch (m.type) {
+        case TLM_MSG_XFER_ENTRY:
+            tlmPut16(p, m.index);
+            tlmPut32(p, m.size);
+            break;
+        case TLM_MSG_XFER_OPEN:
+            tlmPut16(p, m.index);
+            tlmPut32(p, m.offset);
+            tlmPut32(p, m.baud);
+            tlmPut16(p, m.blockSize);
+            tlmPut8(p, m.window);
+            break;
+        case TLM_MSG_XFER_INFO:
+            tlmPut8(p, m.status);
+            tlmPut16(p, m.index);
+            tlmPut32(p, m.size);
+            tlmPut32(p, m.offset);
+            tlmPut32(p, m.baud);
+            tlmPut16(p, m.blockSize);
+            tlmPut8(p, m.window);
+            break;
+        case TLM_MSG_XFER_DATA: {
+            uint16_t n = m.length < XFER_MAX_BLOCK ? m.length : XFER_MAX_BLOCK;
+            tlmPut32(p, m.offset);
+            memcpy(p, m.data, n);
+            p += n;
+            break;
+        }
+        case TLM_MSG_XFER_ACK:
+            tlmPut32(p, m.offset);
+            tlmPut8(p, m.flags);
+            break;
+        case TLM_MSG_XFER_DONE:
+            tlmPut32(p, m.size);
+            tlmPut32(p, m.frames);
+            tlmPut32(p, m.resent);
+            break;
+        default:                // LIST, CLOSE: no payload
+            break;
+    }
+    return tlmSealFrame(frame, p, out);
+}
+
+/**
+ * Unpack a decoded frame (COBS already removed)
+ *
+ * @return False if it isn't an intact transfer message
+ */
+static inline bool xferDecode(const uint8_t* frame, size_t len, XferMessage& m) {
+    if (!tlmCheckFrame(frame, len)) {
+        return false;
+    }
+    const uint8_t* p = frame + 1;
+    const size_t payload = len - TLM_HEADER_BYTES - TLM_CRC_BYTES;
+    memset(&m, 0, sizeof(m));
+    m.type = tlmGet8(p);
+    m.seq = tlmGet16(p);
+    switch (m.type) {
+        case TLM_MSG_XFER_ENTRY:
+            if (payload != 6) return false;
+            m.index = tlmGet16(p);
+            m.size = tlmGet32(p);
+            return true;
+        case TLM_MSG_XFER_OPEN:
+            if (payload != 13) return false;
+            m.index = tlmGet16(p);
+            m.offset = tlmGet32(p);
+            m.baud = tlmGet32(p);
+            m.blockSize = tlmGet16(p);
+            m.window = tlmGet8(p);
+            return true;
+        case TLM_MSG_XFER_INFO:
+            if (payload != 18) return false;
+            m.status = tlmGet8(p);
+            m.index = tlmGet16(p);
+            m.size = tlmGet32(p);
+            m.offset = tlmGet32(p);
+            m.baud = tlmGet32(p);
+            m.blockSize = tlmGet16(p);
+            m.window = tlmGet8(p);
+            return true;
+        case TLM_MSG_XFER_DATA:
+            if (payload < XFER_DATA_HEADER || payload > XFER_DATA_HEADER + XFER_MAX_BLOCK) return false;
+            m.offset = tlmGet32(p);
+            m.data = p;
+            m.length = (uint16_t)(payload - XFER_DATA_HEADER);
+            return true;
+        case TLM_MSG_XFER_ACK:
+            if (payload != 5) return false;
+            m.offset = tlmGet32(p);
+            m.flags = tlmGet8(p);
+            return true;
+        case TLM_MSG_XFER_DONE:
+            if (payload != 12) return false;
+            m.size = tlmGet32(p);
+            m.frames = tlmGet32(p);
+            m.resent = tlmGet32(p);
+            return true;
+        case TLM_MSG_XFER_LIST:
+        case TLM_MSG_XFER_CLOSE:
+            return payload == 0;
+        default:
+            return false;
+    }
+}
+
+// ============================================================================
+// SENDER WINDOW (controller)
+// ============================================================================
+
+struct XferWindow {
+    uint32_t size;              // File bytes
+    uint32_t acked;             // Host has everything below this
+    uint32_t next;              // Next byte to send
+    uint32_t highWater;         // Furthest byte ever sent
+    uint16_t blockSize;
+    uint8_t window;
+    uint32_t lastProgressMs;    // Last ACK that moved `acked`, or last rewind
+    uint32_t frames;
+    uint32_t bytes;
+    uint32_t resentBytes;
+    uint32_t rewinds;           // RESEND requests honoured
+    uint32_t timeouts;          // Rewinds because no ACK came
+};
+
+void xferWindowStart(XferWindow& w, uint32_t size, uint32_t offset, uint16_t blockSize,
+                     uint8_t window, uint32_t nowMs);
+
+/**
+ * Apply a cumulative ACK (offsets past anything sent are ignored)
+ */
+void xferWindowAck(XferWindow& w, uint32_t offset, bool resend, uint32_t nowMs);
+
+/**
+ * Next block to send, if the window has room (rewinds first on ACK timeout)
+ *
+ * @return False if nothing may be sent now
+ */
+bool xferWindowNext(XferWindow& w, uint32_t nowMs, uint32_t& offset, uint16_t& length);
+
+static inline bool xferWindowComplete(const XferWindow& w) {
+    return w.acked >= w.size;
+}
+
+// ============================================================================
+// RECEIVER RULE (host)
+// ============================================================================
+
+enum XferVerdict {
+    XFER_ACCEPT,                // Write the block, ACK the new offset
+    XFER_DISCARD,               // Duplicate or past a gap already reported
+    XFER_DISCARD_RESEND         // First block past a gap: ACK with XFER_ACK_RESEND
+};
+
+struct XferReceiver {
+    uint32_t expected;          // Next byte wanted
+    bool gapReported;           // RESEND sent for `expected`, not yet filled
+    uint32_t accepted;
+    uint32_t duplicates;
+    uint32_t outOfOrder;
+    uint32_t resendRequests;
+};
+
+void xferReceiverStart(XferReceiver& r, uint32_t offset);
+
+XferVerdict xferReceive(XferReceiver& r, uint32_t offset, uint16_t length);
+
+// ============================================================================
+// TARGET: SERIAL AND FLASH SIDE
+// ============================================================================
+
+#if defined(ARDUINO)
+
+/**
+ * Offer one received serial byte to the transfer
+ * Frames start at a 0x00, which a typed key never is. While a transfer is
+ * running every byte belongs to it.
+ *
+ * @return True if the byte was consumed (not shell input)
+ */
+bool logTransferRxByte(uint8_t b);
+
+/**
+ * Send queued replies and data blocks; run every XFER_POLL_MS
+ */
+void logTransferPoll();
+
+/**
+ * A download holds the port (other serial output should pause)
+ */
+bool logTransferActive();
+
+#endif // ARDUINO
+
+#endif // LOG_TRANSFER_H
@@ -23,15 +23,54 @@
 #include <Adafruit_MAX31855.h>
 #include <TFT_eSPI.h>
 #include <PID_v1.h>
+#include <esp_timer.h>
+#include "profile.h"
+#include "ware_observer.h"
+#include "step_analyzer.h"
+#include "firing_log.h"
+#include "shadow_controller.h"
+#include "heat_work.h"
+#include "firing_predictor.h"
+#include "element_health.h"
+#include "fault_observer.h"
+#include "tc_sampler.h"
+#include "tc_linearize.h"
+#include "noise_spectrum.h"
+#include "ice_calibration.h"
+#include "zone_control.h"
+#include "tc_vote.h"
+#include "scheduler.h"
+#include "sample_bus.h"
+#include "command_queue.h"
+#include "profiler.h"
+#include "ui_latency.h"
+#include "memory_monitor.h"
+#include "async_log.h"
+#include "telemetry_protocol.h"
+#include "log_transfer.h"
+#include "serial_shell.h"
+#include "flight_recorder.h"
+#include "settings_store.h"
 
 // ============================================================================
 // HARDWARE OBJECTS
 // ============================================================================
 
-// Thermocouple using HARDWARE SPI (shares bus with TFT)
+// Thermocouples using HARDWARE SPI (shares bus with TFT), one per heating zone
 // Constructor: Adafruit_MAX31855(CS pin) - uses hardware SPI
-// Pins: Hardware SPI uses CLK=18, MISO=19 automatically, CS=5
-Adafruit_MAX31855 thermocouple(THERMOCOUPLE_CS);
+// Pins: Hardware SPI uses CLK=18, MISO=19 automatically, CS per ZONE_TC_CS_PINS
+const uint8_t zoneCsPins[] = ZONE_TC_CS_PINS;
+const int8_t zoneBackupCsPins[] = ZONE_TC_BACKUP_CS_PINS;
+const uint8_t zoneSsrPins[] = ZONE_SSR_PINS;
+static_assert(sizeof(zoneCsPins) == KILN_ZONE_COUNT, "ZONE_TC_CS_PINS needs one pin per zone");
+static_assert(sizeof(zoneBackupCsPins) == KILN_ZONE_COUNT, "ZONE_TC_BACKUP_CS_PINS needs one entry per zone");
+static_assert(sizeof(zoneSsrPins) == KILN_ZONE_COUNT, "ZONE_SSR_PINS needs one pin per zone");
+static_assert(KILN_ZONE_COUNT <= TLM_MAX_ZONES, "Telemetry frames carry at most TLM_MAX_ZONES zones");
+Adafruit_MAX31855 zoneThermocouples[KILN_ZONE_COUNT] = ZONE_TC_CS_PINS;
+Adafruit_MAX31855 zoneBackupThermocouples[KILN_ZONE_COUNT] = ZONE_TC_BACKUP_CS_PINS;  // Unused where -1
+
+// Zone 0's thermocouple (hardware tests and ice calibration)
+Adafruit_MAX31855& thermocouple = zoneThermocouples[0];
 
 // TFT Display (ILI9341)
 // Uses hardware SPI configured via platformio.ini build flags
@@ -42,23 +81,28 @@ TFT_eSPI tft = TFT_eSPI();
 // PID CONTROLLER
 // ============================================================================
 
-// PID variables (must be double for PID library)
-double pidInput = 0;      // Current temperature
-double pidOutput = 0;     // PID output (0-100%)
+// Kiln-level view of the zone loops (see zone_control.h): coldest zone in,
+// mean zone output out. With one zone these are that zone's PID values.
+double pidInput = 0;      // Control temperature (coldest zone)
+double pidOutput = 0;     // Mean zone output (0-100%)
 double pidSetpoint = 100; // Target temperature
 
-// PID tuning parameters (conservative starting values)
-double Kp = 5.0;   // Proportional gain
-double Ki = 0.5;   // Integral gain
-double Kd = 1.0;   // Derivative gain
+// PID tuning parameters in use, shared by all zones (from settings at boot)
+double Kp = DEFAULT_KP;   // Proportional gain
+double Ki = DEFAULT_KI;   // Integral gain
+double Kd = DEFAULT_KD;   // Derivative gain
 
-// Create PID controller instance
-// Parameters: &Input, &Output, &Setpoint, Kp, Ki, Kd, DIRECT
-// DIRECT means: increase output when below setpoint (heating mode)
-PID kilnPID(&pidInput, &pidOutput, &pidSetpoint, Kp, Ki, Kd, DIRECT);
+// Heating zones, each with its own PID (DIRECT: increase output when below setpoint)
+KilnZone zones[KILN_ZONE_COUNT];
 
-// SSR control variables for time-proportional control
-unsigned long ssrWindowSize = SSR_CYCLE_TIME_MS;  // 2 seconds from config.h
+// Shadow controller: candidate gains evaluated on the same inputs, output never used
+#if ENABLE_SHADOW_CONTROLLER
+ShadowController shadowPID(SHADOW_KP, SHADOW_KI, SHADOW_KD);
+#endif
+ComputeCost livePidCost = {};
+bool livePidComputed = false;  // True if zone 0's PID produced a new output this tick
+
+// SSR control variables for time-proportional control (window: settings.ssrCycleMs)
 unsigned long ssrWindowStartTime = 0;
 
 // ============================================================================
@@ -76,26 +120,76 @@ enum SystemMode {
 
 struct SystemState {
     SystemMode mode;
-    float currentTemp;
+    float currentTemp;      // Coldest zone (control temperature)
+    float hottestTemp;      // Hottest zone (safety limit)
     float targetTemp;
     bool heating;
     bool sensorError;
     unsigned long lastTempRead;
-    unsigned long lastDisplayUpdate;
     unsigned long heatingStartTime;
 };
 
 SystemState state = {
     .mode = MODE_IDLE,
     .currentTemp = 0.0,
+    .hottestTemp = 0.0,
     .targetTemp = 100.0,  // Default target: 100°C
     .heating = false,
     .sensorError = false,
     .lastTempRead = 0,
-    .lastDisplayUpdate = 0,
     .heatingStartTime = 0
 };
 
+// ============================================================================
+// SCHEDULER
+// ============================================================================
+
+// Cooperative scheduler driving loop() (see scheduler.h)
+Scheduler scheduler;
+int jobSsrId = -1;      // Rescheduled to the next SSR edge
+int jobTcReadId = -1;   // Retried shortly while the sampler defers a read
+int jobReportId = -1;   // Run at once when a shell command asks for a report
+int jobSchedReportId = -1;  // Resumed shortly while its report waits for TX buffer room
+
+static uint64_t schedulerClock() {
+    return (uint64_t)esp_timer_get_time();
+}
+
+// ============================================================================
+// SAMPLE BUS
+// ============================================================================
+
+// Per-tick control snapshots (see sample_bus.h); consumers read these, not `state`
+SampleBus sampleBus;
+SampleCursor displayCursor;
+SampleCursor statusCursor;
+SampleCursor logCursor;
+SampleCursor telemetryCursor;
+SampleCursor shellCursor;
+bool sampleDue = false;  // New kiln temperature since the last publish
+
+// ============================================================================
+// COMMAND QUEUE
+// ============================================================================
+
+// Inputs post here; the control job applies them (see command_queue.h)
+CommandQueue commandQueue;
+
+// Encoder/button event -> pixels on the glass, per screen (see ui_latency.h)
+UiLatency uiLatency;
+
+// Binary telemetry stream (see telemetry_protocol.h); replaces [STATUS] while on
+bool telemetryStreaming = ENABLE_TELEMETRY && TELEMETRY_START_STREAMING;
+uint16_t telemetrySeq = 0;
+uint32_t telemetrySent = 0;
+uint32_t telemetryDropped = 0;      // UART buffer too full to take a whole frame
+
+#if ENABLE_PROFILER
+// Control-period jitter trackers (see profiler.h)
+int pidPeriod = -1;         // Zone PID computes, nominally PID_SAMPLE_TIME apart
+int tcRoundPeriod = -1;     // Completed read rounds, nominally TC_SAMPLE_INTERVAL_MS apart
+#endif
+
 // ============================================================================
 // ENCODER STATE
 // ============================================================================
@@ -109,6 +203,17 @@ struct EncoderState {
 EncoderState leftEncoder = {HIGH, HIGH, 0};
 EncoderState rightEncoder = {HIGH, HIGH, 0};
 
+// Profile selected on the profile screen (index into builtinProfiles)
+int selectedProfile = 0;
+
+// Step-response analyzer (scores every setpoint change)
+StepAnalyzer stepAnalyzer;
+
+// Latest remaining-time prediction for the running profile
+FiringPrediction firingPrediction;
+bool predictionValid = false;
+uint32_t predictionCostUs = 0;
+
 // Debounce time
 #define DEBOUNCE_MS 50
 
@@ -140,105 +245,311 @@ void playTone(uint32_t frequency, uint32_t duration) {
 // ============================================================================
 
 /**
- * Read temperature from thermocouple with validation
+ * Read one thermocouple with validation
  * Returns true if reading is valid, false on error
  */
-bool readTemperature() {
-    double temp = thermocouple.readCelsius();
+bool readThermocouple(Adafruit_MAX31855& tc, float& tempOut) {
+    double temp = tc.readCelsius();
 
     // Check for sensor errors
     if (isnan(temp)) {
-        state.sensorError = true;
-        DEBUG_PRINTLN("[ERROR] Thermocouple returned NaN");
+        LOG_ERROR("[ERROR] Thermocouple returned NaN\n");
         return false;
     }
 
+#if ENABLE_TC_LINEARIZATION
+    // Replace the chip's linear approximation with ITS-90 (offset folded in)
+    temp = tcLinearize(temp, tc.readInternal());
+#else
+    temp += tcLinearizeOffset();
+#endif
+
     // Validate temperature range
     if (temp < MIN_VALID_TEMP || temp > MAX_VALID_TEMP) {
-        state.sensorError = true;
-        DEBUG_PRINT("[ERROR] Temperature out of range: ");
-        DEBUG_PRINTLN(temp);
+        LOG_ERROR("[ERROR] Temperature out of range: %.2f\n", temp);
         return false;
     }
 
-    // Valid reading
+    tempOut = temp;
+    return true;
+}
+
+/**
+ * Read one zone: its thermocouple, or both thermocouples voted when the
+ * zone has a backup (a single failure fails over instead of stopping)
+ * Returns true if the zone has a usable temperature
+ */
+bool readZoneTemperature(int z) {
+    PROFILE_ZONE("tc_read");
+    KilnZone& zone = zones[z];
+    zone.reads++;
+
+    float primary = 0.0;
+    bool primaryOk = readThermocouple(zoneThermocouples[z], primary);
+    if (!primaryOk) {
+        zone.errors++;
+    }
+
+    if (zoneBackupCsPins[z] < 0) {
+        zone.valid = primaryOk;
+        if (primaryOk) {
+            zone.temp = primary;
+        }
+        return zone.valid;
+    }
+
+    float backup = 0.0;
+    bool backupOk = readThermocouple(zoneBackupThermocouples[z], backup);
+    if (!backupOk) {
+        zone.errors++;
+    }
+
+    TcVoteSource lastSource = zone.vote.source;
+    bool wasWarning = zone.vote.driftWarning;
+    zone.valid = tcVoteUpdate(zone.vote, primaryOk, primary, backupOk, backup, millis(), zone.temp);
+
+    if (zone.vote.source != lastSource && zone.vote.source != TC_VOTE_NONE) {
+        LOG_WARN("[TC] Zone %d control on %s thermocouple (primary %s, backup %s, diff %+.1fC)\n",
+                 z, tcVoteSourceName(zone.vote.source), primaryOk ? "ok" : "FAIL",
+                 backupOk ? "ok" : "FAIL", zone.vote.diff);
+        firingLogPrintf("TCVOTE z=%d %s p=%s b=%s diff=%.1f", z, tcVoteSourceName(zone.vote.source),
+                        primaryOk ? "ok" : "fail", backupOk ? "ok" : "fail", zone.vote.diff);
+    }
+    if (zone.vote.driftWarning && !wasWarning) {
+        LOG_WARN("[TC] Zone %d thermocouples disagree (diff %+.1fC, rate %+.0fC/h) - check both\n",
+                 z, zone.vote.diff, zone.vote.rateMismatch);
+        firingLogPrintf("TCDRIFT z=%d diff=%.1f rate=%.0f", z, zone.vote.diff, zone.vote.rateMismatch);
+        playTone(500, 100);
+    }
+    return zone.valid;
+}
+
+/**
+ * Combine the latest zone readings into the kiln temperature
+ * The coldest zone is the control temperature, the hottest is checked
+ * against the safety limit. Any failed zone is a sensor error.
+ */
+bool updateKilnTemperature() {
+    ZoneSummary summary = zonesSummarize(zones, KILN_ZONE_COUNT);
+    if (summary.validCount < KILN_ZONE_COUNT) {
+        state.sensorError = true;
+        return false;
+    }
     state.sensorError = false;
-    state.currentTemp = temp;
+    state.currentTemp = summary.coldest;
+    state.hottestTemp = summary.hottest;
     return true;
 }
 
+/**
+ * Boot self-check of the thermocouple linearization: accuracy against NIST
+ * reference points and per-sample cost
+ */
+void reportLinearization() {
+    TcLinearizeCheck check = tcLinearizeSelfCheck();
+    Serial.printf("[TC] ITS-90 table: max error %.3fC at %.0fC over %d NIST points "
+                  "(chip linear: %.1fC at %.0fC)\n",
+                  check.maxError, check.maxErrorAt, check.points,
+                  check.maxChipError, check.maxChipErrorAt);
+
+    const int iterations = 1000;
+    volatile float sink = 0.0;
+    uint32_t start = ESP.getCycleCount();
+    for (int i = 0; i < iterations; i++) {
+        sink = tcLinearize(20.0 + i * 1.3, 25.0);
+    }
+    uint32_t cycles = (ESP.getCycleCount() - start) / iterations;
+    (void)sink;
+    Serial.printf("[TC] Linearization: %lu cycles/sample (%.2f us), offset %+.2fC%s\n",
+                  (unsigned long)cycles, (float)cycles / ESP.getCpuFreqMHz(), tcLinearizeOffset(),
+                  ENABLE_TC_LINEARIZATION ? "" : " (table disabled, offset only)");
+}
+
+// ============================================================================
+// CONTROL QUALITY
+// ============================================================================
+
+/**
+ * Publish a completed step response to the log and the firing log
+ * Two log lines: one record holds LOG_PAYLOAD_BYTES of arguments, five doubles.
+ */
+void publishStepResult(const StepResult& r) {
+    LOG_INFO("[STEP] %.0f->%.0fC rise=%.0fs overshoot=%.1fC settle=%.0fs\n",
+             r.fromTemp, r.toTemp, r.riseTimeSec, r.overshoot, r.settlingTimeSec);
+    LOG_INFO("[STEP] sse=%.2fC iae=%.0f %s\n",
+             r.steadyStateError, r.iae, r.settled ? "settled" : "unsettled");
+    firingLogPrintf("STEP %.0f %.0f rise=%.0f os=%.1f settle=%.0f sse=%.2f iae=%.0f %s",
+                    r.fromTemp, r.toTemp, r.riseTimeSec, r.overshoot, r.settlingTimeSec,
+                    r.steadyStateError, r.iae, r.settled ? "settled" : "unsettled");
+}
+
+/**
+ * Report shadow-vs-live divergence and per-controller compute cost
+ */
+void reportShadow() {
+#if ENABLE_SHADOW_CONTROLLER
+    const DivergenceStats& d = shadowPID.divergence();
+    const ComputeCost& sc = shadowPID.cost();
+    float budgetUs = PID_SAMPLE_TIME * 1000.0;
+
+    Serial.printf("[SHADOW] live=%.1f%% shadow=%.1f%% | diff mean=%.2f sd=%.2f max=%.2f n=%lu\n",
+                  pidOutput, shadowPID.output(), d.mean, d.stddev(), d.maxAbs,
+                  (unsigned long)d.count);
+    Serial.printf("[SHADOW] cost live=%.0f/%luus shadow=%.0f/%luus (mean/max, %.3f%% of period)\n",
+                  livePidCost.meanUs, (unsigned long)livePidCost.maxUs,
+                  sc.meanUs, (unsigned long)sc.maxUs,
+                  100.0 * (livePidCost.maxUs + sc.maxUs) / budgetUs);
+    firingLogPrintf("SHADOW out=%.1f live=%.1f mean=%.2f sd=%.2f max=%.2f n=%lu us=%lu/%lu",
+                    shadowPID.output(), pidOutput, d.mean, d.stddev(), d.maxAbs,
+                    (unsigned long)d.count, (unsigned long)livePidCost.maxUs,
+                    (unsigned long)sc.maxUs);
+#endif
+}
+
+/**
+ * Report thermocouple noise per SSR state and how often reads were moved
+ */
+void reportTcNoise() {
+    for (int z = 0; z < KILN_ZONE_COUNT; z++) {
+        const TcSampler& s = zones[z].sampler;
+        Serial.printf("[TC] zone %d noise sd", z);
+        for (int i = 0; i < TC_SAMPLE_CLASSES; i++) {
+            Serial.printf(" %s=%.3fC(n=%lu)", tcSampleClassName((TcSampleClass)i),
+                          s.noise[i].stddev(), (unsigned long)s.noise[i].count);
+        }
+        Serial.printf(" | reads=%lu deferred=%lu avg=%.0fms forced=%lu errors=%lu\n",
+                      (unsigned long)s.reads, (unsigned long)s.deferred,
+                      s.deferred ? (float)s.totalDeferMs / s.deferred : 0.0f,
+                      (unsigned long)s.forced, (unsigned long)zones[z].errors);
+        firingLogPrintf("TCNOISE z=%d off=%.3f on=%.3f edge=%.3f deferred=%lu forced=%lu",
+                        z, s.noise[TC_SAMPLE_SSR_OFF].stddev(), s.noise[TC_SAMPLE_SSR_ON].stddev(),
+                        s.noise[TC_SAMPLE_EDGE].stddev(), (unsigned long)s.deferred,
+                        (unsigned long)s.forced);
+    }
+}
+
 // ============================================================================
 // SSR CONTROL FUNCTIONS
 // ============================================================================
 
 /**
- * PID-based time-proportional SSR control
- * Uses a time window to simulate analog output with digital SSR
+ * SSR states, bit per zone
  */
-void updateSSRControl() {
-    // SAFETY: Don't heat if sensor error
-    if (state.sensorError) {
-        digitalWrite(SSR_PIN, LOW);
-        state.heating = false;
-        kilnPID.SetMode(MANUAL);
-        pidOutput = 0;
-        return;
+static uint8_t ssrMask() {
+    uint8_t mask = 0;
+    for (int z = 0; z < KILN_ZONE_COUNT; z++) {
+        mask |= zones[z].heating ? (uint8_t)(1 << z) : 0;
     }
+    return mask;
+}
 
-    // SAFETY: Don't heat if target exceeds hard limit
-    if (state.targetTemp > MAX_TEMP_LIMIT) {
-        digitalWrite(SSR_PIN, LOW);
-        state.heating = false;
-        kilnPID.SetMode(MANUAL);
-        pidOutput = 0;
-        DEBUG_PRINTLN("[SAFETY] Target exceeds MAX_TEMP_LIMIT - heating disabled");
-        return;
+/**
+ * Any SSR transition (control, safety or fault cut-off) is an edge for that zone's sampler
+ * (and goes in the flight recorder)
+ */
+void noteSsrEdges() {
+    unsigned long now = millis();
+    bool edge = false;
+    for (int z = 0; z < KILN_ZONE_COUNT; z++) {
+        if (zones[z].heating != zones[z].lastHeating) {
+            tcSamplerNoteEdge(zones[z].sampler, zones[z].heating, now);
+            zones[z].lastHeating = zones[z].heating;
+            edge = true;
+        }
+    }
+    if (edge) {
+        flightRecordSsr(ssrMask(), state.currentTemp);
     }
+}
 
-    // SAFETY: Don't heat if current temperature exceeds hard limit
-    if (state.currentTemp >= MAX_TEMP_LIMIT) {
-        digitalWrite(SSR_PIN, LOW);
-        state.heating = false;
-        kilnPID.SetMode(MANUAL);
-        pidOutput = 0;
-        DEBUG_PRINTLN("[SAFETY] Current temp at/above MAX_TEMP_LIMIT - heating disabled");
+/**
+ * Switch every zone's SSR off and drop its PID to MANUAL
+ */
+void allZonesOff() {
+    for (int z = 0; z < KILN_ZONE_COUNT; z++) {
+        digitalWrite(zoneSsrPins[z], LOW);
+        zones[z].heating = false;
+        zones[z].onTime = 0;
+        zones[z].controller.stop();
+    }
+    state.heating = false;
+    pidOutput = 0;
+    noteSsrEdges();
+}
+
+/**
+ * PID-based time-proportional SSR control
+ * Uses a time window to simulate analog output with digital SSR. Every zone
+ * shares the window; each gets its own on-time from its own PID.
+ */
+void updateSSRControl() {
+    livePidComputed = false;
+    for (int z = 0; z < KILN_ZONE_COUNT; z++) {
+        // Until proven otherwise
+        tcSamplerSetSchedule(zones[z].sampler, ssrWindowStartTime, settings.ssrCycleMs, 0);
+    }
+
+    // SAFETY: sensor error (any zone), latched stuck SSR, idle (E-stop), target or
+    // hottest zone above the limit (max_temp, never above MAX_TEMP_LIMIT)
+    ZoneHeatGate gate = zoneHeatGate(state.mode == MODE_IDLE, state.sensorError,
+                                     faultObserver.active == FAULT_STUCK_SSR, state.targetTemp,
+                                     state.hottestTemp, settingsTempLimit(settings));
+    if (gate != ZONE_HEAT_OK) {
+        allZonesOff();
+        if (gate == ZONE_HEAT_TARGET_LIMIT) {
+            DEBUG_PRINTLN("[SAFETY] Target exceeds max_temp - heating disabled");
+        } else if (gate == ZONE_HEAT_TEMP_LIMIT) {
+            DEBUG_PRINTLN("[SAFETY] Current temp at/above max_temp - heating disabled");
+        }
         return;
     }
 
-    // Update PID input and setpoint
+    // Kiln-level PID view
     pidInput = state.currentTemp;
     pidSetpoint = state.targetTemp;
 
-    // Enable PID if not already enabled
-    if (kilnPID.GetMode() != AUTOMATIC) {
-        kilnPID.SetMode(AUTOMATIC);
+    // Start a fresh SSR window when the zone loops come out of MANUAL
+    if (!zones[0].controller.running()) {
         ssrWindowStartTime = millis();
         DEBUG_PRINTLN("[PID] PID controller enabled");
     }
 
-    // Compute PID output
-    kilnPID.Compute();
+    // Compute all zone PIDs (timed so the shadow's cost can be compared against it)
+    int64_t computeStart = esp_timer_get_time();
+    {
+        PROFILE_ZONE("pid");
+        livePidComputed = zonesControlTick(zones, KILN_ZONE_COUNT, state.targetTemp);
+    }
+    if (livePidComputed) {
+        livePidCost.record((uint32_t)(esp_timer_get_time() - computeStart));
+#if ENABLE_PROFILER
+        profilerPeriodMark(pidPeriod, (uint64_t)computeStart);
+#endif
+    }
 
     // Time-proportional SSR control
-    // pidOutput is 0-100, representing percentage of time SSR should be ON
+    // Zone outputs are 0-100, representing percentage of time its SSR should be ON
     unsigned long now = millis();
 
     // Check if we need to start a new SSR window
-    if (now - ssrWindowStartTime >= ssrWindowSize) {
+    if (now - ssrWindowStartTime >= settings.ssrCycleMs) {
         ssrWindowStartTime = now;
     }
 
-    // Calculate SSR on-time for this window
-    unsigned long onTime = (ssrWindowSize * pidOutput) / 100;
-
-    // Determine if SSR should be on or off in current window
-    if ((now - ssrWindowStartTime) < onTime) {
-        digitalWrite(SSR_PIN, HIGH);
-        state.heating = true;
-    } else {
-        digitalWrite(SSR_PIN, LOW);
-        state.heating = false;
+    // Calculate each zone's on-time and whether its SSR is on in the current window
+    double outputSum = 0.0;
+    state.heating = false;
+    for (int z = 0; z < KILN_ZONE_COUNT; z++) {
+        KilnZone& zone = zones[z];
+        outputSum += zone.controller.output();
+        zone.onTime = (settings.ssrCycleMs * zone.controller.output()) / 100;
+        tcSamplerSetSchedule(zone.sampler, ssrWindowStartTime, settings.ssrCycleMs, zone.onTime);
+
+        zone.heating = (now - ssrWindowStartTime) < zone.onTime;
+        digitalWrite(zoneSsrPins[z], zone.heating ? HIGH : LOW);
+        state.heating = state.heating || zone.heating;
     }
+    pidOutput = outputSum / KILN_ZONE_COUNT;
 }
 
 // ============================================================================
@@ -247,6 +558,31 @@ void updateSSRControl() {
 
 void displayTestMenu();
 void initTestState();
+void runIceCalibration();
+
+// ============================================================================
+// COMMANDS
+// ============================================================================
+
+/**
+ * Post an input command from the main loop
+ * Also runs the control job on the next pass, so the command is applied
+ * without waiting for the next SSR edge.
+ */
+bool postCommand(CommandType type, float value = 0.0f, int16_t arg = 0,
+                 CommandSource source = CMD_SOURCE_ENCODER) {
+    Command cmd = {};
+    cmd.type = type;
+    cmd.source = source;
+    cmd.arg = arg;
+    cmd.value[0] = value;
+    bool posted = commandPost(commandQueue, cmd, micros());
+    if (!posted) {
+        DEBUG_PRINTF("[CMD] %s dropped, queue full\n", commandName(type));
+    }
+    schedulerRunIn(scheduler, jobSsrId, 0);
+    return posted;
+}
 
 // ============================================================================
 // MAIN MENU SYSTEM
@@ -255,7 +591,7 @@ void initTestState();
 enum MainMenuItem {
     MAIN_MENU_MANUAL,
     MAIN_MENU_PROFILES,
-    MAIN_MENU_SETTINGS,
+    MAIN_MENU_CALIBRATION,
     MAIN_MENU_HARDWARE_TEST,
     MAIN_MENU_ABOUT
 };
@@ -269,7 +605,7 @@ MainMenuState mainMenu = {0};
 const char* mainMenuItems[] = {
     "Manual Control",
     "Firing Profiles",
-    "Settings",
+    "Ice Calibration",
     "Hardware Test",
     "About"
 };
@@ -280,6 +616,7 @@ const int numMainMenuItems = 5;
  * Landscape mode: 320x240
  */
 void displayMainMenu() {
+    uint32_t frameStart = micros();
     tft.fillScreen(TFT_BLACK);
 
     // Header
@@ -307,11 +644,20 @@ void displayMainMenu() {
         tft.print(mainMenuItems[i]);
     }
 
+    // Element health warning
+    if (elementHealthTrend().warning) {
+        tft.setTextSize(1);
+        tft.setTextColor(TFT_ORANGE, TFT_BLACK);
+        tft.setCursor(10, 208);
+        tft.print(elementHealthTrend().message);
+    }
+
     // Instructions
     tft.setTextSize(1);
     tft.setTextColor(TFT_YELLOW, TFT_BLACK);
     tft.setCursor(10, 220);
     tft.print("Turn: Navigate    Press: Select");
+    uiLatencyFrame(uiLatency, UI_SCREEN_MENU, frameStart, micros());
 }
 
 /**
@@ -323,6 +669,7 @@ void handleMainMenuInput() {
 
     // Navigate menu - only on FALLING edge
     if (clk != lastCLK && clk == LOW) {
+        uiLatencyInput(uiLatency, micros());
         int dt = digitalRead(ENCODER_LEFT_DT_PIN);
         if (dt == LOW) {
             // Clockwise - down
@@ -337,6 +684,7 @@ void handleMainMenuInput() {
                 mainMenu.selection = numMainMenuItems - 1;
             }
         }
+        uiLatencyApplied(uiLatency, micros());
         displayMainMenu();
         playTone(1200, 20);
     }
@@ -349,23 +697,23 @@ void handleMainMenuInput() {
 
     if (sw != lastSW && sw == LOW) {
         if (millis() - lastPress > 200) {
+            uint32_t pressUs = micros();
             lastPress = millis();
             playTone(2000, 50);
 
             // Execute selected menu item
             switch (mainMenu.selection) {
                 case MAIN_MENU_MANUAL:
-                    state.mode = MODE_MANUAL;
-                    state.targetTemp = 100.0;
-                    state.heating = false;
+                    uiLatencyInput(uiLatency, pressUs);
+                    postCommand(CMD_START_MANUAL);
                     break;
                 case MAIN_MENU_PROFILES:
-                    // TODO: Implement profiles
-                    playTone(500, 100); // Error beep
+                    uiLatencyInput(uiLatency, pressUs);
+                    postCommand(CMD_ENTER_PROFILES);
                     break;
-                case MAIN_MENU_SETTINGS:
-                    // TODO: Implement settings
-                    playTone(500, 100); // Error beep
+                case MAIN_MENU_CALIBRATION:
+                    runIceCalibration();
+                    displayMainMenu();
                     break;
                 case MAIN_MENU_HARDWARE_TEST:
                     state.mode = MODE_TEST;
@@ -397,6 +745,7 @@ enum TestMenuItem {
     TEST_SSR,
     TEST_THERMOCOUPLE,
     TEST_DISPLAY,
+    TEST_NOISE_SPECTRUM,
     TEST_EXIT
 };
 
@@ -433,9 +782,10 @@ const char* testMenuItems[] = {
     "6. SSR Output",
     "7. Thermocouple",
     "8. TFT Display",
+    "9. TC Noise Spectrum",
     "Exit Test Mode"
 };
-const int numTestMenuItems = 10;
+const int numTestMenuItems = 11;
 
 /**
  * Display the hardware test menu
@@ -864,7 +1214,7 @@ void runThermocoupleTest() {
             lastRead = millis();
             double tempC = thermocouple.readCelsius();
 
-            Serial.printf("[DEBUG] Raw reading: %.1f°C, isnan=%d, valid range: %.1f to %.1f\n",
+            DEBUG_PRINTF("[DEBUG] Raw reading: %.1f°C, isnan=%d, valid range: %.1f to %.1f\n",
                           tempC, isnan(tempC), MIN_VALID_TEMP, MAX_VALID_TEMP);
 
             if (!isnan(tempC) && tempC > MIN_VALID_TEMP && tempC < MAX_VALID_TEMP) {
@@ -886,14 +1236,14 @@ void runThermocoupleTest() {
                 Serial.printf("[ERROR] Bad reading! (NaN or out of range) - Errors: %d\n", errorSamples);
             }
 
-            Serial.println("[DEBUG] About to update TFT display...");
+            DEBUG_PRINTLN("[DEBUG] About to update TFT display...");
 
             // Update display ONLY when we have new temperature data
             // Landscape mode: 320x240
-            Serial.println("[DEBUG] Clearing TFT screen...");
+            DEBUG_PRINTLN("[DEBUG] Clearing TFT screen...");
             tft.fillScreen(TFT_BLACK);
 
-            Serial.println("[DEBUG] Drawing header...");
+            DEBUG_PRINTLN("[DEBUG] Drawing header...");
             tft.setTextSize(2);
             tft.setTextColor(TFT_CYAN, TFT_BLACK);
             tft.setCursor(10, 10);
@@ -901,7 +1251,7 @@ void runThermocoupleTest() {
             tft.drawLine(0, 35, 320, 35, TFT_WHITE);
 
             // Current reading - LARGE (left side)
-            Serial.printf("[DEBUG] Drawing temperature: %.1f°F\n", currentTemp);
+            DEBUG_PRINTF("[DEBUG] Drawing temperature: %.1f°F\n", currentTemp);
             tft.setTextSize(4);
             if (currentTemp == -999) {
                 tft.setTextColor(TFT_RED, TFT_BLACK);
@@ -916,7 +1266,7 @@ void runThermocoupleTest() {
                 tft.setTextSize(2);
                 tft.print(" F");
             }
-            Serial.println("[DEBUG] Temperature drawn.");
+            DEBUG_PRINTLN("[DEBUG] Temperature drawn.");
 
             // Statistics (right side)
             tft.setTextSize(1);
@@ -960,7 +1310,7 @@ void runThermocoupleTest() {
                 tft.print("To exit: 1. Press RIGHT  2. Press LEFT");
             }
 
-            Serial.println("[DEBUG] TFT display update complete!");
+            DEBUG_PRINTLN("[DEBUG] TFT display update complete!");
             Serial.println();
         }  // End of temperature reading and display update block
 
@@ -1006,6 +1356,205 @@ void runThermocoupleTest() {
     waitForButtonPress();
 }
 
+// Noise spectrum bursts: SSR off, then SSR cycling at 50% to expose switching noise
+static float noiseBurst[NOISE_FFT_SIZE];
+static float noiseImag[NOISE_FFT_SIZE];     // FFT benchmark workspace
+static NoiseSpectrum noiseResults[2];
+
+/**
+ * Fill noiseBurst at the MAX31855's fastest useful rate (one full conversion
+ * per read; reading sooner just restarts the conversion)
+ *
+ * With cycleSsr the burst is stopped (SSR off, aborted set) by a faulted
+ * reading, since the temperature can no longer be watched, or by one
+ * NOISE_SSR_MAX_RISE above the starting temperature or over the limit.
+ *
+ * @return false if any reading was a fault
+ */
+bool captureNoiseBurst(bool cycleSsr, bool& aborted) {
+    unsigned long start = millis();
+    unsigned long next = start;
+    bool ok = true;
+    double ceiling = 0.0;
+    aborted = false;
+
+    if (cycleSsr) {
+        double t = thermocouple.readCelsius();
+        ceiling = fmin(t + NOISE_SSR_MAX_RISE, settingsTempLimit(settings));
+        if (isnan(t) || t >= ceiling) {
+            aborted = true;
+            return false;
+        }
+        next += TC_CONVERSION_MS;
+    }
+
+    for (int i = 0; i < NOISE_FFT_SIZE; i++) {
+        while ((long)(millis() - next) < 0) {
+            if (cycleSsr) {
+                bool on = ((millis() - start) % settings.ssrCycleMs) < settings.ssrCycleMs / 2;
+                digitalWrite(SSR_PIN, on ? HIGH : LOW);
+            }
+            delay(1);
+        }
+        next += TC_CONVERSION_MS;
+
+        double t = thermocouple.readCelsius();
+        if (cycleSsr && (isnan(t) || t > ceiling)) {
+            digitalWrite(SSR_PIN, LOW);
+            Serial.printf("[NOISE] Burst aborted at sample %d: %.1f C (limit %.1f C)\n", i, t, ceiling);
+            aborted = true;
+            return false;
+        }
+        if (isnan(t)) {
+            ok = false;
+            t = (i > 0) ? noiseBurst[i - 1] : 0.0;
+        }
+        noiseBurst[i] = t;
+    }
+    digitalWrite(SSR_PIN, LOW);
+    return ok;
+}
+
+/**
+ * Wait for LEFT button (yes) or RIGHT button / timeout (no)
+ */
+bool waitForConfirm(unsigned long timeoutMs) {
+    delay(500);  // Let go of the button that opened the screen
+    unsigned long start = millis();
+    while (millis() - start < timeoutMs) {
+        if (digitalRead(ENCODER_LEFT_SW_PIN) == LOW) {
+            playTone(2000, 50);
+            return true;
+        }
+        if (digitalRead(ENCODER_RIGHT_SW_PIN) == LOW) {
+            break;
+        }
+        delay(10);
+    }
+    playTone(500, 100);
+    return false;
+}
+
+/**
+ * Draw one spectrum as log-scaled bars (1e-6 .. 1 °C² per bin)
+ */
+void drawNoiseSpectrum(const NoiseSpectrum& sp, int y, int height, const char* label) {
+    const int barWidth = 4;
+    const int x0 = 30;
+    tft.setTextSize(1);
+    tft.setTextColor(TFT_WHITE, TFT_BLACK);
+    tft.setCursor(10, y - 10);
+    tft.printf("%s sd=%.3fC  peak %.2fHz", label, sqrtf(sp.variance), sp.peaks[0].freqHz);
+    tft.drawRect(x0 - 1, y - 1, (NOISE_SPECTRUM_BINS - 1) * barWidth + 2, height + 2, TFT_DARKGREY);
+
+    for (int k = 1; k < NOISE_SPECTRUM_BINS; k++) {
+        float db = 10.0f * log10f(fmaxf(sp.power[k], 1e-6f));   // -60 .. 0 dB
+        int h = (int)((db + 60.0f) / 60.0f * height);
+        h = constrain(h, 0, height);
+        bool isPeak = false;
+        for (int p = 0; p < NOISE_SPECTRUM_PEAKS; p++) {
+            isPeak |= (sp.peaks[p].bin == k);
+        }
+        tft.fillRect(x0 + (k - 1) * barWidth, y + height - h, barWidth - 1, h,
+                     isPeak ? TFT_ORANGE : TFT_CYAN);
+    }
+}
+
+void printNoiseSpectrum(const NoiseSpectrum& sp, const char* label) {
+    Serial.printf("[NOISE] %s: mean=%.2fC sd=%.4fC fs=%.1fHz\n", label, sp.mean,
+                  sqrtf(sp.variance), sp.sampleRateHz);
+    for (int p = 0; p < NOISE_SPECTRUM_PEAKS; p++) {
+        Serial.printf("[NOISE]   peak %d: %.3f Hz  %.2e C^2 (%.1f dB)\n", p + 1,
+                      sp.peaks[p].freqHz, sp.peaks[p].power,
+                      10.0f * log10f(fmaxf(sp.peaks[p].power, 1e-12f)));
+    }
+    for (int k = 0; k < NOISE_SPECTRUM_BINS; k++) {
+        Serial.printf("[NOISE]   %3d %6.3f Hz %.3e\n", k, k * sp.sampleRateHz / NOISE_FFT_SIZE,
+                      sp.power[k]);
+    }
+}
+
+/**
+ * Run thermocouple noise spectrum diagnostic
+ * Landscape mode: 320x240
+ */
+void runNoiseSpectrumTest() {
+    Serial.println("\n========================================");
+    Serial.println("[TEST] Starting Thermocouple Noise Spectrum");
+    Serial.println("========================================");
+
+    const float sampleRateHz = 1000.0f / TC_CONVERSION_MS;
+    const char* labels[2] = {"SSR off", "SSR 50%"};
+    bool ok = true;
+    bool aborted = false;
+    uint32_t analyzeCycles = 0;
+
+    for (int b = 0; b < 2; b++) {
+        char msg[160];
+        if (b == 1) {
+            // The second burst switches the elements: only with someone watching
+            snprintf(msg, sizeof(msg), "Burst 2 switches the\nSSR at 50%% for %.0f s.\nStops at +%.0fC.\n\n"
+                     "LEFT: start\nRIGHT: skip",
+                     NOISE_FFT_SIZE / sampleRateHz, (float)NOISE_SSR_MAX_RISE);
+            displayTestRunning("TC Noise Spectrum", msg);
+            if (!waitForConfirm(NOISE_CONFIRM_TIMEOUT_MS)) {
+                Serial.println("[NOISE] SSR burst skipped");
+                aborted = true;
+                break;
+            }
+        }
+        snprintf(msg, sizeof(msg), "Burst %d/2: %s\n\n%d samples at %.0f Hz\n(%.1f seconds)",
+                 b + 1, labels[b], NOISE_FFT_SIZE, sampleRateHz, NOISE_FFT_SIZE / sampleRateHz);
+        displayTestRunning("TC Noise Spectrum", msg);
+
+        bool burstAborted;
+        ok &= captureNoiseBurst(b == 1, burstAborted);
+        if (burstAborted) {
+            aborted = true;
+            break;
+        }
+
+        uint32_t start = ESP.getCycleCount();
+        noiseSpectrumAnalyze(noiseBurst, sampleRateHz, noiseResults[b]);
+        analyzeCycles = ESP.getCycleCount() - start;
+        printNoiseSpectrum(noiseResults[b], labels[b]);
+    }
+
+    // FFT kernel alone, warm cache (burst contents are scratch by now)
+    memset(noiseImag, 0, sizeof(noiseImag));
+    uint32_t start = ESP.getCycleCount();
+    noiseFft(noiseBurst, noiseImag);
+    uint32_t fftCycles = ESP.getCycleCount() - start;
+    Serial.printf("[NOISE] %d-point FFT: %lu cycles (%.0f us), full analysis: %lu cycles\n",
+                  NOISE_FFT_SIZE, (unsigned long)fftCycles,
+                  (float)fftCycles / ESP.getCpuFreqMHz(), (unsigned long)analyzeCycles);
+    Serial.printf("[NOISE] Note: fs=%.0f Hz, mains (50/60 Hz) aliases to DC; SSR window at %.1f Hz\n",
+                  sampleRateHz, 1000.0f / settings.ssrCycleMs);
+
+    tft.fillScreen(TFT_BLACK);
+    tft.setTextSize(2);
+    tft.setTextColor(TFT_CYAN, TFT_BLACK);
+    tft.setCursor(10, 10);
+    tft.println("TC Noise Spectrum");
+    tft.drawLine(0, 35, 320, 35, TFT_WHITE);
+    drawNoiseSpectrum(noiseResults[0], 55, 60, labels[0]);
+    if (!aborted) {
+        drawNoiseSpectrum(noiseResults[1], 145, 60, labels[1]);
+    }
+
+    tft.setTextSize(1);
+    tft.setTextColor(TFT_YELLOW, TFT_BLACK);
+    tft.setCursor(10, 215);
+    tft.printf("0-%.0f Hz, -60..0 dB  FFT %.0f us  Press: Back",
+               sampleRateHz / 2, (float)fftCycles / ESP.getCpuFreqMHz());
+    if (aborted || !ok) {
+        tft.setTextColor(TFT_RED, TFT_BLACK);
+        tft.setCursor(10, 225);
+        tft.print(aborted ? "SSR burst skipped or stopped" : "Thermocouple faults during burst");
+    }
+    waitForButtonPress();
+}
+
 /**
  * Run display test
  * Landscape mode: 320x240
@@ -1080,6 +1629,7 @@ void handleTestModeInput() {
                     runSSRTest();
                     runThermocoupleTest();
                     runDisplayTest();
+                    // Not the noise spectrum: it switches the SSR, so run it on its own
                     displayTestMenu();
                     break;
                 case 1: runLEDTest(); displayTestMenu(); break;
@@ -1090,7 +1640,8 @@ void handleTestModeInput() {
                 case 6: runSSRTest(); displayTestMenu(); break;
                 case 7: runThermocoupleTest(); displayTestMenu(); break;
                 case 8: runDisplayTest(); displayTestMenu(); break;
-                case 9: // Exit
+                case 9: runNoiseSpectrumTest(); displayTestMenu(); break;
+                case 10: // Exit
                     state.mode = MODE_MAIN_MENU;
                     displayMainMenu();
                     break;
@@ -1100,15 +1651,181 @@ void handleTestModeInput() {
     lastSW = sw;
 }
 
+// ============================================================================
+// ICE-POINT CALIBRATION
+// ============================================================================
+
+/**
+ * Returns true once per press of the given encoder button (waits for release)
+ */
+bool buttonPressed(int pin) {
+    if (digitalRead(pin) != LOW) {
+        return false;
+    }
+    while (digitalRead(pin) == LOW) {
+        delay(10);
+    }
+    delay(50);  // Debounce
+    return true;
+}
+
+/**
+ * Draw the live calibration screen
+ * Landscape mode: 320x240
+ */
+void drawIceCalibration(const IceCalibration& cal, float reading, unsigned long elapsedMs) {
+    tft.fillRect(0, 100, 320, 110, TFT_BLACK);
+    tft.setTextSize(2);
+    tft.setTextColor(TFT_WHITE, TFT_BLACK);
+    tft.setCursor(10, 100);
+    tft.printf("Reading: %+.2fC", reading);
+    tft.setCursor(10, 125);
+    tft.printf("Offset:  %+.2fC", cal.offset);
+
+    tft.setTextSize(1);
+    tft.setCursor(10, 155);
+    if (isinf(cal.halfWidth)) {
+        tft.printf("CI: --  (target +/-%.2fC)", ICE_CAL_TOLERANCE);
+    } else {
+        tft.printf("CI: +/-%.3fC  (target +/-%.2fC)", cal.halfWidth, ICE_CAL_TOLERANCE);
+    }
+    tft.setCursor(10, 170);
+    tft.printf("Drift: %+.2fC/min  Samples: %lu", cal.slopePerMin, (unsigned long)cal.samples);
+    tft.setCursor(10, 185);
+    tft.printf("Restarts: %u  Time: %lus", cal.restarts, elapsedMs / 1000);
+}
+
+/**
+ * Streaming ice-point calibration
+ * Samples at the MAX31855 conversion rate until the offset has converged
+ * (see ice_calibration.h), then offers to save it. The saved offset is
+ * folded into the linearization table, so normal readings pay nothing for it.
+ */
+void runIceCalibration() {
+    Serial.println("\n[CAL] Ice-point calibration started");
+    allZonesOff();
+
+    tft.fillScreen(TFT_BLACK);
+    tft.setTextSize(2);
+    tft.setTextColor(TFT_CYAN, TFT_BLACK);
+    tft.setCursor(10, 10);
+    tft.println("Ice Calibration");
+    tft.drawLine(0, 35, 320, 35, TFT_WHITE);
+    tft.setTextSize(1);
+    tft.setTextColor(TFT_WHITE, TFT_BLACK);
+    tft.setCursor(10, 50);
+    tft.println("Probe in stirred ice-water slush (0.0C).");
+    tft.setCursor(10, 65);
+    tft.println("Stops automatically once the offset is known.");
+    tft.setTextColor(TFT_YELLOW, TFT_BLACK);
+    tft.setCursor(10, 220);
+    tft.print("Left press: Cancel");
+
+    IceCalibration cal;
+    unsigned long start = millis();
+    iceCalReset(cal, start);
+    unsigned long nextRead = start;
+    unsigned long lastDraw = 0;
+    float reading = 0.0;
+    IceCalStatus status = ICE_CAL_RUNNING;
+
+    while (status == ICE_CAL_RUNNING) {
+        if (buttonPressed(ENCODER_LEFT_SW_PIN)) {
+            Serial.println("[CAL] Cancelled");
+            playTone(1000, 50);
+            return;
+        }
+        if ((long)(millis() - nextRead) < 0) {
+            delay(1);
+            continue;
+        }
+        nextRead += TC_CONVERSION_MS;
+
+        double raw = thermocouple.readCelsius();
+        if (isnan(raw)) {
+            continue;
+        }
+#if ENABLE_TC_LINEARIZATION
+        // Measure without the currently stored offset
+        reading = tcLinearize(raw, thermocouple.readInternal()) - tcLinearizeOffset();
+#else
+        reading = raw;
+#endif
+        uint16_t restarts = cal.restarts;
+        status = iceCalAddSample(cal, reading, millis());
+        if (cal.restarts != restarts) {
+            Serial.printf("[CAL] Drift %+.2fC/min, restarting statistics\n", cal.slopePerMin);
+        }
+
+        if (millis() - lastDraw >= 500) {
+            lastDraw = millis();
+            drawIceCalibration(cal, reading, millis() - start);
+        }
+    }
+
+    unsigned long elapsed = millis() - start;
+    drawIceCalibration(cal, reading, elapsed);
+    Serial.printf("[CAL] %s after %.1fs: offset %+.3fC +/-%.3fC, drift %+.2fC/min, "
+                  "%lu samples, %u restarts\n",
+                  iceCalStatusName(status), elapsed / 1000.0, cal.offset, cal.halfWidth,
+                  cal.slopePerMin, (unsigned long)cal.samples, cal.restarts);
+
+    tft.fillRect(0, 200, 320, 40, TFT_BLACK);
+    tft.setTextSize(1);
+    if (status != ICE_CAL_CONVERGED) {
+        tft.setTextColor(TFT_RED, TFT_BLACK);
+        tft.setCursor(10, 205);
+        tft.print(status == ICE_CAL_OUT_OF_RANGE ? "Offset too large - check wiring"
+                                                 : "Reading never settled - check ice bath");
+        tft.setTextColor(TFT_YELLOW, TFT_BLACK);
+        tft.setCursor(10, 220);
+        tft.print("Press any button...");
+        playTone(500, 300);
+        waitForButtonPress();
+        return;
+    }
+
+    tft.setTextColor(TFT_GREEN, TFT_BLACK);
+    tft.setCursor(10, 205);
+    tft.printf("Converged. Apply offset %+.2fC?", cal.offset);
+    tft.setTextColor(TFT_YELLOW, TFT_BLACK);
+    tft.setCursor(10, 220);
+    tft.print("Right press: Save    Left press: Discard");
+    playTone(2000, 200);
+
+    while (true) {
+        if (buttonPressed(ENCODER_RIGHT_SW_PIN)) {
+            KilnSettings next = settings;
+            next.tcOffset = cal.offset;
+            if (!settingsCommit(next)) {
+                Serial.println("[CAL] Saving the offset FAILED");
+                playTone(500, 300);
+                return;
+            }
+            tcLinearizeSetOffset(cal.offset);
+            Serial.printf("[CAL] Saved offset %+.3fC\n", cal.offset);
+            playTone(2500, 100);
+            return;
+        }
+        if (buttonPressed(ENCODER_LEFT_SW_PIN)) {
+            Serial.println("[CAL] Offset discarded");
+            playTone(1000, 50);
+            return;
+        }
+        delay(10);
+    }
+}
+
 // ============================================================================
 // DISPLAY FUNCTIONS
 // ============================================================================
 
 /**
- * Update TFT display with current system state
+ * Update TFT display with one control tick
  * Landscape mode: 320x240
  */
-void updateDisplay() {
+void updateDisplay(const ControlSample& sample) {
+    PROFILE_ZONE("display");
     // Clear screen
     tft.fillScreen(TFT_BLACK);
 
@@ -1116,10 +1833,14 @@ void updateDisplay() {
     tft.setTextSize(2);
     tft.setCursor(10, 10);
     tft.setTextColor(TFT_GREEN, TFT_BLACK);
-    tft.print("MANUAL CONTROL");
+    if (sample.mode == MODE_PROFILE) {
+        tft.print(builtinProfiles[selectedProfile].name);
+    } else {
+        tft.print("MANUAL CONTROL");
+    }
 
     // Heating indicator
-    if (state.heating) {
+    if (sample.heating) {
         tft.setTextColor(TFT_RED, TFT_BLACK);
         tft.setCursor(230, 10);
         tft.print("HEAT");
@@ -1127,10 +1848,32 @@ void updateDisplay() {
 
     tft.drawLine(0, 35, 320, 35, TFT_WHITE);
 
-    // Current Temperature (large)
-    tft.setTextSize(6);
-    char tempStr[20];
-    if (state.sensorError) {
+    // Latched fault from the model-residual observer
+    if (faultObserver.active != FAULT_NONE) {
+        tft.setTextSize(1);
+        tft.setTextColor(TFT_RED, TFT_BLACK);
+        tft.setCursor(10, 42);
+        tft.printf("FAULT: %s", faultClassName(faultObserver.active));
+        if (profileIsPaused()) {
+            tft.print("  - R Press to resume");
+        }
+    } else {
+        // Redundant thermocouples that have disagreed too long
+        for (int z = 0; z < KILN_ZONE_COUNT; z++) {
+            if (zones[z].vote.driftWarning) {
+                tft.setTextSize(1);
+                tft.setTextColor(TFT_ORANGE, TFT_BLACK);
+                tft.setCursor(10, 42);
+                tft.printf("TC DISAGREE zone %d (%+.1fC)", z, zones[z].vote.diff);
+                break;
+            }
+        }
+    }
+
+    // Current Temperature (large)
+    tft.setTextSize(6);
+    char tempStr[20];
+    if (sample.sensorError) {
         tft.setTextColor(TFT_RED, TFT_BLACK);
         tft.setCursor(20, 70);
         tft.setTextSize(3);
@@ -1138,163 +1881,1664 @@ void updateDisplay() {
     } else {
         tft.setTextColor(TFT_WHITE, TFT_BLACK);
         tft.setCursor(20, 70);
-        snprintf(tempStr, sizeof(tempStr), "%.1f", state.currentTemp);
+        snprintf(tempStr, sizeof(tempStr), "%.1f", sample.temp);
         tft.print(tempStr);
 
-        // Degree symbol and C
-        tft.setTextSize(3);
-        tft.drawCircle(280, 80, 8, TFT_WHITE);
-        tft.setCursor(275, 100);
-        tft.print("C");
+        // Degree symbol and C
+        tft.setTextSize(3);
+        tft.drawCircle(280, 80, 8, TFT_WHITE);
+        tft.setCursor(275, 100);
+        tft.print("C");
+    }
+
+    // Profile progress and estimated ware temperature
+    if (sample.mode == MODE_PROFILE) {
+        tft.setTextSize(1);
+        tft.setTextColor(TFT_CYAN, TFT_BLACK);
+        tft.setCursor(10, 132);
+        if (profileIsRunning()) {
+            float coneFraction;
+            int cone = heatWorkEquivalentCone(&coneFraction);
+            tft.printf("Seg %d/%d %s  Ware: %.1f C  Cone: %s+%d%%",
+                       profileRunner.segment + 1, profileRunner.profile->numSegments,
+                       profileStateName(profileRunner.state), sample.wareTemp,
+                       cone >= 0 ? ortonCones[cone].name : "-", (int)(coneFraction * 100));
+
+            tft.setCursor(10, 141);
+            if (predictionValid && firingPrediction.stalled) {
+                tft.setTextColor(TFT_ORANGE, TFT_BLACK);
+                tft.printf("STALLING: max reachable ~%.0f C", firingPrediction.maxReachable);
+            } else if (predictionValid) {
+                int eta = (int)(firingPrediction.etaSec / 60);
+                int band = (int)((firingPrediction.etaHighSec - firingPrediction.etaLowSec) / 120);
+                tft.printf("ETA %d:%02d (+/-%d min)  %.1f kWh", eta / 60, eta % 60, band,
+                           firingPrediction.kwh);
+            }
+        } else {
+            tft.printf("%s  (%d/%d)", profileStateName(profileRunner.state),
+                       selectedProfile + 1, numBuiltinProfiles);
+        }
+    }
+
+    // Target Temperature
+    tft.drawLine(0, 150, 320, 150, TFT_DARKGREY);
+    tft.setTextSize(2);
+    tft.setTextColor(TFT_CYAN, TFT_BLACK);
+    tft.setCursor(10, 165);
+    tft.print("Target: ");
+    snprintf(tempStr, sizeof(tempStr), "%.0f", sample.target);
+    tft.setTextColor(TFT_WHITE, TFT_BLACK);
+    tft.print(tempStr);
+    tft.drawCircle(210, 172, 5, TFT_WHITE);
+    tft.print("C");
+
+    // PID Output
+    tft.setTextSize(1);
+    tft.setTextColor(TFT_YELLOW, TFT_BLACK);
+    tft.setCursor(10, 190);
+    tft.printf("PID Output: %.1f%%", sample.output);
+
+    if (elementHealthTrend().warning) {
+        tft.setTextColor(TFT_ORANGE, TFT_BLACK);
+        tft.setCursor(130, 190);
+        tft.print(elementHealthTrend().message);
+    }
+
+    // Instructions
+    tft.drawLine(0, 200, 320, 200, TFT_DARKGREY);
+    tft.setTextSize(1);
+    tft.setTextColor(TFT_GREENYELLOW, TFT_BLACK);
+    tft.setCursor(10, 210);
+    if (sample.mode == MODE_PROFILE) {
+        tft.print("L Press: Menu  R Turn: Select  R Press: Start/Stop");
+    } else {
+        tft.print("L Press: Menu    R Turn: Setpoint");
+    }
+    tft.setCursor(10, 225);
+    tft.setTextColor(TFT_ORANGE, TFT_BLACK);
+    tft.print("Both Hold: Emergency Stop");
+}
+
+// ============================================================================
+// UI LATENCY
+// ============================================================================
+
+// Position in a report printed a line at a time (see statsReportLine)
+struct ReportCursor {
+    uint8_t section;
+    uint16_t item;
+    uint16_t count;             // Entries listed, for a report ending in a total
+};
+
+/**
+ * Input-to-photon latency per screen, split into its stages
+ * One line per call, item counting from 0.
+ *
+ * @return False once the report is complete (nothing printed)
+ */
+bool uiReportLine(uint16_t& item) {
+    for (; item < UI_SCREEN_COUNT; item++) {
+        const UiScreenLatency& s = uiLatency.screens[item];
+        if (s.count == 0) {
+            continue;
+        }
+        Serial.printf("[UI] %-8s events=%lu frames=%lu p50<=%.1fms p99<=%.1fms max=%.1fms | "
+                      "mean input->state %.1fms, state->frame %.1fms, draw %.1fms\n",
+                      uiScreenName((UiScreen)item), (unsigned long)s.count, (unsigned long)s.frames,
+                      uiLatencyPercentile(s, 50.0f) / 1000.0f,
+                      uiLatencyPercentile(s, 99.0f) / 1000.0f, s.maxUs / 1000.0f,
+                      s.applyUs / 1000.0f / s.count, s.waitUs / 1000.0f / s.count,
+                      s.drawUs / 1000.0f / s.count);
+        item++;
+        return true;
+    }
+    if (item++ == UI_SCREEN_COUNT && (uiLatency.dropped || uiLatency.expired)) {
+        Serial.printf("[UI] dropped=%lu expired=%lu\n", (unsigned long)uiLatency.dropped,
+                      (unsigned long)uiLatency.expired);
+        return true;
+    }
+    return false;
+}
+
+// ============================================================================
+// MEMORY MONITOR
+// ============================================================================
+
+/**
+ * Heap, fragmentation, task stack high-water marks and post-init allocations
+ * One line per call, item counting from 0.
+ *
+ * @return False once the report is complete (nothing printed)
+ */
+bool memReportLine(uint16_t& item) {
+    const int tasks = memMonitor.taskCount;
+    const int line = item++;
+    if (line == 0) {
+        const MemHeapStats& h = memMonitor.heap;
+        Serial.printf("[MEM] heap free=%lu largest=%lu minEver=%lu frag=%u%% (worst %u%%, "
+                      "smallest largest=%lu)\n", (unsigned long)h.freeBytes,
+                      (unsigned long)h.largestBlock, (unsigned long)h.minEverFree,
+                      h.fragmentationPct, h.worstFragmentationPct, (unsigned long)h.lowestLargest);
+        return true;
+    }
+    if (line <= tasks) {
+        Serial.printf("[MEM] stack %-12s min free=%lu bytes\n", memMonitor.tasks[line - 1].name,
+                      (unsigned long)memMonitor.tasks[line - 1].minFreeBytes);
+        return true;
+    }
+    if (line == tasks + 1) {
+        Serial.printf("[MEM] after setup: allocs=%lu bytes=%lu frees=%lu untracked=%lu\n",
+                      (unsigned long)memMonitor.allocs.load(),
+                      (unsigned long)memMonitor.allocBytes.load(),
+                      (unsigned long)memMonitor.frees.load(),
+                      (unsigned long)memMonitor.untracked.load());
+        return true;
+    }
+
+    MemAllocSite sites[MEM_MONITOR_SITES];
+    int n = memMonitorCopySites(memMonitor, sites, MEM_MONITOR_SITES);
+    int site = line - tasks - 2;
+    if (site < n) {
+        Serial.printf("[MEM] site pc=0x%08lx tag=%-10s count=%lu bytes=%lu largest=%lu\n",
+                      (unsigned long)sites[site].pc, sites[site].tag ? sites[site].tag : "-",
+                      (unsigned long)sites[site].count, (unsigned long)sites[site].bytes,
+                      (unsigned long)sites[site].largest);
+        return true;
+    }
+    return false;
+}
+
+// ============================================================================
+// PROFILER
+// ============================================================================
+
+#if ENABLE_PROFILER
+/**
+ * Per-zone timing percentiles and control-period jitter
+ * One line per call, item counting from 0.
+ *
+ * @return False once the report is complete (nothing printed)
+ */
+bool profReportLine(uint16_t& item) {
+    const int line = item++;
+    if (line == 0) {
+        Serial.println("[PROF] zone          count     p50us     p99us     maxus   total ms");
+        return true;
+    }
+    if (line <= profiler.zoneCount) {
+        const ProfZoneStats& z = profiler.zones[line - 1];
+        Serial.printf("[PROF] %-10s %8lu %9.1f %9.1f %9.1f %10.1f\n", z.name,
+                      (unsigned long)z.count, profilerZonePercentileUs(z, 50.0f),
+                      profilerZonePercentileUs(z, 99.0f),
+                      (float)z.maxCycles / profiler.cyclesPerUs,
+                      (double)z.totalCycles / profiler.cyclesPerUs / 1000.0);
+        return true;
+    }
+    const int period = line - profiler.zoneCount - 1;
+    if (period < profiler.periodCount) {
+        const ProfPeriodStats& p = profiler.periods[period];
+        Serial.printf("[PROF] period %-9s n=%lu mean=%.2fms (nominal %.0fms) jitter p50<=%luus "
+                      "p99<=%luus max=%luus\n", p.name, (unsigned long)p.count,
+                      p.count ? p.totalUs / 1000.0 / p.count : 0.0, p.nominalUs / 1000.0,
+                      (unsigned long)profilerPeriodPercentileUs(p, 50.0f),
+                      (unsigned long)profilerPeriodPercentileUs(p, 99.0f),
+                      (unsigned long)p.maxJitterUs);
+        return true;
+    }
+    return false;
+}
+#endif
+
+// ============================================================================
+// SERIAL SHELL
+// ============================================================================
+
+// Reports that print more than the reply ring holds; a shell command queues
+// them for the "report" job, which prints them under their usual tags. The
+// job prints one report at a time, in bit order, and only as many lines as
+// the TX buffer has room for; it comes back for the rest.
+enum ShellReport {
+    SHELL_REPORT_STATS   = 1 << 0,    // Scheduler, bus, commands, UI, memory, log ring
+    SHELL_REPORT_PROFILE = 1 << 1,
+    SHELL_REPORT_TRACE   = 1 << 2,
+    SHELL_REPORT_UI      = 1 << 3,
+    SHELL_REPORT_MEMORY  = 1 << 4,
+    SHELL_REPORT_LOGS    = 1 << 5,    // Reads /logs, so kept off the input job too
+    SHELL_REPORT_FLIGHT  = 1 << 6,    // Hex dump of a flight recorder archive
+    SHELL_REPORT_CONFIG  = 1 << 7     // Write staged settings (a flash write takes milliseconds)
+};
+
+Shell shell;
+uint8_t pendingReports = 0;
+int flightDumpIndex = -1;       // Archive the next SHELL_REPORT_FLIGHT dumps
+bool flightDumping = false;     // Dump in progress, a few lines per report job run
+uint8_t activeReport = 0;       // Report being printed (a ShellReport bit), 0 if none
+ReportCursor reportCursor;      // Its position
+#if ENABLE_PROFILER
+ProfTraceCursor traceCursor;    // Position in a "prof trace" dump
+#endif
+KilnSettings configDraft;       // Values staged by "config set"
+uint16_t configStaged = 0;      // Staged fields, bit per settingSpecs entry
+
+static void queueReport(Shell& sh, uint8_t report, const char* what) {
+    pendingReports |= report;
+    schedulerRunIn(scheduler, jobReportId, 0);
+    shellPrintf(sh, "ok %s queued", what);
+}
+
+static const char* modeName(uint8_t mode) {
+    switch (mode) {
+        case MODE_MAIN_MENU: return "MENU";
+        case MODE_MANUAL:    return "MANUAL";
+        case MODE_PROFILE:   return "PROFILE";
+        case MODE_TEST:      return "TEST";
+        case MODE_IDLE:      return "IDLE";
+        default:             return "?";
+    }
+}
+
+/**
+ * Latest control sample (kept between calls; the bus only hands out new ones)
+ */
+static const ControlSample& shellSample() {
+    static ControlSample sample = {};
+    sampleBusLatest(sampleBus, shellCursor, sample);
+    return sample;
+}
+
+static bool shellPost(Shell& sh, CommandType type, float value = 0.0f, int16_t arg = 0) {
+    if (!postCommand(type, value, arg, CMD_SOURCE_SERIAL)) {
+        shellPrintf(sh, "err %s dropped, queue full", commandName(type));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Mode changes are the menu's job while the hardware test or calibration runs
+ */
+static bool shellModeFree(Shell& sh) {
+    if (state.mode == MODE_TEST) {
+        shellPrintf(sh, "err hardware test running");
+        return false;
+    }
+    return true;
+}
+
+static void cmdHelp(Shell& sh, int argc, char** argv) {
+    shellHelp(sh);
+}
+
+static void cmdGet(Shell& sh, int argc, char** argv) {
+    const ControlSample& s = shellSample();
+    const char* what = argc > 1 ? argv[1] : "status";
+    if (strcmp(what, "temp") == 0) {
+        shellPrintf(sh, "ok temp %.1f", s.temp);
+    } else if (strcmp(what, "target") == 0) {
+        shellPrintf(sh, "ok target %.1f", s.target);
+    } else if (strcmp(what, "mode") == 0) {
+        shellPrintf(sh, "ok mode %s", modeName(state.mode));
+    } else if (strcmp(what, "status") == 0) {
+        shellPrintf(sh, "ok t=%lu mode=%s temp=%.1f hottest=%.1f target=%.1f out=%.1f heat=%d "
+                    "fault=%s profile=%s seg=%u", (unsigned long)s.timeMs, modeName(state.mode),
+                    s.temp, s.hottest, s.target, s.output, s.heating ? 1 : 0,
+                    faultClassName((FaultClass)s.fault),
+                    profileStateName((ProfileState)s.profileState), s.profileSegment);
+    } else {
+        shellPrintf(sh, "err get temp|target|mode|status");
+    }
+}
+
+static void cmdSet(Shell& sh, int argc, char** argv) {
+    if (argc != 3 || strcmp(argv[1], "target") != 0) {
+        shellPrintf(sh, "err set target <C>");
+        return;
+    }
+    char* end;
+    float target = strtof(argv[2], &end);
+    if (*end != '\0' || !(target >= 0.0f && target <= settingsTempLimit(settings))) {
+        shellPrintf(sh, "err target must be 0..%d C", (int)settingsTempLimit(settings));
+        return;
+    }
+    if (state.mode != MODE_MANUAL) {
+        shellPrintf(sh, "err set target needs manual mode");
+        return;
+    }
+    if (shellPost(sh, CMD_SET_TARGET, target)) {
+        shellPrintf(sh, "ok target %.1f", target);
+    }
+}
+
+static void cmdManual(Shell& sh, int argc, char** argv) {
+    if (shellModeFree(sh) && shellPost(sh, CMD_START_MANUAL)) {
+        shellPrintf(sh, "ok manual");
+    }
+}
+
+static void cmdMenu(Shell& sh, int argc, char** argv) {
+    if (shellModeFree(sh) && shellPost(sh, CMD_EXIT_TO_MENU)) {
+        shellPrintf(sh, "ok menu");
+    }
+}
+
+static void cmdEstop(Shell& sh, int argc, char** argv) {
+    if (shellPost(sh, CMD_ESTOP)) {
+        shellPrintf(sh, "ok estop");
+    }
+}
+
+static void cmdProfile(Shell& sh, int argc, char** argv) {
+    const char* what = argc > 1 ? argv[1] : "";
+    if (strcmp(what, "list") == 0) {
+        for (int i = 0; i < numBuiltinProfiles; i++) {
+            shellPrintf(sh, "ok profile %d %s (%u segments)", i, builtinProfiles[i].name,
+                        builtinProfiles[i].numSegments);
+        }
+    } else if (strcmp(what, "start") == 0 && argc == 3) {
+        char* end;
+        long index = strtol(argv[2], &end, 10);
+        if (*end != '\0' || index < 0 || index >= numBuiltinProfiles) {
+            shellPrintf(sh, "err profile index must be 0..%d", numBuiltinProfiles - 1);
+            return;
+        }
+        if (profileIsRunning() || profileIsPaused()) {
+            shellPrintf(sh, "err profile already running (profile stop first)");
+            return;
+        }
+        if (!shellModeFree(sh)) {
+            return;
+        }
+        // Same lane, so the mode change is applied before the start
+        if (state.mode != MODE_PROFILE && !shellPost(sh, CMD_ENTER_PROFILES)) {
+            return;
+        }
+        if (shellPost(sh, CMD_PROFILE_START, 0.0f, (int16_t)index)) {
+            selectedProfile = (int)index;
+            shellPrintf(sh, "ok profile start %ld %s", index, builtinProfiles[index].name);
+        }
+    } else if (strcmp(what, "stop") == 0) {
+        if (shellPost(sh, CMD_PROFILE_STOP)) {
+            shellPrintf(sh, "ok profile stop");
+        }
+    } else if (strcmp(what, "resume") == 0) {
+        if (shellPost(sh, CMD_PROFILE_RESUME)) {
+            shellPrintf(sh, "ok profile resume");
+        }
+    } else {
+        shellPrintf(sh, "err profile list|start <n>|stop|resume");
+    }
+}
+
+static void cmdStats(Shell& sh, int argc, char** argv) {
+    queueReport(sh, SHELL_REPORT_STATS, "stats");
+}
+
+#if ENABLE_PROFILER
+static void cmdTrace(Shell& sh, int argc, char** argv) {
+    queueReport(sh, SHELL_REPORT_TRACE, "prof trace");
+}
+
+static void cmdProfReset(Shell& sh, int argc, char** argv) {
+    profilerReset();
+    shellPrintf(sh, "ok prof reset");
+}
+
+static void cmdProf(Shell& sh, int argc, char** argv) {
+    const char* what = argc > 1 ? argv[1] : "";
+    if (what[0] == '\0' || strcmp(argv[0], "p") == 0) {
+        queueReport(sh, SHELL_REPORT_PROFILE, "prof");
+    } else if (strcmp(what, "trace") == 0) {
+        queueReport(sh, SHELL_REPORT_TRACE, "prof trace");
+    } else if (strcmp(what, "reset") == 0) {
+        cmdProfReset(sh, argc, argv);
+    } else {
+        shellPrintf(sh, "err prof [trace|reset]");
+    }
+}
+#endif
+
+static void cmdUi(Shell& sh, int argc, char** argv) {
+    queueReport(sh, SHELL_REPORT_UI, "ui");
+}
+
+static void cmdMem(Shell& sh, int argc, char** argv) {
+    queueReport(sh, SHELL_REPORT_MEMORY, "mem");
+}
+
+static void cmdLogs(Shell& sh, int argc, char** argv) {
+    queueReport(sh, SHELL_REPORT_LOGS, "logs");
+}
+
+static void cmdFlight(Shell& sh, int argc, char** argv) {
+    int index = flightLastArchive();
+    if (argc > 1) {
+        char* end;
+        index = (int)strtol(argv[1], &end, 10);
+        if (*end != '\0') {
+            shellPrintf(sh, "err flight [archive]");
+            return;
+        }
+    }
+    if (index < 0) {
+        shellPrintf(sh, "err no flight recorder archives");
+        return;
+    }
+    flightDumpIndex = index;
+    queueReport(sh, SHELL_REPORT_FLIGHT, "flight");
+}
+
+static void printSetting(Shell& sh, const SettingSpec& spec) {
+    int i = (int)(&spec - settingSpecs);
+    if (configStaged & (1 << i)) {
+        shellPrintf(sh, "ok %s %g%s (staged %g)", spec.name, settingGet(settings, spec), spec.unit,
+                    settingGet(configDraft, spec));
+    } else {
+        shellPrintf(sh, "ok %s %g%s", spec.name, settingGet(settings, spec), spec.unit);
+    }
+}
+
+/**
+ * "set" and "defaults" only stage values; "commit" writes them all at once
+ */
+static void cmdConfig(Shell& sh, int argc, char** argv) {
+    const char* what = argc > 1 ? argv[1] : "list";
+    const SettingSpec* spec = argc > 2 ? settingFind(argv[2]) : nullptr;
+    if (argc > 2 && !spec) {
+        shellPrintf(sh, "err unknown setting '%s' (config list)", argv[2]);
+        return;
+    }
+    if (configStaged == 0) {
+        configDraft = settings;
+    }
+
+    if (strcmp(what, "list") == 0 && argc == 2) {
+        for (int i = 0; i < settingSpecCount; i++) {
+            printSetting(sh, settingSpecs[i]);
+        }
+    } else if (strcmp(what, "get") == 0 && argc == 3) {
+        printSetting(sh, *spec);
+    } else if (strcmp(what, "set") == 0 && argc == 4) {
+        char* end;
+        float value = strtof(argv[3], &end);
+        if (*end != '\0' || !settingSet(configDraft, *spec, value)) {
+            shellPrintf(sh, "err %s must be %g..%g%s", spec->name, spec->min, spec->max, spec->unit);
+            return;
+        }
+        configStaged |= 1 << (spec - settingSpecs);
+        shellPrintf(sh, "ok %s %g%s staged (config commit saves)", spec->name,
+                    settingGet(configDraft, *spec), spec->unit);
+    } else if (strcmp(what, "defaults") == 0 && argc == 2) {
+        settingsDefaults(configDraft);
+        configStaged = (1 << settingSpecCount) - 1;
+        shellPrintf(sh, "ok defaults staged (config commit saves)");
+    } else if (strcmp(what, "discard") == 0 && argc == 2) {
+        configStaged = 0;
+        shellPrintf(sh, "ok discarded");
+    } else if (strcmp(what, "commit") == 0 && argc == 2) {
+        if (configStaged == 0) {
+            shellPrintf(sh, "ok nothing staged");
+            return;
+        }
+        queueReport(sh, SHELL_REPORT_CONFIG, "config commit");
+    } else {
+        shellPrintf(sh, "err config [list|get <k>|set <k> <v>|commit|discard|defaults]");
+    }
+}
+
+#if ENABLE_TELEMETRY
+static void cmdTelemetry(Shell& sh, int argc, char** argv) {
+    const char* what = argc > 1 ? argv[1] : "";
+    if (strcmp(what, "on") == 0) {
+        telemetryStreaming = true;
+    } else if (strcmp(what, "off") == 0) {
+        telemetryStreaming = false;
+    } else if (strcmp(argv[0], "b") == 0) {
+        telemetryStreaming = !telemetryStreaming;
+    } else {
+        shellPrintf(sh, "err tlm on|off");
+        return;
+    }
+    shellPrintf(sh, "ok tlm %s", telemetryStreaming ? "on" : "off");
+}
+#endif
+
+// Single letters are the old one-key commands, now ended with Enter
+static const ShellCommand shellCommands[] = {
+    {"help",    "",                                 cmdHelp},
+    {"get",     "temp|target|mode|status",          cmdGet},
+    {"set",     "target <C> (manual mode)",         cmdSet},
+    {"manual",  "",                                 cmdManual},
+    {"menu",    "",                                 cmdMenu},
+    {"estop",   "",                                 cmdEstop},
+    {"profile", "list|start <n>|stop|resume",       cmdProfile},
+    {"stats",   "(scheduler, bus, commands, memory)", cmdStats},
+#if ENABLE_PROFILER
+    {"prof",    "[trace|reset]",                    cmdProf},
+    {"p",       "(prof)",                           cmdProf},
+    {"t",       "(prof trace)",                     cmdTrace},
+    {"z",       "(prof reset)",                     cmdProfReset},
+#endif
+    {"ui",      "(input-to-photon latency)",        cmdUi},
+    {"u",       "(ui)",                             cmdUi},
+    {"mem",     "(heap, stacks, allocations)",      cmdMem},
+    {"m",       "(mem)",                            cmdMem},
+    {"logs",    "(firing logs and sizes)",          cmdLogs},
+    {"flight",  "[archive] (hex dump, default newest)", cmdFlight},
+    {"config",  "[list|get <k>|set <k> <v>|commit|discard|defaults]", cmdConfig},
+#if ENABLE_TELEMETRY
+    {"tlm",     "on|off",                           cmdTelemetry},
+    {"b",       "(toggle tlm)",                     cmdTelemetry},
+#endif
+};
+
+/**
+ * Copy queued replies into the UART TX buffer, as much as it takes now
+ */
+static void drainShellOutput() {
+    char chunk[64];
+    while (shell.outLen > 0 && !logTransferActive()) {
+        int room = Serial.availableForWrite();
+        if (room <= 0) {
+            return;
+        }
+        size_t n = shellDrain(shell, chunk, (size_t)room < sizeof(chunk) ? (size_t)room : sizeof(chunk));
+        Serial.write((const uint8_t*)chunk, n);
+    }
+}
+
+// ============================================================================
+// INPUT HANDLING
+// ============================================================================
+
+/**
+ * Serial bytes: log transfer frames first, the rest to the command shell
+ * At most SHELL_LINES_PER_POLL commands per pass, and none while the reply
+ * ring can't take a reply: unread bytes wait in the UART RX buffer, so a
+ * fast script slows the shell down instead of the input job.
+ */
+void handleSerialInput() {
+    drainShellOutput();
+    int lines = 0;
+    while (Serial.available() > 0 && lines < SHELL_LINES_PER_POLL &&
+           shellOutputFree(shell) >= SHELL_REPLY_BYTES) {
+        int key = Serial.read();
+        if (logTransferRxByte((uint8_t)key)) {
+            continue;  // Log download request or data (see log_transfer.h)
+        }
+        if (shellFeed(shell, (char)key)) {
+            lines++;
+        }
+    }
+    drainShellOutput();
+}
+
+/**
+ * Handle left encoder (back to menu / mode selection)
+ */
+void handleLeftEncoder() {
+    int clk = digitalRead(ENCODER_LEFT_CLK_PIN);
+    int dt = digitalRead(ENCODER_LEFT_DT_PIN);
+    int sw = digitalRead(ENCODER_LEFT_SW_PIN);
+
+    // Button press detection - back to main menu
+    if (sw != leftEncoder.lastSW && sw == LOW) {
+        unsigned long now = millis();
+        if (now - leftEncoder.lastButtonPress > DEBOUNCE_MS) {
+            DEBUG_PRINTLN("[LEFT] Button pressed - returning to main menu");
+            uiLatencyInput(uiLatency, micros());
+            postCommand(CMD_EXIT_TO_MENU);
+            playTone(2000, 30);
+            leftEncoder.lastButtonPress = now;
+        }
+    }
+    leftEncoder.lastSW = sw;
+}
+
+/**
+ * Handle right encoder (setpoint adjustment)
+ */
+void handleRightEncoder() {
+    int clk = digitalRead(ENCODER_RIGHT_CLK_PIN);
+    int dt = digitalRead(ENCODER_RIGHT_DT_PIN);
+    int sw = digitalRead(ENCODER_RIGHT_SW_PIN);
+
+    // Profile screen: rotation selects a profile, press starts/stops it
+    if (state.mode == MODE_PROFILE) {
+        if (clk != rightEncoder.lastCLK) {
+            if (!profileIsRunning() && !profileIsPaused()) {
+                uiLatencyInput(uiLatency, micros());
+                selectedProfile += (dt != clk) ? 1 : -1;
+                if (selectedProfile >= numBuiltinProfiles) selectedProfile = 0;
+                if (selectedProfile < 0) selectedProfile = numBuiltinProfiles - 1;
+                uiLatencyApplied(uiLatency, micros());  // Drawn straight from selectedProfile
+                playTone(1200, 20);
+            }
+            rightEncoder.lastCLK = clk;
+        }
+
+        if (sw != rightEncoder.lastSW && sw == LOW) {
+            unsigned long now = millis();
+            if (now - rightEncoder.lastButtonPress > DEBOUNCE_MS) {
+                uiLatencyInput(uiLatency, micros());
+                if (profileIsRunning()) {
+                    postCommand(CMD_PROFILE_STOP);
+                } else if (profileIsPaused()) {
+                    postCommand(CMD_PROFILE_RESUME);
+                } else {
+                    postCommand(CMD_PROFILE_START, 0.0f, selectedProfile);
+                }
+                playTone(2000, 30);
+                rightEncoder.lastButtonPress = now;
+            }
+        }
+        rightEncoder.lastSW = sw;
+        return;
+    }
+
+    // Rotation detection: clockwise raises the setpoint, counter-clockwise lowers it
+    if (clk != rightEncoder.lastCLK) {
+        uiLatencyInput(uiLatency, micros());
+        postCommand(CMD_ADJUST_TARGET, (dt != clk) ? 5.0f : -5.0f);
+        playTone(1200, 20);  // Quick beep
+        rightEncoder.lastCLK = clk;
+    }
+
+    // Button press detection (for future use)
+    if (sw != rightEncoder.lastSW && sw == LOW) {
+        unsigned long now = millis();
+        if (now - rightEncoder.lastButtonPress > DEBOUNCE_MS) {
+            DEBUG_PRINTLN("[RIGHT] Button pressed");
+            playTone(2000, 30);
+            rightEncoder.lastButtonPress = now;
+        }
+    }
+    rightEncoder.lastSW = sw;
+}
+
+// ============================================================================
+// FAULT OBSERVER
+// ============================================================================
+
+/**
+ * React to a newly detected fault
+ * Stuck SSR: cut power and stop. Lid open: pause the profile so the elements
+ * don't heat the room. TC drift: warn and keep firing.
+ */
+void handleFault(FaultClass fault) {
+    flightRecordFault((uint8_t)fault, faultObserver.innovation, state.currentTemp);
+    LOG_WARN("[FAULT] %s (innovation %.1f C, predicted %.1f C)\n", faultClassName(fault),
+             faultObserver.innovation, faultObserver.predicted);
+    firingLogPrintf("FAULT %s innov=%.1f pred=%.1f", faultClassName(fault),
+                    faultObserver.innovation, faultObserver.predicted);
+
+    switch (fault) {
+        case FAULT_STUCK_SSR:
+            allZonesOff();
+            state.targetTemp = 0.0;
+            state.mode = MODE_IDLE;
+            profileStop();
+            elementHealthEndFiring();
+            firingLogStop();
+            digitalWrite(LED_ERROR_PIN, HIGH);
+            LOG_ERROR("[SAFETY] Kiln heating with SSR commanded off - DISCONNECT POWER\n");
+            playTone(2000, 1000);  // Long alarm
+            break;
+
+        case FAULT_LID_OPEN:
+            if (profileIsRunning()) {
+                profilePause(millis());
+                LOG_WARN("[FAULT] Profile paused - close lid, then R Press to resume\n");
+            }
+            playTone(500, 300);
+            break;
+
+        case FAULT_TC_DRIFT:
+            playTone(500, 100);
+            break;
+
+        case FAULT_NONE:
+            break;
+    }
+}
+
+// ============================================================================
+// EMERGENCY STOP
+// ============================================================================
+
+/**
+ * Check for emergency stop (both encoder buttons pressed simultaneously)
+ */
+void checkEmergencyStop() {
+    static unsigned long bothPressedStart = 0;
+    static bool wasTriggered = false;
+
+    int leftSW = digitalRead(ENCODER_LEFT_SW_PIN);
+    int rightSW = digitalRead(ENCODER_RIGHT_SW_PIN);
+
+    // Both buttons pressed
+    if (leftSW == LOW && rightSW == LOW) {
+        if (bothPressedStart == 0) {
+            bothPressedStart = millis();
+        }
+
+        // Check if held for required time
+        if (millis() - bothPressedStart >= EMERGENCY_STOP_HOLD_TIME_MS && !wasTriggered) {
+            postCommand(CMD_ESTOP);
+            wasTriggered = true;
+        }
+    } else {
+        // Reset
+        bothPressedStart = 0;
+        wasTriggered = false;
+    }
+}
+
+// ============================================================================
+// SCHEDULED JOBS
+// ============================================================================
+
+/**
+ * True in the modes where the kiln loop runs (reads, control, display)
+ * The main menu and hardware tests only poll input.
+ */
+static bool controlActive() {
+    return state.mode != MODE_MAIN_MENU && state.mode != MODE_TEST;
+}
+
+/**
+ * Serial keys, then encoders and E-stop or the menu / test-mode handlers
+ */
+void jobInput() {
+    PROFILE_ZONE("input");
+    handleSerialInput();
+    if (state.mode == MODE_MAIN_MENU) {
+        handleMainMenuInput();
+        return;
+    }
+    if (state.mode == MODE_TEST) {
+        handleTestModeInput();
+        return;
+    }
+    handleLeftEncoder();
+    handleRightEncoder();
+    checkEmergencyStop();
+}
+
+/**
+ * Apply one input command to the control state
+ */
+void applyCommand(const Command& cmd) {
+    unsigned long now = millis();
+    flightRecordCommand(cmd.type, cmd.source, cmd.value[0], state.currentTemp);
+    switch ((CommandType)cmd.type) {
+        case CMD_ESTOP: {
+            allZonesOff();
+            state.targetTemp = 0.0;
+            state.mode = MODE_IDLE;
+            profileStop();
+            firingLogPrintf("EMERGENCY STOP");
+            elementHealthEndFiring();
+            firingLogStop();
+
+            // Anything queued before the E-stop is stale
+            uint32_t flushed = commandFlushBelow(commandQueue, CMD_LANE_SAFETY);
+            DEBUG_PRINTLN("*** EMERGENCY STOP ACTIVATED ***");
+            if (flushed) {
+                DEBUG_PRINTF("[CMD] Discarded %lu queued command(s)\n", (unsigned long)flushed);
+            }
+            playTone(2000, 1000);  // Long alarm
+            break;
+        }
+
+        case CMD_EXIT_TO_MENU:
+            // Safety: Turn off heating when returning to menu
+            allZonesOff();
+            profileStop();
+            elementHealthEndFiring();
+            firingLogStop();
+
+            state.mode = MODE_MAIN_MENU;
+            uiLatencyApplied(uiLatency, micros());
+            displayMainMenu();
+            break;
+
+        case CMD_START_MANUAL:
+            state.mode = MODE_MANUAL;
+            state.targetTemp = 100.0;
+            state.heating = false;
+            stepAnalyzerReset(stepAnalyzer);
+            heatWorkReset();
+            predictorReset(state.currentTemp, now);
+            faultObserverClear(state.currentTemp);
+            elementHealthStartFiring();
+            firingLogStart("Manual");
+            break;
+
+        case CMD_ENTER_PROFILES:
+            state.mode = MODE_PROFILE;
+            state.targetTemp = 0.0;
+            state.heating = false;
+            profileRunner.state = PROFILE_IDLE;
+            stepAnalyzerReset(stepAnalyzer);
+            break;
+
+        case CMD_SET_TARGET:
+        case CMD_ADJUST_TARGET: {
+            // The profile engine owns the setpoint in profile mode
+            if (state.mode == MODE_PROFILE) {
+                break;
+            }
+            float target = (cmd.type == CMD_SET_TARGET) ? cmd.value[0]
+                                                       : state.targetTemp + cmd.value[0];
+            // SAFETY: Enforce the temperature limit (max_temp, never above MAX_TEMP_LIMIT)
+            if (target > settingsTempLimit(settings)) target = settingsTempLimit(settings);
+            if (target < 0.0) target = 0.0;
+            state.targetTemp = target;
+            DEBUG_PRINT("[SETPOINT] Set to: ");
+            DEBUG_PRINTLN(state.targetTemp);
+            break;
+        }
+
+        case CMD_PROFILE_START:
+            if (state.mode != MODE_PROFILE || profileIsRunning() || profileIsPaused() ||
+                cmd.arg < 0 || cmd.arg >= numBuiltinProfiles) {
+                break;
+            }
+            wareObserverReset(state.currentTemp);
+            heatWorkReset();
+            predictorReset(state.currentTemp, now);
+            predictionValid = false;
+            faultObserverClear(state.currentTemp);
+            elementHealthStartFiring();
+            firingLogStart(builtinProfiles[cmd.arg].name);
+            profileStart(&builtinProfiles[cmd.arg], state.currentTemp, now);
+            break;
+
+        case CMD_PROFILE_STOP:
+            if (profileIsRunning()) {
+                profileStop();
+                firingLogPrintf("ABORT by user");
+            }
+            break;
+
+        case CMD_PROFILE_RESUME:
+            if (profileIsPaused()) {
+                faultObserverClear(state.currentTemp);
+                profileResume(state.currentTemp, now);
+                firingLogPrintf("RESUME");
+            }
+            break;
+
+        case CMD_SET_TUNINGS:
+            Kp = cmd.value[0];
+            Ki = cmd.value[1];
+            Kd = cmd.value[2];
+            for (int z = 0; z < KILN_ZONE_COUNT; z++) {
+                zones[z].controller.setTunings(Kp, Ki, Kd);
+            }
+            firingLogPrintf("TUNE kp=%.3f ki=%.4f kd=%.3f", Kp, Ki, Kd);
+            break;
+
+        case CMD_TYPE_COUNT:
+            break;
+    }
+}
+
+/**
+ * The single point where input commands change control state, E-stop first
+ */
+void applyCommands() {
+    MEM_TAG("commands");
+    Command cmd;
+    while (commandPop(commandQueue, cmd)) {
+        applyCommand(cmd);
+        commandNoteApplied(commandQueue, cmd, micros());
+    }
+}
+
+/**
+ * Snapshot the reading and the outputs computed from it onto the sample bus
+ */
+void publishControlSample() {
+    ControlSample sample;
+    sample.timeMs = millis();
+    sample.temp = state.currentTemp;
+    sample.hottest = state.hottestTemp;
+    sample.target = state.targetTemp;
+    sample.output = pidOutput;
+    sample.wareTemp = wareObserver.wareTemp;
+    sample.mode = (uint8_t)state.mode;
+    sample.heating = state.heating;
+    sample.sensorError = state.sensorError;
+    sample.fault = (uint8_t)faultObserver.active;
+    sample.profileState = (uint8_t)profileRunner.state;
+    sample.profileSegment = profileRunner.segment;
+    sample.faultResidual = faultObserver.innovation;
+    for (int z = 0; z < KILN_ZONE_COUNT; z++) {
+        sample.zoneTemp[z] = zones[z].temp;
+        sample.zoneSetpoint[z] = zones[z].controller.setpoint();
+        sample.zoneOutput[z] = zones[z].controller.output();
+        sample.zoneErrors[z] = zones[z].errors;
+    }
+    sampleBusPublish(sampleBus, sample);
+
+    flightRecordTick(state.currentTemp, state.targetTemp, pidOutput, ssrMask(),
+                     (state.heating ? FLIGHT_FLAG_HEATING : 0) |
+                     (state.sensorError ? FLIGHT_FLAG_SENSOR_ERR : 0));
+    flightRecordProfile((uint8_t)profileRunner.state, profileRunner.segment);
+    flightRecordSensor(state.sensorError, state.currentTemp);
+
+    // Queued input now reaches the display through this sample
+    uiLatencyApplied(uiLatency, micros());
+}
+
+/**
+ * Zone PIDs and SSR outputs
+ * Instead of polling, the job wakes at the next SSR edge of any zone (or the
+ * window end), at most PID_UPDATE_INTERVAL_MS apart. A completed read round
+ * also runs it at once, so the safety limits act on each new temperature,
+ * and so does a posted command. Queued commands are applied first.
+ */
+void jobSsrControl() {
+    PROFILE_ZONE("ssr");
+    applyCommands();
+    flightRecordMode((uint8_t)state.mode);
+    if (!controlActive()) {
+        return;
+    }
+    updateSSRControl();
+
+#if ENABLE_SHADOW_CONTROLLER
+    // Candidate sees exactly what the live controller saw
+    shadowPID.update(pidInput, pidSetpoint, zones[0].controller.running(),
+                     livePidComputed, pidOutput);
+#endif
+
+    noteSsrEdges();
+
+    if (sampleDue) {
+        sampleDue = false;
+        publishControlSample();
+    }
+
+    // Update heating LED
+    digitalWrite(LED_WIFI_PIN, state.heating ? HIGH : LOW);
+
+    unsigned long elapsed = millis() - ssrWindowStartTime;
+    unsigned long wait = (elapsed < settings.ssrCycleMs) ? settings.ssrCycleMs - elapsed : 0;
+    for (int z = 0; z < KILN_ZONE_COUNT; z++) {
+        if (elapsed < zones[z].onTime && zones[z].onTime - elapsed < wait) {
+            wait = zones[z].onTime - elapsed;
+        }
+    }
+    if (wait > PID_UPDATE_INTERVAL_MS) {
+        wait = PID_UPDATE_INTERVAL_MS;
+    }
+    schedulerRunIn(scheduler, jobSsrId, wait);
+}
+
+/**
+ * Every zone read: update the kiln temperature and everything fed from it
+ */
+void onReadRoundComplete(unsigned long now) {
+    PROFILE_ZONE("observers");
+#if ENABLE_PROFILER
+    profilerPeriodMark(tcRoundPeriod, (uint64_t)esp_timer_get_time());
+#endif
+    float dtSeconds = (now - state.lastTempRead) / 1000.0;
+    state.lastTempRead = now;
+
+    bool valid = updateKilnTemperature();
+    if (valid) {
+        // Update error LED based on sensor state
+        digitalWrite(LED_ERROR_PIN, LOW);
+
+        // Power applied over the last interval is whatever the SSR was doing
+        float power = state.heating ? settings.wattage : 0.0;
+        wareObserverUpdate(state.currentTemp, power, dtSeconds);
+        heatWorkUpdate(state.currentTemp, dtSeconds);
+        predictorSample(state.currentTemp, state.heating, now);
+        elementHealthSample(state.currentTemp, state.heating, now);
+
+        FaultClass fault = faultObserverUpdate(state.currentTemp, state.heating, pidOutput,
+                                               heatingModel.a, heatingModel.b,
+                                               dtSeconds, now);
+        if (fault != FAULT_NONE) {
+            handleFault(fault);
+        }
+    } else {
+        digitalWrite(LED_ERROR_PIN, HIGH);
+    }
+
+    // Profile mode: the profile engine owns the setpoint
+    if (state.mode == MODE_PROFILE) {
+        state.targetTemp = profileUpdate(state.currentTemp, state.heating, now);
+
+        const ProfileSegment* seg = profileCurrentSegment();
+        bool soaking = profileRunner.state == PROFILE_SOAKING;
+        bool wareSoaked = soaking && seg->soakEndOnWare && wareObserverIsSoaked(seg->targetTemp, now);
+        static unsigned long wareNotedSoak = 0;  // soakStartTime of the soak already noted
+        if (wareSoaked && ENABLE_WARE_SOAK_END) {
+            profileEndSoak(now, settings.wattage, "ware");
+            firingLogPrintf("SOAK END ware=%.1f saved=%lumin %.3fkWh", wareObserver.wareTemp,
+                            profileRunner.minutesSaved, profileRunner.kwhSaved);
+        } else if (soaking && profileRunner.segmentCone >= 0 &&
+                   heatWorkTotal() >= heatWorkForCone(profileRunner.segmentCone)) {
+            profileEndSoak(now, settings.wattage, "cone");
+            firingLogPrintf("SOAK END cone %s heatwork=%.0f saved=%lumin %.3fkWh",
+                            ortonCones[profileRunner.segmentCone].name, heatWorkTotal(),
+                            profileRunner.minutesSaved, profileRunner.kwhSaved);
+        } else if (wareSoaked && wareNotedSoak != profileRunner.soakStartTime) {
+            // Advisory: the soak runs its full time, the log shows what could be saved
+            wareNotedSoak = profileRunner.soakStartTime;
+            unsigned long programmedMs = seg->soakMinutes * 60000UL;
+            unsigned long soakMs = now - profileRunner.soakStartTime;
+            unsigned long leftMin = soakMs < programmedMs ? (programmedMs - soakMs) / 60000UL : 0;
+            LOG_INFO("[PROFILE] Ware estimate soaked at %.1f C, %lu min of soak left (advisory)\n",
+                     wareObserver.wareTemp, leftMin);
+            firingLogPrintf("SOAK WARE ready ware=%.1f left=%lumin", wareObserver.wareTemp, leftMin);
+        }
+    }
+
+    // Firing finished: record element health while the data is fresh
+    static ProfileState lastProfileState = PROFILE_IDLE;
+    if (profileRunner.state == PROFILE_COMPLETE && lastProfileState != PROFILE_COMPLETE) {
+        firingLogPrintf("COMPLETE");
+        elementHealthEndFiring();
+        const HealthTrend& health = elementHealthTrend();
+        firingLogPrintf("HEALTH reachable=%.0f slope=%.1f left=%d%s", health.latestReachable,
+                        health.slopePerFiring, health.firingsLeft,
+                        health.warning ? " WARN" : "");
+    }
+    lastProfileState = profileRunner.state;
+
+    // Score setpoint changes (segment target in profile mode, setpoint in manual)
+    if (!state.sensorError) {
+        const ProfileSegment* seg = profileCurrentSegment();
+        float reference = (state.mode == MODE_PROFILE && profileIsRunning())
+                              ? seg->targetTemp : state.targetTemp;
+        StepResult stepResult;
+        if (stepAnalyzerUpdate(stepAnalyzer, reference, state.currentTemp, now, stepResult)) {
+            publishStepResult(stepResult);
+        }
+    }
+
+    // Control acts on the new reading now rather than at the next SSR edge,
+    // then publishes it
+    sampleDue = true;
+    schedulerRunIn(scheduler, jobSsrId, 0);
+}
+
+/**
+ * Read one zone's thermocouple: each zone every ~100ms, reads spaced evenly
+ * on the shared bus and shifted into gaps between its SSR edges
+ */
+void jobTcRead() {
+    if (!controlActive()) {
+        return;
+    }
+    static int nextZone = 0;
+    unsigned long now = millis();
+    KilnZone& readZone = zones[nextZone];
+    if (!tcSamplerShouldRead(readZone.sampler, now)) {
+        schedulerRunIn(scheduler, jobTcReadId, TC_EDGE_GUARD_MS);
+        return;
     }
 
-    // Target Temperature
-    tft.drawLine(0, 150, 320, 150, TFT_DARKGREY);
-    tft.setTextSize(2);
-    tft.setTextColor(TFT_CYAN, TFT_BLACK);
-    tft.setCursor(10, 165);
-    tft.print("Target: ");
-    snprintf(tempStr, sizeof(tempStr), "%.0f", state.targetTemp);
-    tft.setTextColor(TFT_WHITE, TFT_BLACK);
-    tft.print(tempStr);
-    tft.drawCircle(210, 172, 5, TFT_WHITE);
-    tft.print("C");
+    bool valid = readZoneTemperature(nextZone);
+    TcSampleTag tag = tcSamplerOnRead(readZone.sampler, now);
+    if (valid) {
+        tcSamplerAddSample(readZone.sampler, tag, readZone.temp);
+    }
+    nextZone = (nextZone + 1) % KILN_ZONE_COUNT;
+    if (nextZone == 0) {
+        onReadRoundComplete(now);
+    }
+}
 
-    // PID Output
-    tft.setTextSize(1);
-    tft.setTextColor(TFT_YELLOW, TFT_BLACK);
-    tft.setCursor(10, 190);
-    tft.printf("PID Output: %.1f%%", pidOutput);
+/**
+ * Redraw from the newest sample (the last one again if none is new)
+ */
+void jobDisplay() {
+    MEM_TAG("display");
+    static ControlSample sample = {};
+    if (controlActive()) {
+        uint32_t frameStart = micros();
+        sampleBusLatest(sampleBus, displayCursor, sample);
+        updateDisplay(sample);
+        uiLatencyFrame(uiLatency, sample.mode == MODE_PROFILE ? UI_SCREEN_PROFILE : UI_SCREEN_MANUAL,
+                       frameStart, micros());
+    }
+}
 
-    // Instructions
-    tft.drawLine(0, 200, 320, 200, TFT_DARKGREY);
-    tft.setTextSize(1);
-    tft.setTextColor(TFT_GREENYELLOW, TFT_BLACK);
-    tft.setCursor(10, 210);
-    tft.print("L Press: Menu    R Turn: Setpoint");
-    tft.setCursor(10, 225);
-    tft.setTextColor(TFT_ORANGE, TFT_BLACK);
-    tft.print("Both Hold: Emergency Stop");
+/**
+ * Serial status line
+ */
+void jobStatus() {
+    PROFILE_ZONE("status");
+    MEM_TAG("status");
+    static ControlSample sample = {};
+    if (!controlActive() || telemetryStreaming || logTransferActive()) {
+        return;
+    }
+    sampleBusLatest(sampleBus, statusCursor, sample);
+
+    Serial.print("[STATUS] Mode: ");
+    Serial.print(sample.mode == MODE_IDLE ? "IDLE" : (sample.mode == MODE_PROFILE ? "PROFILE" : "MANUAL"));
+    Serial.print(" | Temp: ");
+    Serial.print(sample.temp);
+    Serial.print("°C | Target: ");
+    Serial.print(sample.target);
+    Serial.print("°C | Heating: ");
+    Serial.print(sample.heating ? "YES" : "NO");
+    Serial.print(" | Ware: ");
+    Serial.print(sample.wareTemp);
+    Serial.print("°C");
+
+    float coneFraction;
+    int cone = heatWorkEquivalentCone(&coneFraction);
+    Serial.printf(" | Cone: %s+%d%%", cone >= 0 ? ortonCones[cone].name : "-",
+                  (int)(coneFraction * 100));
+
+    if (sample.mode == MODE_PROFILE && predictionValid) {
+        Serial.printf(" | ETA: %.0f min [%.0f-%.0f] %.2f kWh",
+                      firingPrediction.etaSec / 60, firingPrediction.etaLowSec / 60,
+                      firingPrediction.etaHighSec / 60, firingPrediction.kwh);
+#if ENABLE_COST_TRACKING
+        Serial.printf(" %s%.2f", DEFAULT_CURRENCY_SYMBOL, firingPrediction.kwh * settings.electricityRate);
+#endif
+        Serial.print(firingPrediction.stalled ? " STALL" : "");
+    }
+#if KILN_ZONE_COUNT > 1
+    Serial.print(" | Zones:");
+    for (int z = 0; z < KILN_ZONE_COUNT; z++) {
+        Serial.printf(" %.1f/%.0f%%", sample.zoneTemp[z], sample.zoneOutput[z]);
+    }
+#endif
+    for (int z = 0; z < KILN_ZONE_COUNT; z++) {
+        if (zoneBackupCsPins[z] >= 0) {
+            Serial.printf(" | TC%d: %s %+.1f%s", z, tcVoteSourceName(zones[z].vote.source),
+                          zones[z].vote.diff, zones[z].vote.driftWarning ? " DRIFT" : "");
+        }
+    }
+    Serial.printf(" | Resid: %+.1f", faultObserver.innovation);
+    if (faultObserver.active != FAULT_NONE) {
+        Serial.printf(" FAULT:%s", faultClassName(faultObserver.active));
+    }
+    Serial.println();
 }
 
-// ============================================================================
-// INPUT HANDLING
-// ============================================================================
+/**
+ * One binary telemetry frame per new control sample
+ * The frame is written only if the UART buffer can take all of it, so the
+ * job never blocks on the port and never sends half a frame; a frame that
+ * doesn't fit is counted and the sequence number shows the gap.
+ */
+void jobTelemetry() {
+    PROFILE_ZONE("telemetry");
+    static ControlSample sample = {};
+    if (!telemetryStreaming || logTransferActive() ||
+        !sampleBusLatest(sampleBus, telemetryCursor, sample)) {
+        return;
+    }
+
+    TlmSample t;
+    t.seq = telemetrySeq++;
+    t.timeMs = sample.timeMs;
+    t.temp = sample.temp;
+    t.hottest = sample.hottest;
+    t.target = sample.target;
+    t.wareTemp = sample.wareTemp;
+    t.output = sample.output;
+    t.mode = sample.mode;
+    t.flags = (sample.heating ? TLM_FLAG_HEATING : 0) | (sample.sensorError ? TLM_FLAG_SENSOR_ERROR : 0);
+    t.fault = sample.fault;
+    t.profileState = sample.profileState;
+    t.profileSegment = sample.profileSegment;
+    t.faultResidual = sample.faultResidual;
+    t.zoneCount = KILN_ZONE_COUNT;
+    for (int z = 0; z < KILN_ZONE_COUNT; z++) {
+        t.zones[z].temp = sample.zoneTemp[z];
+        t.zones[z].setpoint = sample.zoneSetpoint[z];
+        t.zones[z].output = sample.zoneOutput[z];
+        t.zones[z].errors = sample.zoneErrors[z] > 0xFFFF ? 0xFFFF : (uint16_t)sample.zoneErrors[z];
+    }
+
+    uint8_t frame[TLM_MAX_ENCODED];
+    size_t len = tlmEncodeSample(t, frame);
+    if ((size_t)Serial.availableForWrite() < len) {
+        telemetryDropped++;
+        return;
+    }
+    Serial.write(frame, len);
+    telemetrySent++;
+}
 
 /**
- * Handle left encoder (back to menu / mode selection)
+ * Firing log download: replies and data blocks as the UART has room
  */
-void handleLeftEncoder() {
-    int clk = digitalRead(ENCODER_LEFT_CLK_PIN);
-    int dt = digitalRead(ENCODER_LEFT_DT_PIN);
-    int sw = digitalRead(ENCODER_LEFT_SW_PIN);
+void jobLogTransfer() {
+    PROFILE_ZONE("xfer");
+    logTransferPoll();
+}
 
-    // Button press detection - back to main menu
-    if (sw != leftEncoder.lastSW && sw == LOW) {
-        unsigned long now = millis();
-        if (now - leftEncoder.lastButtonPress > DEBOUNCE_MS) {
-            DEBUG_PRINTLN("[LEFT] Button pressed - returning to main menu");
+/**
+ * Thermocouple noise per SSR state
+ */
+void jobTcNoiseReport() {
+    if (controlActive()) {
+        reportTcNoise();
+    }
+}
 
-            // Safety: Turn off heating when returning to menu
-            digitalWrite(SSR_PIN, LOW);
-            state.heating = false;
+/**
+ * Remaining-time prediction (profile mode only)
+ */
+void jobPredictor() {
+    PROFILE_ZONE("predict");
+    if (state.mode != MODE_PROFILE) {
+        return;
+    }
+    static unsigned long lastPredictionLog = 0;
+    unsigned long now = millis();
+    int64_t start = esp_timer_get_time();
+    predictionValid = predictorRun(profileRunner, state.currentTemp, now,
+                                   settings.wattage, firingPrediction);
+    predictionCostUs = (uint32_t)(esp_timer_get_time() - start);
+
+    if (predictionValid && now - lastPredictionLog >= PREDICTOR_LOG_INTERVAL_MS) {
+        lastPredictionLog = now;
+        firingLogPrintf("PREDICT eta=%.0f lo=%.0f hi=%.0f kwh=%.2f end=%.0f a=%.1f b=%.4f%s us=%lu",
+                        firingPrediction.etaSec, firingPrediction.etaLowSec,
+                        firingPrediction.etaHighSec, firingPrediction.kwh,
+                        firingPrediction.endTemp, heatingModel.a, heatingModel.b,
+                        firingPrediction.stalled ? " STALL" : "",
+                        (unsigned long)predictionCostUs);
+    }
+}
 
-            state.mode = MODE_MAIN_MENU;
-            displayMainMenu();
-            playTone(2000, 30);
-            leftEncoder.lastButtonPress = now;
-        }
+/**
+ * Shadow controller report
+ */
+void jobShadowReport() {
+    if (controlActive() && zones[0].controller.running()) {
+        reportShadow();
     }
-    leftEncoder.lastSW = sw;
 }
 
 /**
- * Handle right encoder (setpoint adjustment)
+ * Temperature trend in the firing log
  */
-void handleRightEncoder() {
-    int clk = digitalRead(ENCODER_RIGHT_CLK_PIN);
-    int dt = digitalRead(ENCODER_RIGHT_DT_PIN);
-    int sw = digitalRead(ENCODER_RIGHT_SW_PIN);
+void jobFiringLogSample() {
+    PROFILE_ZONE("log");
+    MEM_TAG("log");
+    static ControlSample sample = {};
+    if (!controlActive()) {
+        return;
+    }
+    sampleBusLatest(sampleBus, logCursor, sample);
+    firingLogPrintf("T %.1f SP %.1f OUT %.1f WARE %.1f",
+                    sample.temp, sample.target, sample.output, sample.wareTemp);
+#if KILN_ZONE_COUNT > 1
+    for (int z = 0; z < KILN_ZONE_COUNT; z++) {
+        firingLogPrintf("Z%d T %.1f SP %.1f OUT %.1f ERR %lu", z, sample.zoneTemp[z],
+                        sample.zoneSetpoint[z], sample.zoneOutput[z],
+                        (unsigned long)zones[z].errors);
+    }
+#endif
+    firingLogPrintf("MEM FREE %lu LARGEST %lu MIN %lu ALLOCS %lu",
+                    (unsigned long)memMonitor.heap.freeBytes,
+                    (unsigned long)memMonitor.heap.largestBlock,
+                    (unsigned long)memMonitor.heap.minEverFree,
+                    (unsigned long)memMonitor.allocs.load());
+}
 
-    // Rotation detection
-    if (clk != rightEncoder.lastCLK) {
-        if (dt != clk) {
-            // Clockwise - increase setpoint
-            state.targetTemp += 5.0;
-            // SAFETY: Enforce hard temperature limit from config.h
-            if (state.targetTemp > MAX_TEMP_LIMIT) {
-                state.targetTemp = MAX_TEMP_LIMIT;
-            }
-            DEBUG_PRINT("[SETPOINT] Increased to: ");
-            DEBUG_PRINTLN(state.targetTemp);
-        } else {
-            // Counter-clockwise - decrease setpoint
-            state.targetTemp -= 5.0;
-            if (state.targetTemp < 0.0) state.targetTemp = 0.0;
-            DEBUG_PRINT("[SETPOINT] Decreased to: ");
-            DEBUG_PRINTLN(state.targetTemp);
+/**
+ * Heap and stack poll; announces each new post-setup allocation site once
+ */
+void jobMemory() {
+    static int sitesSeen = 0;
+    memMonitorPoll();
+
+    MemAllocSite sites[MEM_MONITOR_SITES];
+    int n = memMonitorCopySites(memMonitor, sites, MEM_MONITOR_SITES);
+    for (; sitesSeen < n; sitesSeen++) {
+        const MemAllocSite& s = sites[sitesSeen];
+        Serial.printf("[MEM] Allocation after setup: pc=0x%08lx tag=%s size=%lu\n",
+                      (unsigned long)s.pc, s.tag ? s.tag : "-", (unsigned long)s.largest);
+    }
+}
+
+enum StatsSection {
+    STATS_SCHED,
+    STATS_BUS,
+    STATS_CMD,
+    STATS_UI,
+    STATS_MEM,
+    STATS_LOG,
+    STATS_TLM,
+    STATS_SHELL,
+    STATS_CONFIG,
+    STATS_DONE
+};
+
+/**
+ * Per-job run counts, lateness and overruns; sample bus consumer lag;
+ * command latency per lane; UI latency; memory; log ring; telemetry; shell
+ * One line per call, so the caller can stop whenever the TX buffer is short
+ * of room (REPORT_LINE_BYTES) and carry on in a later run.
+ *
+ * @return False once the report is complete (nothing printed)
+ */
+bool statsReportLine(ReportCursor& c) {
+    static const SampleCursor* const cursors[] = {&displayCursor, &statusCursor, &logCursor,
+                                                  &telemetryCursor, &shellCursor};
+    for (; c.section < STATS_DONE; c.section++, c.item = 0) {
+        switch (c.section) {
+            case STATS_SCHED:
+                if (c.item < scheduler.jobCount) {
+                    const SchedJob& j = scheduler.jobs[c.item++];
+                    Serial.printf("[SCHED] %-8s runs=%lu late=%lu maxLate=%lums skipped=%lu "
+                                  "over=%lu maxRun=%luus\n",
+                                  j.name, (unsigned long)j.stats.runs, (unsigned long)j.stats.late,
+                                  (unsigned long)j.stats.maxLateMs, (unsigned long)j.stats.skipped,
+                                  (unsigned long)j.stats.overruns, (unsigned long)j.stats.maxRunUs);
+                    return true;
+                }
+                break;
+
+            case STATS_BUS:
+                if (c.item < sizeof(cursors) / sizeof(cursors[0])) {
+                    const SampleCursor* b = cursors[c.item++];
+                    Serial.printf("[BUS] %-8s reads=%lu skipped=%lu overruns=%lu maxLag=%lu\n",
+                                  b->name, (unsigned long)b->reads, (unsigned long)b->skipped,
+                                  (unsigned long)b->overruns, (unsigned long)b->maxLag);
+                    return true;
+                }
+                break;
+
+            case STATS_CMD:
+                for (; c.item < CMD_LANE_COUNT; c.item++) {
+                    const CommandLaneStats& l = commandQueue.lanes[c.item].stats;
+                    if (l.applied == 0 && l.dropped.load() == 0) {
+                        continue;
+                    }
+                    Serial.printf("[CMD] %-8s posted=%lu applied=%lu dropped=%lu flushed=%lu "
+                                  "latency mean=%luus p99<=%luus max=%luus\n",
+                                  commandLaneName((CommandLane)c.item),
+                                  (unsigned long)l.posted.load(), (unsigned long)l.applied,
+                                  (unsigned long)l.dropped.load(), (unsigned long)l.flushed,
+                                  (unsigned long)(l.applied ? l.totalLatencyUs / l.applied : 0),
+                                  (unsigned long)commandLatencyPercentile(l, 99.0f),
+                                  (unsigned long)l.maxLatencyUs);
+                    c.item++;
+                    return true;
+                }
+                break;
+
+            case STATS_UI:
+                if (uiReportLine(c.item)) {
+                    return true;
+                }
+                break;
+
+            case STATS_MEM:
+                if (memReportLine(c.item)) {
+                    return true;
+                }
+                break;
+
+            case STATS_LOG:
+                if (c.item++ == 0) {
+                    Serial.printf("[LOG] written=%lu dropped=%lu maxDepth=%lu/%d\n",
+                                  (unsigned long)logRing.stats.written,
+                                  (unsigned long)logRing.stats.dropped.load(),
+                                  (unsigned long)logRing.stats.maxDepth, LOG_RING_DEPTH);
+                    return true;
+                }
+                break;
+
+            case STATS_TLM:
+#if ENABLE_TELEMETRY
+                if (c.item++ == 0) {
+                    Serial.printf("[TLM] %s sent=%lu dropped=%lu\n", telemetryStreaming ? "on" : "off",
+                                  (unsigned long)telemetrySent, (unsigned long)telemetryDropped);
+                    return true;
+                }
+#endif
+                break;
+
+            case STATS_SHELL:
+                if (c.item++ == 0) {
+                    Serial.printf("[SHELL] lines=%lu errors=%lu repliesDropped=%lu\n",
+                                  (unsigned long)shell.stats.lines, (unsigned long)shell.stats.errors,
+                                  (unsigned long)shell.stats.outputDropped);
+                    return true;
+                }
+                break;
+
+            case STATS_CONFIG:
+                if (c.item++ == 0) {
+                    Serial.printf("[CONFIG] commits=%lu failures=%lu lastCommit=%luus staged=0x%02x\n",
+                                  (unsigned long)settingsStats.commits,
+                                  (unsigned long)settingsStats.failures,
+                                  (unsigned long)settingsStats.lastCommitUs, configStaged);
+                    return true;
+                }
+                break;
         }
-        playTone(1200, 20);  // Quick beep
-        rightEncoder.lastCLK = clk;
     }
+    return false;
+}
 
-    // Button press detection (for future use)
-    if (sw != rightEncoder.lastSW && sw == LOW) {
-        unsigned long now = millis();
-        if (now - rightEncoder.lastButtonPress > DEBOUNCE_MS) {
-            DEBUG_PRINTLN("[RIGHT] Button pressed");
-            playTone(2000, 30);
-            rightEncoder.lastButtonPress = now;
+/**
+ * Periodic stats report, printed as far as the TX buffer has room; the job
+ * comes back REPORT_RESUME_MS later for the rest
+ */
+void jobSchedulerReport() {
+    static ReportCursor cursor = {};
+    while (Serial.availableForWrite() >= REPORT_LINE_BYTES) {
+        if (!statsReportLine(cursor)) {
+            cursor = {};
+            return;
         }
     }
-    rightEncoder.lastSW = sw;
+    schedulerRunIn(scheduler, jobSchedReportId, REPORT_RESUME_MS);
 }
 
-// ============================================================================
-// EMERGENCY STOP
-// ============================================================================
+/**
+ * Put newly committed settings into effect
+ * Most are read straight from settings; the gains go through the command
+ * queue like any other change to the control loop.
+ */
+void applySettings(const KilnSettings& old) {
+    if (settings.kp != old.kp || settings.ki != old.ki || settings.kd != old.kd) {
+        Command cmd = {};
+        cmd.type = CMD_SET_TUNINGS;
+        cmd.source = CMD_SOURCE_SERIAL;
+        cmd.value[0] = settings.kp;
+        cmd.value[1] = settings.ki;
+        cmd.value[2] = settings.kd;
+        if (!commandPost(commandQueue, cmd, micros())) {
+            Serial.println("[CONFIG] Gains saved but not applied (queue full); they apply at boot");
+        }
+        schedulerRunIn(scheduler, jobSsrId, 0);
+    }
+    if (settings.tcOffset != old.tcOffset) {
+        tcLinearizeSetOffset(settings.tcOffset);
+    }
+}
 
 /**
- * Check for emergency stop (both encoder buttons pressed simultaneously)
+ * Write the fields staged by "config set" over the live settings
  */
-void checkEmergencyStop() {
-    static unsigned long bothPressedStart = 0;
-    static bool wasTriggered = false;
+void commitConfig() {
+    KilnSettings old = settings;
+    KilnSettings next = settings;
+    for (int i = 0; i < settingSpecCount; i++) {
+        if (configStaged & (1 << i)) {
+            settingSet(next, settingSpecs[i], settingGet(configDraft, settingSpecs[i]));
+        }
+    }
+    int changes = settingsDiff(next, old);
+    if (!settingsCommit(next)) {
+        Serial.println("[CONFIG] Save FAILED, changes still staged");
+        return;
+    }
+    configStaged = 0;
+    if (changes == 0) {
+        Serial.println("[CONFIG] No changes to save");
+        return;
+    }
+    applySettings(old);
+    Serial.printf("[CONFIG] Saved %d change(s) in %luus\n", changes,
+                  (unsigned long)settingsStats.lastCommitUs);
+}
 
-    int leftSW = digitalRead(ENCODER_LEFT_SW_PIN);
-    int rightSW = digitalRead(ENCODER_RIGHT_SW_PIN);
+/**
+ * Firing logs on flash, one per line, then the count
+ * item is the next log index, count the logs listed so far.
+ *
+ * @return False once the list is complete (nothing printed)
+ */
+bool logsReportLine(ReportCursor& c) {
+    for (; c.item <= firingLogCurrentIndex(); c.item++) {
+        int32_t size = firingLogSize(c.item);
+        if (size >= 0) {
+            Serial.printf("[LOGS] %d %ld bytes\n", c.item, (long)size);
+            c.item++;
+            c.count++;
+            return true;
+        }
+    }
+    if (c.item++ == firingLogCurrentIndex() + 1) {
+        Serial.printf("[LOGS] %d logs\n", c.count);
+        return true;
+    }
+    return false;
+}
 
-    // Both buttons pressed
-    if (leftSW == LOW && rightSW == LOW) {
-        if (bothPressedStart == 0) {
-            bothPressedStart = millis();
+/**
+ * Next line of the active report
+ *
+ * @return False once it is complete
+ */
+static bool shellReportLine() {
+    switch (activeReport) {
+        case SHELL_REPORT_STATS:
+            return statsReportLine(reportCursor);
+#if ENABLE_PROFILER
+        case SHELL_REPORT_PROFILE:
+            return profReportLine(reportCursor.item);
+        case SHELL_REPORT_TRACE: {
+            char line[PROFILER_TRACE_LINE_BYTES];
+            if (profilerTraceNext(traceCursor, line, sizeof(line)) == 0) {
+                return false;
+            }
+            Serial.print(line);
+            return true;
         }
+#endif
+        case SHELL_REPORT_UI:
+            return uiReportLine(reportCursor.item);
+        case SHELL_REPORT_MEMORY:
+            return memReportLine(reportCursor.item);
+        case SHELL_REPORT_LOGS:
+            return logsReportLine(reportCursor);
+    }
+    return false;
+}
 
-        // Check if held for required time
-        if (millis() - bothPressedStart >= EMERGENCY_STOP_HOLD_TIME_MS && !wasTriggered) {
-            // EMERGENCY STOP!
-            digitalWrite(SSR_PIN, LOW);
-            state.mode = MODE_IDLE;
-            state.heating = false;
-            wasTriggered = true;
+/**
+ * Reports asked for from the shell (see ShellReport)
+ * Waits while a log download holds the port. Staged settings are written
+ * at once; the printed reports run one after another, each printing while
+ * the TX buffer has REPORT_LINE_BYTES free, with the job re-armed to carry
+ * on (a flight archive dump FLIGHT_DUMP_INTERVAL_MS later).
+ */
+void jobShellReport() {
+    if (logTransferActive()) {
+        return;
+    }
+    if (pendingReports & SHELL_REPORT_CONFIG) {
+        pendingReports &= ~SHELL_REPORT_CONFIG;
+        commitConfig();
+    }
 
-            DEBUG_PRINTLN("*** EMERGENCY STOP ACTIVATED ***");
-            playTone(2000, 1000);  // Long alarm
+    if (!flightDumping && activeReport == 0 && pendingReports != 0) {
+        activeReport = pendingReports & -pendingReports;    // Lowest bit first
+        pendingReports &= ~activeReport;
+        reportCursor = {};
+#if ENABLE_PROFILER
+        if (activeReport == SHELL_REPORT_TRACE) {
+            profilerTraceBegin(traceCursor);
         }
-    } else {
-        // Reset
-        bothPressedStart = 0;
-        wasTriggered = false;
+#endif
+    }
+
+    if (activeReport == SHELL_REPORT_FLIGHT) {
+        activeReport = 0;
+        flightDumping = flightDumpArchive(flightDumpIndex, true);
+    } else if (flightDumping) {
+        flightDumping = flightDumpArchive(flightDumpIndex, false);
+    } else if (activeReport != 0) {
+        bool more = true;
+        while (more && Serial.availableForWrite() >= REPORT_LINE_BYTES) {
+            more = shellReportLine();
+        }
+        if (!more) {
+            activeReport = 0;
+        }
+    }
+
+    if (flightDumping) {
+        schedulerRunIn(scheduler, jobReportId, FLIGHT_DUMP_INTERVAL_MS);
+    } else if (activeReport != 0 || pendingReports != 0) {
+        schedulerRunIn(scheduler, jobReportId, REPORT_RESUME_MS);
     }
 }
 
+/**
+ * Register the periodic jobs (budgets are rough worst cases, only used to
+ * count overruns). Phases spread jobs that would otherwise share a tick.
+ */
+void startScheduler() {
+    schedulerInit(scheduler, schedulerClock);
+    //                         name        job                 period                       phase prio budget(us)
+    schedulerAdd(scheduler, "input",    jobInput,           INPUT_CHECK_INTERVAL_MS,     0,  0, 2000);
+    jobSsrId =
+    schedulerAdd(scheduler, "ssr",      jobSsrControl,      PID_UPDATE_INTERVAL_MS,      0,  1, 1000);
+    jobTcReadId =
+    schedulerAdd(scheduler, "tc",       jobTcRead,          ZONE_READ_STAGGER_MS,        0,  2, 1000);
+    schedulerAdd(scheduler, "display",  jobDisplay,         DISPLAY_UPDATE_INTERVAL_MS,  3,  5, 50000);
+    schedulerAdd(scheduler, "status",   jobStatus,          STATUS_PRINT_INTERVAL_MS,    7,  6, 5000);
+#if ENABLE_TELEMETRY
+    schedulerAdd(scheduler, "tlm",      jobTelemetry,       TELEMETRY_INTERVAL_MS,       5,  6, 2000);
+#endif
+    schedulerAdd(scheduler, "xfer",     jobLogTransfer,     XFER_POLL_MS,                1,  6, 3000);
+    schedulerAdd(scheduler, "predict",  jobPredictor,       PREDICTOR_INTERVAL_MS,       11, 7, 50000);
+    schedulerAdd(scheduler, "tcnoise",  jobTcNoiseReport,   TC_NOISE_REPORT_INTERVAL_MS, 13, 8, 10000);
+    schedulerAdd(scheduler, "shadow",   jobShadowReport,    SHADOW_REPORT_INTERVAL_MS,   17, 8, 10000);
+    schedulerAdd(scheduler, "log",      jobFiringLogSample, FIRING_LOG_SAMPLE_MS,        19, 8, 20000);
+    jobSchedReportId =
+    schedulerAdd(scheduler, "sched",    jobSchedulerReport, SCHED_REPORT_INTERVAL_MS,    23, 9, 10000);
+    schedulerAdd(scheduler, "memory",   jobMemory,          MEM_MONITOR_INTERVAL_MS,     29, 9, 5000);
+    jobReportId =
+    schedulerAdd(scheduler, "report",   jobShellReport,     SHELL_REPORT_POLL_MS,        31, 9, 20000);
+    Serial.printf("[OK] Scheduler started (%d jobs)\n", scheduler.jobCount);
+}
+
 // ============================================================================
 // SETUP
 // ============================================================================
 
 void setup() {
+    memMonitorInit(memMonitor);
+
     // Initialize serial communication
+    Serial.setTxBufferSize(SERIAL_TX_BUFFER_BYTES);
     Serial.begin(SERIAL_BAUD_RATE);
+    logBegin();
     delay(1000);
 
     Serial.println("\n\n");
@@ -1304,10 +3548,12 @@ void setup() {
     Serial.println("========================================");
     Serial.println();
 
-    // Initialize SSR pin (SAFETY: Default to OFF)
-    pinMode(SSR_PIN, OUTPUT);
-    digitalWrite(SSR_PIN, LOW);
-    Serial.println("[SAFETY] SSR initialized to OFF state");
+    // Initialize SSR pins (SAFETY: Default to OFF)
+    for (int z = 0; z < KILN_ZONE_COUNT; z++) {
+        pinMode(zoneSsrPins[z], OUTPUT);
+        digitalWrite(zoneSsrPins[z], LOW);
+    }
+    Serial.printf("[SAFETY] %d SSR(s) initialized to OFF state\n", KILN_ZONE_COUNT);
 
     // Initialize status LEDs
     pinMode(LED_POWER_PIN, OUTPUT);
@@ -1343,22 +3589,52 @@ void setup() {
     // Initialize test state
     initTestState();
 
-    // Initialize PID controller
-    kilnPID.SetOutputLimits(0, 100);  // Output is 0-100%
-    kilnPID.SetSampleTime(PID_SAMPLE_TIME);  // 1000ms from config.h
-    kilnPID.SetMode(MANUAL);  // Start in manual mode (off)
+    // Tunables from NVS, before anything reads them
+    settingsBegin();
+    Kp = settings.kp;
+    Ki = settings.ki;
+    Kd = settings.kd;
+
+    // Initialize zone PID controllers: output 0-100%, 1000ms sample time, start off
+    for (int z = 0; z < KILN_ZONE_COUNT; z++) {
+        zones[z].controller.begin(Kp, Ki, Kd, 0, 100, PID_SAMPLE_TIME);
+    }
     pidOutput = 0;
     ssrWindowStartTime = millis();
-    Serial.println("[OK] PID controller initialized (Kp=5.0, Ki=0.5, Kd=1.0)");
+    Serial.printf("[OK] PID controller initialized (Kp=%.3f, Ki=%.4f, Kd=%.3f, %d zone(s))\n",
+                  Kp, Ki, Kd, KILN_ZONE_COUNT);
+
+#if ENABLE_SHADOW_CONTROLLER
+    shadowPID.begin(0, 100, PID_SAMPLE_TIME);
+    Serial.printf("[OK] Shadow controller armed (Kp=%.1f, Ki=%.1f, Kd=%.1f)\n",
+                  SHADOW_KP, SHADOW_KI, SHADOW_KD);
+#endif
 
     // Initialize SPI for shared bus (MAX31855 thermocouple uses software SPI)
     SPI.begin();
     Serial.println("[INFO] SPI bus initialized");
 
+    // Mount filesystem for firing logs
+    if (firingLogBegin()) {
+        Serial.println("[OK] LittleFS mounted (firing logs)");
+    }
+    stepAnalyzerReset(stepAnalyzer);
+    for (int z = 0; z < KILN_ZONE_COUNT; z++) {
+        tcSamplerReset(zones[z].sampler);
+        tcVoteReset(zones[z].vote);
+    }
+    heatWorkBegin();
+    predictorReset(0.0, millis());  // Prior model for the fault observer until a firing starts
+    elementHealthBegin();
+
     // Initialize thermocouple (software SPI)
     delay(500);  // Give MAX31855 time to stabilize
     Serial.println("[OK] MAX31855 thermocouple initialized (software SPI)");
 
+    // Ice-point calibration offset (see PLANNING.md) folded into the linearization table
+    tcLinearizeBegin(settings.tcOffset);
+    reportLinearization();
+
     // Initialize TFT display
     tft.init();
     tft.setRotation(1);  // Landscape mode (320x240)
@@ -1395,7 +3671,38 @@ void setup() {
     displayMainMenu();
 
     state.lastTempRead = millis();
-    state.lastDisplayUpdate = millis();
+#if ENABLE_PROFILER
+    profilerBegin(ESP.getCpuFreqMHz());
+    pidPeriod = profilerPeriod("pid", PID_SAMPLE_TIME * 1000UL);
+    tcRoundPeriod = profilerPeriod("tc_round", TC_SAMPLE_INTERVAL_MS * 1000UL);
+#endif
+    commandQueueInit(commandQueue);
+    uiLatencyReset(uiLatency);
+    sampleBusInit(sampleBus);
+    sampleCursorAttach(sampleBus, displayCursor, "display");
+    sampleCursorAttach(sampleBus, statusCursor, "status");
+    sampleCursorAttach(sampleBus, logCursor, "log");
+    sampleCursorAttach(sampleBus, telemetryCursor, "tlm");
+    sampleCursorAttach(sampleBus, shellCursor, "shell");
+    shellInit(shell, shellCommands, sizeof(shellCommands) / sizeof(shellCommands[0]));
+    startScheduler();
+
+    // Report how the last boot ended, then record this one
+    const char* jobNames[SCHED_MAX_JOBS];
+    for (int i = 0; i < scheduler.jobCount; i++) {
+        jobNames[i] = scheduler.jobs[i].name;
+    }
+    flightRecorderBegin(jobNames, scheduler.jobCount);
+    schedulerSetRunHook(scheduler, flightJobHook);
+
+    // Startup allocations are done; count everything from here on
+    memMonitorWatchTask(nullptr);   // loopTask
+    memMonitorWatchTask("IDLE0");
+    memMonitorWatchTask("IDLE1");
+    memMonitorWatchTask("esp_timer");
+    memMonitorWatchTask("log");
+    memMonitorPoll();
+    memMonitorArm(memMonitor);
 }
 
 // ============================================================================
@@ -1403,67 +3710,12 @@ void setup() {
 // ============================================================================
 
 void loop() {
-    unsigned long now = millis();
-
-    // Handle main menu
-    if (state.mode == MODE_MAIN_MENU) {
-        handleMainMenuInput();
-        delay(10);
-        return;
-    }
-
-    // Handle test mode
-    if (state.mode == MODE_TEST) {
-        handleTestModeInput();
-        delay(10);
-        return;
-    }
-
-    // Handle manual control mode
+    schedulerRunDue(scheduler);
+    flightHeartbeat();
 
-    // Read temperature (every 100ms)
-    if (now - state.lastTempRead >= 100) {
-        state.lastTempRead = now;
-
-        if (readTemperature()) {
-            // Update error LED based on sensor state
-            digitalWrite(LED_ERROR_PIN, LOW);
-        } else {
-            digitalWrite(LED_ERROR_PIN, HIGH);
-        }
-
-        // Update SSR control
-        updateSSRControl();
-
-        // Update heating LED
-        digitalWrite(LED_WIFI_PIN, state.heating ? HIGH : LOW);
-    }
-
-    // Update display (every 250ms)
-    if (now - state.lastDisplayUpdate >= 250) {
-        state.lastDisplayUpdate = now;
-        updateDisplay();
+    // Sleep until the next job is due; delay() yields, so the idle task runs
+    uint32_t idleMs = schedulerIdleMs(scheduler, INPUT_CHECK_INTERVAL_MS);
+    if (idleMs > 0) {
+        delay(idleMs);
     }
-
-    // Handle user input (every loop iteration with debouncing)
-    handleLeftEncoder();
-    handleRightEncoder();
-    checkEmergencyStop();
-
-    // Print status to serial (every 2 seconds)
-    static unsigned long lastSerialPrint = 0;
-    if (now - lastSerialPrint >= 2000) {
-        lastSerialPrint = now;
-
-        Serial.print("[STATUS] Mode: ");
-        Serial.print(state.mode == MODE_IDLE ? "IDLE" : "MANUAL");
-        Serial.print(" | Temp: ");
-        Serial.print(state.currentTemp);
-        Serial.print("°C | Target: ");
-        Serial.print(state.targetTemp);
-        Serial.print("°C | Heating: ");
-        Serial.println(state.heating ? "YES" : "NO");
-    }
-
-    delay(10);  // Small delay to prevent watchdog issues
 }
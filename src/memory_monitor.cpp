@@ -0,0 +1,232 @@
+/**
+ * Memory monitor
+ *
+ * memMonitor lives in zero-initialised static storage and has no
+ * constructor, so the wrappers are safe to call before C++ static
+ * initialisation has run: until memMonitorArm() they only pass through.
+ */
+
+#include <string.h>
+#include "memory_monitor.h"
+
+MemMonitor memMonitor;
+
+// ============================================================================
+// SETUP
+// ============================================================================
+
+void memMonitorInit(MemMonitor& m) {
+    m.armed.store(false, std::memory_order_relaxed);
+    m.allocs.store(0, std::memory_order_relaxed);
+    m.allocBytes.store(0, std::memory_order_relaxed);
+    m.frees.store(0, std::memory_order_relaxed);
+    m.untracked.store(0, std::memory_order_relaxed);
+    m.siteLock.clear(std::memory_order_relaxed);
+    memset(m.sites, 0, sizeof(m.sites));
+    m.siteCount = 0;
+    memset(&m.heap, 0, sizeof(m.heap));
+    memset(m.tasks, 0, sizeof(m.tasks));
+    m.taskCount = 0;
+}
+
+void memMonitorArm(MemMonitor& m) {
+    m.armed.store(true, std::memory_order_release);
+}
+
+int memMonitorAddTask(MemMonitor& m, const char* name, void* handle) {
+    if (handle == nullptr || m.taskCount >= MEM_MONITOR_TASKS) {
+        return -1;
+    }
+    MemTaskWatermark& t = m.tasks[m.taskCount];
+    t.name = name;
+    t.handle = handle;
+    t.minFreeBytes = UINT32_MAX;
+    return m.taskCount++;
+}
+
+// ============================================================================
+// ALLOCATION ACCOUNTING
+// ============================================================================
+
+bool memMonitorNoteAlloc(MemMonitor& m, size_t size, uint32_t pc, const char* tag) {
+    if (!m.armed.load(std::memory_order_acquire)) {
+        return false;
+    }
+    m.allocs.fetch_add(1, std::memory_order_relaxed);
+    m.allocBytes.fetch_add((uint32_t)size, std::memory_order_relaxed);
+
+    // Never wait here: the holder may be a lower-priority task
+    if (m.siteLock.test_and_set(std::memory_order_acquire)) {
+        m.untracked.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    MemAllocSite* site = nullptr;
+    for (int i = 0; i < m.siteCount; i++) {
+        if (m.sites[i].pc == pc && m.sites[i].tag == tag) {
+            site = &m.sites[i];
+            break;
+        }
+    }
+    if (site == nullptr && m.siteCount < MEM_MONITOR_SITES) {
+        site = &m.sites[m.siteCount++];
+        site->tag = tag;
+        site->pc = pc;
+    }
+    if (site != nullptr) {
+        site->count++;
+        site->bytes += (uint32_t)size;
+        if (size > site->largest) {
+            site->largest = (uint32_t)size;
+        }
+    } else {
+        m.untracked.fetch_add(1, std::memory_order_relaxed);
+    }
+    m.siteLock.clear(std::memory_order_release);
+    return true;
+}
+
+void memMonitorNoteFree(MemMonitor& m) {
+    if (m.armed.load(std::memory_order_relaxed)) {
+        m.frees.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+int memMonitorCopySites(MemMonitor& m, MemAllocSite* out, int max) {
+    while (m.siteLock.test_and_set(std::memory_order_acquire)) {
+        // Held for a few dozen instructions by an allocating task
+    }
+    int n = m.siteCount < max ? m.siteCount : max;
+    memcpy(out, m.sites, n * sizeof(MemAllocSite));
+    m.siteLock.clear(std::memory_order_release);
+    return n;
+}
+
+// ============================================================================
+// HEAP AND STACK POLLING
+// ============================================================================
+
+uint8_t memFragmentationPct(uint32_t freeBytes, uint32_t largestBlock) {
+    if (freeBytes == 0 || largestBlock >= freeBytes) {
+        return 0;
+    }
+    return (uint8_t)(100ULL * (freeBytes - largestBlock) / freeBytes);
+}
+
+void memMonitorSampleHeap(MemMonitor& m, uint32_t freeBytes, uint32_t largestBlock,
+                          uint32_t minEverFree) {
+    MemHeapStats& h = m.heap;
+    h.freeBytes = freeBytes;
+    h.largestBlock = largestBlock;
+    h.minEverFree = minEverFree;
+    if (h.samples == 0 || largestBlock < h.lowestLargest) {
+        h.lowestLargest = largestBlock;
+    }
+    h.fragmentationPct = memFragmentationPct(freeBytes, largestBlock);
+    if (h.fragmentationPct > h.worstFragmentationPct) {
+        h.worstFragmentationPct = h.fragmentationPct;
+    }
+    h.samples++;
+}
+
+void memMonitorSampleTask(MemMonitor& m, int index, uint32_t freeStackBytes) {
+    if (index < 0 || index >= m.taskCount) {
+        return;
+    }
+    if (freeStackBytes < m.tasks[index].minFreeBytes) {
+        m.tasks[index].minFreeBytes = freeStackBytes;
+    }
+}
+
+// ============================================================================
+// TARGET: ALLOCATOR WRAPPERS AND POLLING
+// ============================================================================
+
+#if defined(ARDUINO)
+
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static const char* volatile currentTag = nullptr;
+static void* volatile tagOwner = nullptr;
+
+MemTagScope::MemTagScope(const char* tag)
+    : _previous(currentTag), _previousOwner(tagOwner) {
+    tagOwner = xTaskGetCurrentTaskHandle();
+    currentTag = tag;
+}
+
+MemTagScope::~MemTagScope() {
+    currentTag = _previous;
+    tagOwner = _previousOwner;
+}
+
+/**
+ * Caller PC as addr2line expects it
+ * Windowed-ABI return addresses carry the call size in the top two bits.
+ */
+static inline uint32_t callerPc(void* ret) {
+    return ((uint32_t)(uintptr_t)ret & 0x3FFFFFFFUL) | 0x40000000UL;
+}
+
+static inline void noteAlloc(size_t size, void* ret) {
+    if (!memMonitor.armed.load(std::memory_order_relaxed)) {
+        return;  // Also covers allocations made before the scheduler starts
+    }
+    const char* tag = (tagOwner == xTaskGetCurrentTaskHandle()) ? currentTag : nullptr;
+    if (memMonitorNoteAlloc(memMonitor, size, callerPc(ret), tag) && ENABLE_ALLOC_TRAP) {
+        abort();  // The panic backtrace names the allocating call
+    }
+}
+
+extern "C" {
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t n, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+
+void* __wrap_malloc(size_t size) {
+    noteAlloc(size, __builtin_return_address(0));
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t n, size_t size) {
+    noteAlloc(n * size, __builtin_return_address(0));
+    return __real_calloc(n, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    if (size > 0) {
+        noteAlloc(size, __builtin_return_address(0));
+    }
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void* ptr) {
+    if (ptr != nullptr) {
+        memMonitorNoteFree(memMonitor);
+    }
+    __real_free(ptr);
+}
+
+}  // extern "C"
+
+int memMonitorWatchTask(const char* name) {
+    TaskHandle_t handle = name ? xTaskGetHandle(name) : xTaskGetCurrentTaskHandle();
+    return memMonitorAddTask(memMonitor, name ? name : pcTaskGetName(handle), handle);
+}
+
+void memMonitorPoll() {
+    memMonitorSampleHeap(memMonitor, ESP.getFreeHeap(),
+                         heap_caps_get_largest_free_block(MALLOC_CAP_8BIT),
+                         ESP.getMinFreeHeap());
+    for (int i = 0; i < memMonitor.taskCount; i++) {
+        // ESP-IDF counts stack in bytes
+        memMonitorSampleTask(memMonitor, i,
+                             uxTaskGetStackHighWaterMark((TaskHandle_t)memMonitor.tasks[i].handle));
+    }
+}
+
+#endif // ARDUINO
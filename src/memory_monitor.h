@@ -0,0 +1,152 @@
+#ifndef MEMORY_MONITOR_H
+#define MEMORY_MONITOR_H
+
+// Memory monitor
+// The production firmware is meant to allocate only during startup
+// (PLANNING.md). This checks it:
+//   - malloc/calloc/realloc/free are wrapped at link time
+//     (-Wl,--wrap=..., platformio.ini). Once memMonitorArm() is called at
+//     the end of setup(), every allocation is counted per call site. A call
+//     site is the caller's PC (decode with xtensa-esp32-elf-addr2line)
+//     plus the MEM_TAG() scope active on the tagging task, if any. With
+//     ENABLE_ALLOC_TRAP the first post-init allocation aborts instead, so
+//     the panic backtrace points at it.
+//   - A periodic poll records free heap, largest free block, the minimum
+//     free heap since boot, fragmentation (1 - largest / free) and the
+//     stack high-water mark of each watched task.
+//
+// Framework code that calls heap_caps_malloc() or newlib's _malloc_r()
+// directly bypasses the wrappers; those allocations still show in the heap
+// poll.
+//
+// The wrappers run on any task and must neither block nor allocate. Totals
+// are atomic counters. The site table sits behind a try-lock, and an
+// allocation that finds it busy is only counted in the totals (untracked).
+//
+// The bookkeeping is plain C++ so it runs on host; the wrappers and the
+// heap/stack polling are target-only.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include "config.h"
+
+struct MemAllocSite {
+    const char* tag;            // MEM_TAG() scope, nullptr if none
+    uint32_t pc;                // Caller of malloc/calloc/realloc
+    uint32_t count;
+    uint32_t bytes;
+    uint32_t largest;
+};
+
+struct MemTaskWatermark {
+    const char* name;
+    void* handle;               // TaskHandle_t on target
+    uint32_t minFreeBytes;      // Least stack ever left unused
+};
+
+struct MemHeapStats {
+    uint32_t samples;
+    uint32_t freeBytes;         // Latest poll
+    uint32_t largestBlock;
+    uint32_t minEverFree;       // Allocator's own low-water mark
+    uint32_t lowestLargest;     // Smallest largest-block seen
+    uint8_t fragmentationPct;
+    uint8_t worstFragmentationPct;
+};
+
+struct MemMonitor {
+    std::atomic<bool> armed;
+    std::atomic<uint32_t> allocs;       // After arming
+    std::atomic<uint32_t> allocBytes;
+    std::atomic<uint32_t> frees;
+    std::atomic<uint32_t> untracked;    // Site table busy or full
+    std::atomic_flag siteLock;
+    MemAllocSite sites[MEM_MONITOR_SITES];
+    uint8_t siteCount;                  // Guarded by siteLock
+    MemHeapStats heap;
+    MemTaskWatermark tasks[MEM_MONITOR_TASKS];
+    uint8_t taskCount;
+};
+
+extern MemMonitor memMonitor;
+
+void memMonitorInit(MemMonitor& m);
+
+/**
+ * Startup is over: count allocations from here on
+ */
+void memMonitorArm(MemMonitor& m);
+
+/**
+ * Count one allocation (allocator wrappers; any task)
+ *
+ * @return True if it happened after memMonitorArm()
+ */
+bool memMonitorNoteAlloc(MemMonitor& m, size_t size, uint32_t pc, const char* tag);
+
+void memMonitorNoteFree(MemMonitor& m);
+
+/**
+ * Record one heap poll
+ */
+void memMonitorSampleHeap(MemMonitor& m, uint32_t freeBytes, uint32_t largestBlock,
+                          uint32_t minEverFree);
+
+/**
+ * Watch a task's stack (handle is a TaskHandle_t on target)
+ *
+ * @return Index, or -1 if MEM_MONITOR_TASKS are watched or handle is null
+ */
+int memMonitorAddTask(MemMonitor& m, const char* name, void* handle);
+
+void memMonitorSampleTask(MemMonitor& m, int index, uint32_t freeStackBytes);
+
+/**
+ * Consistent copy of the site table (reporting task)
+ *
+ * @return Sites copied
+ */
+int memMonitorCopySites(MemMonitor& m, MemAllocSite* out, int max);
+
+/**
+ * Share of free heap outside the largest block, 0-100
+ */
+uint8_t memFragmentationPct(uint32_t freeBytes, uint32_t largestBlock);
+
+#if defined(ARDUINO)
+
+/**
+ * Watch a task by FreeRTOS name (nullptr: the calling task)
+ */
+int memMonitorWatchTask(const char* name);
+
+/**
+ * Sample the heap and every watched task's stack high-water mark
+ */
+void memMonitorPoll();
+
+/**
+ * Tag allocations the current task makes while the scope is alive
+ */
+class MemTagScope {
+public:
+    explicit MemTagScope(const char* tag);
+    ~MemTagScope();
+
+private:
+    const char* _previous;
+    void* _previousOwner;
+};
+
+#define MEM_TAG_CONCAT_(a, b) a##b
+#define MEM_TAG_CONCAT(a, b) MEM_TAG_CONCAT_(a, b)
+#define MEM_TAG(name) MemTagScope MEM_TAG_CONCAT(_memTag, __LINE__)(name)
+
+#else
+
+#define MEM_TAG(name) do {} while (0)
+
+#endif // ARDUINO
+
+#endif // MEMORY_MONITOR_H
@@ -0,0 +1,130 @@
+/**
+ * Thermocouple noise spectrum
+ *
+ * Iterative Cooley-Tukey: bit-reversal permutation, then log2(N) butterfly
+ * passes using a twiddle table built on first use. The imaginary workspace
+ * is a static buffer, so analyzing a burst needs only the caller's samples.
+ */
+
+#include <math.h>
+#include "noise_spectrum.h"
+
+#if (NOISE_FFT_SIZE & (NOISE_FFT_SIZE - 1)) != 0
+#error "NOISE_FFT_SIZE must be a power of two"
+#endif
+
+static float twiddleCos[NOISE_FFT_SIZE / 2];
+static float twiddleSin[NOISE_FFT_SIZE / 2];
+static bool twiddlesReady = false;
+
+static float imagWork[NOISE_FFT_SIZE];
+
+static void buildTwiddles() {
+    for (int k = 0; k < NOISE_FFT_SIZE / 2; k++) {
+        float angle = -2.0f * (float)M_PI * k / NOISE_FFT_SIZE;
+        twiddleCos[k] = cosf(angle);
+        twiddleSin[k] = sinf(angle);
+    }
+    twiddlesReady = true;
+}
+
+// ============================================================================
+// FFT
+// ============================================================================
+
+void noiseFft(float* re, float* im) {
+    const int n = NOISE_FFT_SIZE;
+    if (!twiddlesReady) {
+        buildTwiddles();
+    }
+
+    // Bit-reversal permutation
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            float t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    // Butterflies
+    for (int len = 2; len <= n; len <<= 1) {
+        int half = len >> 1;
+        int stride = n / len;
+        for (int start = 0; start < n; start += len) {
+            for (int k = 0; k < half; k++) {
+                float wr = twiddleCos[k * stride];
+                float wi = twiddleSin[k * stride];
+                int a = start + k;
+                int b = a + half;
+                float xr = re[b] * wr - im[b] * wi;
+                float xi = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - xr;
+                im[b] = im[a] - xi;
+                re[a] += xr;
+                im[a] += xi;
+            }
+        }
+    }
+}
+
+// ============================================================================
+// ANALYSIS
+// ============================================================================
+
+void noiseSpectrumAnalyze(float* samples, float sampleRateHz, NoiseSpectrum& out) {
+    const int n = NOISE_FFT_SIZE;
+    out.sampleRateHz = sampleRateHz;
+
+    // Mean and variance (two-pass, burst is small)
+    float sum = 0.0f;
+    for (int i = 0; i < n; i++) {
+        sum += samples[i];
+    }
+    out.mean = sum / n;
+    float sq = 0.0f;
+    for (int i = 0; i < n; i++) {
+        float d = samples[i] - out.mean;
+        sq += d * d;
+    }
+    out.variance = sq / (n - 1);
+
+    // Remove the mean and apply a Hann window so drift doesn't leak across bins
+    float windowPower = 0.0f;
+    for (int i = 0; i < n; i++) {
+        float w = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / n);
+        samples[i] = (samples[i] - out.mean) * w;
+        imagWork[i] = 0.0f;
+        windowPower += w * w;
+    }
+
+    noiseFft(samples, imagWork);
+
+    // One-sided power, scaled so the bins sum to the variance (Parseval)
+    float scale = 1.0f / (n * windowPower);
+    for (int k = 0; k < NOISE_SPECTRUM_BINS; k++) {
+        float p = (samples[k] * samples[k] + imagWork[k] * imagWork[k]) * scale;
+        out.power[k] = (k == 0 || k == n / 2) ? p : 2.0f * p;
+    }
+
+    // Strongest non-DC bins
+    for (int p = 0; p < NOISE_SPECTRUM_PEAKS; p++) {
+        out.peaks[p] = {0, 0.0f, 0.0f};
+    }
+    for (int k = 1; k < NOISE_SPECTRUM_BINS; k++) {
+        float pw = out.power[k];
+        for (int p = 0; p < NOISE_SPECTRUM_PEAKS; p++) {
+            if (pw > out.peaks[p].power) {
+                for (int q = NOISE_SPECTRUM_PEAKS - 1; q > p; q--) {
+                    out.peaks[q] = out.peaks[q - 1];
+                }
+                out.peaks[p] = {k, k * sampleRateHz / n, pw};
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef NOISE_SPECTRUM_H
+#define NOISE_SPECTRUM_H
+
+// Thermocouple noise spectrum
+// Variance and Hann-windowed power spectrum of a fixed-size sample burst,
+// computed with an in-place radix-2 FFT over static buffers (no allocation).
+// The one-sided spectrum is scaled so its bins sum to the burst variance.
+//
+// Pure C++ with no Arduino dependencies so the kernel can be benchmarked on host.
+
+#include <stdint.h>
+#include "config.h"
+
+#define NOISE_SPECTRUM_BINS  (NOISE_FFT_SIZE / 2 + 1)
+
+struct NoisePeak {
+    int bin;
+    float freqHz;
+    float power;            // °C² in this bin
+};
+
+struct NoiseSpectrum {
+    float sampleRateHz;
+    float mean;             // °C
+    float variance;         // °C², from the raw (unwindowed) burst
+    float power[NOISE_SPECTRUM_BINS];   // °C² per bin, DC .. Nyquist
+    NoisePeak peaks[NOISE_SPECTRUM_PEAKS];  // Strongest non-DC bins, descending
+};
+
+/**
+ * In-place complex radix-2 FFT of NOISE_FFT_SIZE points
+ */
+void noiseFft(float* re, float* im);
+
+/**
+ * Analyze one burst
+ *
+ * @param samples NOISE_FFT_SIZE readings (°C), consumed as FFT workspace
+ * @param sampleRateHz Burst sample rate
+ */
+void noiseSpectrumAnalyze(float* samples, float sampleRateHz, NoiseSpectrum& out);
+
+#endif // NOISE_SPECTRUM_H
@@ -0,0 +1,229 @@
+/**
+ * Firing profile engine
+ *
+ * Simple ramp/soak state machine. Each segment ramps the setpoint toward its
+ * target at the programmed rate, waits for the kiln to arrive, then soaks.
+ * The PID loop tracks whatever setpoint profileUpdate() returns.
+ */
+
+#define LOG_MODULE LOG_MOD_PROFILE
+
+#include <math.h>
+#include "profile.h"
+#include "async_log.h"
+#include "heat_work.h"
+
+ProfileRunner profileRunner = {
+    .profile = nullptr,
+    .state = PROFILE_IDLE,
+    .segment = 0,
+    .segmentCone = -1,
+    .setpoint = 0.0,
+    .rampStartTemp = 0.0,
+    .firingStartTime = 0,
+    .segmentStartTime = 0,
+    .soakStartTime = 0,
+    .soakHeatOnMs = 0,
+    .lastUpdate = 0,
+    .minutesSaved = 0,
+    .kwhSaved = 0.0
+};
+
+// Pre-loaded profiles (see README "Pre-Loaded Profiles")
+// Final soaks may end early on the ware estimate or on heat-work; intermediate holds are
+// process steps and never do. A segment that ends on a cone takes its target from the cone
+// chart at its own ramp rate (ortonCones is constant-initialized, so it is ready before
+// this table is built).
+const FiringProfile builtinProfiles[] = {
+    {"Bisque Cone 04", 3, {
+        {50.0,  100.0,  60, false, nullptr},   // Water smoking
+        {100.0, 500.0,  30, false, nullptr},   // Organic burnout
+        {150.0, heatWorkConeTemp("04", 150.0), 15, true, "04"}    // Final bisque temperature
+    }},
+    {"Glaze Cone 6", 3, {
+        {100.0, 120.0,  30, false, nullptr},   // Dry out
+        {150.0, 1100.0, 0,  false, nullptr},   // Fast climb
+        {60.0,  heatWorkConeTemp("6", 60.0), 15, true, "6"}       // Slow finish + hold
+    }},
+    {"Raku", 1, {
+        {300.0, 900.0,  10, true,  nullptr}
+    }}
+};
+const int numBuiltinProfiles = sizeof(builtinProfiles) / sizeof(builtinProfiles[0]);
+
+// ============================================================================
+// INTERNAL HELPERS
+// ============================================================================
+
+static void beginSegment(uint8_t index, float fromTemp, unsigned long now) {
+    profileRunner.segment = index;
+    profileRunner.state = PROFILE_RAMPING;
+    profileRunner.rampStartTemp = fromTemp;
+    profileRunner.setpoint = fromTemp;
+    profileRunner.segmentStartTime = now;
+    profileRunner.soakHeatOnMs = 0;
+
+    const ProfileSegment& seg = profileRunner.profile->segments[index];
+    profileRunner.segmentCone = seg.soakEndCone ? heatWorkFindCone(seg.soakEndCone) : -1;
+    DEBUG_PRINTF("[PROFILE] Segment %d/%d: %.0f C/h to %.0f C, soak %u min\n",
+                 index + 1, profileRunner.profile->numSegments,
+                 seg.rampRate, seg.targetTemp, seg.soakMinutes);
+}
+
+static void nextSegment(unsigned long now) {
+    uint8_t next = profileRunner.segment + 1;
+    if (next >= profileRunner.profile->numSegments) {
+        profileRunner.state = PROFILE_COMPLETE;
+        profileRunner.setpoint = 0.0;
+        DEBUG_PRINTF("[PROFILE] Complete after %.1f h (soak skipped: %lu min, ~%.2f kWh)\n",
+                     (now - profileRunner.firingStartTime) / 3600000.0,
+                     profileRunner.minutesSaved, profileRunner.kwhSaved);
+        return;
+    }
+    beginSegment(next, profileRunner.profile->segments[profileRunner.segment].targetTemp, now);
+}
+
+// ============================================================================
+// PROFILE ENGINE API
+// ============================================================================
+
+void profileStart(const FiringProfile* profile, float currentTemp, unsigned long now) {
+    if (profile == nullptr || profile->numSegments == 0) {
+        return;
+    }
+    profileRunner.profile = profile;
+    profileRunner.firingStartTime = now;
+    profileRunner.lastUpdate = now;
+    profileRunner.minutesSaved = 0;
+    profileRunner.kwhSaved = 0.0;
+
+    DEBUG_PRINT("[PROFILE] Starting: ");
+    DEBUG_PRINTLN(profile->name);
+    beginSegment(0, currentTemp, now);
+}
+
+void profileStop() {
+    if (profileIsRunning() || profileIsPaused()) {
+        DEBUG_PRINTLN("[PROFILE] Aborted");
+        profileRunner.state = PROFILE_ABORTED;
+    }
+    profileRunner.setpoint = 0.0;
+}
+
+void profilePause(unsigned long now) {
+    if (!profileIsRunning()) {
+        return;
+    }
+    DEBUG_PRINTF("[PROFILE] Paused in segment %d after %.1f h\n", profileRunner.segment + 1,
+                 (now - profileRunner.firingStartTime) / 3600000.0);
+    profileRunner.state = PROFILE_PAUSED;
+    profileRunner.setpoint = 0.0;
+}
+
+void profileResume(float currentTemp, unsigned long now) {
+    if (profileRunner.state != PROFILE_PAUSED) {
+        return;
+    }
+    DEBUG_PRINTLN("[PROFILE] Resumed");
+    profileRunner.lastUpdate = now;
+    beginSegment(profileRunner.segment, currentTemp, now);
+}
+
+float profileUpdate(float currentTemp, bool heating, unsigned long now) {
+    unsigned long dt = now - profileRunner.lastUpdate;
+    profileRunner.lastUpdate = now;
+
+    if (!profileIsRunning()) {
+        return 0.0;
+    }
+
+    const ProfileSegment& seg = profileRunner.profile->segments[profileRunner.segment];
+
+    if (profileRunner.state == PROFILE_RAMPING) {
+        if (seg.rampRate <= 0.0) {
+            // Full power: jump straight to target
+            profileRunner.setpoint = seg.targetTemp;
+        } else {
+            float elapsedHours = (now - profileRunner.segmentStartTime) / 3600000.0;
+            float delta = seg.rampRate * elapsedHours;
+            if (seg.targetTemp >= profileRunner.rampStartTemp) {
+                profileRunner.setpoint = fminf(profileRunner.rampStartTemp + delta, seg.targetTemp);
+            } else {
+                profileRunner.setpoint = fmaxf(profileRunner.rampStartTemp - delta, seg.targetTemp);
+            }
+        }
+
+        // Soak starts once the setpoint has arrived and the kiln has caught up
+        if (profileRunner.setpoint == seg.targetTemp &&
+            fabs(currentTemp - seg.targetTemp) <= PROFILE_AT_TARGET_TOLERANCE) {
+            profileRunner.state = PROFILE_SOAKING;
+            profileRunner.soakStartTime = now;
+            profileRunner.soakHeatOnMs = 0;
+            DEBUG_PRINTF("[PROFILE] Soaking at %.0f C\n", seg.targetTemp);
+        }
+    }
+
+    if (profileRunner.state == PROFILE_SOAKING) {
+        profileRunner.setpoint = seg.targetTemp;
+        if (heating) {
+            profileRunner.soakHeatOnMs += dt;
+        }
+        if (now - profileRunner.soakStartTime >= seg.soakMinutes * 60000UL) {
+            nextSegment(now);
+        }
+    }
+
+    return profileRunner.setpoint;
+}
+
+void profileEndSoak(unsigned long now, float wattage, const char* reason) {
+    if (profileRunner.state != PROFILE_SOAKING) {
+        return;
+    }
+
+    const ProfileSegment& seg = profileRunner.profile->segments[profileRunner.segment];
+    unsigned long soakMs = now - profileRunner.soakStartTime;
+    unsigned long programmedMs = seg.soakMinutes * 60000UL;
+
+    if (soakMs < programmedMs) {
+        // Energy saved: remaining soak time at the duty cycle observed so far in this soak
+        unsigned long remainingMs = programmedMs - soakMs;
+        float duty = soakMs > 0 ? (float)profileRunner.soakHeatOnMs / soakMs : 0.0;
+        float kwh = wattage * duty * (remainingMs / 3600000.0) / 1000.0;
+
+        profileRunner.minutesSaved += remainingMs / 60000UL;
+        profileRunner.kwhSaved += kwh;
+
+        DEBUG_PRINTF("[PROFILE] Soak ended early (%s): %lu min, ~%.3f kWh saved\n",
+                     reason, remainingMs / 60000UL, kwh);
+    }
+
+    nextSegment(now);
+}
+
+bool profileIsRunning() {
+    return profileRunner.state == PROFILE_RAMPING || profileRunner.state == PROFILE_SOAKING;
+}
+
+bool profileIsPaused() {
+    return profileRunner.state == PROFILE_PAUSED;
+}
+
+const ProfileSegment* profileCurrentSegment() {
+    if (profileRunner.profile == nullptr) {
+        return nullptr;
+    }
+    return &profileRunner.profile->segments[profileRunner.segment];
+}
+
+const char* profileStateName(ProfileState s) {
+    switch (s) {
+        case PROFILE_IDLE:     return "IDLE";
+        case PROFILE_RAMPING:  return "RAMP";
+        case PROFILE_SOAKING:  return "SOAK";
+        case PROFILE_PAUSED:   return "PAUSE";
+        case PROFILE_COMPLETE: return "DONE";
+        case PROFILE_ABORTED:  return "ABORT";
+    }
+    return "?";
+}
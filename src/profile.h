@@ -0,0 +1,108 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+// Firing profile engine
+// Turns a list of ramp/soak segments into a moving setpoint for the PID loop.
+
+#include <stdint.h>
+#include "config.h"
+
+// ============================================================================
+// DATA STRUCTURES
+// ============================================================================
+
+struct ProfileSegment {
+    float rampRate;         // °C/hour (0 = full power, jump straight to target)
+    float targetTemp;       // Segment target (°C)
+    uint16_t soakMinutes;   // Hold time at target (minutes)
+    bool soakEndOnWare;     // End soak early once the estimated ware temp is soaked
+    const char* soakEndCone;// End soak once heat-work reaches this Orton cone (nullptr = off)
+};
+
+struct FiringProfile {
+    const char* name;
+    uint8_t numSegments;
+    ProfileSegment segments[PROFILE_MAX_SEGMENTS];
+};
+
+enum ProfileState {
+    PROFILE_IDLE,       // No firing in progress
+    PROFILE_RAMPING,    // Setpoint moving toward segment target
+    PROFILE_SOAKING,    // Holding at segment target
+    PROFILE_PAUSED,     // Heating suspended (e.g. lid open), resumable
+    PROFILE_COMPLETE,   // All segments finished
+    PROFILE_ABORTED     // Stopped by user or safety
+};
+
+struct ProfileRunner {
+    const FiringProfile* profile;
+    ProfileState state;
+    uint8_t segment;                // Current segment index
+    int segmentCone;                // Resolved soakEndCone index (-1 = off)
+    float setpoint;                 // Current commanded setpoint (°C)
+    float rampStartTemp;            // Setpoint at start of current ramp (°C)
+    unsigned long firingStartTime;
+    unsigned long segmentStartTime; // Start of current ramp
+    unsigned long soakStartTime;    // Start of current soak
+    unsigned long soakHeatOnMs;     // SSR on-time accumulated during the current soak
+    unsigned long lastUpdate;
+    unsigned long minutesSaved;     // Soak time skipped by early termination (this firing)
+    float kwhSaved;                 // Estimated energy saved by early termination (this firing)
+};
+
+extern ProfileRunner profileRunner;
+
+extern const FiringProfile builtinProfiles[];
+extern const int numBuiltinProfiles;
+
+// ============================================================================
+// PROFILE ENGINE API
+// ============================================================================
+
+/**
+ * Start running a profile from the current kiln temperature
+ */
+void profileStart(const FiringProfile* profile, float currentTemp, unsigned long now);
+
+/**
+ * Abort the running profile (setpoint drops to 0)
+ */
+void profileStop();
+
+/**
+ * Suspend heating without abandoning the firing (setpoint drops to 0)
+ */
+void profilePause(unsigned long now);
+
+/**
+ * Continue a paused firing
+ * The current segment's ramp restarts from the measured temperature, so a
+ * soak that was interrupted runs its full time again once back at target.
+ */
+void profileResume(float currentTemp, unsigned long now);
+
+/**
+ * Advance the profile state machine
+ *
+ * @param currentTemp Measured kiln temperature (°C)
+ * @param heating True if the SSR is currently on (used for soak energy accounting)
+ * @param now Current time (ms)
+ * @return Setpoint to feed the PID controller (°C)
+ */
+float profileUpdate(float currentTemp, bool heating, unsigned long now);
+
+/**
+ * End the current soak before its programmed time
+ * Records the skipped minutes and estimated kWh saved for the firing summary.
+ *
+ * @param wattage Kiln element wattage used for the energy estimate
+ * @param reason Short tag printed to serial (e.g. "ware")
+ */
+void profileEndSoak(unsigned long now, float wattage, const char* reason);
+
+bool profileIsRunning();
+bool profileIsPaused();
+const ProfileSegment* profileCurrentSegment();
+const char* profileStateName(ProfileState s);
+
+#endif // PROFILE_H
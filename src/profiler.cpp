@@ -0,0 +1,227 @@
+/**
+ * Hot-path profiler
+ *
+ * Histogram bucket of a count c:
+ *   c < 2     -> c
+ *   otherwise -> 2 * msb(c) + (bit below the msb)
+ * Each power of two therefore splits into two buckets, and bucket b >= 2
+ * covers [(2 + b % 2) << (b / 2 - 1), (3 + b % 2) << (b / 2 - 1)).
+ * Percentiles report the bucket's upper edge, a conservative value.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "profiler.h"
+
+#if ENABLE_PROFILER
+
+Profiler profiler;
+
+static inline int bucketOf(uint32_t c) {
+    if (c < 2) {
+        return (int)c;
+    }
+    int msb = 31 - __builtin_clz(c);
+    return 2 * msb + (int)((c >> (msb - 1)) & 1);
+}
+
+static inline uint64_t bucketUpper(int b) {
+    if (b < 2) {
+        return (uint64_t)b + 1;
+    }
+    int shift = b / 2 - 1;
+    return (uint64_t)(3 + b % 2) << shift;
+}
+
+static int percentileBucket(const uint32_t* histogram, uint32_t count, float percentile) {
+    uint32_t rank = (uint32_t)(count * percentile / 100.0f);
+    uint32_t seen = 0;
+    for (int b = 0; b < PROFILER_BUCKETS; b++) {
+        seen += histogram[b];
+        if (seen > rank) {
+            return b;
+        }
+    }
+    return PROFILER_BUCKETS - 1;
+}
+
+// ============================================================================
+// SETUP
+// ============================================================================
+
+void profilerBegin(uint32_t cyclesPerUs) {
+    memset(&profiler, 0, sizeof(profiler));
+    profiler.cyclesPerUs = cyclesPerUs ? cyclesPerUs : 1;
+}
+
+void profilerReset() {
+    for (int i = 0; i < profiler.zoneCount; i++) {
+        const char* name = profiler.zones[i].name;
+        memset(&profiler.zones[i], 0, sizeof(ProfZoneStats));
+        profiler.zones[i].name = name;
+    }
+    for (int i = 0; i < profiler.periodCount; i++) {
+        ProfPeriodStats& p = profiler.periods[i];
+        const char* name = p.name;
+        uint32_t nominal = p.nominalUs;
+        memset(&p, 0, sizeof(ProfPeriodStats));
+        p.name = name;
+        p.nominalUs = nominal;
+    }
+    profiler.traceCount = 0;
+}
+
+int profilerZone(const char* name) {
+    for (int i = 0; i < profiler.zoneCount; i++) {
+        if (strcmp(profiler.zones[i].name, name) == 0) {
+            return i;
+        }
+    }
+    if (profiler.zoneCount >= PROFILER_MAX_ZONES) {
+        return -1;
+    }
+    profiler.zones[profiler.zoneCount].name = name;
+    return profiler.zoneCount++;
+}
+
+int profilerPeriod(const char* name, uint32_t nominalUs) {
+    if (profiler.periodCount >= PROFILER_MAX_PERIODS) {
+        return -1;
+    }
+    ProfPeriodStats& p = profiler.periods[profiler.periodCount];
+    p.name = name;
+    p.nominalUs = nominalUs;
+    return profiler.periodCount++;
+}
+
+// ============================================================================
+// RECORDING
+// ============================================================================
+
+void profilerRecord(int zone, uint32_t startCycles, uint32_t endCycles) {
+    if (zone < 0) {
+        return;
+    }
+    uint32_t cycles = endCycles - startCycles;
+
+    ProfZoneStats& z = profiler.zones[zone];
+    z.count++;
+    z.totalCycles += cycles;
+    if (cycles > z.maxCycles) {
+        z.maxCycles = cycles;
+    }
+    z.histogram[bucketOf(cycles)]++;
+
+    // Extend the 32-bit counter (wraps every ~18 s at 240 MHz; zones run far
+    // more often than that)
+    if (endCycles < profiler.lastCycles) {
+        profiler.cycleEpoch += 1ULL << 32;
+    }
+    profiler.lastCycles = endCycles;
+
+    ProfTraceEvent& e = profiler.trace[profiler.traceCount % PROFILER_TRACE_EVENTS];
+    e.startCycles = profiler.cycleEpoch + endCycles - cycles;
+    e.cycles = cycles;
+    e.zone = (uint8_t)zone;
+    profiler.traceCount++;
+}
+
+void profilerPeriodMark(int period, uint64_t nowUs) {
+    if (period < 0) {
+        return;
+    }
+    ProfPeriodStats& p = profiler.periods[period];
+    if (p.started) {
+        uint64_t interval = nowUs - p.lastUs;
+        uint32_t jitter = (uint32_t)(interval > p.nominalUs ? interval - p.nominalUs
+                                                            : p.nominalUs - interval);
+        p.count++;
+        p.totalUs += interval;
+        if (jitter > p.maxJitterUs) {
+            p.maxJitterUs = jitter;
+        }
+        p.histogram[bucketOf(jitter)]++;
+    }
+    p.lastUs = nowUs;
+    p.started = true;
+}
+
+// ============================================================================
+// REPORTING
+// ============================================================================
+
+float profilerZonePercentileUs(const ProfZoneStats& z, float percentile) {
+    if (z.count == 0) {
+        return 0.0f;
+    }
+    int b = percentileBucket(z.histogram, z.count, percentile);
+    uint64_t upper = bucketUpper(b);
+    if (upper > z.maxCycles) {
+        upper = z.maxCycles;  // The top bucket's edge can overshoot the real max
+    }
+    return (float)upper / profiler.cyclesPerUs;
+}
+
+uint32_t profilerPeriodPercentileUs(const ProfPeriodStats& p, float percentile) {
+    if (p.count == 0) {
+        return 0;
+    }
+    uint64_t upper = bucketUpper(percentileBucket(p.histogram, p.count, percentile));
+    return (uint32_t)(upper < p.maxJitterUs ? upper : p.maxJitterUs);
+}
+
+enum {
+    TRACE_HEADER,
+    TRACE_EVENTS,
+    TRACE_FOOTER,
+    TRACE_DONE
+};
+
+void profilerTraceBegin(ProfTraceCursor& c) {
+    c.end = profiler.traceCount;
+    c.next = c.end > PROFILER_TRACE_EVENTS ? c.end - PROFILER_TRACE_EVENTS : 0;
+    c.lost = 0;
+    c.stage = TRACE_HEADER;
+}
+
+int profilerTraceNext(ProfTraceCursor& c, char* buf, int size) {
+    switch (c.stage) {
+        case TRACE_HEADER:
+            c.stage = TRACE_EVENTS;
+            return snprintf(buf, size, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+        case TRACE_EVENTS: {
+            // Oldest event still in the ring
+            uint32_t oldest = profiler.traceCount > PROFILER_TRACE_EVENTS
+                                  ? profiler.traceCount - PROFILER_TRACE_EVENTS : 0;
+            if (c.next < oldest) {
+                uint32_t skip = (oldest < c.end ? oldest : c.end) - c.next;
+                c.lost += skip;
+                c.next += skip;
+            }
+            if (c.next < c.end) {
+                const ProfTraceEvent& e = profiler.trace[c.next % PROFILER_TRACE_EVENTS];
+                c.next++;
+                return snprintf(buf, size,
+                                "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+                                "\"ts\":%.3f,\"dur\":%.3f},\n",
+                                profiler.zones[e.zone].name,
+                                (double)e.startCycles / profiler.cyclesPerUs,
+                                (double)e.cycles / profiler.cyclesPerUs);
+            }
+            c.stage = TRACE_FOOTER;
+        }
+            // Fall through
+        case TRACE_FOOTER:
+            // Every event line ends in a comma, so the list closes with metadata
+            c.stage = TRACE_DONE;
+            return snprintf(buf, size,
+                            "{\"name\":\"lost_events\",\"ph\":\"M\",\"pid\":1,"
+                            "\"args\":{\"count\":%lu}}]}\n", (unsigned long)c.lost);
+
+        default:
+            return 0;
+    }
+}
+
+#endif // ENABLE_PROFILER
@@ -0,0 +1,165 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Hot-path profiler
+// PROFILE_ZONE("name") at the top of a block times the block with the CPU
+// cycle counter. The zone's id is registered once, on the first pass. Each
+// zone keeps a fixed log-bucket histogram (two buckets per power of two;
+// percentiles are reported as the bucket's upper edge, at most 1.5x the
+// true value), plus count, total and max. The last
+// PROFILER_TRACE_EVENTS scopes also go into a ring that can be dumped as a
+// Chrome trace (chrome://tracing, ui.perfetto.dev). Period trackers record
+// how far a repeating event (a PID compute, a read round) lands from its
+// nominal period: the control-period jitter.
+//
+// A zone costs two cycle-counter reads, one histogram increment and one
+// ring write. With ENABLE_PROFILER false, PROFILE_ZONE compiles to nothing.
+// Everything here runs in the main loop task only.
+//
+// Cycle counts come from profilerCycles() (ESP.getCycleCount() on target,
+// nanoseconds on host) and are converted with the rate given to
+// profilerBegin(). The recording core is plain C++ so it runs on host.
+
+#include <stdint.h>
+#include "config.h"
+
+#define PROFILER_BUCKETS 64     // Two per octave of a 32-bit count
+
+struct ProfZoneStats {
+    const char* name;
+    uint32_t count;
+    uint64_t totalCycles;
+    uint32_t maxCycles;
+    uint32_t histogram[PROFILER_BUCKETS];
+};
+
+struct ProfPeriodStats {
+    const char* name;
+    uint32_t nominalUs;
+    uint64_t lastUs;
+    bool started;
+    uint32_t count;             // Intervals measured
+    uint64_t totalUs;
+    uint32_t maxJitterUs;       // Largest |interval - nominal|
+    uint32_t histogram[PROFILER_BUCKETS];  // |interval - nominal| in µs
+};
+
+struct ProfTraceEvent {
+    uint64_t startCycles;       // Extended past the 32-bit counter's wrap
+    uint32_t cycles;
+    uint8_t zone;
+};
+
+struct Profiler {
+    uint32_t cyclesPerUs;
+    ProfZoneStats zones[PROFILER_MAX_ZONES];
+    uint8_t zoneCount;
+    ProfPeriodStats periods[PROFILER_MAX_PERIODS];
+    uint8_t periodCount;
+    ProfTraceEvent trace[PROFILER_TRACE_EVENTS];
+    uint32_t traceCount;        // Events ever recorded (ring index = count % size)
+    uint32_t lastCycles;
+    uint64_t cycleEpoch;        // High bits of the extended counter
+};
+
+extern Profiler profiler;
+
+void profilerBegin(uint32_t cyclesPerUs);
+
+/**
+ * Clear all statistics and the trace (registered zones stay)
+ */
+void profilerReset();
+
+/**
+ * Register a zone by name (returns the existing id for a known name)
+ *
+ * @return Zone id, or -1 if PROFILER_MAX_ZONES are in use
+ */
+int profilerZone(const char* name);
+
+void profilerRecord(int zone, uint32_t startCycles, uint32_t endCycles);
+
+/**
+ * Register a period tracker
+ *
+ * @return Period id, or -1 if PROFILER_MAX_PERIODS are in use
+ */
+int profilerPeriod(const char* name, uint32_t nominalUs);
+
+/**
+ * Note one occurrence of a periodic event
+ */
+void profilerPeriodMark(int period, uint64_t nowUs);
+
+/**
+ * Upper bound of the histogram bucket holding the percentile
+ */
+float profilerZonePercentileUs(const ProfZoneStats& z, float percentile);
+uint32_t profilerPeriodPercentileUs(const ProfPeriodStats& p, float percentile);
+
+#define PROFILER_TRACE_LINE_BYTES 128  // Longest line profilerTraceNext() writes, with its terminator
+
+/**
+ * Position in a trace dump
+ */
+struct ProfTraceCursor {
+    uint32_t next;              // traceCount of the next event to write
+    uint32_t end;               // traceCount when the dump began: later events aren't included
+    uint32_t lost;              // Events overwritten by the ring before they were written
+    uint8_t stage;              // Header, events, footer, done
+};
+
+/**
+ * Start a dump of the trace ring as Chrome trace-event JSON, oldest first
+ */
+void profilerTraceBegin(ProfTraceCursor& c);
+
+/**
+ * Write the next line of the document into buf (one event per line), so a
+ * caller can stop whenever its output is short of room and carry on later.
+ * Recording continues meanwhile: events the ring overwrites before their
+ * turn are skipped and counted in lost.
+ *
+ * @return Length written, 0 once the document is complete
+ */
+int profilerTraceNext(ProfTraceCursor& c, char* buf, int size);
+
+#if ENABLE_PROFILER
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+static inline uint32_t profilerCycles() {
+    return ESP.getCycleCount();
+}
+#else
+#include <chrono>
+static inline uint32_t profilerCycles() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+class ProfileScope {
+public:
+    explicit ProfileScope(int zone) : _zone(zone), _start(profilerCycles()) {}
+    ~ProfileScope() { profilerRecord(_zone, _start, profilerCycles()); }
+
+private:
+    int _zone;
+    uint32_t _start;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name)                                                              \
+    static const int PROFILE_CONCAT(_profZone, __LINE__) = profilerZone(name);          \
+    ProfileScope PROFILE_CONCAT(_profScope, __LINE__)(PROFILE_CONCAT(_profZone, __LINE__))
+
+#else
+
+#define PROFILE_ZONE(name) do {} while (0)
+
+#endif // ENABLE_PROFILER
+
+#endif // PROFILER_H
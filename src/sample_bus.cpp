@@ -0,0 +1,128 @@
+/**
+ * Control telemetry sample bus
+ *
+ * Producer, for publish index n in slot n % SAMPLE_BUS_CAPACITY:
+ *   seq = 2n+1 ; release fence ; words (relaxed) ; seq = 2n+2 (release) ;
+ *   head = n+1 (release)
+ * Reader of index n:
+ *   seq == 2n+2 (acquire) ; words (relaxed) ; acquire fence ; seq == 2n+2
+ * A slot's sequence only moves forward, so any other value on either load
+ * means the producer has lapped the reader onto that slot. The payload is
+ * copied as relaxed atomic words rather than with memcpy, so a torn read is
+ * a detected retry rather than a data race.
+ */
+
+#include <string.h>
+#include "sample_bus.h"
+
+static_assert((SAMPLE_BUS_CAPACITY & (SAMPLE_BUS_CAPACITY - 1)) == 0,
+              "SAMPLE_BUS_CAPACITY must be a power of two");
+
+static inline const SampleSlot& slotFor(const SampleBus& bus, uint32_t n) {
+    return bus.slots[n & (SAMPLE_BUS_CAPACITY - 1)];
+}
+
+/**
+ * Copy sample n out of its slot
+ *
+ * @return False if the slot no longer (or not yet) holds sample n intact
+ */
+static bool readSlot(const SampleBus& bus, uint32_t n, ControlSample& out) {
+    const SampleSlot& slot = slotFor(bus, n);
+    uint32_t expect = 2 * n + 2;
+    if (slot.seq.load(std::memory_order_acquire) != expect) {
+        return false;
+    }
+    uint32_t words[SAMPLE_BUS_WORDS];
+    for (size_t i = 0; i < SAMPLE_BUS_WORDS; i++) {
+        words[i] = slot.words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != expect) {
+        return false;
+    }
+    memcpy(&out, words, sizeof(ControlSample));
+    return true;
+}
+
+void sampleBusInit(SampleBus& bus) {
+    bus.head.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < SAMPLE_BUS_CAPACITY; i++) {
+        // Odd: never matches a reader's expected value until written
+        bus.slots[i].seq.store(1, std::memory_order_relaxed);
+        for (size_t w = 0; w < SAMPLE_BUS_WORDS; w++) {
+            bus.slots[i].words[w].store(0, std::memory_order_relaxed);
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void sampleBusPublish(SampleBus& bus, const ControlSample& sample) {
+    uint32_t n = bus.head.load(std::memory_order_relaxed);
+    SampleSlot& slot = bus.slots[n & (SAMPLE_BUS_CAPACITY - 1)];
+
+    uint32_t words[SAMPLE_BUS_WORDS] = {0};
+    memcpy(words, &sample, sizeof(ControlSample));
+
+    slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < SAMPLE_BUS_WORDS; i++) {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.seq.store(2 * n + 2, std::memory_order_release);
+    bus.head.store(n + 1, std::memory_order_release);
+}
+
+void sampleCursorAttach(const SampleBus& bus, SampleCursor& cursor, const char* name) {
+    cursor.name = name;
+    cursor.next = bus.head.load(std::memory_order_acquire);
+    cursor.reads = 0;
+    cursor.skipped = 0;
+    cursor.overruns = 0;
+    cursor.maxLag = 0;
+}
+
+bool sampleBusRead(const SampleBus& bus, SampleCursor& cursor, ControlSample& out) {
+    for (;;) {
+        uint32_t head = bus.head.load(std::memory_order_acquire);
+        uint32_t lag = head - cursor.next;
+        if (lag == 0) {
+            return false;
+        }
+        if (lag > cursor.maxLag) {
+            cursor.maxLag = lag;
+        }
+        if (lag > SAMPLE_BUS_CAPACITY) {
+            cursor.overruns += lag - SAMPLE_BUS_CAPACITY;
+            cursor.next = head - SAMPLE_BUS_CAPACITY;
+        }
+        if (readSlot(bus, cursor.next, out)) {
+            cursor.next++;
+            cursor.reads++;
+            return true;
+        }
+        // Lapped while reading: that sample is gone, move on to the next
+        cursor.overruns++;
+        cursor.next++;
+    }
+}
+
+bool sampleBusLatest(const SampleBus& bus, SampleCursor& cursor, ControlSample& out) {
+    for (;;) {
+        uint32_t head = bus.head.load(std::memory_order_acquire);
+        if (head == cursor.next) {
+            return false;
+        }
+        uint32_t lag = head - cursor.next;
+        if (lag > cursor.maxLag) {
+            cursor.maxLag = lag;
+        }
+        if (readSlot(bus, head - 1, out)) {
+            cursor.skipped += lag - 1;
+            cursor.next = head;
+            cursor.reads++;
+            return true;
+        }
+        // The producer lapped the whole ring mid-copy; take the new newest
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef SAMPLE_BUS_H
+#define SAMPLE_BUS_H
+
+// Control telemetry sample bus
+// The control path publishes one ControlSample per control tick into a
+// fixed ring of SAMPLE_BUS_CAPACITY slots. Consumers (display, serial status,
+// firing log, later the web socket) each keep their own cursor and read
+// snapshots instead of the live globals, so they see one coherent tick
+// whatever task they run in.
+//
+// Single producer, any number of consumers, no locks and no allocation.
+// Each slot is a seqlock: the sequence word is odd while the producer writes
+// and 2 * (publish index + 1) once the slot is stable. A reader copies the
+// slot and keeps the copy only if the sequence was the expected even value
+// before and after. The producer never waits. A consumer that falls more
+// than a ring behind loses the oldest samples and counts them as overruns.
+// Slots and the head are SAMPLE_BUS_ALIGN aligned, so a reader polling the
+// head doesn't share a cache line with a slot being written.
+//
+// Only 32-bit atomics are used (lock-free on ESP32). Pure C++ with no
+// Arduino dependencies so the stress test runs on host.
+
+#include <stdint.h>
+#include <atomic>
+#include "config.h"
+
+struct ControlSample {
+    uint32_t timeMs;
+    float temp;             // Control temperature (coldest zone, °C)
+    float hottest;          // Safety temperature (hottest zone, °C)
+    float target;           // Setpoint (°C)
+    float output;           // Mean zone duty (%)
+    float wareTemp;         // Observer estimate (°C)
+    uint8_t mode;           // SystemMode
+    bool heating;
+    bool sensorError;
+    uint8_t fault;          // FaultClass (latched)
+    uint8_t profileState;   // ProfileState
+    uint8_t profileSegment;
+    float faultResidual;    // Fault observer innovation (°C)
+    float zoneTemp[KILN_ZONE_COUNT];
+    float zoneSetpoint[KILN_ZONE_COUNT];
+    float zoneOutput[KILN_ZONE_COUNT];
+    uint32_t zoneErrors[KILN_ZONE_COUNT];  // Failed thermocouple reads
+};
+
+#define SAMPLE_BUS_WORDS ((sizeof(ControlSample) + 3) / 4)
+
+struct alignas(SAMPLE_BUS_ALIGN) SampleSlot {
+    std::atomic<uint32_t> seq;
+    std::atomic<uint32_t> words[SAMPLE_BUS_WORDS];
+};
+
+struct SampleBus {
+    alignas(SAMPLE_BUS_ALIGN) std::atomic<uint32_t> head;  // Samples published
+    SampleSlot slots[SAMPLE_BUS_CAPACITY];
+};
+
+/**
+ * One consumer's position and counters (owned by that consumer only)
+ */
+struct SampleCursor {
+    const char* name;
+    uint32_t next;          // Publish index of the next unread sample
+    uint32_t reads;
+    uint32_t skipped;       // Passed over on purpose by sampleBusLatest()
+    uint32_t overruns;      // Overwritten before sampleBusRead() reached them
+    uint32_t maxLag;        // Most unread samples seen at once
+};
+
+void sampleBusInit(SampleBus& bus);
+
+/**
+ * Publish a sample (producer only; never blocks)
+ */
+void sampleBusPublish(SampleBus& bus, const ControlSample& sample);
+
+/**
+ * Start a consumer at the next sample to be published
+ */
+void sampleCursorAttach(const SampleBus& bus, SampleCursor& cursor, const char* name);
+
+/**
+ * Oldest unread sample, for consumers that want every tick
+ *
+ * @return False if there is nothing new (out unchanged)
+ */
+bool sampleBusRead(const SampleBus& bus, SampleCursor& cursor, ControlSample& out);
+
+/**
+ * Newest sample, skipping anything older, for consumers that only show the
+ * current state
+ *
+ * @return False if there is nothing new (out unchanged)
+ */
+bool sampleBusLatest(const SampleBus& bus, SampleCursor& cursor, ControlSample& out);
+
+#endif // SAMPLE_BUS_H
@@ -0,0 +1,223 @@
+/**
+ * Cooperative timer-wheel scheduler
+ *
+ * A job due at tick t lives in slot t % SCHED_WHEEL_SLOTS, possibly several
+ * revolutions ahead, so each visited slot checks the due time of its
+ * entries. A pass visits the slots for lastTick..nowTick, or every slot
+ * once if more than a revolution has elapsed. lastTick itself is visited
+ * again because a job can be rescheduled into the current tick after that
+ * tick was visited. Due jobs are collected first and then run sorted by
+ * (priority, due time), which keeps one pass's order stable when a job
+ * reschedules another.
+ *
+ * A job is linked into the wheel only while it waits there: collecting it
+ * unlinks it, and it goes back in exactly once, after it runs. A
+ * schedulerRunIn() for a job collected or running in the current pass is
+ * recorded and applied at that point instead.
+ */
+
+#include "scheduler.h"
+
+static const uint64_t TICK_US = (uint64_t)SCHED_TICK_MS * 1000;
+
+static inline uint64_t tickOf(uint64_t us) {
+    return us / TICK_US;
+}
+
+// ============================================================================
+// WHEEL
+// ============================================================================
+
+static void wheelInsert(Scheduler& s, int id) {
+    SchedJob& j = s.jobs[id];
+    uint64_t tick = tickOf(j.dueUs);
+    if (tick < s.lastTick) {
+        tick = s.lastTick;  // Overdue: lands in the slot visited next pass
+    }
+    int slot = (int)(tick % SCHED_WHEEL_SLOTS);
+    j.nextInSlot = s.wheel[slot];
+    s.wheel[slot] = (int8_t)id;
+    j.state = SCHED_JOB_WHEEL;
+}
+
+static void wheelRemove(Scheduler& s, int id) {
+    for (int slot = 0; slot < SCHED_WHEEL_SLOTS; slot++) {
+        int8_t* link = &s.wheel[slot];
+        while (*link >= 0) {
+            if (*link == id) {
+                *link = s.jobs[id].nextInSlot;
+                s.jobs[id].nextInSlot = -1;
+                s.jobs[id].state = SCHED_JOB_IDLE;
+                return;
+            }
+            link = &s.jobs[*link].nextInSlot;
+        }
+    }
+}
+
+// ============================================================================
+// API
+// ============================================================================
+
+void schedulerInit(Scheduler& s, SchedClockFn clock) {
+    s.clock = clock;
+    s.jobCount = 0;
+    for (int i = 0; i < SCHED_MAX_JOBS; i++) {
+        s.jobs[i].state = SCHED_JOB_IDLE;
+    }
+    for (int i = 0; i < SCHED_WHEEL_SLOTS; i++) {
+        s.wheel[i] = -1;
+    }
+    s.lastTick = tickOf(clock());
+    s.running = -1;
+    s.runHook = nullptr;
+    s.passes = 0;
+}
+
+void schedulerSetRunHook(Scheduler& s, SchedRunHook hook) {
+    s.runHook = hook;
+}
+
+int schedulerAdd(Scheduler& s, const char* name, SchedJobFn fn, uint32_t periodMs,
+                 uint32_t phaseMs, uint8_t priority, uint32_t budgetUs) {
+    if (s.jobCount >= SCHED_MAX_JOBS || periodMs == 0) {
+        return -1;
+    }
+    int id = s.jobCount++;
+    SchedJob& j = s.jobs[id];
+    j.name = name;
+    j.fn = fn;
+    j.periodMs = periodMs;
+    j.priority = priority;
+    j.budgetUs = budgetUs;
+    j.dueUs = s.clock() + (uint64_t)phaseMs * 1000;
+    j.nextInSlot = -1;
+    j.hasOverride = false;
+    j.overrideDueUs = 0;
+    j.stats = SchedJobStats();
+    wheelInsert(s, id);
+    return id;
+}
+
+void schedulerRunIn(Scheduler& s, int job, uint32_t delayMs) {
+    if (job < 0 || job >= s.jobCount) {
+        return;
+    }
+    SchedJob& j = s.jobs[job];
+    uint64_t due = s.clock() + (uint64_t)delayMs * 1000;
+    if (j.state != SCHED_JOB_WHEEL) {
+        // Ready or running: applied once it has run, in place of the
+        // periodic reschedule
+        j.hasOverride = true;
+        j.overrideDueUs = due;
+        return;
+    }
+    wheelRemove(s, job);
+    j.dueUs = due;
+    wheelInsert(s, job);
+}
+
+int schedulerRunDue(Scheduler& s) {
+    uint64_t now = s.clock();
+    uint64_t nowTick = tickOf(now);
+    s.passes++;
+
+    // Collect due jobs from the elapsed slots
+    int8_t ready[SCHED_MAX_JOBS];
+    int readyCount = 0;
+    uint64_t first = s.lastTick;
+    if (nowTick - first >= SCHED_WHEEL_SLOTS) {
+        first = nowTick - SCHED_WHEEL_SLOTS + 1;
+    }
+    for (uint64_t t = first; t <= nowTick; t++) {
+        int8_t* link = &s.wheel[t % SCHED_WHEEL_SLOTS];
+        while (*link >= 0) {
+            int id = *link;
+            if (tickOf(s.jobs[id].dueUs) <= nowTick) {
+                *link = s.jobs[id].nextInSlot;
+                s.jobs[id].nextInSlot = -1;
+                s.jobs[id].state = SCHED_JOB_READY;
+                ready[readyCount++] = (int8_t)id;
+            } else {
+                link = &s.jobs[id].nextInSlot;
+            }
+        }
+    }
+    s.lastTick = nowTick;
+
+    // Insertion sort by (priority, due); at most SCHED_MAX_JOBS entries
+    for (int i = 1; i < readyCount; i++) {
+        int8_t id = ready[i];
+        int k = i - 1;
+        while (k >= 0 && (s.jobs[ready[k]].priority > s.jobs[id].priority ||
+                          (s.jobs[ready[k]].priority == s.jobs[id].priority &&
+                           s.jobs[ready[k]].dueUs > s.jobs[id].dueUs))) {
+            ready[k + 1] = ready[k];
+            k--;
+        }
+        ready[k + 1] = id;
+    }
+
+    for (int i = 0; i < readyCount; i++) {
+        int id = ready[i];
+        SchedJob& j = s.jobs[id];
+
+        uint64_t start = s.clock();
+        uint32_t lateMs = (start > j.dueUs) ? (uint32_t)((start - j.dueUs) / 1000) : 0;
+        if (lateMs > j.stats.maxLateMs) {
+            j.stats.maxLateMs = lateMs;
+        }
+        if (lateMs > SCHED_LATE_TOLERANCE_MS) {
+            j.stats.late++;
+        }
+
+        s.running = (int8_t)id;
+        j.state = SCHED_JOB_RUNNING;
+        if (s.runHook) {
+            s.runHook(id);
+        }
+        j.fn();
+        s.running = -1;
+        if (s.runHook) {
+            s.runHook(-1);
+        }
+
+        uint64_t end = s.clock();
+        uint32_t runUs = (uint32_t)(end - start);
+        j.stats.runs++;
+        j.stats.lastRunUs = runUs;
+        if (runUs > j.stats.maxRunUs) {
+            j.stats.maxRunUs = runUs;
+        }
+        if (j.budgetUs && runUs > j.budgetUs) {
+            j.stats.overruns++;
+        }
+
+        if (j.hasOverride) {
+            j.dueUs = j.overrideDueUs;
+            j.hasOverride = false;
+        } else {
+            // Phase-locked; periods that have fully passed are skipped
+            uint64_t periodUs = (uint64_t)j.periodMs * 1000;
+            j.dueUs += periodUs;
+            if (j.dueUs <= end) {
+                uint64_t missed = (end - j.dueUs) / periodUs + 1;
+                j.dueUs += missed * periodUs;
+                j.stats.skipped += (uint32_t)missed;
+            }
+        }
+        wheelInsert(s, id);
+    }
+    return readyCount;
+}
+
+uint32_t schedulerIdleMs(const Scheduler& s, uint32_t maxMs) {
+    uint64_t now = s.clock();
+    uint64_t next = now + (uint64_t)maxMs * 1000;
+    for (int i = 0; i < s.jobCount; i++) {
+        if (s.jobs[i].dueUs < next) {
+            next = s.jobs[i].dueUs;
+        }
+    }
+    return (next > now) ? (uint32_t)((next - now) / 1000) : 0;
+}
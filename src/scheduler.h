@@ -0,0 +1,110 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+// Cooperative timer-wheel scheduler
+// Periodic jobs register with a period, phase and priority. Each job sits
+// in one slot of a hashed timing wheel (SCHED_WHEEL_SLOTS slots of
+// SCHED_TICK_MS); a pass visits only the slots for ticks that have elapsed
+// since the last pass and runs the due jobs in priority order. Jobs are
+// never preempted. Between passes the caller sleeps for schedulerIdleMs()
+// instead of spinning.
+//
+// Next deadlines stay phase-locked (due += period), so a late start doesn't
+// push later runs back. A job more than a full period late skips the missed
+// runs rather than running back to back. Each job counts late starts,
+// skipped periods and runs over its time budget.
+//
+// The clock is injected, so schedules can be replayed on host.
+//
+// Pure C++ with no Arduino dependencies so it runs unchanged on host.
+
+#include <stdint.h>
+#include "config.h"
+
+typedef void (*SchedJobFn)();
+typedef uint64_t (*SchedClockFn)();     // Monotonic microseconds
+typedef void (*SchedRunHook)(int job);  // Job id before it runs, -1 after
+
+// Where a job is; it is linked into the wheel only in SCHED_JOB_WHEEL
+enum SchedJobState {
+    SCHED_JOB_IDLE,         // Not registered
+    SCHED_JOB_WHEEL,        // Waiting in its wheel slot
+    SCHED_JOB_READY,        // Collected as due, waiting its turn in this pass
+    SCHED_JOB_RUNNING
+};
+
+struct SchedJobStats {
+    uint32_t runs;
+    uint32_t late;          // Started more than SCHED_LATE_TOLERANCE_MS after due
+    uint32_t maxLateMs;
+    uint32_t skipped;       // Whole periods missed
+    uint32_t overruns;      // Ran longer than the job's budget
+    uint32_t lastRunUs;
+    uint32_t maxRunUs;
+};
+
+struct SchedJob {
+    const char* name;
+    SchedJobFn fn;
+    uint32_t periodMs;
+    uint8_t priority;       // 0 runs first among jobs due together
+    uint32_t budgetUs;      // 0 = no overrun accounting
+
+    uint64_t dueUs;
+    uint8_t state;          // SchedJobState
+    int8_t nextInSlot;      // Wheel slot list (-1 = end)
+    bool hasOverride;       // schedulerRunIn() called while the job was ready or running
+    uint64_t overrideDueUs;
+
+    SchedJobStats stats;
+};
+
+struct Scheduler {
+    SchedClockFn clock;
+    SchedJob jobs[SCHED_MAX_JOBS];
+    uint8_t jobCount;
+    int8_t wheel[SCHED_WHEEL_SLOTS];    // First job per slot (-1 = empty)
+    uint64_t lastTick;                  // Last tick visited
+    int8_t running;                     // Job currently running (-1 = none)
+    SchedRunHook runHook;               // Optional (crash diagnostics)
+    uint32_t passes;
+};
+
+void schedulerInit(Scheduler& s, SchedClockFn clock);
+
+/**
+ * Register a periodic job
+ *
+ * @param phaseMs First run this long after now (spreads jobs sharing a period)
+ * @return Job id, or -1 if SCHED_MAX_JOBS are registered
+ */
+int schedulerAdd(Scheduler& s, const char* name, SchedJobFn fn, uint32_t periodMs,
+                 uint32_t phaseMs, uint8_t priority, uint32_t budgetUs);
+
+/**
+ * Call hook around every job run (nullptr to remove)
+ */
+void schedulerSetRunHook(Scheduler& s, SchedRunHook hook);
+
+/**
+ * Move a job's next run to delayMs from now
+ * From inside the job itself this replaces the periodic reschedule for
+ * that one run (e.g. to wake at the next SSR edge). For a job that is due
+ * and waiting its turn in the current pass, it runs as planned and then
+ * next at the requested time, unless it reschedules itself meanwhile.
+ */
+void schedulerRunIn(Scheduler& s, int job, uint32_t delayMs);
+
+/**
+ * Run every job that is due
+ *
+ * @return Number of jobs run
+ */
+int schedulerRunDue(Scheduler& s);
+
+/**
+ * Time until the earliest deadline, capped at maxMs
+ */
+uint32_t schedulerIdleMs(const Scheduler& s, uint32_t maxMs);
+
+#endif // SCHEDULER_H
@@ -0,0 +1,125 @@
+/**
+ * Serial command shell
+ *
+ * Lines end at CR, LF or CR LF (an empty line between CR and LF is
+ * ignored). Backspace and DEL edit the line, so it works from a plain
+ * terminal. Words are separated by spaces or tabs.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "serial_shell.h"
+
+void shellInit(Shell& sh, const ShellCommand* commands, int count) {
+    memset(&sh, 0, sizeof(sh));
+    sh.commands = commands;
+    sh.commandCount = (uint8_t)count;
+}
+
+static void outPut(Shell& sh, const char* text, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        sh.out[(sh.outHead + sh.outLen) % SHELL_OUT_BYTES] = text[i];
+        sh.outLen++;
+    }
+}
+
+void shellPrintf(Shell& sh, const char* fmt, ...) {
+    char text[SHELL_REPLY_BYTES];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(text, sizeof(text) - 1, fmt, args);
+    va_end(args);
+    if (n < 0) {
+        return;
+    }
+    size_t len = (size_t)n < sizeof(text) - 1 ? (size_t)n : sizeof(text) - 2;
+    text[len++] = '\n';
+    if (len > shellOutputFree(sh)) {
+        sh.stats.outputDropped++;
+        return;
+    }
+    outPut(sh, text, len);
+}
+
+size_t shellDrain(Shell& sh, char* dst, size_t max) {
+    size_t n = 0;
+    while (n < max && sh.outLen > 0) {
+        dst[n++] = sh.out[sh.outHead];
+        sh.outHead = (sh.outHead + 1) % SHELL_OUT_BYTES;
+        sh.outLen--;
+    }
+    return n;
+}
+
+void shellHelp(Shell& sh) {
+    for (int i = 0; i < sh.commandCount; i++) {
+        shellPrintf(sh, "ok %s %s", sh.commands[i].name, sh.commands[i].usage);
+    }
+}
+
+/**
+ * Split the line into words in place and run the matching command
+ */
+static void runLine(Shell& sh) {
+    char* argv[SHELL_MAX_ARGS];
+    int argc = 0;
+    char* p = sh.line;
+    while (*p) {
+        while (*p == ' ' || *p == '\t') {
+            *p++ = '\0';
+        }
+        if (*p == '\0') {
+            break;
+        }
+        if (argc == SHELL_MAX_ARGS) {
+            sh.stats.errors++;
+            shellPrintf(sh, "err too many arguments");
+            return;
+        }
+        argv[argc++] = p;
+        while (*p && *p != ' ' && *p != '\t') {
+            p++;
+        }
+    }
+    if (argc == 0) {
+        return;
+    }
+    sh.stats.lines++;
+    for (int i = 0; i < sh.commandCount; i++) {
+        if (strcmp(argv[0], sh.commands[i].name) == 0) {
+            sh.commands[i].run(sh, argc, argv);
+            return;
+        }
+    }
+    sh.stats.errors++;
+    shellPrintf(sh, "err unknown command '%s' (try help)", argv[0]);
+}
+
+bool shellFeed(Shell& sh, char c) {
+    if (c == '\r' || c == '\n') {
+        bool complete = sh.lineLen > 0 || sh.overflow;
+        if (sh.overflow) {
+            sh.stats.errors++;
+            shellPrintf(sh, "err line longer than %d characters", SHELL_LINE_BYTES - 1);
+        } else if (sh.lineLen > 0) {
+            sh.line[sh.lineLen] = '\0';
+            runLine(sh);
+        }
+        sh.lineLen = 0;
+        sh.overflow = false;
+        return complete;
+    }
+    if (c == '\b' || c == 0x7F) {
+        if (sh.lineLen > 0) {
+            sh.lineLen--;
+        }
+        return false;
+    }
+    if (sh.lineLen < SHELL_LINE_BYTES - 1) {
+        sh.line[sh.lineLen++] = c;
+    } else {
+        sh.overflow = true;
+    }
+    return false;
+}
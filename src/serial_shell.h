@@ -0,0 +1,88 @@
+#ifndef SERIAL_SHELL_H
+#define SERIAL_SHELL_H
+
+// Serial command shell
+// Line-oriented commands for bench scripts and diagnostics ("get temp",
+// "set target 600", "profile start 2", ...). Bytes are fed one at a time
+// as they come off the UART, into a fixed line buffer; a complete line is
+// split into words in place and dispatched through a command table. Every
+// reply starts with "ok" or "err", so a script can wait for one line per
+// command.
+//
+// Replies go into a fixed output ring instead of straight to the port. The
+// caller drains the ring into whatever the UART TX buffer can take, and
+// stops feeding input while the ring has no room for another reply, so a
+// fast script is held back by the RX buffer rather than losing replies, and
+// nothing here ever waits on the port. No allocation.
+//
+// Pure C++ with no Arduino dependencies, so it can be driven on host
+// through a pty.
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+struct Shell;
+
+struct ShellCommand {
+    const char* name;
+    const char* usage;          // Arguments, for help
+    void (*run)(Shell& sh, int argc, char** argv);  // argv[0] is the name
+};
+
+struct ShellStats {
+    uint32_t lines;             // Commands run
+    uint32_t errors;            // Unknown commands, overlong lines
+    uint32_t outputDropped;     // Replies that didn't fit the output ring
+};
+
+struct Shell {
+    const ShellCommand* commands;
+    uint8_t commandCount;
+
+    char line[SHELL_LINE_BYTES];
+    uint8_t lineLen;
+    bool overflow;              // Current line is too long; discard at its end
+
+    char out[SHELL_OUT_BYTES];  // Reply ring
+    uint16_t outHead;           // Next byte to drain
+    uint16_t outLen;            // Bytes waiting
+
+    ShellStats stats;
+};
+
+void shellInit(Shell& sh, const ShellCommand* commands, int count);
+
+/**
+ * Feed one received byte; runs the command when it ends a line
+ *
+ * @return True if a line was completed
+ */
+bool shellFeed(Shell& sh, char c);
+
+/**
+ * Room left for replies (feed input only while this is SHELL_REPLY_BYTES or more)
+ */
+static inline size_t shellOutputFree(const Shell& sh) {
+    return SHELL_OUT_BYTES - sh.outLen;
+}
+
+/**
+ * Take up to max reply bytes out of the ring
+ *
+ * @return Bytes copied
+ */
+size_t shellDrain(Shell& sh, char* dst, size_t max);
+
+/**
+ * Queue one formatted reply line (a newline is added)
+ * A line that doesn't fit in the ring is dropped and counted.
+ */
+void shellPrintf(Shell& sh, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * "ok <command> <usage>" for each command
+ */
+void shellHelp(Shell& sh);
+
+#endif // SERIAL_SHELL_H
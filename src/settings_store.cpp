@@ -0,0 +1,280 @@
+/**
+ * Settings store
+ *
+ * Boot (settingsBegin): read the "settings" blob from the kiln-settings
+ * namespace. If there isn't one, this is the first boot with the store:
+ * take the defaults plus the ice-point offset saved by older firmware
+ * (kiln-config/temp_offset) and write a record. A corrupt record falls back
+ * to defaults and is rewritten, as is one from another schema.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "settings_store.h"
+
+#define FIELD(f) (uint16_t)offsetof(KilnSettings, f)
+
+// ============================================================================
+// FIELDS
+// ============================================================================
+
+const SettingSpec settingSpecs[] = {
+    // name          unit     field                     type          min      max                     default
+    {"kp",           "",      FIELD(kp),                SETTING_FLOAT, 0.0f,    100.0f,                 DEFAULT_KP},
+    {"ki",           "",      FIELD(ki),                SETTING_FLOAT, 0.0f,    10.0f,                  DEFAULT_KI},
+    {"kd",           "",      FIELD(kd),                SETTING_FLOAT, 0.0f,    100.0f,                 DEFAULT_KD},
+    {"ssr_cycle",    "ms",    FIELD(ssrCycleMs),        SETTING_U16,   500.0f,  10000.0f,               SSR_CYCLE_TIME_MS},
+    {"watts",        "W",     FIELD(wattage),           SETTING_FLOAT, 100.0f,  20000.0f,               DEFAULT_KILN_WATTAGE},
+    {"rate",         "/kWh",  FIELD(electricityRate),   SETTING_FLOAT, 0.0f,    10.0f,                  DEFAULT_ELECTRICITY_RATE},
+    {"max_temp",     "C",     FIELD(maxTemp),           SETTING_FLOAT, 100.0f,  MAX_TEMP_LIMIT,         MAX_TEMP_LIMIT},
+    {"tc_offset",    "C",     FIELD(tcOffset),          SETTING_FLOAT, -ICE_CAL_MAX_OFFSET, ICE_CAL_MAX_OFFSET, 0.0f},
+};
+
+const int settingSpecCount = sizeof(settingSpecs) / sizeof(settingSpecs[0]);
+
+void settingsDefaults(KilnSettings& s) {
+    memset(&s, 0, sizeof(s));
+    for (int i = 0; i < settingSpecCount; i++) {
+        settingSet(s, settingSpecs[i], settingSpecs[i].def);
+    }
+}
+
+const SettingSpec* settingFind(const char* name) {
+    for (int i = 0; i < settingSpecCount; i++) {
+        if (strcmp(settingSpecs[i].name, name) == 0) {
+            return &settingSpecs[i];
+        }
+    }
+    return nullptr;
+}
+
+float settingGet(const KilnSettings& s, const SettingSpec& spec) {
+    const uint8_t* field = (const uint8_t*)&s + spec.offset;
+    if (spec.type == SETTING_U16) {
+        uint16_t v;
+        memcpy(&v, field, sizeof(v));
+        return v;
+    }
+    float v;
+    memcpy(&v, field, sizeof(v));
+    return v;
+}
+
+static bool inBounds(const SettingSpec& spec, float value) {
+    return value >= spec.min && value <= spec.max;  // False for NaN
+}
+
+bool settingSet(KilnSettings& s, const SettingSpec& spec, float value) {
+    if (spec.type == SETTING_U16) {
+        value = floorf(value + 0.5f);
+    }
+    if (!inBounds(spec, value)) {
+        return false;
+    }
+    uint8_t* field = (uint8_t*)&s + spec.offset;
+    if (spec.type == SETTING_U16) {
+        uint16_t v = (uint16_t)value;
+        memcpy(field, &v, sizeof(v));
+    } else {
+        memcpy(field, &value, sizeof(value));
+    }
+    return true;
+}
+
+int settingsSanitize(KilnSettings& s) {
+    int fixed = 0;
+    for (int i = 0; i < settingSpecCount; i++) {
+        if (!inBounds(settingSpecs[i], settingGet(s, settingSpecs[i]))) {
+            settingSet(s, settingSpecs[i], settingSpecs[i].def);
+            fixed++;
+        }
+    }
+    s.reserved = 0;
+    return fixed;
+}
+
+int settingsDiff(const KilnSettings& a, const KilnSettings& b) {
+    int n = 0;
+    for (int i = 0; i < settingSpecCount; i++) {
+        n += settingGet(a, settingSpecs[i]) != settingGet(b, settingSpecs[i]);
+    }
+    return n;
+}
+
+// ============================================================================
+// RECORD
+// ============================================================================
+
+uint32_t settingsCrc32(const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= p[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+void settingsEncode(const KilnSettings& s, uint8_t* out) {
+    SettingsHeader h;
+    h.magic = SETTINGS_MAGIC;
+    h.schema = SETTINGS_SCHEMA;
+    h.length = sizeof(KilnSettings);
+    h.crc = settingsCrc32(&s, sizeof(s));
+    memcpy(out, &h, sizeof(h));
+    memcpy(out + sizeof(h), &s, sizeof(s));
+}
+
+SettingsLoad settingsDecode(const uint8_t* data, size_t len, KilnSettings& out, int* fixed) {
+    settingsDefaults(out);
+    *fixed = 0;
+    if (len == 0) {
+        return SETTINGS_EMPTY;
+    }
+    SettingsHeader h;
+    if (len < sizeof(h)) {
+        return SETTINGS_CORRUPT;
+    }
+    memcpy(&h, data, sizeof(h));
+    if (h.magic != SETTINGS_MAGIC || h.length == 0 || h.length > len - sizeof(h) ||
+        h.crc != settingsCrc32(data + sizeof(h), h.length)) {
+        return SETTINGS_CORRUPT;
+    }
+
+    // Fields are only appended: keep the ones both layouts have, defaults
+    // for the rest
+    size_t known = h.length < sizeof(KilnSettings) ? h.length : sizeof(KilnSettings);
+    memcpy(&out, data + sizeof(h), known);
+
+    // Conversions for fields whose meaning changed go here, keyed on
+    // h.schema (none yet: schema 1 is the first)
+
+    *fixed = settingsSanitize(out);
+    return h.schema == SETTINGS_SCHEMA && h.length == sizeof(KilnSettings) ? SETTINGS_LOADED
+                                                                            : SETTINGS_MIGRATED;
+}
+
+const char* settingsLoadName(SettingsLoad load) {
+    switch (load) {
+        case SETTINGS_LOADED:   return "loaded";
+        case SETTINGS_MIGRATED: return "migrated";
+        case SETTINGS_EMPTY:    return "empty";
+        case SETTINGS_CORRUPT:  return "corrupt";
+    }
+    return "?";
+}
+
+// ============================================================================
+// TARGET
+// ============================================================================
+
+#if defined(ARDUINO)
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+#define SETTINGS_NVS_NAMESPACE  "kiln-settings"
+#define SETTINGS_NVS_KEY        "settings"
+
+KilnSettings settings;
+SettingsStoreStats settingsStats;
+
+/**
+ * Write the record and read it back
+ */
+static bool writeRecord(const KilnSettings& s) {
+    uint8_t record[SETTINGS_RECORD_BYTES];
+    uint8_t check[SETTINGS_RECORD_BYTES];
+    settingsEncode(s, record);
+
+    uint32_t start = micros();
+    Preferences prefs;
+    prefs.begin(SETTINGS_NVS_NAMESPACE, false);
+    bool ok = prefs.putBytes(SETTINGS_NVS_KEY, record, sizeof(record)) == sizeof(record) &&
+              prefs.getBytes(SETTINGS_NVS_KEY, check, sizeof(check)) == sizeof(check) &&
+              memcmp(record, check, sizeof(record)) == 0;
+    prefs.end();
+    settingsStats.lastCommitUs = micros() - start;
+
+    if (ok) {
+        settingsStats.commits++;
+    } else {
+        settingsStats.failures++;
+    }
+    return ok;
+}
+
+void settingsBegin() {
+    uint8_t record[SETTINGS_RECORD_BYTES + 64];  // Room for a newer, longer record
+    size_t len = 0;
+    Preferences prefs;
+    prefs.begin(SETTINGS_NVS_NAMESPACE, true);  // read-only
+    size_t stored = prefs.getBytesLength(SETTINGS_NVS_KEY);
+    if (stored > 0 && stored <= sizeof(record)) {
+        len = prefs.getBytes(SETTINGS_NVS_KEY, record, stored);
+    } else if (stored > sizeof(record)) {
+        len = 1;  // Can't be ours: decodes as corrupt
+        record[0] = 0;
+    }
+    prefs.end();
+
+    int fixed;
+    SettingsLoad load = settingsDecode(record, len, settings, &fixed);
+    settingsStats.load = load;
+    settingsStats.fixed = (uint8_t)fixed;
+    if (len >= sizeof(SettingsHeader)) {
+        SettingsHeader h;
+        memcpy(&h, record, sizeof(h));
+        settingsStats.loadedSchema = load == SETTINGS_CORRUPT ? 0 : h.schema;
+    }
+
+    // Schema 0: the calibration offset was a loose key before the store
+    bool legacy = false;
+    if (load == SETTINGS_EMPTY) {
+        prefs.begin("kiln-config", true);
+        if (prefs.isKey("temp_offset")) {
+            legacy = settingSet(settings, *settingFind("tc_offset"), prefs.getFloat("temp_offset", 0.0));
+        }
+        prefs.end();
+        if (legacy) {
+            load = SETTINGS_MIGRATED;
+            settingsStats.load = load;
+        }
+    }
+
+    if (load != SETTINGS_LOADED || fixed > 0) {
+        bool written = writeRecord(settings);
+        if (written && legacy) {
+            prefs.begin("kiln-config", false);
+            prefs.remove("temp_offset");
+            prefs.end();
+        }
+        Serial.printf("[CONFIG] Record %s (schema %u, %d fields reset), %s schema %d\n",
+                      settingsLoadName(load), settingsStats.loadedSchema, fixed,
+                      written ? "rewritten as" : "FAILED to rewrite as", SETTINGS_SCHEMA);
+    }
+    Serial.printf("[CONFIG] Kp=%.3f Ki=%.4f Kd=%.3f, SSR %ums, %.0fW, %.3f/kWh, max %.0fC, "
+                  "TC offset %+.2fC\n",
+                  settings.kp, settings.ki, settings.kd, settings.ssrCycleMs, settings.wattage,
+                  settings.electricityRate, settings.maxTemp, settings.tcOffset);
+}
+
+bool settingsCommit(const KilnSettings& next) {
+    KilnSettings s = next;
+    if (settingsSanitize(s) > 0) {
+        settingsStats.failures++;
+        return false;
+    }
+    if (settingsDiff(s, settings) == 0) {
+        return true;
+    }
+    if (!writeRecord(s)) {
+        return false;
+    }
+    settings = s;
+    return true;
+}
+
+#endif // ARDUINO
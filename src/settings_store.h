@@ -0,0 +1,176 @@
+#ifndef SETTINGS_STORE_H
+#define SETTINGS_STORE_H
+
+// Settings store
+// The tunables a kiln owner changes (PID gains, SSR cycle, element wattage,
+// electricity rate, temperature ceiling, thermocouple offset), kept in NVS
+// and loaded once at boot into the settings struct. Everything else reads
+// plain fields of that struct: no flash access and no lookups on the
+// control path. config.h keeps the defaults and the hard limits.
+//
+// Each field has an entry in a table (name, bounds, default), so the shell
+// can read and change settings by name and every write is checked the same
+// way. A value outside its bounds is refused; the temperature ceiling can
+// never exceed MAX_TEMP_LIMIT.
+//
+// The whole set is one NVS blob: a header (magic, schema, payload length,
+// CRC-32 of the payload), then the struct. Changes are collected in a copy
+// and written in one putBytes, so a reset mid-write leaves the old record or
+// the new one (NVS writes an entry before erasing the one it replaces), and
+// the CRC catches anything else. A record that fails its checks is replaced
+// by the defaults.
+//
+// Schema changes: fields are only ever appended. A record written by an
+// older build keeps its fields and takes defaults for the new ones, a
+// newer one (firmware downgrade) keeps the fields this build knows, and
+// settingsDecode() is where a field whose meaning changed gets converted.
+// Either way the record is rewritten with this build's schema. Schema 0 is
+// the loose "temp_offset" key used before this store existed.
+//
+// Encoding, validation and migration are pure C++ (host-testable); the NVS
+// side is target-only.
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+#define SETTINGS_MAGIC      0x5347464B  // "KFGS"
+#define SETTINGS_SCHEMA     1
+
+/**
+ * Live settings (schema 1); append new fields at the end
+ */
+struct KilnSettings {
+    float kp;                   // PID gains, shared by all zones
+    float ki;
+    float kd;
+    float wattage;              // Element power (W): energy estimate, observer, predictor
+    float electricityRate;      // Cost per kWh, in DEFAULT_CURRENCY_SYMBOL
+    float maxTemp;              // Heating ceiling (°C), at most MAX_TEMP_LIMIT
+    float tcOffset;             // Ice-point calibration offset (°C)
+    uint16_t ssrCycleMs;        // Time-proportioning window
+    uint16_t reserved;
+};
+
+struct SettingsHeader {
+    uint32_t magic;
+    uint16_t schema;            // SETTINGS_SCHEMA of the build that wrote it
+    uint16_t length;            // Payload bytes that follow
+    uint32_t crc;               // CRC-32 of the payload
+};
+
+#define SETTINGS_RECORD_BYTES   (sizeof(SettingsHeader) + sizeof(KilnSettings))
+
+enum SettingType {
+    SETTING_FLOAT,
+    SETTING_U16
+};
+
+struct SettingSpec {
+    const char* name;
+    const char* unit;
+    uint16_t offset;            // offsetof(KilnSettings, field)
+    uint8_t type;               // SettingType
+    float min;
+    float max;
+    float def;
+};
+
+extern const SettingSpec settingSpecs[];
+extern const int settingSpecCount;
+
+enum SettingsLoad {
+    SETTINGS_LOADED,            // Record valid, current schema
+    SETTINGS_MIGRATED,          // Record valid, other schema: converted
+    SETTINGS_EMPTY,             // No record: defaults
+    SETTINGS_CORRUPT            // Bad magic, length or CRC: defaults
+};
+
+void settingsDefaults(KilnSettings& s);
+
+/**
+ * Table entry by name, null if unknown
+ */
+const SettingSpec* settingFind(const char* name);
+
+float settingGet(const KilnSettings& s, const SettingSpec& spec);
+
+/**
+ * Set one field if value is within the spec's bounds
+ * (a U16 field is rounded to the nearest integer)
+ *
+ * @return False (s unchanged) if out of bounds or not a number
+ */
+bool settingSet(KilnSettings& s, const SettingSpec& spec, float value);
+
+/**
+ * Replace every out-of-bounds field with its default
+ *
+ * @return Fields replaced
+ */
+int settingsSanitize(KilnSettings& s);
+
+/**
+ * Fields that differ between a and b
+ */
+int settingsDiff(const KilnSettings& a, const KilnSettings& b);
+
+uint32_t settingsCrc32(const void* data, size_t len);
+
+/**
+ * Header plus payload, SETTINGS_RECORD_BYTES
+ */
+void settingsEncode(const KilnSettings& s, uint8_t* out);
+
+/**
+ * Parse a stored record into out (defaults if it can't be used)
+ * Fields out of bounds are replaced by defaults and counted in *fixed.
+ */
+SettingsLoad settingsDecode(const uint8_t* data, size_t len, KilnSettings& out, int* fixed);
+
+const char* settingsLoadName(SettingsLoad load);
+
+/**
+ * Heating ceiling: maxTemp, and never above MAX_TEMP_LIMIT whatever RAM holds
+ */
+static inline float settingsTempLimit(const KilnSettings& s) {
+    return s.maxTemp < MAX_TEMP_LIMIT ? s.maxTemp : MAX_TEMP_LIMIT;
+}
+
+// ============================================================================
+// TARGET
+// ============================================================================
+
+#if defined(ARDUINO)
+
+extern KilnSettings settings;   // Live values; change them through settingsCommit()
+
+struct SettingsStoreStats {
+    uint8_t load;               // SettingsLoad at boot
+    uint16_t loadedSchema;      // Schema of the record found (0: legacy keys or none)
+    uint8_t fixed;              // Fields replaced by defaults at boot
+    uint32_t commits;           // Records written
+    uint32_t failures;          // Refused or failed writes
+    uint32_t lastCommitUs;      // Duration of the last write
+};
+
+extern SettingsStoreStats settingsStats;
+
+/**
+ * Load the record (migrating or repairing it if needed) into settings
+ * Call once, before anything reads settings.
+ */
+void settingsBegin();
+
+/**
+ * Validate next and write it as one record; settings takes it on success
+ * Blocks for the flash write (milliseconds), so not from the control job.
+ * Writing values equal to the live ones is a no-op that succeeds.
+ *
+ * @return False if a field is out of bounds or the write didn't verify
+ */
+bool settingsCommit(const KilnSettings& next);
+
+#endif // ARDUINO
+
+#endif // SETTINGS_STORE_H
@@ -0,0 +1,101 @@
+/**
+ * Shadow-mode controller evaluation
+ *
+ * The shadow PID owns private input/output/setpoint variables so it can never
+ * disturb the live loop. Divergence is only sampled on ticks where both
+ * controllers produced a fresh output, so differing sample phases don't
+ * show up as spurious disagreement.
+ */
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "shadow_controller.h"
+
+// ============================================================================
+// STATISTICS
+// ============================================================================
+
+void ComputeCost::record(uint32_t us) {
+    lastUs = us;
+    if (us > maxUs) {
+        maxUs = us;
+    }
+    meanUs = (samples == 0) ? us : meanUs + 0.05f * (us - meanUs);
+    samples++;
+}
+
+void DivergenceStats::reset() {
+    count = 0;
+    mean = 0.0;
+    m2 = 0.0;
+    maxAbs = 0.0;
+}
+
+void DivergenceStats::add(double diff) {
+    count++;
+    double delta = diff - mean;
+    mean += delta / count;
+    m2 += delta * (diff - mean);
+    if (fabs(diff) > maxAbs) {
+        maxAbs = fabs(diff);
+    }
+}
+
+double DivergenceStats::stddev() const {
+    return count > 1 ? sqrt(m2 / (count - 1)) : 0.0;
+}
+
+// ============================================================================
+// SHADOW CONTROLLER
+// ============================================================================
+
+ShadowController::ShadowController(double kp, double ki, double kd)
+    : _input(0), _output(0), _setpoint(0),
+      _pid(&_input, &_output, &_setpoint, kp, ki, kd, DIRECT),
+      _divergence(), _cost() {
+    _divergence.reset();
+}
+
+void ShadowController::begin(double outMin, double outMax, int sampleTimeMs) {
+    _pid.SetOutputLimits(outMin, outMax);
+    _pid.SetSampleTime(sampleTimeMs);
+    _pid.SetMode(MANUAL);
+    _output = 0;
+}
+
+void ShadowController::update(double input, double setpoint, bool liveAutomatic,
+                              bool liveComputed, double liveOutput) {
+    _input = input;
+    _setpoint = setpoint;
+
+    if (!liveAutomatic) {
+        if (_pid.GetMode() != MANUAL) {
+            _pid.SetMode(MANUAL);
+        }
+        _output = 0;
+        return;
+    }
+    if (_pid.GetMode() != AUTOMATIC) {
+        _pid.SetMode(AUTOMATIC);
+    }
+
+    int64_t start = esp_timer_get_time();
+    bool computed = _pid.Compute();
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+
+    if (computed) {
+        _cost.record(elapsed);
+        if (liveComputed) {
+            _divergence.add(_output - liveOutput);
+        }
+    }
+}
+
+void ShadowController::setTunings(double kp, double ki, double kd) {
+    _pid.SetTunings(kp, ki, kd);
+}
+
+void ShadowController::resetStats() {
+    _divergence.reset();
+    _cost = ComputeCost();
+}
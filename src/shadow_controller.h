@@ -0,0 +1,73 @@
+#ifndef SHADOW_CONTROLLER_H
+#define SHADOW_CONTROLLER_H
+
+// Shadow-mode controller evaluation
+// A candidate controller fed the same input and setpoint as the live zone
+// loops every tick. Its output is logged and compared against the live output
+// but never reaches an SSR.
+
+#include <stdint.h>
+#include <PID_v1.h>
+
+/**
+ * Running cost statistics for one controller's Compute() call
+ */
+struct ComputeCost {
+    uint32_t lastUs;
+    uint32_t maxUs;
+    float meanUs;           // Exponential moving average
+    uint32_t samples;
+
+    void record(uint32_t us);
+};
+
+/**
+ * Divergence between shadow and live outputs (Welford running statistics)
+ */
+struct DivergenceStats {
+    uint32_t count;
+    double mean;            // Mean of (shadow - live), percentage points
+    double m2;              // Sum of squared deviations from the mean
+    double maxAbs;          // Largest |shadow - live| seen
+
+    void reset();
+    void add(double diff);
+    double stddev() const;
+};
+
+class ShadowController {
+public:
+    ShadowController(double kp, double ki, double kd);
+
+    /**
+     * Apply the same output limits and sample time as the live controller
+     */
+    void begin(double outMin, double outMax, int sampleTimeMs);
+
+    /**
+     * Run the candidate on this tick's inputs
+     *
+     * @param liveAutomatic Mirrors the live PID mode so both start and stop together
+     * @param liveComputed True if the live PID produced a new output this tick
+     * @param liveOutput The live output (only compared when both computed)
+     */
+    void update(double input, double setpoint, bool liveAutomatic,
+                bool liveComputed, double liveOutput);
+
+    void setTunings(double kp, double ki, double kd);
+    void resetStats();
+
+    double output() const { return _output; }
+    const DivergenceStats& divergence() const { return _divergence; }
+    const ComputeCost& cost() const { return _cost; }
+
+private:
+    double _input;
+    double _output;
+    double _setpoint;
+    PID _pid;
+    DivergenceStats _divergence;
+    ComputeCost _cost;
+};
+
+#endif // SHADOW_CONTROLLER_H
@@ -0,0 +1,129 @@
+/**
+ * Streaming step-response analyzer
+ *
+ * Every metric is updated incrementally per sample; nothing is buffered.
+ * Rise time and overshoot are measured relative to the temperature at the
+ * moment of the step, settling uses a band of max(STEP_SETTLE_BAND, 5% of
+ * the step), and a step is published once it has stayed in band for
+ * STEP_SETTLE_CONFIRM_MS or when the next step supersedes it.
+ */
+
+#include <math.h>
+#include "config.h"
+#include "step_analyzer.h"
+
+// Time constant of the steady-state error smoother (s)
+#define STEP_SSE_TAU_SEC 60.0f
+
+// Crossing times use (unsigned long)-1 as "not reached yet"
+static bool stepReached(unsigned long t) { return t != (unsigned long)-1; }
+
+void stepAnalyzerReset(StepAnalyzer& a) {
+    a.active = false;
+    a.reference = NAN;
+    a.fromTemp = 0.0f;
+    a.startMeasured = 0.0f;
+    a.stepStart = 0;
+    a.lastUpdate = 0;
+    a.t10 = (unsigned long)-1;
+    a.t90 = (unsigned long)-1;
+    a.lastOutsideBand = 0;
+    a.peakExcursion = 0.0f;
+    a.errorEwma = 0.0f;
+    a.iae = 0.0f;
+}
+
+static void beginStep(StepAnalyzer& a, float from, float to, float measured, unsigned long now) {
+    a.active = true;
+    a.fromTemp = from;
+    a.reference = to;
+    a.startMeasured = measured;
+    a.stepStart = now;
+    a.t10 = (unsigned long)-1;
+    a.t90 = (unsigned long)-1;
+    a.lastOutsideBand = now;
+    a.peakExcursion = -INFINITY;
+    a.errorEwma = to - measured;
+    a.iae = 0.0f;
+}
+
+static void finishStep(StepAnalyzer& a, unsigned long now, bool settled, StepResult& out) {
+    out.fromTemp = a.fromTemp;
+    out.toTemp = a.reference;
+    out.riseTimeSec = (stepReached(a.t10) && stepReached(a.t90))
+                          ? (a.t90 - a.t10) / 1000.0f : -1.0f;
+    out.overshoot = a.peakExcursion > 0.0f ? a.peakExcursion : 0.0f;
+    out.settlingTimeSec = (a.lastOutsideBand - a.stepStart) / 1000.0f;
+    out.steadyStateError = a.errorEwma;
+    out.iae = a.iae;
+    out.durationSec = (now - a.stepStart) / 1000.0f;
+    out.settled = settled;
+    a.active = false;
+}
+
+bool stepAnalyzerUpdate(StepAnalyzer& a, float reference, float measured,
+                        unsigned long now, StepResult& out) {
+    bool published = false;
+
+    if (isnan(a.reference)) {
+        a.reference = reference;
+        a.lastUpdate = now;
+        return false;
+    }
+
+    // Step detection (quick successive encoder detents merge into one step)
+    if (fabs(reference - a.reference) > STEP_DETECT_MIN) {
+        if (a.active && now - a.stepStart < STEP_MERGE_MS) {
+            a.reference = reference;
+        } else {
+            float from = a.reference;
+            if (a.active) {
+                finishStep(a, now, false, out);
+                published = true;
+            }
+            beginStep(a, from, reference, measured, now);
+        }
+        a.lastUpdate = now;
+        return published;
+    }
+
+    if (!a.active) {
+        a.lastUpdate = now;
+        return false;
+    }
+
+    float dt = (now - a.lastUpdate) / 1000.0f;
+    a.lastUpdate = now;
+
+    float err = a.reference - measured;
+    a.iae += fabs(err) * dt;
+
+    float alpha = dt / STEP_SSE_TAU_SEC;
+    if (alpha > 1.0f) alpha = 1.0f;
+    a.errorEwma += alpha * (err - a.errorEwma);
+
+    float step = a.reference - a.startMeasured;
+    float direction = step >= 0.0f ? 1.0f : -1.0f;
+    if (fabs(step) > 0.0f) {
+        float progress = (measured - a.startMeasured) / step;
+        if (!stepReached(a.t10) && progress >= 0.1f) a.t10 = now;
+        if (!stepReached(a.t90) && progress >= 0.9f) a.t90 = now;
+    }
+
+    float excursion = (measured - a.reference) * direction;
+    if (excursion > a.peakExcursion) a.peakExcursion = excursion;
+
+    float band = fabs(step) * 0.05f;
+    if (band < STEP_SETTLE_BAND) band = STEP_SETTLE_BAND;
+    if (fabs(err) > band) a.lastOutsideBand = now;
+
+    if (now - a.lastOutsideBand >= STEP_SETTLE_CONFIRM_MS) {
+        finishStep(a, now, true, out);
+        return true;
+    }
+    if (now - a.stepStart >= STEP_MAX_DURATION_MS) {
+        finishStep(a, now, false, out);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,58 @@
+#ifndef STEP_ANALYZER_H
+#define STEP_ANALYZER_H
+
+// Streaming step-response analyzer
+// Watches the reference target (manual setpoint or profile segment target)
+// and the measured temperature, and scores each setpoint change in O(1)
+// memory: rise time, overshoot, settling time, steady-state error and IAE.
+//
+// Pure C++ with no Arduino dependencies so it runs unchanged on host replays.
+
+#include <stdint.h>
+
+struct StepResult {
+    float fromTemp;         // Reference before the step (°C)
+    float toTemp;           // Reference after the step (°C)
+    float riseTimeSec;      // 10% -> 90% of the step (s, <0 if never reached)
+    float overshoot;        // Peak excursion past target (°C, >= 0)
+    float settlingTimeSec;  // Time until last exit from the settling band (s)
+    float steadyStateError; // Smoothed target - measured at publish time (°C)
+    float iae;              // Integrated absolute error (°C*s)
+    float durationSec;      // Observation window length (s)
+    bool settled;           // True if the response stayed in band long enough
+};
+
+struct StepAnalyzer {
+    bool active;
+    float reference;        // Current reference being tracked
+    float fromTemp;
+    float startMeasured;    // Measured temperature when the step began
+    unsigned long stepStart;
+    unsigned long lastUpdate;
+    unsigned long t10;      // Time 10% of step reached (-1 = not yet)
+    unsigned long t90;      // Time 90% of step reached (-1 = not yet)
+    unsigned long lastOutsideBand;
+    float peakExcursion;    // Max signed progress past target, in step direction
+    float errorEwma;
+    float iae;
+};
+
+/**
+ * Reset analyzer state (no step in progress)
+ */
+void stepAnalyzerReset(StepAnalyzer& a);
+
+/**
+ * Feed one sample
+ *
+ * @param reference Current reference target (°C). A change larger than
+ *                  STEP_DETECT_MIN starts a new step.
+ * @param measured Measured temperature (°C)
+ * @param now Sample time (ms)
+ * @param out Filled when a step completes (settled, or superseded by a new step)
+ * @return True if `out` holds a newly published result
+ */
+bool stepAnalyzerUpdate(StepAnalyzer& a, float reference, float measured,
+                        unsigned long now, StepResult& out);
+
+#endif // STEP_ANALYZER_H
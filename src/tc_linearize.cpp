@@ -0,0 +1,134 @@
+/**
+ * K-type thermocouple linearization (NIST ITS-90)
+ *
+ * Inverse table: 115 points at 0.5 mV from -2 to 55 mV (-53..1375°C); linear
+ * interpolation between them stays within 0.06°C of the NIST forward
+ * polynomial over -50..1372°C. Cold-junction table: 22 points at 5°C over
+ * the MAX31855's -20..85°C operating range. Inputs outside either table are
+ * extrapolated from the end segment.
+ */
+
+#include "config.h"
+#include "tc_linearize.h"
+
+#define INV_E_MIN_MV    -2.0f
+#define INV_E_STEP_MV   0.5f
+#define CJ_T_MIN_C      -20.0f
+#define CJ_T_STEP_C     5.0f
+
+// ============================================================================
+// TABLES
+// ============================================================================
+
+// Generated by tools/gen_ktype_tables.py - do not edit by hand
+// Inverse: T (°C) at E = -2.0 + i * 0.5 mV
+static const float kInverseTable[115] = {
+      -53.102f,   -39.266f,   -25.852f,   -12.787f,     0.000f,    12.580f,    24.994f,    37.271f,
+       49.440f,    61.533f,    73.582f,    85.618f,    97.675f,   109.780f,   121.957f,   134.218f,
+      146.568f,   158.997f,   171.486f,   184.008f,   196.534f,   209.037f,   221.495f,   233.895f,
+      246.230f,   258.499f,   270.708f,   282.861f,   294.964f,   307.025f,   319.049f,   331.039f,
+      343.000f,   354.934f,   366.843f,   378.728f,   390.592f,   402.435f,   414.258f,   426.064f,
+      437.853f,   449.628f,   461.390f,   473.140f,   484.881f,   496.615f,   508.343f,   520.069f,
+      531.792f,   543.517f,   555.244f,   566.977f,   578.716f,   590.465f,   602.224f,   613.997f,
+      625.784f,   637.589f,   649.412f,   661.255f,   673.120f,   685.009f,   696.923f,   708.863f,
+      720.831f,   732.828f,   744.856f,   756.915f,   769.006f,   781.130f,   793.289f,   805.482f,
+      817.711f,   829.976f,   842.278f,   854.617f,   866.993f,   879.408f,   891.861f,   904.354f,
+      916.886f,   929.458f,   942.070f,   954.724f,   967.419f,   980.156f,   992.937f,  1005.761f,
+     1018.630f,  1031.546f,  1044.509f,  1057.520f,  1070.582f,  1083.697f,  1096.865f,  1110.089f,
+     1123.372f,  1136.715f,  1150.122f,  1163.594f,  1177.136f,  1190.749f,  1204.437f,  1218.202f,
+     1232.047f,  1245.976f,  1259.991f,  1274.093f,  1288.286f,  1302.570f,  1316.946f,  1331.415f,
+     1345.974f,  1360.622f,  1375.356f,
+};
+
+// Cold junction: E (µV) at T = -20 + i * 5 °C
+static const float kColdJunctionTable[22] = {
+     -777.540f,  -585.535f,  -391.854f,  -196.622f,     0.000f,   197.851f,   396.862f,   596.972f,
+      798.120f,  1000.242f,  1203.275f,  1407.149f,  1611.792f,  1817.128f,  2023.078f,  2229.555f,
+     2436.472f,  2643.734f,  2851.249f,  3058.917f,  3266.642f,  3474.327f,
+};
+
+#define INV_POINTS  (int)(sizeof(kInverseTable) / sizeof(kInverseTable[0]))
+#define CJ_POINTS   (int)(sizeof(kColdJunctionTable) / sizeof(kColdJunctionTable[0]))
+
+// Inverse table with the ice-point offset added to every entry
+static float inverseRam[INV_POINTS];
+static float iceOffsetC = 0.0f;
+
+/**
+ * Piecewise-linear lookup on a uniform grid, extrapolating past either end
+ */
+static inline float interpolate(const float* table, int points, float x0, float step, float x) {
+    float pos = (x - x0) / step;
+    int i = (int)pos;
+    if (pos < 0.0f) i = 0;
+    if (i > points - 2) i = points - 2;
+    float frac = pos - i;
+    return table[i] + frac * (table[i + 1] - table[i]);
+}
+
+// ============================================================================
+// API
+// ============================================================================
+
+void tcLinearizeSetOffset(float iceOffset) {
+    iceOffsetC = iceOffset;
+    for (int i = 0; i < INV_POINTS; i++) {
+        inverseRam[i] = kInverseTable[i] + iceOffset;
+    }
+}
+
+void tcLinearizeBegin(float iceOffset) {
+    tcLinearizeSetOffset(iceOffset);
+}
+
+float tcLinearizeOffset() {
+    return iceOffsetC;
+}
+
+float tcLinearize(float hotC, float coldC) {
+    // Voltage the chip measured, then referenced to 0°C via the cold-junction EMF
+    float junctionUv = (hotC - coldC) * TC_MAX31855_SEEBECK_UV;
+    float coldUv = interpolate(kColdJunctionTable, CJ_POINTS, CJ_T_MIN_C, CJ_T_STEP_C, coldC);
+    float emfMv = (junctionUv + coldUv) / 1000.0f;
+    return interpolate(inverseRam, INV_POINTS, INV_E_MIN_MV, INV_E_STEP_MV, emfMv);
+}
+
+// ============================================================================
+// SELF-CHECK
+// ============================================================================
+
+// NIST Monograph 175 type K reference values (°C, mV)
+static const float kNistPoints[][2] = {
+    {-50.0f, -1.889f}, {0.0f, 0.000f}, {100.0f, 4.096f}, {200.0f, 8.138f},
+    {300.0f, 12.209f}, {400.0f, 16.397f}, {500.0f, 20.644f}, {600.0f, 24.905f},
+    {700.0f, 29.129f}, {800.0f, 33.275f}, {900.0f, 37.326f}, {1000.0f, 41.276f},
+    {1100.0f, 45.119f}, {1200.0f, 48.838f}, {1300.0f, 52.410f}, {1370.0f, 54.819f}
+};
+#define NIST_COLD_C     25.0f
+#define NIST_COLD_MV    1.000f  // E(25°C)
+
+TcLinearizeCheck tcLinearizeSelfCheck() {
+    TcLinearizeCheck c = {0, 0.0f, 0.0f, 0.0f, 0.0f};
+    int n = sizeof(kNistPoints) / sizeof(kNistPoints[0]);
+
+    for (int i = 0; i < n; i++) {
+        float t = kNistPoints[i][0];
+        float junctionMv = kNistPoints[i][1] - NIST_COLD_MV;
+        float chipC = NIST_COLD_C + junctionMv * 1000.0f / TC_MAX31855_SEEBECK_UV;
+
+        float err = tcLinearize(chipC, NIST_COLD_C) - iceOffsetC - t;
+        if (err < 0.0f) err = -err;
+        if (err > c.maxError) {
+            c.maxError = err;
+            c.maxErrorAt = t;
+        }
+        float chipErr = chipC - t;
+        if (chipErr < 0.0f) chipErr = -chipErr;
+        if (chipErr > c.maxChipError) {
+            c.maxChipError = chipErr;
+            c.maxChipErrorAt = t;
+        }
+        c.points++;
+    }
+    return c;
+}
@@ -0,0 +1,53 @@
+#ifndef TC_LINEARIZE_H
+#define TC_LINEARIZE_H
+
+// K-type thermocouple linearization (NIST ITS-90)
+// The MAX31855 reports Tcj + V / 41.276 µV/°C, a straight-line fit that is
+// off by up to ~30°C near MAX_TEMP_LIMIT. This stage recovers the junction
+// voltage from the hot/cold readings, adds the cold-junction EMF, and looks
+// the total up in a precomputed inverse table (see tools/gen_ktype_tables.py)
+// with linear interpolation. The ice-point calibration offset is folded into
+// a RAM copy of the table, so a sample costs two table lookups and no
+// polynomial evaluation.
+//
+// Pure C++ with no Arduino dependencies so it runs unchanged on host.
+
+#include <stdint.h>
+
+/**
+ * Build the RAM table with the ice-point offset folded in
+ *
+ * @param iceOffset Calibration offset (°C), correctedTemp = rawTemp + offset
+ */
+void tcLinearizeBegin(float iceOffset);
+
+/**
+ * Change the folded-in offset (rebuilds the RAM table)
+ */
+void tcLinearizeSetOffset(float iceOffset);
+float tcLinearizeOffset();
+
+/**
+ * Convert a MAX31855 reading to ITS-90 temperature
+ *
+ * @param hotC Thermocouple temperature reported by the chip (°C)
+ * @param coldC Cold-junction (internal) temperature reported by the chip (°C)
+ * @return Linearized, offset-corrected temperature (°C)
+ */
+float tcLinearize(float hotC, float coldC);
+
+struct TcLinearizeCheck {
+    int points;             // NIST reference points checked
+    float maxError;         // Worst |linearized - NIST| (°C), offset excluded
+    float maxErrorAt;       // Where it occurred (°C)
+    float maxChipError;     // Worst |chip linear - NIST| (°C) for comparison
+    float maxChipErrorAt;
+};
+
+/**
+ * Check the table against embedded NIST reference values
+ * Chip readings are synthesized from the reference EMF at a 25°C cold junction.
+ */
+TcLinearizeCheck tcLinearizeSelfCheck();
+
+#endif // TC_LINEARIZE_H
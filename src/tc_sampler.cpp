@@ -0,0 +1,163 @@
+/**
+ * SSR-synchronous thermocouple sampler
+ *
+ * Edges come from the time-proportional window: an on-edge at each window
+ * start and an off-edge onTime later. A read at time t starts a conversion
+ * covering [t, t + TC_CONVERSION_MS], so the read is held back while that
+ * span (plus TC_EDGE_GUARD_MS) contains a predicted edge, or while the
+ * previous edge is still ringing (TC_EDGE_SETTLE_MS). Edges the schedule
+ * didn't predict (PID output changes, safety cut-offs) are still caught and
+ * tagged TC_SAMPLE_EDGE after the fact.
+ */
+
+#include <math.h>
+#include "config.h"
+#include "tc_sampler.h"
+
+// ============================================================================
+// STATISTICS
+// ============================================================================
+
+void TcNoiseStats::add(float x) {
+    count++;
+    float delta = x - mean;
+    mean += delta / count;
+    m2 += delta * (x - mean);
+}
+
+float TcNoiseStats::stddev() const {
+    return count > 1 ? sqrtf(m2 / (count - 1)) : 0.0f;
+}
+
+// ============================================================================
+// SCHEDULE
+// ============================================================================
+
+void tcSamplerReset(TcSampler& s) {
+    s.windowStart = 0;
+    s.windowSize = 0;
+    s.onTime = 0;
+    s.ssrOn = false;
+    s.lastEdge = 0;
+    s.lastRead = 0;
+    s.convSsrOn = false;
+    s.convMsSinceEdge = 0;
+    s.convDirty = false;
+    s.started = false;
+    s.lastTemp = 0.0f;
+    s.haveLast = false;
+    s.lastClean = false;
+    for (int i = 0; i < TC_SAMPLE_CLASSES; i++) {
+        s.noise[i] = {0, 0.0f, 0.0f};
+    }
+    s.reads = 0;
+    s.deferred = 0;
+    s.forced = 0;
+    s.totalDeferMs = 0;
+}
+
+void tcSamplerSetSchedule(TcSampler& s, unsigned long windowStart,
+                          unsigned long windowSize, unsigned long onTime) {
+    s.windowStart = windowStart;
+    s.windowSize = windowSize;
+    s.onTime = onTime;
+}
+
+void tcSamplerNoteEdge(TcSampler& s, bool on, unsigned long now) {
+    s.ssrOn = on;
+    s.lastEdge = now;
+    if (s.started && now - s.lastRead < TC_CONVERSION_MS) {
+        s.convDirty = true;
+    }
+}
+
+/**
+ * True if the schedule puts an SSR edge in [from, from + span]
+ */
+static bool edgePredicted(const TcSampler& s, unsigned long from, unsigned long span) {
+    if (s.windowSize == 0 || s.onTime == 0 || s.onTime >= s.windowSize) {
+        return false;  // Steady off or steady on: no switching
+    }
+    unsigned long cycleStart = from - (from - s.windowStart) % s.windowSize;
+    // Candidates: this window's off-edge, next window's on- and off-edges
+    unsigned long edges[3] = {
+        cycleStart + s.onTime,
+        cycleStart + s.windowSize,
+        cycleStart + s.windowSize + s.onTime
+    };
+    for (int i = 0; i < 3; i++) {
+        unsigned long ahead = edges[i] - from;
+        if (edges[i] - cycleStart >= from - cycleStart && ahead <= span) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool tcSamplerShouldRead(TcSampler& s, unsigned long now) {
+    if (!s.started) {
+        return true;
+    }
+    unsigned long sinceRead = now - s.lastRead;
+    if (sinceRead < TC_SAMPLE_INTERVAL_MS) {
+        return false;
+    }
+
+    unsigned long lateMs = sinceRead - TC_SAMPLE_INTERVAL_MS;
+    bool quiet = (now - s.lastEdge >= TC_EDGE_SETTLE_MS) &&
+                 !edgePredicted(s, now, TC_CONVERSION_MS + TC_EDGE_GUARD_MS);
+    if (!quiet && lateMs < TC_MAX_DEFER_MS) {
+        return false;
+    }
+
+    if (!quiet) {
+        s.forced++;
+    }
+    if (lateMs > 0) {
+        s.deferred++;
+        s.totalDeferMs += lateMs;
+    }
+    return true;
+}
+
+// ============================================================================
+// SAMPLES
+// ============================================================================
+
+TcSampleTag tcSamplerOnRead(TcSampler& s, unsigned long now) {
+    TcSampleTag tag;
+    tag.ssrOn = s.convSsrOn;
+    tag.msSinceEdge = s.convMsSinceEdge;
+    tag.edgeInWindow = s.convDirty || !s.started;
+    tag.cls = tag.edgeInWindow ? TC_SAMPLE_EDGE
+                               : (tag.ssrOn ? TC_SAMPLE_SSR_ON : TC_SAMPLE_SSR_OFF);
+
+    // CS released: the next conversion starts now
+    s.started = true;
+    s.lastRead = now;
+    s.convSsrOn = s.ssrOn;
+    s.convMsSinceEdge = now - s.lastEdge;
+    s.convDirty = (now - s.lastEdge < TC_EDGE_SETTLE_MS);
+    s.reads++;
+    return tag;
+}
+
+void tcSamplerAddSample(TcSampler& s, const TcSampleTag& tag, float temp) {
+    bool clean = tag.cls != TC_SAMPLE_EDGE;
+    if (s.haveLast && (!clean || s.lastClean)) {
+        s.noise[tag.cls].add(temp - s.lastTemp);
+    }
+    s.lastTemp = temp;
+    s.haveLast = true;
+    s.lastClean = clean;
+}
+
+const char* tcSampleClassName(TcSampleClass c) {
+    switch (c) {
+        case TC_SAMPLE_SSR_OFF: return "off";
+        case TC_SAMPLE_SSR_ON:  return "on";
+        case TC_SAMPLE_EDGE:    return "edge";
+        case TC_SAMPLE_CLASSES: break;
+    }
+    return "?";
+}
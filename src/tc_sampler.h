@@ -0,0 +1,106 @@
+#ifndef TC_SAMPLER_H
+#define TC_SAMPLER_H
+
+// SSR-synchronous thermocouple sampler
+// The MAX31855 starts a conversion when CS is released, so each read returns
+// the conversion that ran during the TC_CONVERSION_MS after the previous
+// read. The sampler knows the SSR's time-proportional schedule and only
+// reads when the conversion it is about to start won't contain a switching
+// edge. Each sample is tagged with the SSR state and time since the last edge
+// of its conversion window, and noise statistics are kept per tag.
+//
+// Pure C++ with no Arduino dependencies so the schedule can be checked on host.
+
+#include <stdint.h>
+
+enum TcSampleClass {
+    TC_SAMPLE_SSR_OFF,      // Conversion ran with SSR steadily off
+    TC_SAMPLE_SSR_ON,       // Conversion ran with SSR steadily on
+    TC_SAMPLE_EDGE,         // An SSR edge landed inside the conversion
+    TC_SAMPLE_CLASSES
+};
+
+struct TcSampleTag {
+    bool ssrOn;                 // SSR state when the conversion started
+    unsigned long msSinceEdge;  // Conversion start - last SSR edge (ms)
+    bool edgeInWindow;          // SSR switched during the conversion
+    TcSampleClass cls;
+};
+
+/**
+ * Welford mean/variance of sample-to-sample differences
+ */
+struct TcNoiseStats {
+    uint32_t count;
+    float mean;
+    float m2;
+
+    void add(float x);
+    float stddev() const;
+};
+
+struct TcSampler {
+    // SSR schedule (as last applied by updateSSRControl)
+    unsigned long windowStart;
+    unsigned long windowSize;
+    unsigned long onTime;
+    bool ssrOn;
+    unsigned long lastEdge;
+
+    // Conversion in progress (started by the previous read)
+    unsigned long lastRead;
+    bool convSsrOn;
+    unsigned long convMsSinceEdge;
+    bool convDirty;
+    bool started;
+
+    // Noise statistics
+    float lastTemp;
+    bool haveLast;
+    bool lastClean;             // Previous sample wasn't TC_SAMPLE_EDGE
+    TcNoiseStats noise[TC_SAMPLE_CLASSES];
+
+    // Scheduler statistics
+    uint32_t reads;
+    uint32_t deferred;          // Reads postponed to dodge an edge
+    uint32_t forced;            // Reads taken at TC_MAX_DEFER_MS anyway
+    unsigned long totalDeferMs;
+};
+
+void tcSamplerReset(TcSampler& s);
+
+/**
+ * Record the SSR's current time-proportional window
+ * onTime of 0 or >= windowSize means no edges are expected.
+ */
+void tcSamplerSetSchedule(TcSampler& s, unsigned long windowStart,
+                          unsigned long windowSize, unsigned long onTime);
+
+/**
+ * Record an actual SSR transition
+ */
+void tcSamplerNoteEdge(TcSampler& s, bool on, unsigned long now);
+
+/**
+ * True if a read is due and the conversion it starts will be quiet
+ * (or the read has already been deferred TC_MAX_DEFER_MS)
+ */
+bool tcSamplerShouldRead(TcSampler& s, unsigned long now);
+
+/**
+ * Call after every chip read (valid or not)
+ *
+ * @return Tag describing the conversion that produced this reading
+ */
+TcSampleTag tcSamplerOnRead(TcSampler& s, unsigned long now);
+
+/**
+ * Feed a valid reading into the per-class noise statistics
+ * Steady-state classes only use differences between two clean samples, so a
+ * spike isn't counted again against the clean sample that follows it.
+ */
+void tcSamplerAddSample(TcSampler& s, const TcSampleTag& tag, float temp);
+
+const char* tcSampleClassName(TcSampleClass c);
+
+#endif // TC_SAMPLER_H
@@ -0,0 +1,129 @@
+/**
+ * Dual-thermocouple voting
+ *
+ * Source selection, in order:
+ *   neither valid                -> NONE (caller treats it as a sensor error)
+ *   primary only                 -> PRIMARY
+ *   backup only                  -> BACKUP, reading + bias
+ *   both, agreeing               -> PRIMARY (after a failover, only once the
+ *                                   primary has agreed TC_VOTE_RECOVER_READS
+ *                                   times in a row)
+ *   both, disagreeing            -> HIGHER
+ * The bias only learns while the pair agrees, so a failing sensor can't
+ * drag it along.
+ */
+
+#include <math.h>
+#include "config.h"
+#include "tc_vote.h"
+
+void tcVoteReset(TcVote& v) {
+    v.bias = 0.0f;
+    v.haveBias = false;
+    v.diffSmooth = 0.0f;
+    v.windowDiff = 0.0f;
+    v.windowStart = 0;
+    v.windowStarted = false;
+    v.rateMismatch = 0.0f;
+    v.lastUpdate = 0;
+    v.disagreeMs = 0;
+    v.primaryGoodStreak = 0;
+    v.source = TC_VOTE_PRIMARY;
+    v.diff = 0.0f;
+    v.disagree = false;
+    v.driftWarning = false;
+    v.failovers = 0;
+}
+
+/**
+ * Band and rate checks on a valid pair; updates the rate window
+ */
+static bool pairDisagrees(TcVote& v, float primary, float backup, unsigned long now) {
+    v.diff = primary - backup;
+    float band = TC_VOTE_BAND + TC_VOTE_BAND_FRACTION * fabsf(primary);
+
+    // Rate from the smoothed difference: raw read-to-read noise over a
+    // one-minute window would look like tens of °C/hour
+    if (!v.windowStarted) {
+        v.diffSmooth = v.diff;
+        v.windowDiff = v.diff;
+        v.windowStart = now;
+        v.windowStarted = true;
+    } else {
+        v.diffSmooth += TC_VOTE_BIAS_GAIN * (v.diff - v.diffSmooth);
+        if (now - v.windowStart >= TC_VOTE_RATE_WINDOW_MS) {
+            float hours = (now - v.windowStart) / 3600000.0f;
+            v.rateMismatch = (v.diffSmooth - v.windowDiff) / hours;
+            v.windowDiff = v.diffSmooth;
+            v.windowStart = now;
+        }
+    }
+
+    return fabsf(v.diff) > band || fabsf(v.rateMismatch) > TC_VOTE_RATE_BAND;
+}
+
+bool tcVoteUpdate(TcVote& v, bool primaryOk, float primary, bool backupOk, float backup,
+                  unsigned long now, float& out) {
+    unsigned long dtMs = v.lastUpdate ? now - v.lastUpdate : 0;
+    v.lastUpdate = now;
+    TcVoteSource previous = v.source;
+
+    v.primaryGoodStreak = primaryOk ? v.primaryGoodStreak + 1 : 0;
+    if (v.primaryGoodStreak > TC_VOTE_RECOVER_READS) {
+        v.primaryGoodStreak = TC_VOTE_RECOVER_READS;
+    }
+
+    if (primaryOk && backupOk) {
+        v.disagree = pairDisagrees(v, primary, backup, now);
+        if (v.disagree) {
+            v.source = TC_VOTE_HIGHER;
+            out = fmaxf(primary, backup + v.bias);
+        } else {
+            v.bias = v.haveBias ? v.bias + TC_VOTE_BIAS_GAIN * (v.diff - v.bias) : v.diff;
+            v.haveBias = true;
+            bool failedOver = (v.source == TC_VOTE_BACKUP);
+            if (failedOver && v.primaryGoodStreak < TC_VOTE_RECOVER_READS) {
+                out = backup + v.bias;
+            } else {
+                v.source = TC_VOTE_PRIMARY;
+                out = primary;
+            }
+        }
+    } else if (primaryOk) {
+        v.disagree = false;
+        v.source = TC_VOTE_PRIMARY;
+        out = primary;
+    } else if (backupOk) {
+        v.disagree = false;
+        v.source = TC_VOTE_BACKUP;
+        out = backup + v.bias;
+    } else {
+        v.source = TC_VOTE_NONE;
+        return false;
+    }
+
+    // Persistent disagreement latches the drift warning
+    if (v.disagree) {
+        v.disagreeMs += dtMs;
+        if (v.disagreeMs >= (long)TC_VOTE_DRIFT_MS) {
+            v.driftWarning = true;
+        }
+    } else if (primaryOk && backupOk) {
+        v.disagreeMs = (v.disagreeMs > (long)dtMs) ? v.disagreeMs - dtMs : 0;
+    }
+
+    if ((previous == TC_VOTE_BACKUP) != (v.source == TC_VOTE_BACKUP)) {
+        v.failovers++;
+    }
+    return true;
+}
+
+const char* tcVoteSourceName(TcVoteSource s) {
+    switch (s) {
+        case TC_VOTE_PRIMARY: return "primary";
+        case TC_VOTE_BACKUP:  return "backup";
+        case TC_VOTE_HIGHER:  return "higher";
+        case TC_VOTE_NONE:    return "none";
+    }
+    return "?";
+}
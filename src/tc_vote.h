@@ -0,0 +1,68 @@
+#ifndef TC_VOTE_H
+#define TC_VOTE_H
+
+// Dual-thermocouple voting
+// Cross-checks a zone's primary and backup thermocouples on every read, in
+// constant time. While both agree the primary is used and the primary-backup
+// offset is tracked, so a failover to the backup carries that offset across
+// and the control temperature doesn't step. Two checks flag disagreement:
+//   - band: |primary - backup| wider than TC_VOTE_BAND (+ a fraction of the
+//     reading, thermocouple tolerance grows with temperature)
+//   - rate: the difference changing faster than TC_VOTE_RATE_BAND, i.e. one
+//     sensor drifting away while still inside the band
+// With two sensors neither can be proven right, so a disagreeing pair
+// controls on the higher reading (the kiln under-fires rather than
+// over-fires). Disagreement that persists for TC_VOTE_DRIFT_MS latches a
+// drift warning.
+//
+// Pure C++ with no Arduino dependencies so fault injection runs on host.
+
+#include <stdint.h>
+
+enum TcVoteSource {
+    TC_VOTE_PRIMARY,        // Both agree (or no backup): primary reading
+    TC_VOTE_BACKUP,         // Primary failed: backup + tracked offset
+    TC_VOTE_HIGHER,         // Both valid but disagreeing: higher reading
+    TC_VOTE_NONE            // Both failed
+};
+
+struct TcVote {
+    // Primary - backup offset while they agree (EMA)
+    float bias;
+    bool haveBias;
+
+    // Divergence rate of the smoothed difference over TC_VOTE_RATE_WINDOW_MS
+    float diffSmooth;
+    float windowDiff;       // diffSmooth at the start of the current window
+    unsigned long windowStart;
+    bool windowStarted;
+    float rateMismatch;     // Last completed window (°C/hour)
+
+    // Persistence
+    unsigned long lastUpdate;
+    long disagreeMs;        // Leaky: grows while disagreeing, drains while agreeing
+    uint16_t primaryGoodStreak;  // Consecutive good primary reads (for fail-back)
+
+    // Outputs
+    TcVoteSource source;
+    float diff;             // Latest primary - backup (°C)
+    bool disagree;
+    bool driftWarning;      // Latched until tcVoteReset()
+    uint32_t failovers;     // Source changes to or from the backup
+};
+
+void tcVoteReset(TcVote& v);
+
+/**
+ * Vote on one pair of readings
+ *
+ * @param primaryOk / backupOk False if that read failed (NaN, open, out of range)
+ * @param out Control temperature (°C), unchanged if both failed
+ * @return False if neither reading is usable
+ */
+bool tcVoteUpdate(TcVote& v, bool primaryOk, float primary, bool backupOk, float backup,
+                  unsigned long now, float& out);
+
+const char* tcVoteSourceName(TcVoteSource s);
+
+#endif // TC_VOTE_H
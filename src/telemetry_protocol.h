@@ -0,0 +1,324 @@
+#ifndef TELEMETRY_PROTOCOL_H
+#define TELEMETRY_PROTOCOL_H
+
+// Binary telemetry wire format
+// Shared by the firmware (encoder) and tools/telemetry (host decoder), so
+// both sides pack and unpack with the same code.
+//
+// Frame, before framing:
+//   u8  version       TLM_VERSION; decoders reject other versions
+//   u8  type          TlmMessageType
+//   u16 seq           Per-frame counter; a gap means frames were lost
+//   ..  payload
+//   u16 crc           CRC-16/CCITT-FALSE over version..payload
+// All fields are little-endian. The frame is COBS-encoded and sent as
+//   0x00 <cobs bytes> 0x00
+// COBS output never contains 0x00, so a decoder resynchronises at the next
+// zero after any corruption. Text that shares the port (status lines,
+// debug log) sits between frames. It fails the CRC and version checks and
+// is passed through as text.
+//
+// TLM_MSG_SAMPLE payload (one control tick; temperatures in 0.1 °C, duty
+// in 0.01 %):
+//   u32 timeMs
+//   i16 temp, hottest, target, wareTemp
+//   u16 output        Mean zone duty
+//   u8  mode          SystemMode
+//   u8  flags         TLM_FLAG_*
+//   u8  fault         FaultClass
+//   u8  profileState  ProfileState
+//   u8  profileSegment
+//   i16 faultResidual Fault observer innovation, 0.01 °C
+//   u8  zoneCount
+//   per zone: i16 temp, i16 setpoint, u16 output, u16 errors (saturating)
+//
+// Bytes per sample on the wire, one zone: 4 header + 30 payload + 2 CRC
+// = 36, plus 1 COBS overhead byte and 2 delimiters = 39. Each extra zone
+// adds 8. At 10 Hz a one-zone kiln sends 390 B/s, 3.4 % of a 115200-baud
+// link (11520 B/s); three zones send 550 B/s (4.8 %).
+//
+// Pure C++ with no Arduino dependencies.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+#define TLM_VERSION             1
+#define TLM_HEADER_BYTES        4
+#define TLM_CRC_BYTES           2
+#define TLM_ENCODED_SIZE(frame) ((frame) + (frame) / 254 + 1 + 2)  // COBS + delimiters
+#define TLM_MAX_ZONES           8
+#define TLM_MAX_FRAME           (TLM_HEADER_BYTES + 22 + 8 * TLM_MAX_ZONES + TLM_CRC_BYTES)
+#define TLM_MAX_ENCODED         TLM_ENCODED_SIZE(TLM_MAX_FRAME)
+
+enum TlmMessageType {
+    TLM_MSG_SAMPLE = 1,
+    // Firing log transfer, see log_transfer.h
+    TLM_MSG_XFER_LIST = 16,
+    TLM_MSG_XFER_ENTRY,
+    TLM_MSG_XFER_OPEN,
+    TLM_MSG_XFER_INFO,
+    TLM_MSG_XFER_DATA,
+    TLM_MSG_XFER_ACK,
+    TLM_MSG_XFER_CLOSE,
+    TLM_MSG_XFER_DONE
+};
+
+#define TLM_FLAG_HEATING        0x01
+#define TLM_FLAG_SENSOR_ERROR   0x02
+
+struct TlmZone {
+    float temp;
+    float setpoint;
+    float output;
+    uint16_t errors;
+};
+
+struct TlmSample {
+    uint16_t seq;
+    uint32_t timeMs;
+    float temp;
+    float hottest;
+    float target;
+    float wareTemp;
+    float output;
+    uint8_t mode;
+    uint8_t flags;
+    uint8_t fault;
+    uint8_t profileState;
+    uint8_t profileSegment;
+    float faultResidual;
+    uint8_t zoneCount;
+    TlmZone zones[TLM_MAX_ZONES];
+};
+
+// ============================================================================
+// CRC AND COBS
+// ============================================================================
+
+/**
+ * CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+ */
+static inline uint16_t tlmCrc16(const uint8_t* data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * COBS-encode (no delimiters)
+ *
+ * @return Encoded length, at most len + len / 254 + 1
+ */
+static inline size_t tlmCobsEncode(const uint8_t* in, size_t len, uint8_t* out) {
+    size_t code = 0;            // Index of the current block's code byte
+    size_t o = 1;
+    uint8_t run = 1;
+    for (size_t i = 0; i < len; i++) {
+        if (in[i] == 0) {
+            out[code] = run;
+            code = o++;
+            run = 1;
+        } else {
+            out[o++] = in[i];
+            if (++run == 0xFF) {
+                out[code] = run;
+                code = o++;
+                run = 1;
+            }
+        }
+    }
+    out[code] = run;
+    return o;
+}
+
+/**
+ * COBS-decode one frame (delimiters already stripped)
+ *
+ * @return Decoded length, or 0 if the input isn't valid COBS
+ */
+static inline size_t tlmCobsDecode(const uint8_t* in, size_t len, uint8_t* out) {
+    size_t i = 0;
+    size_t o = 0;
+    while (i < len) {
+        uint8_t code = in[i++];
+        if (code == 0 || i + code - 1 > len) {
+            return 0;
+        }
+        for (uint8_t k = 1; k < code; k++) {
+            out[o++] = in[i++];
+        }
+        if (code != 0xFF && i < len) {
+            out[o++] = 0;
+        }
+    }
+    return o;
+}
+
+// ============================================================================
+// FIELD PACKING
+// ============================================================================
+
+static inline int16_t tlmFixed16(float v, float scale) {
+    if (isnan(v)) {
+        return INT16_MIN;       // Reserved: no value
+    }
+    float x = roundf(v * scale);
+    if (x > 32767.0f) return 32767;
+    if (x < -32767.0f) return -32767;
+    return (int16_t)x;
+}
+
+static inline uint16_t tlmUFixed16(float v, float scale) {
+    float x = isnan(v) ? 0.0f : roundf(v * scale);
+    if (x > 65535.0f) return 65535;
+    if (x < 0.0f) return 0;
+    return (uint16_t)x;
+}
+
+static inline float tlmUnfixed16(int16_t v, float scale) {
+    return (v == INT16_MIN) ? NAN : v / scale;
+}
+
+static inline void tlmPut8(uint8_t*& p, uint8_t v) { *p++ = v; }
+static inline void tlmPut16(uint8_t*& p, uint16_t v) {
+    *p++ = (uint8_t)v;
+    *p++ = (uint8_t)(v >> 8);
+}
+static inline void tlmPut32(uint8_t*& p, uint32_t v) {
+    tlmPut16(p, (uint16_t)v);
+    tlmPut16(p, (uint16_t)(v >> 16));
+}
+static inline uint8_t tlmGet8(const uint8_t*& p) { return *p++; }
+static inline uint16_t tlmGet16(const uint8_t*& p) {
+    uint16_t v = (uint16_t)(p[0] | (p[1] << 8));
+    p += 2;
+    return v;
+}
+static inline uint32_t tlmGet32(const uint8_t*& p) {
+    uint32_t lo = tlmGet16(p);
+    return lo | ((uint32_t)tlmGet16(p) << 16);
+}
+
+// ============================================================================
+// FRAMES
+// ============================================================================
+
+/**
+ * Write a frame header
+ *
+ * @return Where the payload starts
+ */
+static inline uint8_t* tlmBeginFrame(uint8_t* frame, uint8_t type, uint16_t seq) {
+    uint8_t* p = frame;
+    tlmPut8(p, TLM_VERSION);
+    tlmPut8(p, type);
+    tlmPut16(p, seq);
+    return p;
+}
+
+/**
+ * Append the CRC at end (2 spare bytes needed) and frame the result
+ *
+ * @param out At least TLM_ENCODED_SIZE(frame length + TLM_CRC_BYTES) bytes
+ * @return Bytes to send: 0x00, COBS(frame + CRC), 0x00
+ */
+static inline size_t tlmSealFrame(uint8_t* frame, uint8_t* end, uint8_t* out) {
+    tlmPut16(end, tlmCrc16(frame, end - frame));
+    out[0] = 0;
+    size_t n = tlmCobsEncode(frame, end - frame, out + 1);
+    out[n + 1] = 0;
+    return n + 2;
+}
+
+/**
+ * Version and CRC check of a decoded frame
+ */
+static inline bool tlmCheckFrame(const uint8_t* frame, size_t len) {
+    if (len < TLM_HEADER_BYTES + TLM_CRC_BYTES || frame[0] != TLM_VERSION) {
+        return false;
+    }
+    const uint8_t* c = frame + len - TLM_CRC_BYTES;
+    return tlmGet16(c) == tlmCrc16(frame, len - TLM_CRC_BYTES);
+}
+
+// ============================================================================
+// SAMPLES
+// ============================================================================
+
+/**
+ * Build a complete framed sample
+ *
+ * @param out At least TLM_MAX_ENCODED bytes
+ * @return Bytes to send
+ */
+static inline size_t tlmEncodeSample(const TlmSample& s, uint8_t* out) {
+    uint8_t frame[TLM_MAX_FRAME];
+    uint8_t* p = tlmBeginFrame(frame, TLM_MSG_SAMPLE, s.seq);
+    uint8_t zoneCount = s.zoneCount < TLM_MAX_ZONES ? s.zoneCount : TLM_MAX_ZONES;
+
+    tlmPut32(p, s.timeMs);
+    tlmPut16(p, (uint16_t)tlmFixed16(s.temp, 10.0f));
+    tlmPut16(p, (uint16_t)tlmFixed16(s.hottest, 10.0f));
+    tlmPut16(p, (uint16_t)tlmFixed16(s.target, 10.0f));
+    tlmPut16(p, (uint16_t)tlmFixed16(s.wareTemp, 10.0f));
+    tlmPut16(p, tlmUFixed16(s.output, 100.0f));
+    tlmPut8(p, s.mode);
+    tlmPut8(p, s.flags);
+    tlmPut8(p, s.fault);
+    tlmPut8(p, s.profileState);
+    tlmPut8(p, s.profileSegment);
+    tlmPut16(p, (uint16_t)tlmFixed16(s.faultResidual, 100.0f));
+    tlmPut8(p, zoneCount);
+    for (int z = 0; z < zoneCount; z++) {
+        tlmPut16(p, (uint16_t)tlmFixed16(s.zones[z].temp, 10.0f));
+        tlmPut16(p, (uint16_t)tlmFixed16(s.zones[z].setpoint, 10.0f));
+        tlmPut16(p, tlmUFixed16(s.zones[z].output, 100.0f));
+        tlmPut16(p, s.zones[z].errors);
+    }
+    return tlmSealFrame(frame, p, out);
+}
+
+/**
+ * Check and unpack one decoded frame (COBS already removed)
+ *
+ * @return False on a bad CRC, version, type or length
+ */
+static inline bool tlmDecodeSample(const uint8_t* frame, size_t len, TlmSample& s) {
+    const size_t fixed = TLM_HEADER_BYTES + 22 + TLM_CRC_BYTES;
+    if (len < fixed || frame[1] != TLM_MSG_SAMPLE || !tlmCheckFrame(frame, len)) {
+        return false;
+    }
+    const uint8_t* p = frame + 2;
+    s.seq = tlmGet16(p);
+    s.timeMs = tlmGet32(p);
+    s.temp = tlmUnfixed16((int16_t)tlmGet16(p), 10.0f);
+    s.hottest = tlmUnfixed16((int16_t)tlmGet16(p), 10.0f);
+    s.target = tlmUnfixed16((int16_t)tlmGet16(p), 10.0f);
+    s.wareTemp = tlmUnfixed16((int16_t)tlmGet16(p), 10.0f);
+    s.output = tlmGet16(p) / 100.0f;
+    s.mode = tlmGet8(p);
+    s.flags = tlmGet8(p);
+    s.fault = tlmGet8(p);
+    s.profileState = tlmGet8(p);
+    s.profileSegment = tlmGet8(p);
+    s.faultResidual = tlmUnfixed16((int16_t)tlmGet16(p), 100.0f);
+    s.zoneCount = tlmGet8(p);
+    if (s.zoneCount > TLM_MAX_ZONES || len != fixed + 8 * (size_t)s.zoneCount) {
+        return false;
+    }
+    for (int z = 0; z < s.zoneCount; z++) {
+        s.zones[z].temp = tlmUnfixed16((int16_t)tlmGet16(p), 10.0f);
+        s.zones[z].setpoint = tlmUnfixed16((int16_t)tlmGet16(p), 10.0f);
+        s.zones[z].output = tlmGet16(p) / 100.0f;
+        s.zones[z].errors = tlmGet16(p);
+    }
+    return true;
+}
+
+#endif // TELEMETRY_PROTOCOL_H
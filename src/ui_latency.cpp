@@ -0,0 +1,122 @@
+/**
+ * Input-to-photon latency
+ *
+ * Pending events live in a small fixed table. An event resolves on the first
+ * frame with applied <= frame start; the signed 32-bit difference keeps that
+ * test valid across the micros() wrap. Events whose change never reaches a
+ * tracked screen (e.g. a press that leaves for the hardware test menu) are
+ * expired after UI_LATENCY_TIMEOUT_MS instead of being charged to a later
+ * frame.
+ */
+
+#include <string.h>
+#include "ui_latency.h"
+
+static const uint32_t timeoutUs = (uint32_t)UI_LATENCY_TIMEOUT_MS * 1000UL;
+
+static inline bool notAfter(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) <= 0;
+}
+
+static void expireStale(UiLatency& ui, uint32_t nowUs) {
+    for (int i = 0; i < UI_LATENCY_PENDING; i++) {
+        UiPendingEvent& e = ui.pending[i];
+        if (e.used && nowUs - e.inputUs > timeoutUs) {
+            e.used = false;
+            ui.expired++;
+        }
+    }
+}
+
+void uiLatencyReset(UiLatency& ui) {
+    memset(&ui, 0, sizeof(ui));
+}
+
+// ============================================================================
+// STAGES
+// ============================================================================
+
+void uiLatencyInput(UiLatency& ui, uint32_t nowUs) {
+    expireStale(ui, nowUs);
+    for (int i = 0; i < UI_LATENCY_PENDING; i++) {
+        UiPendingEvent& e = ui.pending[i];
+        if (!e.used) {
+            e.used = true;
+            e.applied = false;
+            e.inputUs = nowUs;
+            e.appliedUs = 0;
+            return;
+        }
+    }
+    ui.dropped++;
+}
+
+void uiLatencyApplied(UiLatency& ui, uint32_t nowUs) {
+    for (int i = 0; i < UI_LATENCY_PENDING; i++) {
+        UiPendingEvent& e = ui.pending[i];
+        if (e.used && !e.applied) {
+            e.applied = true;
+            e.appliedUs = nowUs;
+        }
+    }
+}
+
+void uiLatencyFrame(UiLatency& ui, UiScreen screen, uint32_t startUs, uint32_t endUs) {
+    if (screen >= UI_SCREEN_COUNT) {
+        return;
+    }
+    UiScreenLatency& s = ui.screens[screen];
+    s.frames++;
+
+    for (int i = 0; i < UI_LATENCY_PENDING; i++) {
+        UiPendingEvent& e = ui.pending[i];
+        if (!e.used || !e.applied || !notAfter(e.appliedUs, startUs)) {
+            continue;
+        }
+        uint32_t latency = endUs - e.inputUs;
+        s.count++;
+        s.totalUs += latency;
+        s.applyUs += e.appliedUs - e.inputUs;
+        s.waitUs += startUs - e.appliedUs;
+        s.drawUs += endUs - startUs;
+        if (latency > s.maxUs) {
+            s.maxUs = latency;
+        }
+        int bucket = 0;
+        while (bucket < UI_LATENCY_BUCKETS - 1 && latency >= (1UL << bucket)) {
+            bucket++;
+        }
+        s.histogram[bucket]++;
+        e.used = false;
+    }
+    expireStale(ui, endUs);
+}
+
+// ============================================================================
+// REPORTING
+// ============================================================================
+
+uint32_t uiLatencyPercentile(const UiScreenLatency& s, float percentile) {
+    if (s.count == 0) {
+        return 0;
+    }
+    uint32_t rank = (uint32_t)(s.count * percentile / 100.0f);
+    uint32_t seen = 0;
+    for (int b = 0; b < UI_LATENCY_BUCKETS; b++) {
+        seen += s.histogram[b];
+        if (seen > rank) {
+            return (b == UI_LATENCY_BUCKETS - 1 || (1UL << b) > s.maxUs) ? s.maxUs : (1UL << b);
+        }
+    }
+    return s.maxUs;
+}
+
+const char* uiScreenName(UiScreen screen) {
+    switch (screen) {
+        case UI_SCREEN_MENU:    return "menu";
+        case UI_SCREEN_MANUAL:  return "manual";
+        case UI_SCREEN_PROFILE: return "profile";
+        case UI_SCREEN_COUNT:   break;
+    }
+    return "?";
+}
@@ -0,0 +1,86 @@
+#ifndef UI_LATENCY_H
+#define UI_LATENCY_H
+
+// Input-to-photon latency
+// Each encoder or button event is stamped when the handler acts on it and
+// followed through three stages:
+//   input    the handler sees the edge (before any beep)
+//   applied  the change is visible to the renderer: at once for UI-local
+//            state (menu cursor, profile choice), or when the control sample
+//            carrying a queued command's effect is published
+//   frame    the first redraw that started after the change was applied
+//            finishes; TFT_eSPI writes block until SPI has shifted the last
+//            pixel out, so the end of the draw call is when it is on the glass
+// A frame resolves every pending event applied before it started, so
+// several detents turned between redraws are each charged their own wait.
+// Latency is kept per screen in a log2 histogram, with the mean time spent
+// in each stage, so a regression shows where it came from.
+//
+// Pure C++ with no Arduino dependencies; timestamps are micros() values and
+// all comparisons survive its wrap-around.
+
+#include <stdint.h>
+#include "config.h"
+
+enum UiScreen {
+    UI_SCREEN_MENU,
+    UI_SCREEN_MANUAL,
+    UI_SCREEN_PROFILE,
+    UI_SCREEN_COUNT
+};
+
+#define UI_LATENCY_BUCKETS 21   // Bucket b counts latencies below 2^b µs (~1 s at the top)
+
+struct UiPendingEvent {
+    bool used;
+    bool applied;
+    uint32_t inputUs;
+    uint32_t appliedUs;
+};
+
+struct UiScreenLatency {
+    uint32_t count;             // Events that reached the glass
+    uint32_t frames;
+    uint32_t maxUs;
+    uint64_t totalUs;
+    uint64_t applyUs;           // Sum of input -> applied
+    uint64_t waitUs;            // Sum of applied -> frame start
+    uint64_t drawUs;            // Sum of frame start -> pixels out
+    uint32_t histogram[UI_LATENCY_BUCKETS];
+};
+
+struct UiLatency {
+    UiPendingEvent pending[UI_LATENCY_PENDING];
+    UiScreenLatency screens[UI_SCREEN_COUNT];
+    uint32_t dropped;           // No free pending slot
+    uint32_t expired;           // Never drawn within UI_LATENCY_TIMEOUT_MS
+};
+
+void uiLatencyReset(UiLatency& ui);
+
+/**
+ * Stamp an input event the handler is acting on
+ */
+void uiLatencyInput(UiLatency& ui, uint32_t nowUs);
+
+/**
+ * Mark every pending event not yet applied as visible to the renderer
+ */
+void uiLatencyApplied(UiLatency& ui, uint32_t nowUs);
+
+/**
+ * Record a completed frame and resolve the events it shows
+ *
+ * @param startUs When the frame began reading state
+ * @param endUs   When the last pixel left the SPI bus
+ */
+void uiLatencyFrame(UiLatency& ui, UiScreen screen, uint32_t startUs, uint32_t endUs);
+
+/**
+ * Upper bound of the bucket holding the given percentile (µs)
+ */
+uint32_t uiLatencyPercentile(const UiScreenLatency& s, float percentile);
+
+const char* uiScreenName(UiScreen screen);
+
+#endif // UI_LATENCY_H
@@ -0,0 +1,65 @@
+/**
+ * Ware temperature observer
+ *
+ * Model (lumped, per node):
+ *   Ca * dTa/dt = P - Kaw * (Ta - Tw) - Kloss * (Ta - Tamb)
+ *   Cw * dTw/dt = Kaw * (Ta - Tw)
+ *
+ * Forward-Euler prediction followed by a Luenberger correction on both nodes
+ * driven by the air-temperature innovation. Runs once per temperature read.
+ */
+
+#include <math.h>
+#include "ware_observer.h"
+
+WareObserver wareObserver = {
+    .airTemp = OBSERVER_AMBIENT_TEMP,
+    .wareTemp = OBSERVER_AMBIENT_TEMP,
+    .innovation = 0.0,
+    .initialized = false,
+    .inToleranceSince = 0
+};
+
+void wareObserverReset(float temp) {
+    wareObserver.airTemp = temp;
+    wareObserver.wareTemp = temp;
+    wareObserver.innovation = 0.0;
+    wareObserver.initialized = true;
+    wareObserver.inToleranceSince = 0;
+}
+
+void wareObserverUpdate(float measuredTemp, float powerWatts, float dtSeconds) {
+    if (!wareObserver.initialized) {
+        wareObserverReset(measuredTemp);
+        return;
+    }
+
+    float ta = wareObserver.airTemp;
+    float tw = wareObserver.wareTemp;
+
+    // Predict
+    float airToWare = OBSERVER_AIR_WARE_COUPLING * (ta - tw);
+    float loss = OBSERVER_LOSS_COUPLING * (ta - OBSERVER_AMBIENT_TEMP);
+    ta += dtSeconds * (powerWatts - airToWare - loss) / OBSERVER_AIR_CAPACITY;
+    tw += dtSeconds * airToWare / OBSERVER_WARE_CAPACITY;
+
+    // Correct
+    float e = measuredTemp - ta;
+    ta += OBSERVER_GAIN_AIR * dtSeconds * e;
+    tw += OBSERVER_GAIN_WARE * dtSeconds * e;
+
+    wareObserver.airTemp = ta;
+    wareObserver.wareTemp = tw;
+    wareObserver.innovation = e;
+}
+
+bool wareObserverIsSoaked(float targetTemp, unsigned long now) {
+    if (fabs(wareObserver.wareTemp - targetTemp) > WARE_SOAK_TOLERANCE) {
+        wareObserver.inToleranceSince = 0;
+        return false;
+    }
+    if (wareObserver.inToleranceSince == 0) {
+        wareObserver.inToleranceSince = now;
+    }
+    return now - wareObserver.inToleranceSince >= WARE_SOAK_HOLD_MS;
+}
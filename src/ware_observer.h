@@ -0,0 +1,49 @@
+#ifndef WARE_OBSERVER_H
+#define WARE_OBSERVER_H
+
+// Ware temperature observer
+// Luenberger observer on a two-node thermal model (kiln air <-> ware load).
+// The thermocouple only sees the air node; the ware node is inferred from
+// applied SSR power and the air-temperature innovation.
+//
+// The OBSERVER_* constants are generic, not measured on this kiln. With a
+// heavier load or weaker air-to-ware coupling than they assume, the
+// estimate leads the real ware, so a soak ended on it would be short.
+// Ending soaks on the estimate is therefore behind ENABLE_WARE_SOAK_END
+// (off by default); otherwise it is only logged as advice.
+//
+// Pure C++ (host-testable).
+
+#include "config.h"
+
+struct WareObserver {
+    float airTemp;          // Estimated kiln air temperature (°C)
+    float wareTemp;         // Estimated ware temperature (°C)
+    float innovation;       // Last measurement residual (measured - estimated air)
+    bool initialized;
+    unsigned long inToleranceSince;  // When ware entered the soak band (0 = not in band)
+};
+
+extern WareObserver wareObserver;
+
+/**
+ * Reset the observer to a uniform temperature (kiln assumed at equilibrium)
+ */
+void wareObserverReset(float temp);
+
+/**
+ * Advance the model one step and correct it with a thermocouple reading
+ *
+ * @param measuredTemp Thermocouple reading (°C)
+ * @param powerWatts Electrical power applied over the step (W)
+ * @param dtSeconds Step length (s)
+ */
+void wareObserverUpdate(float measuredTemp, float powerWatts, float dtSeconds);
+
+/**
+ * True once the estimated ware temperature has stayed within
+ * WARE_SOAK_TOLERANCE of target for WARE_SOAK_HOLD_MS
+ */
+bool wareObserverIsSoaked(float targetTemp, unsigned long now);
+
+#endif // WARE_OBSERVER_H
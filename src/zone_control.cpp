@@ -0,0 +1,130 @@
+/**
+ * Multi-zone heating control
+ *
+ * Balancing is a proportional setpoint trim, clamped to ZONE_BALANCE_MAX:
+ *   setpoint_z = target - min(ZONE_BALANCE_GAIN * (T_z - T_coldest), ZONE_BALANCE_MAX)
+ * The coldest zone always gets the full target, so the kiln as a whole
+ * still reaches it; the others are held back while they lead. A tick is
+ * one pass to find the coldest zone and one PID Compute() per zone, so its
+ * cost grows linearly with KILN_ZONE_COUNT.
+ */
+
+#include "zone_control.h"
+
+// ============================================================================
+// BALANCING
+// ============================================================================
+
+float zoneBalancedSetpoint(float target, float zoneTemp, float coldest) {
+    float trim = ZONE_BALANCE_GAIN * (zoneTemp - coldest);
+    if (trim > ZONE_BALANCE_MAX) {
+        trim = ZONE_BALANCE_MAX;
+    }
+    return target - trim;
+}
+
+ZoneHeatGate zoneHeatGate(bool idle, bool sensorError, bool stuckSsr, float target,
+                          float hottest, float limit) {
+    if (sensorError) {
+        return ZONE_HEAT_SENSOR_ERROR;
+    }
+    if (stuckSsr) {
+        return ZONE_HEAT_STUCK_SSR;
+    }
+    if (idle) {
+        return ZONE_HEAT_IDLE;
+    }
+    if (target > limit) {
+        return ZONE_HEAT_TARGET_LIMIT;
+    }
+    if (hottest >= limit) {
+        return ZONE_HEAT_TEMP_LIMIT;
+    }
+    return ZONE_HEAT_OK;
+}
+
+// ============================================================================
+// TARGET
+// ============================================================================
+
+#if defined(ARDUINO)
+
+ZoneController::ZoneController()
+    : _input(0), _output(0), _setpoint(0), _running(false),
+      _pid(&_input, &_output, &_setpoint, DEFAULT_KP, DEFAULT_KI, DEFAULT_KD, DIRECT) {
+}
+
+void ZoneController::begin(double kp, double ki, double kd, double outMin, double outMax,
+                           int sampleTimeMs) {
+    _pid.SetTunings(kp, ki, kd);
+    _pid.SetOutputLimits(outMin, outMax);
+    _pid.SetSampleTime(sampleTimeMs);
+    _pid.SetMode(MANUAL);
+    _running = false;
+    _output = 0;
+}
+
+bool ZoneController::compute(float temp, float setpoint) {
+    _input = temp;
+    _setpoint = setpoint;
+    if (!_running) {
+        _pid.SetMode(AUTOMATIC);
+        _running = true;
+    }
+    return _pid.Compute();
+}
+
+void ZoneController::stop() {
+    if (_running) {
+        _pid.SetMode(MANUAL);
+        _running = false;
+    }
+    _output = 0;
+}
+
+void ZoneController::setTunings(double kp, double ki, double kd) {
+    _pid.SetTunings(kp, ki, kd);
+}
+
+ZoneSummary zonesSummarize(const KilnZone* zones, int count) {
+    ZoneSummary s = {0, -1, -1, 0.0f, 0.0f, 0.0f};
+    double outputSum = 0.0;
+    for (int z = 0; z < count; z++) {
+        outputSum += zones[z].controller.output();
+        if (!zones[z].valid) {
+            continue;
+        }
+        if (s.validCount == 0 || zones[z].temp < s.coldest) {
+            s.coldest = zones[z].temp;
+            s.coldestZone = z;
+        }
+        if (s.validCount == 0 || zones[z].temp > s.hottest) {
+            s.hottest = zones[z].temp;
+            s.hottestZone = z;
+        }
+        s.validCount++;
+    }
+    s.meanOutput = (float)(outputSum / count);
+    return s;
+}
+
+bool zonesControlTick(KilnZone* zones, int count, float target) {
+    float coldest = zones[0].temp;
+    for (int z = 1; z < count; z++) {
+        if (zones[z].temp < coldest) {
+            coldest = zones[z].temp;
+        }
+    }
+
+    bool zone0Computed = false;
+    for (int z = 0; z < count; z++) {
+        float setpoint = zoneBalancedSetpoint(target, zones[z].temp, coldest);
+        bool computed = zones[z].controller.compute(zones[z].temp, setpoint);
+        if (z == 0) {
+            zone0Computed = computed;
+        }
+    }
+    return zone0Computed;
+}
+
+#endif // ARDUINO
@@ -0,0 +1,127 @@
+#ifndef ZONE_CONTROL_H
+#define ZONE_CONTROL_H
+
+// Multi-zone heating control
+// Each zone has its own MAX31855 (chip select on the shared SPI bus), SSR and
+// PID loop. All zones chase the same target, but a zone running ahead of the
+// coldest zone has its setpoint lowered by ZONE_BALANCE_GAIN per degree of
+// lead, so the hot zone throttles until the cold one catches up instead of
+// racing to the target. The coldest zone is the kiln's control temperature
+// (profile, observers); the hottest is the one checked against the safety
+// limit. With KILN_ZONE_COUNT 1 this is exactly the single-loop controller.
+//
+// Balancing and the heat gate are pure C++ (host-testable); the zones and
+// their PIDs are target-only.
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * Setpoint for a zone that leads the coldest zone by (zoneTemp - coldest)
+ */
+float zoneBalancedSetpoint(float target, float zoneTemp, float coldest);
+
+enum ZoneHeatGate {
+    ZONE_HEAT_OK,
+    ZONE_HEAT_SENSOR_ERROR,     // A zone's thermocouple failed
+    ZONE_HEAT_STUCK_SSR,        // Latched until reboot
+    ZONE_HEAT_IDLE,             // Nothing to heat for (idle, E-stop)
+    ZONE_HEAT_TARGET_LIMIT,     // Target above the heating ceiling
+    ZONE_HEAT_TEMP_LIMIT        // Hottest zone at or above the ceiling
+};
+
+/**
+ * Whether the zone PIDs may drive the SSRs this tick
+ * Anything but ZONE_HEAT_OK means every SSR off and every PID in MANUAL.
+ */
+ZoneHeatGate zoneHeatGate(bool idle, bool sensorError, bool stuckSsr, float target,
+                          float hottest, float limit);
+
+// ============================================================================
+// TARGET
+// ============================================================================
+
+#if defined(ARDUINO)
+
+#include <PID_v1.h>
+#include "tc_sampler.h"
+#include "tc_vote.h"
+
+/**
+ * One zone's PID with private input/output/setpoint (same pattern as
+ * ShadowController), so zones can live in a plain array
+ */
+class ZoneController {
+public:
+    ZoneController();
+
+    void begin(double kp, double ki, double kd, double outMin, double outMax, int sampleTimeMs);
+
+    /**
+     * Run the PID on this tick's reading (switches to AUTOMATIC on first use)
+     *
+     * @return True if a new output was computed
+     */
+    bool compute(float temp, float setpoint);
+
+    /**
+     * Drop to MANUAL with zero output (safety paths)
+     */
+    void stop();
+
+    void setTunings(double kp, double ki, double kd);
+
+    bool running() const { return _running; }
+    double output() const { return _output; }
+    double setpoint() const { return _setpoint; }
+
+private:
+    double _input;
+    double _output;
+    double _setpoint;
+    bool _running;          // Mirrors the PID mode (PID::GetMode() isn't const)
+    PID _pid;
+};
+
+struct KilnZone {
+    // Latest reading
+    float temp;             // Linearized, offset-corrected (°C), voted if redundant
+    bool valid;             // Last read gave a usable temperature
+    uint32_t reads;
+    uint32_t errors;        // Failed thermocouple reads (either sensor)
+
+    // Control
+    ZoneController controller;
+    unsigned long onTime;   // SSR on-time in the current window (ms)
+    bool heating;           // SSR output state
+    bool lastHeating;       // For edge detection
+
+    TcSampler sampler;      // Read scheduling around this zone's SSR edges
+    TcVote vote;            // Primary/backup cross-check (zones with a backup only)
+};
+
+struct ZoneSummary {
+    int validCount;
+    int coldestZone;
+    int hottestZone;
+    float coldest;          // Control temperature (°C)
+    float hottest;          // Safety temperature (°C)
+    float meanOutput;       // Mean duty across zones (%)
+};
+
+/**
+ * Coldest/hottest valid zones and mean duty
+ */
+ZoneSummary zonesSummarize(const KilnZone* zones, int count);
+
+/**
+ * Balance setpoints and run every zone's PID
+ * All zone readings must be valid (the caller's sensor-error guard).
+ *
+ * @return True if zone 0 computed a new output this tick
+ */
+bool zonesControlTick(KilnZone* zones, int count, float target);
+
+#endif // ARDUINO
+
+#endif // ZONE_CONTROL_H
@@ -0,0 +1,153 @@
+/**
+ * Async log: formatting, ring overflow and drop accounting
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <unity.h>
+#include "async_log.h"
+
+#define LEVEL 4
+
+static char formatted[256];
+
+/**
+ * Log through the ring and format it back
+ */
+#define ROUND_TRIP(...)                                                     \
+    do {                                                                    \
+        char expect[256];                                                   \
+        LogRecord r;                                                        \
+        logWrite(LEVEL, LOG_MOD_MAIN, __VA_ARGS__);                         \
+        TEST_ASSERT_TRUE(logPop(logRing, r));                               \
+        logFormat(r, formatted, sizeof(formatted));                         \
+        snprintf(expect, sizeof(expect), __VA_ARGS__);                      \
+        TEST_ASSERT_EQUAL_STRING(expect, formatted);                        \
+    } while (0)
+
+void setUp(void) {
+    logRingInit(logRing);
+}
+
+void tearDown(void) {}
+
+void test_records_format_as_printf_would(void) {
+    ROUND_TRIP("[PROFILE] Segment %d/%d: %.0f C/h to %.0f C, soak %u min\n", 2, 5, 150.0f,
+               1222.4, 30u);
+    ROUND_TRIP("neg %d %u %x %lu %lld\n", -7, (unsigned)-7, 255, 4000000000UL, -123456789012LL);
+    ROUND_TRIP("%5.2f|%-6s|%c %%\n", 3.14159, "ab", 'Z');
+    ROUND_TRIP("%08.3f %+d %#x %e %g\n", 2.5, 9, 17, 12345.678, 0.0001);
+}
+
+void test_long_arguments_are_truncated_and_flagged(void) {
+    char big[100];
+    memset(big, 'q', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    logWrite(LEVEL, LOG_MOD_MAIN, "%s %d\n", big, 5);
+    LogRecord r;
+    TEST_ASSERT_TRUE(logPop(logRing, r));
+    TEST_ASSERT_TRUE(r.flags & LOG_FLAG_TRUNCATED);
+    TEST_ASSERT_TRUE(r.length <= LOG_PAYLOAD_BYTES);
+    size_t n = logFormat(r, formatted, sizeof(formatted));
+    TEST_ASSERT_TRUE(n < strlen(big));
+}
+
+/**
+ * A full ring drops new records and counts them; the records kept are the
+ * oldest, and nothing blocks
+ */
+void test_full_ring_drops_and_counts(void) {
+    const int logged = 1000;
+    for (int i = 0; i < logged; i++) {
+        logWrite(LEVEL, LOG_MOD_MAIN, "x %d\n", i);
+    }
+    TEST_ASSERT_EQUAL_UINT32(logged - LOG_RING_DEPTH, logRing.stats.dropped.load());
+
+    LogRecord r;
+    int popped = 0;
+    while (logPop(logRing, r)) {
+        logFormat(r, formatted, sizeof(formatted));
+        char expect[32];
+        snprintf(expect, sizeof(expect), "x %d\n", popped);
+        TEST_ASSERT_EQUAL_STRING(expect, formatted);
+        popped++;
+    }
+    TEST_ASSERT_EQUAL_INT(LOG_RING_DEPTH, popped);
+    TEST_ASSERT_EQUAL_UINT32(LOG_RING_DEPTH, logRing.stats.maxDepth);
+
+    // Drained: logging works again and the drop count stays
+    logWrite(LEVEL, LOG_MOD_MAIN, "after\n");
+    TEST_ASSERT_TRUE(logPop(logRing, r));
+    TEST_ASSERT_EQUAL_UINT32(logged - LOG_RING_DEPTH, logRing.stats.dropped.load());
+}
+
+/**
+ * Three tasks log while a drain empties the ring. Each record is either
+ * drained or counted as dropped, and each task's records stay in order.
+ */
+void test_concurrent_producers_account_for_every_record(void) {
+    const int producers = 3;
+    const int perProducer = 100000;
+    std::atomic<bool> done(false);
+    long drained = 0;
+    long orderErrors = 0;
+    long garbled = 0;
+
+    std::thread drain([&] {
+        int last[producers] = {-1, -1, -1};
+        LogRecord r;
+        char line[128];
+        for (;;) {
+            bool finished = done.load();
+            if (logPop(logRing, r)) {
+                logFormat(r, line, sizeof(line));
+                int task, seq;
+                if (sscanf(line, "t%d %d", &task, &seq) != 2 || task < 0 || task >= producers) {
+                    garbled++;
+                    continue;
+                }
+                orderErrors += seq <= last[task];
+                last[task] = seq;
+                drained++;
+            } else if (finished) {
+                break;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < producers; t++) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < perProducer; i++) {
+                logWrite(LEVEL, LOG_MOD_MAIN, "t%d %d %.2f %s\n", t, i, i * 0.5, "abc");
+                if (i % 64 == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    done.store(true);
+    drain.join();
+
+    TEST_ASSERT_EQUAL_INT32(0, garbled);
+    TEST_ASSERT_EQUAL_INT32(0, orderErrors);
+    TEST_ASSERT_EQUAL_INT32(producers * perProducer, drained + (long)logRing.stats.dropped.load());
+    TEST_ASSERT_EQUAL_UINT32(drained, logRing.stats.written);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_records_format_as_printf_would);
+    RUN_TEST(test_long_arguments_are_truncated_and_flagged);
+    RUN_TEST(test_full_ring_drops_and_counts);
+    RUN_TEST(test_concurrent_producers_account_for_every_record);
+    return UNITY_END();
+}
@@ -0,0 +1,181 @@
+/**
+ * Command queue: lane priority, E-stop flush, overflow and a
+ * multi-producer ordering stress test
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <unity.h>
+#include "command_queue.h"
+
+static CommandQueue queue;
+
+static Command make(CommandType type, int seq = 0, uint8_t source = CMD_SOURCE_ENCODER) {
+    Command c = {};
+    c.type = type;
+    c.source = source;
+    c.value[0] = (float)seq;    // Exact up to 2^24
+    return c;
+}
+
+void setUp(void) {
+    commandQueueInit(queue);
+}
+
+void tearDown(void) {}
+
+void test_lanes_drain_in_priority_order(void) {
+    commandPost(queue, make(CMD_SET_TUNINGS), 0);
+    commandPost(queue, make(CMD_PROFILE_START), 0);
+    commandPost(queue, make(CMD_ESTOP), 0);
+    commandPost(queue, make(CMD_PROFILE_STOP), 0);
+
+    Command out;
+    TEST_ASSERT_TRUE(commandPop(queue, out));
+    TEST_ASSERT_EQUAL(CMD_ESTOP, out.type);
+    TEST_ASSERT_TRUE(commandPop(queue, out));
+    TEST_ASSERT_EQUAL(CMD_PROFILE_START, out.type);     // Control lane stays FIFO
+    TEST_ASSERT_TRUE(commandPop(queue, out));
+    TEST_ASSERT_EQUAL(CMD_PROFILE_STOP, out.type);
+    TEST_ASSERT_TRUE(commandPop(queue, out));
+    TEST_ASSERT_EQUAL(CMD_SET_TUNINGS, out.type);
+    TEST_ASSERT_FALSE(commandPop(queue, out));
+}
+
+void test_estop_flushes_the_lower_lanes(void) {
+    commandPost(queue, make(CMD_PROFILE_START), 0);
+    commandPost(queue, make(CMD_SET_TUNINGS), 0);
+    commandPost(queue, make(CMD_ADJUST_TARGET), 0);
+    commandPost(queue, make(CMD_ESTOP), 0);
+
+    Command out;
+    TEST_ASSERT_TRUE(commandPop(queue, out));
+    TEST_ASSERT_EQUAL(CMD_ESTOP, out.type);
+    TEST_ASSERT_EQUAL_UINT32(3, commandFlushBelow(queue, CMD_LANE_SAFETY));
+    TEST_ASSERT_FALSE(commandPop(queue, out));
+    TEST_ASSERT_EQUAL_UINT32(2, queue.lanes[CMD_LANE_CONTROL].stats.flushed);
+    TEST_ASSERT_EQUAL_UINT32(1, queue.lanes[CMD_LANE_TUNE].stats.flushed);
+}
+
+void test_full_lane_drops_and_counts(void) {
+    int accepted = 0;
+    for (int i = 0; i < CMD_QUEUE_DEPTH + 3; i++) {
+        accepted += commandPost(queue, make(CMD_SET_TARGET, i), 0);
+    }
+    TEST_ASSERT_EQUAL_INT(CMD_QUEUE_DEPTH, accepted);
+    const CommandLaneStats& s = queue.lanes[CMD_LANE_CONTROL].stats;
+    TEST_ASSERT_EQUAL_UINT32(CMD_QUEUE_DEPTH, s.posted.load());
+    TEST_ASSERT_EQUAL_UINT32(3, s.dropped.load());
+
+    // The ones kept are the oldest, in order, and the lane takes posts again
+    Command out;
+    for (int i = 0; i < CMD_QUEUE_DEPTH; i++) {
+        TEST_ASSERT_TRUE(commandPop(queue, out));
+        TEST_ASSERT_EQUAL_FLOAT((float)i, out.value[0]);
+    }
+    TEST_ASSERT_FALSE(commandPop(queue, out));
+    TEST_ASSERT_TRUE(commandPost(queue, make(CMD_SET_TARGET), 0));
+}
+
+void test_other_lanes_still_accept_when_one_is_full(void) {
+    for (int i = 0; i < CMD_QUEUE_DEPTH; i++) {
+        commandPost(queue, make(CMD_SET_TUNINGS), 0);
+    }
+    TEST_ASSERT_FALSE(commandPost(queue, make(CMD_SET_TUNINGS), 0));
+    TEST_ASSERT_TRUE(commandPost(queue, make(CMD_ESTOP), 0));
+    TEST_ASSERT_TRUE(commandPost(queue, make(CMD_EXIT_TO_MENU), 0));
+}
+
+void test_latency_is_recorded_when_applied(void) {
+    commandPost(queue, make(CMD_SET_TARGET), 1000);
+    Command out;
+    TEST_ASSERT_TRUE(commandPop(queue, out));
+    commandNoteApplied(queue, out, 1300);
+    const CommandLaneStats& s = queue.lanes[CMD_LANE_CONTROL].stats;
+    TEST_ASSERT_EQUAL_UINT32(1, s.applied);
+    TEST_ASSERT_EQUAL_UINT32(300, s.maxLatencyUs);
+    TEST_ASSERT_EQUAL_UINT32(512, commandLatencyPercentile(s, 99.0f));
+}
+
+/**
+ * Three producers post numbered commands across all lanes, retrying when a
+ * lane is full, while one consumer drains. Every command arrives once, and
+ * each producer's commands stay in order within a lane.
+ */
+void test_producers_keep_per_lane_order(void) {
+    const int producers = 3;
+    const int perProducer = 200000;
+    std::atomic<bool> stop(false);
+    long consumed = 0;
+    long orderErrors = 0;
+
+    std::thread consumer([&] {
+        int last[producers][CMD_LANE_COUNT];
+        for (auto& p : last) {
+            for (int& l : p) {
+                l = -1;
+            }
+        }
+        Command out;
+        for (;;) {
+            bool got = false;
+            while (commandPop(queue, out)) {
+                got = true;
+                int lane = commandLane((CommandType)out.type);
+                int seq = (int)out.value[0];
+                orderErrors += seq <= last[out.source][lane];
+                last[out.source][lane] = seq;
+                commandNoteApplied(queue, out, 0);
+                consumed++;
+            }
+            if (!got) {
+                if (stop.load()) {
+                    break;
+                }
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([p] {
+            const CommandType types[] = {CMD_ADJUST_TARGET, CMD_SET_TUNINGS, CMD_ESTOP,
+                                         CMD_PROFILE_START};
+            for (int i = 0; i < perProducer; i++) {
+                Command c = make(types[i % 4], i, (uint8_t)p);
+                while (!commandPost(queue, c, 0)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    stop.store(true);
+    consumer.join();
+
+    uint32_t posted = 0;
+    uint32_t applied = 0;
+    for (int l = 0; l < CMD_LANE_COUNT; l++) {
+        posted += queue.lanes[l].stats.posted.load();
+        applied += queue.lanes[l].stats.applied;
+    }
+    TEST_ASSERT_EQUAL_INT32(producers * perProducer, consumed);
+    TEST_ASSERT_EQUAL_UINT32(producers * perProducer, posted);
+    TEST_ASSERT_EQUAL_UINT32(posted, applied);
+    TEST_ASSERT_EQUAL_INT32(0, orderErrors);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_lanes_drain_in_priority_order);
+    RUN_TEST(test_estop_flushes_the_lower_lanes);
+    RUN_TEST(test_full_lane_drops_and_counts);
+    RUN_TEST(test_other_lanes_still_accept_when_one_is_full);
+    RUN_TEST(test_latency_is_recorded_when_applied);
+    RUN_TEST(test_producers_keep_per_lane_order);
+    return UNITY_END();
+}
@@ -0,0 +1,196 @@
+/**
+ * Element health: band fits, the reachable-temperature extrapolation and
+ * the trend across firings
+ *
+ * The simulated kiln heats at duty * 600 °C/h against a loss of
+ * 0.4 °C/h per degree above ambient, so its full-power rate falls to
+ * ELEMENT_HEALTH_MIN_RATE (60 °C/h) at 1370 °C.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <unity.h>
+#include "config.h"
+#include "element_health.h"
+
+#define POWER_RATE  600.0f      // °C/h at full duty, before losses
+#define LOSS        0.4f        // °C/h per °C above ambient
+#define REACHABLE   (20.0f + (POWER_RATE - ELEMENT_HEALTH_MIN_RATE) / LOSS)
+
+/**
+ * Band rates that fall linearly to ELEMENT_HEALTH_MIN_RATE at `reachable`,
+ * measured up to (not including) band `bands`
+ */
+static HealthRecord recordFor(uint16_t firing, float reachable, int bands) {
+    HealthRecord rec;
+    rec.firingNumber = firing;
+    for (int i = 0; i < HEALTH_NUM_BANDS; i++) {
+        float x = HEALTH_BAND_MIN_C + (i + 0.5f) * HEALTH_BAND_WIDTH_C;
+        rec.bandRate[i] = i < bands ? (int16_t)(ELEMENT_HEALTH_MIN_RATE + 0.5f * (reachable - x))
+                                    : HEALTH_NO_DATA;
+    }
+    rec.reachableTemp = 0;
+    rec.peakTemp = 0;
+    return rec;
+}
+
+/**
+ * Fire the simulated kiln from 20 °C until it reaches `top` at a duty that
+ * wanders between 0.6 and 1, then coast up to `peak` at zero rate
+ * measurement (duty below ELEMENT_HEALTH_MIN_DUTY)
+ */
+static void fire(float top, float peak) {
+    const unsigned long dtMs = 500;
+    const unsigned long windowMs = 2000;
+    float temp = 20.0f;
+    elementHealthStartFiring();
+    for (unsigned long now = 0; temp < peak; now += dtMs) {
+        float duty = temp < top ? 0.8f + 0.2f * sinf(now / 300000.0f) : 0.2f;
+        bool on = now % windowMs < windowMs * duty;
+        elementHealthSample(temp, on, now);
+        float rate = (on ? POWER_RATE : 0.0f) - LOSS * (temp - 20.0f);
+        if (temp >= top) {
+            rate = 200.0f;      // Pushed on by something other than the elements
+        }
+        temp += rate * dtMs / 3600000.0f;
+    }
+}
+
+void setUp(void) {
+    elementHealthStartFiring();
+}
+
+void tearDown(void) {}
+
+void test_band_fit(void) {
+    HealthBandFit fit = {};
+    TEST_ASSERT_EQUAL_INT(HEALTH_NO_DATA, healthBandFullPowerRate(fit));
+
+    // rate = -100 + 500 * duty: 400 °C/h at full power
+    const float duties[] = {0.5f, 0.7f, 0.9f};
+    for (float d : duties) {
+        float rate = -100.0f + 500.0f * d;
+        fit.n++;
+        fit.sumX += d;
+        fit.sumY += rate;
+        fit.sumXX += d * d;
+        fit.sumXY += d * rate;
+    }
+    TEST_ASSERT_INT_WITHIN(1, 400, healthBandFullPowerRate(fit));
+
+    // Saturated at one duty: scaled to full power
+    HealthBandFit flat = {3, 3 * 0.9f, 3 * 270.0f, 3 * 0.81f, 3 * 243.0f};
+    TEST_ASSERT_INT_WITHIN(1, 300, healthBandFullPowerRate(flat));
+}
+
+void test_reachable_from_bands(void) {
+    const float target = healthTargetConeTemp();
+    TEST_ASSERT_EQUAL_FLOAT(1222.0f, target);   // Cone 6 at 60 °C/h
+
+    HealthRecord full = recordFor(1, 1350.0f, 9);   // Bands up to 1100 °C
+    TEST_ASSERT_INT_WITHIN(1, 1350, healthReachableFromBands(full.bandRate, target));
+
+    // One band is no line; a rate that rises with temperature can't be extrapolated
+    HealthRecord one = recordFor(1, 1350.0f, 1);
+    TEST_ASSERT_EQUAL_INT(HEALTH_NO_DATA, healthReachableFromBands(one.bandRate, target));
+    HealthRecord rising = recordFor(1, 1350.0f, 9);
+    for (int i = 0; i < 9; i++) {
+        rising.bandRate[i] = (int16_t)(100 + 10 * i);
+    }
+    TEST_ASSERT_EQUAL_INT(HEALTH_NO_DATA, healthReachableFromBands(rising.bandRate, target));
+}
+
+/**
+ * Bands ending more than ELEMENT_HEALTH_MAX_EXTRAPOLATION below the cone
+ * give no reachable temperature
+ */
+void test_low_bands_are_not_extrapolated(void) {
+    const float target = healthTargetConeTemp();
+    HealthRecord low = recordFor(1, 900.0f, 5);     // Bands up to 700 °C
+    TEST_ASSERT_EQUAL_INT(HEALTH_NO_DATA, healthReachableFromBands(low.bandRate, target));
+    HealthRecord justEnough = recordFor(1, 1300.0f, 9);
+    TEST_ASSERT_NOT_EQUAL(HEALTH_NO_DATA, healthReachableFromBands(justEnough.bandRate, target));
+}
+
+/**
+ * A firing the elements drove to 1150 °C is measured to the model's
+ * full-power rates and extrapolated to where they fall to 60 °C/h
+ */
+void test_firing_measures_full_power_rates(void) {
+    fire(1150.0f, 1150.0f);
+    HealthRecord rec;
+    TEST_ASSERT_TRUE(elementHealthSummarize(7, rec));
+    TEST_ASSERT_EQUAL_UINT16(7, rec.firingNumber);
+    for (int i = 0; i < 9; i++) {
+        float x = HEALTH_BAND_MIN_C + (i + 0.5f) * HEALTH_BAND_WIDTH_C;
+        TEST_ASSERT_INT_WITHIN(15, (int)(POWER_RATE - LOSS * (x - 20.0f)), rec.bandRate[i]);
+    }
+    TEST_ASSERT_INT_WITHIN(30, (int)REACHABLE, rec.reachableTemp);
+}
+
+/**
+ * A firing whose full-power bands end at 700 °C gets no reachable
+ * temperature, however high it went afterwards
+ */
+void test_peak_does_not_unlock_extrapolation(void) {
+    fire(700.0f, 1230.0f);
+    HealthRecord rec;
+    TEST_ASSERT_TRUE(elementHealthSummarize(1, rec));
+    TEST_ASSERT_GREATER_OR_EQUAL(1229, rec.peakTemp);
+    TEST_ASSERT_EQUAL_INT(HEALTH_NO_DATA, rec.bandRate[5]);
+    TEST_ASSERT_EQUAL_INT(HEALTH_NO_DATA, rec.reachableTemp);
+
+    // No windows at high duty at all: nothing to record
+    elementHealthStartFiring();
+    for (unsigned long now = 0; now < 3600000UL; now += 1000) {
+        elementHealthSample(500.0f, false, now);
+    }
+    TEST_ASSERT_FALSE(elementHealthSummarize(2, rec));
+}
+
+void test_trend(void) {
+    const float target = healthTargetConeTemp();
+    HealthTrend trend;
+
+    // 10 °C lost per firing with 118 °C to spare: no warning yet. The low
+    // firing in the middle is skipped.
+    HealthRecord healthy[] = {
+        recordFor(1, 1400.0f, 9), recordFor(2, 1390.0f, 9), recordFor(3, 1380.0f, 9),
+        recordFor(4, 700.0f, 5), recordFor(5, 1360.0f, 9), recordFor(6, 1350.0f, 9),
+        recordFor(7, 1340.0f, 9),
+    };
+    healthComputeTrend(healthy, 7, target, trend);
+    TEST_ASSERT_EQUAL_INT(6, trend.records);
+    TEST_ASSERT_INT_WITHIN(1, 1340, (int)trend.latestReachable);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, -10.0f, trend.slopePerFiring);
+    TEST_ASSERT_INT_WITHIN(1, 11, trend.firingsLeft);
+    TEST_ASSERT_FALSE(trend.warning);
+
+    HealthRecord wearing[] = {
+        recordFor(1, 1300.0f, 9), recordFor(2, 1290.0f, 9), recordFor(3, 1280.0f, 9),
+    };
+    healthComputeTrend(wearing, 3, target, trend);
+    TEST_ASSERT_INT_WITHIN(1, 5, trend.firingsLeft);
+    TEST_ASSERT_TRUE(trend.warning);
+    TEST_ASSERT_NOT_NULL(strstr(trend.message, "firings"));
+
+    HealthRecord worn[] = {recordFor(1, 1210.0f, 9)};
+    healthComputeTrend(worn, 1, target, trend);
+    TEST_ASSERT_TRUE(trend.warning);
+    TEST_ASSERT_NOT_NULL(strstr(trend.message, "unreachable"));
+
+    healthComputeTrend(healthy, 0, target, trend);
+    TEST_ASSERT_EQUAL_INT(0, trend.records);
+    TEST_ASSERT_FALSE(trend.warning);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_band_fit);
+    RUN_TEST(test_reachable_from_bands);
+    RUN_TEST(test_low_bands_are_not_extrapolated);
+    RUN_TEST(test_firing_measures_full_power_rates);
+    RUN_TEST(test_peak_does_not_unlock_extrapolation);
+    RUN_TEST(test_trend);
+    return UNITY_END();
+}
@@ -0,0 +1,211 @@
+/**
+ * Fault observer: fault injection against a simulated kiln
+ *
+ * Plant: dT/dt = A*u - B*(T - 20) per hour, time-proportioned SSR (2 s
+ * window) driven by a PI loop ramping 150 °C/h to a 1000 °C hold, 10 Hz
+ * reads with 0.15 °C noise and 0.25 °C resolution. As in the firmware, the
+ * observer's model is the predictor's online fit, run on the same readings,
+ * across plants that differ from the predictor's prior.
+ */
+
+#include <math.h>
+#include <random>
+#include <unity.h>
+#include "config.h"
+#include "fault_observer.h"
+#include "firing_predictor.h"
+
+#define DT          0.1f
+
+struct Plant {
+    float a;                    // Full-power heating (°C/h)
+    float b;                    // Losses (1/h)
+};
+
+// The stuck-SSR cases use PLANTS[2]: it holds 1000 °C at about half power,
+// so the loop can back off to zero once the temperature runs away. At full
+// power (PLANTS[1] and [3] never reach the hold) a welded SSR changes nothing.
+static const Plant PLANTS[] = {{250, 0.18f}, {230, 0.2f}, {300, 0.15f}, {180, 0.12f}};
+
+struct Injection {
+    double stuckAt;             // SSR welded on from here (s), -1 = never
+    double lidAt;               // Lid open for lidFor seconds (losses x8)
+    double lidFor;
+    double driftAt;             // Reading falls away at driftRate (°C/h)...
+    float driftRate;
+    float driftMax;             // ...up to this far (°C)
+    double clearAt;             // faultObserverClear() here (user resumes)
+};
+
+static const Injection NONE = {-1, -1, 0, -1, 0, 0, -1};
+
+struct Detection {
+    double at[4];               // First detection per FaultClass (s), -1 = never
+    int reports[4];             // Times each class was returned
+};
+
+static Detection run(const Injection& inj, const Plant& plant, double hours, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 0.15f);
+    Detection d;
+    for (int c = 0; c < 4; c++) {
+        d.at[c] = -1;
+        d.reports[c] = 0;
+    }
+
+    float temp = 20.0f, integral = 0.0f, drift = 0.0f;
+    faultObserverReset(temp);
+    predictorReset(temp, 0);
+    for (long k = 0; k < (long)(hours * 36000); k++) {
+        double t = k * DT;
+        float setpoint = fminf(20.0f + 150.0f * (float)(t / 3600), 1000.0f);
+        if (inj.driftAt >= 0 && t > inj.driftAt) {
+            drift = fminf((float)((t - inj.driftAt) / 3600) * inj.driftRate, inj.driftMax);
+        }
+        float measured = roundf((temp + noise(rng) - drift) * 4.0f) / 4.0f;
+
+        float e = setpoint - measured;
+        integral = fminf(fmaxf(integral + e * DT * 0.3f / 60.0f, 0.0f), 100.0f);
+        float duty = fminf(fmaxf(4.0f * e + integral, 0.0f), 100.0f);
+        bool commanded = fmod(t, 2.0) < 2.0 * duty / 100.0;
+
+        bool heating = commanded;
+        float lossScale = 1.0f;
+        if (inj.stuckAt >= 0 && t > inj.stuckAt) {
+            heating = true;
+        }
+        if (inj.lidAt >= 0 && t > inj.lidAt && t < inj.lidAt + inj.lidFor) {
+            lossScale = 8.0f;
+        }
+        if (inj.clearAt >= 0 && fabs(t - inj.clearAt) < DT / 2) {
+            faultObserverClear(measured);
+        }
+
+        unsigned long now = (unsigned long)(t * 1000);
+        predictorSample(measured, commanded, now);
+        FaultClass f = faultObserverUpdate(measured, commanded, duty, heatingModel.a, heatingModel.b,
+                                           DT, now);
+        if (f != FAULT_NONE) {
+            d.reports[f]++;
+            if (d.at[f] < 0) {
+                d.at[f] = t;
+            }
+        }
+        temp += ((heating ? plant.a : 0.0f) - lossScale * plant.b * (temp - 20.0f)) * DT / 3600.0f;
+        if (temp > 1300.0f) {
+            break;  // Runaway: the test has already failed or passed by now
+        }
+    }
+    return d;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_no_false_alarms_over_a_full_firing(void) {
+    for (const Plant& plant : PLANTS) {
+        for (unsigned seed = 1; seed <= 3; seed++) {
+            Detection d = run(NONE, plant, 10, seed);
+            TEST_ASSERT_EQUAL_INT(0, d.reports[FAULT_STUCK_SSR] + d.reports[FAULT_LID_OPEN] +
+                                     d.reports[FAULT_TC_DRIFT]);
+        }
+    }
+    TEST_ASSERT_EQUAL(FAULT_NONE, faultObserver.active);
+}
+
+void test_stuck_ssr_at_hold_is_detected(void) {
+    Injection inj = NONE;
+    inj.stuckAt = 7.5 * 3600;
+    Detection d = run(inj, PLANTS[2], 8.5, 1);
+    TEST_ASSERT_GREATER_THAN(inj.stuckAt, d.at[FAULT_STUCK_SSR]);
+    TEST_ASSERT_LESS_THAN(inj.stuckAt + 10 * 60, d.at[FAULT_STUCK_SSR]);
+    TEST_ASSERT_EQUAL(FAULT_STUCK_SSR, faultObserver.active);
+}
+
+void test_lid_open_is_detected(void) {
+    Injection inj = NONE;
+    inj.lidAt = 5 * 3600;
+    inj.lidFor = 600;
+    Detection d = run(inj, PLANTS[1], 6, 1);
+    TEST_ASSERT_GREATER_THAN(inj.lidAt, d.at[FAULT_LID_OPEN]);
+    TEST_ASSERT_LESS_THAN(inj.lidAt + 300, d.at[FAULT_LID_OPEN]);
+    TEST_ASSERT_EQUAL_INT(0, d.reports[FAULT_STUCK_SSR]);
+}
+
+void test_thermocouple_drift_is_detected(void) {
+    Injection inj = NONE;
+    inj.driftAt = 5 * 3600;
+    inj.driftRate = 120;
+    inj.driftMax = 1000;
+    Detection d = run(inj, PLANTS[0], 6, 1);
+    TEST_ASSERT_GREATER_THAN(inj.driftAt, d.at[FAULT_TC_DRIFT]);
+    TEST_ASSERT_LESS_THAN(inj.driftAt + 30 * 60, d.at[FAULT_TC_DRIFT]);
+}
+
+/**
+ * A warn-only drift is latched first; the SSR welding later must still be
+ * reported, and becomes the active fault
+ */
+void test_drift_then_stuck_ssr_escalates(void) {
+    Injection inj = NONE;
+    inj.driftAt = 4 * 3600;
+    inj.driftRate = 120;
+    inj.driftMax = 60;
+    inj.stuckAt = 7.5 * 3600;
+    Detection d = run(inj, PLANTS[2], 8.5, 1);
+    TEST_ASSERT_GREATER_THAN(0, d.at[FAULT_TC_DRIFT]);
+    TEST_ASSERT_LESS_THAN(inj.stuckAt, d.at[FAULT_TC_DRIFT]);
+    TEST_ASSERT_GREATER_THAN(inj.stuckAt, d.at[FAULT_STUCK_SSR]);
+    TEST_ASSERT_EQUAL_INT(1, d.reports[FAULT_STUCK_SSR]);
+    TEST_ASSERT_EQUAL(FAULT_STUCK_SSR, faultObserver.active);
+    TEST_ASSERT_TRUE(faultObserver.latched & FAULT_BIT(FAULT_TC_DRIFT));
+}
+
+/**
+ * Manual mode keeps firing after a lid fault; a stuck SSR afterwards is
+ * still caught
+ */
+void test_lid_then_stuck_ssr_escalates(void) {
+    Injection inj = NONE;
+    inj.lidAt = 5 * 3600;
+    inj.lidFor = 600;
+    inj.stuckAt = 7.5 * 3600;
+    Detection d = run(inj, PLANTS[2], 8.5, 1);
+    TEST_ASSERT_GREATER_THAN(0, d.at[FAULT_LID_OPEN]);
+    TEST_ASSERT_GREATER_THAN(inj.stuckAt, d.at[FAULT_STUCK_SSR]);
+    TEST_ASSERT_LESS_THAN(inj.stuckAt + 10 * 60, d.at[FAULT_STUCK_SSR]);
+    TEST_ASSERT_EQUAL(FAULT_STUCK_SSR, faultObserver.active);
+}
+
+void test_clear_keeps_a_stuck_ssr_latched(void) {
+    Injection inj = NONE;
+    inj.stuckAt = 7.5 * 3600;
+    inj.clearAt = 8 * 3600;
+    run(inj, PLANTS[2], 8.1, 1);
+    TEST_ASSERT_EQUAL(FAULT_STUCK_SSR, faultObserver.active);
+    TEST_ASSERT_EQUAL_UINT8(FAULT_BIT(FAULT_STUCK_SSR), faultObserver.latched);
+}
+
+void test_clear_releases_a_lid_fault(void) {
+    Injection inj = NONE;
+    inj.lidAt = 5 * 3600;
+    inj.lidFor = 600;
+    inj.clearAt = 5.5 * 3600;
+    Detection d = run(inj, PLANTS[1], 6, 1);
+    TEST_ASSERT_EQUAL_INT(1, d.reports[FAULT_LID_OPEN]);
+    TEST_ASSERT_EQUAL(FAULT_NONE, faultObserver.active);
+    TEST_ASSERT_EQUAL_UINT8(0, faultObserver.latched);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_no_false_alarms_over_a_full_firing);
+    RUN_TEST(test_stuck_ssr_at_hold_is_detected);
+    RUN_TEST(test_lid_open_is_detected);
+    RUN_TEST(test_thermocouple_drift_is_detected);
+    RUN_TEST(test_drift_then_stuck_ssr_escalates);
+    RUN_TEST(test_lid_then_stuck_ssr_escalates);
+    RUN_TEST(test_clear_keeps_a_stuck_ssr_latched);
+    RUN_TEST(test_clear_releases_a_lid_fault);
+    return UNITY_END();
+}
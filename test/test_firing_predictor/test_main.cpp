@@ -0,0 +1,184 @@
+/**
+ * Firing predictor: fit and ETA against a simulated kiln
+ *
+ * The plant is the model the predictor fits, dT/dt = A*u - B*(T - 20) in
+ * °C/h, started from config.h's prior. The real profile engine runs the
+ * Glaze Cone 6 profile and a PI loop with a 2 s SSR window follows its
+ * setpoint. Every 5 minutes the predicted end (now + ETA) and its band are
+ * compared with when the firing really ends.
+ */
+
+#include <math.h>
+#include <random>
+#include <unity.h>
+#include "config.h"
+#include "firing_predictor.h"
+#include "profile.h"
+
+#define DT              0.5         // s
+#define PLANT_A         250.0       // °C/h at full power
+#define PLANT_B         0.18        // 1/h
+#define RUN_EVERY_MS    (5UL * 60UL * 1000UL)
+#define MAX_PREDICTIONS 300
+
+struct Prediction {
+    double atS;                 // Firing time of the prediction
+    double endS;                // Predicted end (atS + ETA)
+    double lowS;
+    double highS;
+    FiringPrediction raw;
+};
+
+struct Firing {
+    double endS;                // Actual end, -1 if it never finished
+    int count;
+    Prediction predictions[MAX_PREDICTIONS];
+};
+
+static Firing firing;
+
+static void fire(const FiringProfile& profile, double a, double b, double maxHours) {
+    std::mt19937 rng(1);
+    std::normal_distribution<float> noise(0.0f, 0.25f);
+    double temp = 20.0;
+    float integral = 0.0f;
+    firing.endS = -1;
+    firing.count = 0;
+
+    profileStart(&profile, (float)temp, 0);
+    predictorReset((float)temp, 0);
+    unsigned long nextRun = RUN_EVERY_MS;
+
+    for (long i = 1; i * DT < maxHours * 3600; i++) {
+        double t = i * DT;
+        unsigned long now = (unsigned long)(t * 1000);
+        float measured = roundf(((float)temp + noise(rng)) * 4.0f) / 4.0f;
+        float setpoint = profileUpdate(measured, false, now);
+        if (!profileIsRunning()) {
+            firing.endS = t;
+            return;
+        }
+
+        float e = setpoint - measured;
+        integral = fminf(fmaxf(integral + e * (float)DT * 0.3f / 60.0f, 0.0f), 100.0f);
+        float duty = fminf(fmaxf(4.0f * e + integral, 0.0f), 100.0f);
+        bool on = fmod(t, 2.0) < 2.0 * duty / 100.0;
+        predictorSample(measured, on, now);
+
+        if (now >= nextRun && firing.count < MAX_PREDICTIONS) {
+            nextRun += RUN_EVERY_MS;
+            Prediction& p = firing.predictions[firing.count];
+            if (predictorRun(profileRunner, measured, now, DEFAULT_KILN_WATTAGE, p.raw)) {
+                p.atS = t;
+                p.endS = t + p.raw.etaSec;
+                p.lowS = t + p.raw.etaLowSec;
+                p.highS = t + p.raw.etaHighSec;
+                firing.count++;
+            }
+        }
+
+        temp += DT / 3600.0 * ((on ? a : 0.0) - b * (temp - 20.0));
+    }
+}
+
+// Largest |predicted - actual end| among predictions made after fromHours (minutes)
+static double worstErrorAfter(double fromHours) {
+    double worst = 0.0;
+    for (int i = 0; i < firing.count; i++) {
+        const Prediction& p = firing.predictions[i];
+        if (p.atS >= fromHours * 3600) {
+            worst = fmax(worst, fabs(p.endS - firing.endS) / 60.0);
+        }
+    }
+    return worst;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/**
+ * The ETA tightens as the fit converges, and the fit lands on the plant
+ */
+void test_eta_converges_on_the_real_end(void) {
+    fire(builtinProfiles[1], PLANT_A, PLANT_B, 24);
+    TEST_ASSERT_TRUE(firing.endS > 0);
+    TEST_ASSERT_GREATER_THAN(100, firing.count);
+
+    TEST_ASSERT_LESS_THAN_FLOAT(45.0f, (float)worstErrorAfter(2.0));
+    TEST_ASSERT_LESS_THAN_FLOAT(10.0f, (float)worstErrorAfter(7.0));
+    TEST_ASSERT_LESS_THAN_FLOAT(3.0f, (float)worstErrorAfter(10.0));
+
+    TEST_ASSERT_FLOAT_WITHIN(0.05f * PLANT_A, PLANT_A, heatingModel.a);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f * PLANT_B, PLANT_B, heatingModel.b);
+    const FiringPrediction& last = firing.predictions[firing.count - 1].raw;
+    TEST_ASSERT_FALSE(last.stalled);
+    TEST_ASSERT_FALSE(last.truncated);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 1222.0f, last.endTemp);
+}
+
+/**
+ * Once the fit has a couple of hours of ramp the band holds the real end,
+ * and it narrows toward the end of the firing
+ */
+void test_band_contains_the_real_end(void) {
+    fire(builtinProfiles[1], PLANT_A, PLANT_B, 24);
+    double widthAt8h = -1, widthAt12h = -1;
+    for (int i = 0; i < firing.count; i++) {
+        const Prediction& p = firing.predictions[i];
+        TEST_ASSERT_TRUE(p.lowS <= p.endS && p.endS <= p.highS);
+        if (p.atS < 2 * 3600) {
+            continue;
+        }
+        // Slack: the simulation moves in PREDICTOR_SIM_STEP_S steps
+        const double slack = 2 * PREDICTOR_SIM_STEP_S;
+        TEST_ASSERT_TRUE(p.lowS <= firing.endS + slack && firing.endS - slack <= p.highS);
+        if (widthAt8h < 0 && p.atS >= 8 * 3600) widthAt8h = p.highS - p.lowS;
+        if (widthAt12h < 0 && p.atS >= 12 * 3600) widthAt12h = p.highS - p.lowS;
+    }
+    TEST_ASSERT_LESS_THAN_FLOAT(120.0f * 60, (float)widthAt8h);
+    TEST_ASSERT_LESS_THAN_FLOAT((float)widthAt8h / 4, (float)widthAt12h);
+}
+
+/**
+ * A kiln that levels off near 850 °C can't reach cone 6: flagged, with
+ * its ceiling
+ */
+void test_weak_kiln_is_flagged_stalled(void) {
+    const double weakA = 150.0;
+    fire(builtinProfiles[1], weakA, PLANT_B, 8);
+    TEST_ASSERT_TRUE(firing.endS < 0);
+    const FiringPrediction& last = firing.predictions[firing.count - 1].raw;
+    TEST_ASSERT_TRUE(last.stalled);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f * (weakA / PLANT_B), 20.0f + weakA / PLANT_B, last.maxReachable);
+}
+
+void test_soak_eta_is_the_remaining_hold(void) {
+    static const FiringProfile hold = {"Hold", 1, {{100.0, 1000.0, 30, false, nullptr}}};
+    predictorReset(1000.0f, 0);
+    ProfileRunner run = profileRunner;
+    run.profile = &hold;
+    run.segment = 0;
+    run.state = PROFILE_SOAKING;
+    run.setpoint = 1000.0f;
+    run.soakStartTime = 0;
+
+    FiringPrediction out;
+    TEST_ASSERT_TRUE(predictorRun(run, 1000.0f, 10UL * 60000UL, DEFAULT_KILN_WATTAGE, out));
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 20.0f * 60, out.etaSec);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1000.0f, out.endTemp);
+    // Holding against losses: the prior's hold duty for the remaining 20 minutes
+    float duty = heatingModel.b * (1000.0f - OBSERVER_AMBIENT_TEMP) / heatingModel.a;
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, DEFAULT_KILN_WATTAGE * duty / 3 / 1000, out.kwh);
+
+    run.state = PROFILE_COMPLETE;
+    TEST_ASSERT_FALSE(predictorRun(run, 1000.0f, 0, DEFAULT_KILN_WATTAGE, out));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_eta_converges_on_the_real_end);
+    RUN_TEST(test_band_contains_the_real_end);
+    RUN_TEST(test_weak_kiln_is_flagged_stalled);
+    RUN_TEST(test_soak_eta_is_the_remaining_hold);
+    return UNITY_END();
+}
@@ -0,0 +1,123 @@
+/**
+ * Heat-work: cone chart consistency and the profiles built on it
+ *
+ * The chart is the one source for cone temperatures: heat-work thresholds
+ * come from its 60°C/h column, and cone-terminated profile segments take
+ * their targets from it. These tests check that the two columns agree with
+ * each other and with the heat-work model, and that a cone profile fired
+ * as programmed actually reaches its cone.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <unity.h>
+#include "config.h"
+#include "heat_work.h"
+#include "profile.h"
+
+// Heat-work of a ramp from the table floor, first temperature reaching cone c
+static float rampTempAtCone(int c, float ratePerHour) {
+    heatWorkReset();
+    float t = 400.0f;
+    while (heatWorkTotal() < heatWorkForCone(c) && t < 1400.0f) {
+        heatWorkUpdate(t, 1.0f);
+        t += ratePerHour / 3600.0f;
+    }
+    return t;
+}
+
+void setUp() {
+    heatWorkBegin();
+}
+
+void tearDown() {}
+
+void test_chart_is_ordered() {
+    for (int c = 0; c < numOrtonCones; c++) {
+        TEST_ASSERT_TRUE_MESSAGE(ortonCones[c].temp150 > ortonCones[c].temp60, ortonCones[c].name);
+        TEST_ASSERT_EQUAL_INT(c, heatWorkFindCone(ortonCones[c].name));
+        if (c > 0) {
+            TEST_ASSERT_TRUE_MESSAGE(ortonCones[c].temp60 > ortonCones[c - 1].temp60, ortonCones[c].name);
+            TEST_ASSERT_TRUE_MESSAGE(ortonCones[c].temp150 > ortonCones[c - 1].temp150, ortonCones[c].name);
+            TEST_ASSERT_TRUE(heatWorkForCone(c) > heatWorkForCone(c - 1));
+        }
+    }
+}
+
+// The heat-work thresholds come from the 60 column only: a 150°C/h ramp
+// must bend each cone near its 150 column entry
+void test_150_column_matches_heat_work() {
+    double sumSq = 0.0;
+    for (int c = 0; c < numOrtonCones; c++) {
+        float err = rampTempAtCone(c, 150.0f) - ortonCones[c].temp150;
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(15.0f, 0.0f, err, ortonCones[c].name);
+        sumSq += err * err;
+    }
+    TEST_ASSERT_TRUE(sqrt(sumSq / numOrtonCones) < 7.0);
+}
+
+void test_cone_temp_follows_ramp_rate() {
+    int c = heatWorkFindCone("6");
+    TEST_ASSERT_EQUAL_FLOAT(ortonCones[c].temp60, heatWorkConeTemp("6", 60.0f));
+    TEST_ASSERT_EQUAL_FLOAT(ortonCones[c].temp150, heatWorkConeTemp("6", 150.0f));
+    TEST_ASSERT_EQUAL_FLOAT(0.5f * (ortonCones[c].temp60 + ortonCones[c].temp150),
+                            heatWorkConeTemp("6", 105.0f));
+    TEST_ASSERT_EQUAL_FLOAT(ortonCones[c].temp60, heatWorkConeTemp("6", 20.0f));
+    TEST_ASSERT_EQUAL_FLOAT(ortonCones[c].temp150, heatWorkConeTemp("6", 300.0f));
+    TEST_ASSERT_EQUAL_FLOAT(ortonCones[c].temp150, heatWorkConeTemp("6", 0.0f));  // Full power
+    TEST_ASSERT_TRUE(isnan(heatWorkConeTemp("13", 60.0f)));
+}
+
+void test_profile_cone_targets_come_from_chart() {
+    int checked = 0;
+    for (int p = 0; p < numBuiltinProfiles; p++) {
+        for (int s = 0; s < builtinProfiles[p].numSegments; s++) {
+            const ProfileSegment& seg = builtinProfiles[p].segments[s];
+            TEST_ASSERT_TRUE_MESSAGE(seg.targetTemp <= MAX_TEMP_LIMIT, builtinProfiles[p].name);
+            if (seg.soakEndCone == nullptr) {
+                continue;
+            }
+            TEST_ASSERT_TRUE_MESSAGE(heatWorkFindCone(seg.soakEndCone) >= 0, seg.soakEndCone);
+            TEST_ASSERT_EQUAL_FLOAT_MESSAGE(heatWorkConeTemp(seg.soakEndCone, seg.rampRate),
+                                            seg.targetTemp, builtinProfiles[p].name);
+            checked++;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(2, checked);
+}
+
+// Fire each cone profile with the kiln following the setpoint exactly: by
+// the end of the programmed soak, heat-work must have reached the cone
+void test_cone_profiles_reach_their_cone() {
+    for (int p = 0; p < numBuiltinProfiles; p++) {
+        const FiringProfile& profile = builtinProfiles[p];
+        const char* cone = profile.segments[profile.numSegments - 1].soakEndCone;
+        if (cone == nullptr) {
+            continue;
+        }
+        heatWorkReset();
+        unsigned long now = 0;
+        float temp = 20.0f;
+        profileStart(&profile, temp, now);
+        while (profileIsRunning() && now < 48UL * 3600000UL) {
+            now += 1000;
+            float setpoint = profileUpdate(temp, true, now);
+            if (profileIsRunning()) {
+                temp = setpoint;
+                heatWorkUpdate(temp, 1.0f);
+            }
+        }
+        TEST_ASSERT_EQUAL_INT_MESSAGE(PROFILE_COMPLETE, profileRunner.state, profile.name);
+        TEST_ASSERT_TRUE_MESSAGE(heatWorkEquivalentCone(nullptr) >= heatWorkFindCone(cone), profile.name);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_chart_is_ordered);
+    RUN_TEST(test_150_column_matches_heat_work);
+    RUN_TEST(test_cone_temp_follows_ramp_rate);
+    RUN_TEST(test_profile_cone_targets_come_from_chart);
+    RUN_TEST(test_cone_profiles_reach_their_cone);
+    return UNITY_END();
+}
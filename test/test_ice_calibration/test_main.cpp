@@ -0,0 +1,113 @@
+/**
+ * Ice-point calibration: interval coverage and stopping
+ *
+ * The probe reads a true offset of +0.6 °C with Gaussian (optionally AR(1))
+ * noise, quantized to the MAX31855's 0.25 °C, at 10 Hz.
+ */
+
+#include <math.h>
+#include <random>
+#include <unity.h>
+#include "config.h"
+#include "ice_calibration.h"
+
+#define TRUE_READING    0.6f    // What a perfect probe would read in the bath (°C)
+
+struct Bath {
+    float sd;                   // Reading noise (°C)
+    float rho;                  // AR(1) correlation between readings
+    float settleTau;            // Probe settling from 20 °C (s)
+    float driftPerMin;          // Bath still warming (°C/min)
+};
+
+static IceCalStatus calibrate(const Bath& b, unsigned seed, IceCalibration& c) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    iceCalReset(c, 0);
+    float e = 0.0f;
+    for (unsigned long t = 100;; t += 100) {
+        float s = t / 1000.0f;
+        e = b.rho * e + sqrtf(1.0f - b.rho * b.rho) * b.sd * noise(rng);
+        float truth = TRUE_READING + 20.0f * expf(-s / b.settleTau) + b.driftPerMin * s / 60.0f;
+        IceCalStatus status = iceCalAddSample(c, roundf((truth + e) * 4.0f) / 4.0f, t);
+        if (status != ICE_CAL_RUNNING) {
+            return status;
+        }
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_t_quantiles_match_the_table(void) {
+    TEST_ASSERT_TRUE(isinf(iceCalTQuantile95(0)));
+    const double df[] = {1, 2, 3, 4, 5, 10, 20, 30, 31, 40, 60, 120, 1000};
+    const double t95[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.228, 2.086, 2.042,
+                          2.040, 2.021, 2.000, 1.980, 1.962};
+    for (int i = 0; i < (int)(sizeof(df) / sizeof(df[0])); i++) {
+        TEST_ASSERT_FLOAT_WITHIN(0.001, t95[i], iceCalTQuantile95(df[i]));
+    }
+    for (int d = 2; d < 200; d++) {
+        TEST_ASSERT_TRUE(iceCalTQuantile95(d) < iceCalTQuantile95(d - 1));
+    }
+}
+
+/**
+ * After the first ICE_CAL_MIN_BLOCKS blocks (4 degrees of freedom) the
+ * interval holds the true offset 95% of the time
+ */
+void test_small_sample_interval_covers_95_percent(void) {
+    const int trials = 8000;
+    int covered = 0;
+    for (int seed = 1; seed <= trials; seed++) {
+        std::mt19937 rng(seed);
+        std::normal_distribution<float> blockNoise(0.0f, 1.0f);
+        IceCalibration c;
+        iceCalReset(c, 0);
+        unsigned long t = 0;
+        for (int b = 0; b < ICE_CAL_MIN_BLOCKS; b++) {
+            float blockMean = TRUE_READING + blockNoise(rng);
+            for (int i = 0; i < ICE_CAL_BLOCK_SAMPLES; i++) {
+                iceCalAddSample(c, blockMean, t += 100);
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT32(ICE_CAL_MIN_BLOCKS, c.blocks);
+        covered += fabsf(c.offset + TRUE_READING) <= c.halfWidth;
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 95.0f, 100.0f * covered / trials);
+}
+
+void test_settled_bath_converges_on_the_offset(void) {
+    const Bath baths[] = {
+        {0.05f, 0.0f, 0.01f, 0.0f},     // Clean, already settled
+        {0.05f, 0.0f, 8.0f, 0.0f},      // Clean, probe settling
+        {0.3f, 0.0f, 8.0f, 0.0f},       // Noisy
+        {0.3f, 0.8f, 8.0f, 0.0f},       // Noisy and correlated
+    };
+    for (const Bath& b : baths) {
+        for (unsigned seed = 1; seed <= 3; seed++) {
+            IceCalibration c;
+            TEST_ASSERT_EQUAL_INT(ICE_CAL_CONVERGED, calibrate(b, seed, c));
+            TEST_ASSERT_FLOAT_WITHIN(ICE_CAL_TOLERANCE, -TRUE_READING, c.offset);
+            TEST_ASSERT_LESS_OR_EQUAL_FLOAT(ICE_CAL_TOLERANCE, c.halfWidth);
+        }
+    }
+}
+
+/**
+ * A bath still warming at 1 °C/min keeps restarting and never gives an offset
+ */
+void test_drifting_bath_is_not_accepted(void) {
+    IceCalibration c;
+    TEST_ASSERT_EQUAL_INT(ICE_CAL_TIMEOUT, calibrate({0.1f, 0.0f, 0.01f, 1.0f}, 1, c));
+    TEST_ASSERT_GREATER_THAN(0, c.restarts);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_t_quantiles_match_the_table);
+    RUN_TEST(test_small_sample_interval_covers_95_percent);
+    RUN_TEST(test_settled_bath_converges_on_the_offset);
+    RUN_TEST(test_drifting_bath_is_not_accepted);
+    return UNITY_END();
+}
@@ -0,0 +1,153 @@
+/**
+ * Noise spectrum: FFT against a direct DFT, Parseval scaling and peak
+ * finding on a synthetic thermocouple burst
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include <random>
+#include <unity.h>
+#include "noise_spectrum.h"
+
+#define N NOISE_FFT_SIZE
+
+static std::mt19937 rng;
+
+void setUp(void) {
+    rng.seed(3);
+}
+
+void tearDown(void) {}
+
+void test_fft_matches_a_direct_dft(void) {
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    float re[N], im[N];
+    double dftRe[N], dftIm[N];
+    for (int i = 0; i < N; i++) {
+        re[i] = noise(rng);
+        im[i] = noise(rng);
+    }
+    double peak = 0.0;
+    for (int k = 0; k < N; k++) {
+        double a = 0.0, b = 0.0;
+        for (int t = 0; t < N; t++) {
+            double angle = -2.0 * M_PI * k * t / N;
+            a += re[t] * cos(angle) - im[t] * sin(angle);
+            b += re[t] * sin(angle) + im[t] * cos(angle);
+        }
+        dftRe[k] = a;
+        dftIm[k] = b;
+        peak = fmax(peak, hypot(a, b));
+    }
+    noiseFft(re, im);
+    double err = 0.0;
+    for (int k = 0; k < N; k++) {
+        err = fmax(err, hypot(re[k] - dftRe[k], im[k] - dftIm[k]));
+    }
+    printf("max |fft - dft| %.1e (%.1e of the largest bin)\n", err, err / peak);
+    TEST_ASSERT_TRUE(err / peak < 1e-5);
+}
+
+void test_fft_preserves_energy(void) {
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    float re[N], im[N];
+    double timeEnergy = 0.0, freqEnergy = 0.0;
+    for (int i = 0; i < N; i++) {
+        re[i] = noise(rng);
+        im[i] = 0.0f;
+        timeEnergy += (double)re[i] * re[i];
+    }
+    noiseFft(re, im);
+    for (int k = 0; k < N; k++) {
+        freqEnergy += (double)re[k] * re[k] + (double)im[k] * im[k];
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-5, 1.0, freqEnergy / (N * timeEnergy));
+}
+
+/**
+ * A single tone sits on one bin; with the Hann window its power spreads over
+ * that bin and its two neighbours, which together hold the tone's variance
+ */
+void test_tone_power_lands_on_its_bin(void) {
+    const float rateHz = 10.0f;
+    const int bin = 16;
+    const float amp = 0.3f;
+    float s[N];
+    for (int i = 0; i < N; i++) {
+        s[i] = 500.0f + amp * sinf(2.0f * (float)M_PI * bin * i / N);
+    }
+    NoiseSpectrum sp;
+    noiseSpectrumAnalyze(s, rateHz, sp);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, 500.0f, sp.mean);
+    TEST_ASSERT_EQUAL_INT(bin, sp.peaks[0].bin);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, bin * rateHz / N, sp.peaks[0].freqHz);
+    float tone = sp.power[bin - 1] + sp.power[bin] + sp.power[bin + 1];
+    TEST_ASSERT_FLOAT_WITHIN(0.01f * amp * amp / 2, amp * amp / 2, tone);
+}
+
+/**
+ * Bins sum to the variance (Parseval with the window's power removed), on
+ * average over many white-noise bursts; two tones plus drift still come out
+ * as the two strongest peaks
+ */
+void test_spectrum_sums_to_the_variance(void) {
+    const float sigma = 0.05f;
+    std::normal_distribution<float> noise(0.0f, sigma);
+    float s[N];
+    NoiseSpectrum sp;
+    double ratio = 0.0;
+    const int bursts = 200;
+    for (int b = 0; b < bursts; b++) {
+        for (int i = 0; i < N; i++) {
+            s[i] = 500.0f + noise(rng);
+        }
+        noiseSpectrumAnalyze(s, 10.0f, sp);
+        double total = 0.0;
+        for (int k = 0; k < NOISE_SPECTRUM_BINS; k++) {
+            total += sp.power[k];
+        }
+        ratio += total / sp.variance / bursts;
+    }
+    printf("mean sum(power) / variance %.3f over %d bursts\n", ratio, bursts);
+    TEST_ASSERT_FLOAT_WITHIN(0.05, 1.0, ratio);
+
+    for (int i = 0; i < N; i++) {
+        s[i] = 500.0f + 0.3f * sinf(2.0f * (float)M_PI * 8 * i / N) +
+               0.2f * sinf(2.0f * (float)M_PI * 30 * i / N) + noise(rng) + 0.002f * i;
+    }
+    noiseSpectrumAnalyze(s, 10.0f, sp);
+    TEST_ASSERT_EQUAL_INT(8, sp.peaks[0].bin);
+    TEST_ASSERT_EQUAL_INT(30, sp.peaks[1].bin);
+}
+
+/**
+ * FFT cost including the input refill, printed for comparison between
+ * builds (not asserted)
+ */
+void test_benchmark_fft(void) {
+    float re[N], im[N];
+    const int rounds = 20000;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        // Fresh input each round: repeated transforms would overflow
+        for (int i = 0; i < N; i++) {
+            re[i] = (float)((i + r) % 7);
+            im[i] = 0.0f;
+        }
+        noiseFft(re, im);
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    printf("noiseFft (%d points): %.2f us\n", N, us / rounds);
+    TEST_ASSERT_FALSE(isnan(re[0]));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fft_matches_a_direct_dft);
+    RUN_TEST(test_fft_preserves_energy);
+    RUN_TEST(test_tone_power_lands_on_its_bin);
+    RUN_TEST(test_spectrum_sums_to_the_variance);
+    RUN_TEST(test_benchmark_fft);
+    return UNITY_END();
+}
@@ -0,0 +1,250 @@
+/**
+ * Sample bus: ordering, overrun accounting, a seqlock stress test and a
+ * benchmark
+ *
+ * Every field of a published sample is derived from its index, so a reader
+ * can tell a torn copy (fields from two publishes) from a whole one.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <unity.h>
+#include "sample_bus.h"
+
+static SampleBus bus;
+
+static ControlSample make(uint32_t i) {
+    ControlSample s;
+    memset(&s, 0, sizeof(s));   // Padding too, so whole samples compare equal
+    s.timeMs = i;
+    s.temp = i * 0.5f;
+    s.hottest = i + 1.0f;
+    s.target = (float)(i ^ 0x5555);
+    s.output = (float)(i % 101);
+    s.wareTemp = i * 0.25f;
+    s.mode = (uint8_t)i;
+    s.heating = i & 1;
+    s.sensorError = (i & 2) != 0;
+    s.fault = (uint8_t)(i >> 8);
+    s.faultResidual = -(float)i;
+    for (int z = 0; z < KILN_ZONE_COUNT; z++) {
+        s.zoneTemp[z] = (float)(i + z);
+        s.zoneSetpoint[z] = (float)(i - z);
+        s.zoneOutput[z] = (float)z;
+        s.zoneErrors[z] = i * (z + 1);
+    }
+    return s;
+}
+
+static bool whole(const ControlSample& s) {
+    ControlSample expect = make(s.timeMs);
+    return memcmp(&s, &expect, sizeof(s)) == 0;
+}
+
+void setUp(void) {
+    sampleBusInit(bus);
+}
+
+void tearDown(void) {}
+
+void test_read_returns_every_sample_in_order(void) {
+    SampleCursor c;
+    ControlSample s;
+    sampleCursorAttach(bus, c, "t");
+    TEST_ASSERT_FALSE(sampleBusRead(bus, c, s));
+    for (uint32_t i = 0; i < 10; i++) {
+        sampleBusPublish(bus, make(i));
+    }
+    for (uint32_t i = 0; i < 10; i++) {
+        TEST_ASSERT_TRUE(sampleBusRead(bus, c, s));
+        TEST_ASSERT_EQUAL_UINT32(i, s.timeMs);
+        TEST_ASSERT_TRUE(whole(s));
+    }
+    TEST_ASSERT_FALSE(sampleBusRead(bus, c, s));
+    TEST_ASSERT_EQUAL_UINT32(10, c.reads);
+    TEST_ASSERT_EQUAL_UINT32(0, c.overruns);
+    TEST_ASSERT_EQUAL_UINT32(10, c.maxLag);
+}
+
+void test_attach_starts_at_the_next_publish(void) {
+    sampleBusPublish(bus, make(0));
+    SampleCursor c;
+    ControlSample s;
+    sampleCursorAttach(bus, c, "t");
+    TEST_ASSERT_FALSE(sampleBusRead(bus, c, s));
+    sampleBusPublish(bus, make(1));
+    TEST_ASSERT_TRUE(sampleBusRead(bus, c, s));
+    TEST_ASSERT_EQUAL_UINT32(1, s.timeMs);
+}
+
+void test_lapped_reader_counts_overruns(void) {
+    SampleCursor c;
+    ControlSample s;
+    sampleCursorAttach(bus, c, "t");
+    const uint32_t published = SAMPLE_BUS_CAPACITY + 5;
+    for (uint32_t i = 0; i < published; i++) {
+        sampleBusPublish(bus, make(i));
+    }
+    TEST_ASSERT_TRUE(sampleBusRead(bus, c, s));
+    TEST_ASSERT_EQUAL_UINT32(5, s.timeMs);      // Oldest still in the ring
+    TEST_ASSERT_EQUAL_UINT32(5, c.overruns);
+    while (sampleBusRead(bus, c, s)) {
+    }
+    TEST_ASSERT_EQUAL_UINT32(published, c.reads + c.overruns);
+}
+
+void test_latest_skips_to_the_newest(void) {
+    SampleCursor c;
+    ControlSample s;
+    sampleCursorAttach(bus, c, "t");
+    for (uint32_t i = 0; i < 7; i++) {
+        sampleBusPublish(bus, make(i));
+    }
+    TEST_ASSERT_TRUE(sampleBusLatest(bus, c, s));
+    TEST_ASSERT_EQUAL_UINT32(6, s.timeMs);
+    TEST_ASSERT_EQUAL_UINT32(6, c.skipped);
+    TEST_ASSERT_FALSE(sampleBusLatest(bus, c, s));
+}
+
+/**
+ * One producer publishing flat out against three readers (one kept a full
+ * ring behind, where it races the producer for every slot) and one
+ * latest-only reader. No copy may be torn or go
+ * backwards, and every sample is either read or counted as lost.
+ */
+void test_concurrent_readers_never_see_a_torn_sample(void) {
+    const uint32_t published = 2000000;
+    const int readers = 4;
+    struct Result {
+        SampleCursor cursor;
+        uint32_t torn;
+        uint32_t backwards;
+    };
+    Result results[readers];
+    std::atomic<bool> done(false);
+    std::vector<std::thread> threads;
+
+    for (int r = 0; r < readers; r++) {
+        Result& me = results[r];
+        me.torn = 0;
+        me.backwards = 0;
+        sampleCursorAttach(bus, me.cursor, "t");
+        threads.emplace_back([r, &me, &done] {
+            ControlSample s;
+            bool seen = false;
+            uint32_t last = 0;
+            while (!done.load(std::memory_order_acquire) ||
+                   me.cursor.next != bus.head.load(std::memory_order_acquire)) {
+                if (r == 2) {
+                    // Stay a full ring behind: the next publish overwrites
+                    // the very slot this reader copies
+                    while (!done.load(std::memory_order_acquire) &&
+                           bus.head.load(std::memory_order_acquire) - me.cursor.next <
+                               SAMPLE_BUS_CAPACITY) {
+                    }
+                }
+                bool got = r == 3 ? sampleBusLatest(bus, me.cursor, s)
+                                  : sampleBusRead(bus, me.cursor, s);
+                if (!got) {
+                    continue;
+                }
+                me.torn += !whole(s);
+                me.backwards += seen && s.timeMs <= last;
+                seen = true;
+                last = s.timeMs;
+            }
+        });
+    }
+    for (uint32_t i = 0; i < published; i++) {
+        sampleBusPublish(bus, make(i));
+    }
+    done.store(true, std::memory_order_release);
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    for (int r = 0; r < readers; r++) {
+        const Result& x = results[r];
+        TEST_ASSERT_EQUAL_UINT32(0, x.torn);
+        TEST_ASSERT_EQUAL_UINT32(0, x.backwards);
+        uint32_t lost = r == 3 ? x.cursor.skipped : x.cursor.overruns;
+        TEST_ASSERT_EQUAL_UINT32(published, x.cursor.reads + lost);
+    }
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+/**
+ * Publish and read costs, printed for comparison between builds (host
+ * timings vary too much to assert on). Uncontended, then flat out against
+ * a reader paced at 10 kHz, the way a consumer task polling on a tick sees
+ * the bus.
+ */
+void test_benchmark_publish_and_read(void) {
+    const uint32_t rounds = 2000000;
+    SampleCursor c;
+    ControlSample in = make(1), out;
+    sampleCursorAttach(bus, c, "bench");
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < rounds; i++) {
+        sampleBusPublish(bus, in);
+    }
+    double publishNs = secondsSince(t0) * 1e9 / rounds;
+    while (sampleBusRead(bus, c, out)) {
+    }
+
+    t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < rounds; i++) {
+        sampleBusPublish(bus, in);
+        sampleBusRead(bus, c, out);
+    }
+    double pairNs = secondsSince(t0) * 1e9 / rounds;
+    printf("uncontended: %.1f ns/publish, %.1f ns/read\n", publishNs, pairNs - publishNs);
+
+    sampleBusInit(bus);
+    SampleCursor paced;
+    sampleCursorAttach(bus, paced, "paced");
+    std::atomic<bool> done(false);
+    double readSeconds = 0.0;
+    std::thread reader([&] {
+        ControlSample s;
+        auto start = std::chrono::steady_clock::now();
+        auto wake = start;
+        while (!done.load(std::memory_order_acquire)) {
+            sampleBusRead(bus, paced, s);
+            wake += std::chrono::microseconds(100);
+            std::this_thread::sleep_until(wake);
+        }
+        readSeconds = secondsSince(start);
+    });
+    t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < rounds; i++) {
+        sampleBusPublish(bus, make(i));
+    }
+    double contendedNs = secondsSince(t0) * 1e9 / rounds;
+    done.store(true, std::memory_order_release);
+    reader.join();
+    printf("with a 10 kHz reader: %.1f ns/publish, reader %.0f reads/s, %lu overruns\n",
+           contendedNs, paced.reads / readSeconds, (unsigned long)paced.overruns);
+
+    TEST_ASSERT_GREATER_THAN(0, paced.reads);
+    TEST_ASSERT_TRUE(paced.reads + paced.overruns <= rounds);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_read_returns_every_sample_in_order);
+    RUN_TEST(test_attach_starts_at_the_next_publish);
+    RUN_TEST(test_lapped_reader_counts_overruns);
+    RUN_TEST(test_latest_skips_to_the_newest);
+    RUN_TEST(test_concurrent_readers_never_see_a_torn_sample);
+    RUN_TEST(test_benchmark_publish_and_read);
+    return UNITY_END();
+}
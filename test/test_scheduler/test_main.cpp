@@ -0,0 +1,248 @@
+/**
+ * Timer-wheel scheduler on an injected clock
+ *
+ * The clock only moves when a test or a job advances it, so every schedule
+ * here is exact and repeatable.
+ */
+
+#include <unity.h>
+#include "scheduler.h"
+
+static uint64_t fakeUs;
+static uint64_t fakeClock() {
+    return fakeUs;
+}
+
+static Scheduler s;
+
+/**
+ * Step the clock the way loop() does: run due jobs, then sleep until the next one
+ */
+static void runUntil(uint64_t untilUs) {
+    while (fakeUs < untilUs) {
+        schedulerRunDue(s);
+        uint32_t idle = schedulerIdleMs(s, 10);
+        fakeUs += idle ? idle * 1000ULL : 100;
+    }
+}
+
+/**
+ * Every job is in exactly one place: linked once in the wheel if waiting
+ * there, not at all otherwise (bounded walk, so a cycle fails rather than hangs)
+ */
+static void assertWheelConsistent() {
+    int seen[SCHED_MAX_JOBS] = {};
+    int links = 0;
+    for (int slot = 0; slot < SCHED_WHEEL_SLOTS; slot++) {
+        for (int id = s.wheel[slot]; id >= 0; id = s.jobs[id].nextInSlot) {
+            TEST_ASSERT_LESS_THAN_MESSAGE(SCHED_MAX_JOBS + 1, ++links, "wheel list has a cycle");
+            seen[id]++;
+        }
+    }
+    for (int id = 0; id < s.jobCount; id++) {
+        TEST_ASSERT_EQUAL_INT(s.jobs[id].state == SCHED_JOB_WHEEL ? 1 : 0, seen[id]);
+    }
+}
+
+// ============================================================================
+// JOBS
+// ============================================================================
+
+static char order[64];
+static int orderLen;
+static uint32_t costAUs, costBUs;
+static void jobA() {
+    order[orderLen++ % 63] = 'A';
+    fakeUs += costAUs;
+}
+static int pokeId;
+static void jobB() {
+    order[orderLen++ % 63] = 'B';
+    fakeUs += costBUs;
+    if (pokeId >= 0) {
+        schedulerRunIn(s, pokeId, 5);
+    }
+}
+
+static int selfId;
+static int selfRuns;
+static uint64_t selfTimes[8];
+static void jobSelf() {
+    selfTimes[selfRuns++ & 7] = fakeUs;
+    schedulerRunIn(s, selfId, 3);
+}
+
+// The control loop pattern: "ssr" reschedules itself for its next edge,
+// and "input" (higher priority) wakes it to apply a command at once
+static int ssrId, inputId;
+static uint32_t ssrDelayMs;
+static int ssrRuns, inputRuns;
+static int ssrRunsThisPass;
+static bool inputPokes;
+static void jobSsr() {
+    ssrRuns++;
+    TEST_ASSERT_LESS_THAN_MESSAGE(4, ++ssrRunsThisPass, "ssr ran repeatedly in one pass");
+    schedulerRunIn(s, ssrId, ssrDelayMs);
+}
+static void jobInput() {
+    inputRuns++;
+    if (inputPokes) {
+        schedulerRunIn(s, ssrId, 0);    // postCommand()
+    }
+}
+
+static uint64_t longFiredAt;
+static void jobLong() {
+    if (!longFiredAt) {
+        longFiredAt = fakeUs;
+    }
+}
+
+void setUp(void) {
+    fakeUs = 1000000;
+    orderLen = 0;
+    costAUs = costBUs = 0;
+    pokeId = -1;
+    selfRuns = 0;
+    ssrRuns = inputRuns = 0;
+    inputPokes = false;
+    longFiredAt = 0;
+    schedulerInit(s, fakeClock);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+void test_priority_orders_jobs_due_together(void) {
+    schedulerAdd(s, "A", jobA, 10, 0, 1, 500);
+    schedulerAdd(s, "B", jobB, 10, 0, 0, 500);
+    TEST_ASSERT_EQUAL_INT(2, schedulerRunDue(s));
+    TEST_ASSERT_EQUAL('B', order[0]);
+    TEST_ASSERT_EQUAL('A', order[1]);
+}
+
+void test_deadlines_stay_phase_locked(void) {
+    int a = schedulerAdd(s, "A", jobA, 10, 0, 1, 500);
+    costAUs = 3000;     // Over budget, but well inside the period
+    runUntil(fakeUs + 1000000);
+    TEST_ASSERT_EQUAL_UINT32(100, s.jobs[a].stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(0, s.jobs[a].stats.skipped);
+    TEST_ASSERT_EQUAL_UINT32(0, s.jobs[a].stats.late);
+    TEST_ASSERT_EQUAL_UINT32(100, s.jobs[a].stats.overruns);
+}
+
+void test_blocked_job_skips_missed_periods_then_relocks(void) {
+    int a = schedulerAdd(s, "A", jobA, 10, 0, 1, 0);
+    int b = schedulerAdd(s, "B", jobB, 1000, 500, 0, 0);
+    runUntil(fakeUs + 100000);
+    costBUs = 35000;
+    schedulerRunIn(s, b, 0);
+    runUntil(fakeUs + 1000);
+    costBUs = 0;
+    uint32_t runs = s.jobs[a].stats.runs;
+    runUntil(fakeUs + 200000);
+    TEST_ASSERT_GREATER_OR_EQUAL(2, s.jobs[a].stats.skipped);
+    TEST_ASSERT_GREATER_THAN(0, s.jobs[a].stats.late);
+    TEST_ASSERT_EQUAL_UINT32(runs + 20, s.jobs[a].stats.runs);
+}
+
+void test_job_can_replace_its_own_reschedule(void) {
+    selfId = schedulerAdd(s, "self", jobSelf, 1000, 0, 2, 0);
+    runUntil(fakeUs + 20000);
+    TEST_ASSERT_GREATER_THAN(3, selfRuns);
+    TEST_ASSERT_EQUAL_UINT32(3000, selfTimes[2] - selfTimes[1]);
+}
+
+void test_clock_jump_beyond_a_revolution_runs_each_job_once(void) {
+    int a = schedulerAdd(s, "A", jobA, 10, 0, 1, 0);
+    runUntil(fakeUs + 50000);
+    uint32_t before = s.jobs[a].stats.runs;
+    fakeUs += 500000;
+    schedulerRunDue(s);
+    TEST_ASSERT_EQUAL_UINT32(before + 1, s.jobs[a].stats.runs);
+    assertWheelConsistent();
+}
+
+void test_long_period_job_fires_on_time(void) {
+    fakeUs = 0;
+    schedulerInit(s, fakeClock);
+    schedulerAdd(s, "long", jobLong, 1000, 777, 0, 0);
+    runUntil(2000000);
+    TEST_ASSERT_EQUAL_UINT32(777000, (uint32_t)longFiredAt);
+}
+
+/**
+ * input re-arms ssr while ssr is already collected for the same pass; ssr
+ * then reschedules itself. ssr must go back into the wheel once, whatever
+ * its delay (multiples of the wheel size used to land in the same slot).
+ */
+static void rearmWhileReady(uint32_t delayMs) {
+    setUp();
+    ssrDelayMs = delayMs;
+    inputId = schedulerAdd(s, "input", jobInput, 10, 0, 0, 0);
+    ssrId = schedulerAdd(s, "ssr", jobSsr, 100, 0, 1, 0);
+    inputPokes = true;
+    for (int pass = 0; pass < 2000; pass++) {
+        ssrRunsThisPass = 0;
+        schedulerRunDue(s);
+        assertWheelConsistent();
+        uint32_t idle = schedulerIdleMs(s, 10);
+        fakeUs += idle ? idle * 1000ULL : 100;
+    }
+    TEST_ASSERT_GREATER_THAN(0, ssrRuns);
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)inputRuns, s.jobs[inputId].stats.runs);
+}
+
+void test_rearm_of_a_ready_job_inserts_it_once(void) {
+    const uint32_t delays[] = {0, 10, 64, 128, 640, 1000};
+    for (uint32_t d : delays) {
+        rearmWhileReady(d);
+    }
+}
+
+void test_rearm_of_a_ready_job_is_kept(void) {
+    // ssr due together with input, which asks for ssr again in 0 ms: ssr
+    // runs in this pass as planned and its own reschedule (in 50 ms) wins
+    inputId = schedulerAdd(s, "input", jobInput, 1000, 0, 0, 0);
+    ssrId = schedulerAdd(s, "ssr", jobSsr, 1000, 0, 1, 0);
+    ssrDelayMs = 50;
+    inputPokes = true;
+    ssrRunsThisPass = 0;
+    TEST_ASSERT_EQUAL_INT(2, schedulerRunDue(s));
+    TEST_ASSERT_EQUAL_UINT64(fakeUs + 50000, s.jobs[ssrId].dueUs);
+
+    // A job that doesn't reschedule itself runs again when it was asked to
+    setUp();
+    int a = schedulerAdd(s, "A", jobA, 1000, 0, 1, 0);
+    schedulerAdd(s, "B", jobB, 1000, 0, 0, 0);
+    pokeId = a;
+    TEST_ASSERT_EQUAL_INT(2, schedulerRunDue(s));
+    assertWheelConsistent();
+    TEST_ASSERT_EQUAL_UINT32(1, s.jobs[a].stats.runs);
+    TEST_ASSERT_EQUAL_UINT64(fakeUs + 5000, s.jobs[a].dueUs);
+}
+
+void test_idle_time_is_the_next_deadline(void) {
+    schedulerAdd(s, "A", jobA, 10, 0, 1, 0);
+    schedulerAdd(s, "B", jobB, 100, 4, 0, 0);
+    schedulerRunDue(s);
+    TEST_ASSERT_EQUAL_UINT32(4, schedulerIdleMs(s, 1000));
+    TEST_ASSERT_EQUAL_UINT32(2, schedulerIdleMs(s, 2));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_priority_orders_jobs_due_together);
+    RUN_TEST(test_deadlines_stay_phase_locked);
+    RUN_TEST(test_blocked_job_skips_missed_periods_then_relocks);
+    RUN_TEST(test_job_can_replace_its_own_reschedule);
+    RUN_TEST(test_clock_jump_beyond_a_revolution_runs_each_job_once);
+    RUN_TEST(test_long_period_job_fires_on_time);
+    RUN_TEST(test_rearm_of_a_ready_job_inserts_it_once);
+    RUN_TEST(test_rearm_of_a_ready_job_is_kept);
+    RUN_TEST(test_idle_time_is_the_next_deadline);
+    return UNITY_END();
+}
@@ -0,0 +1,202 @@
+/**
+ * Serial shell: throughput and ordering through a bounded port stand-in
+ *
+ * The port is modelled the way the firmware sees it: a 256-byte RX buffer,
+ * a 2 KB TX buffer that the wire empties at 115200 baud, and the input job
+ * polling every 10 ms as handleSerialInput() does (drain replies, feed at
+ * most SHELL_LINES_PER_POLL lines while the ring has room for a reply,
+ * drain again). A host script keeps a number of commands in flight and
+ * checks every reply against the command that asked for it. Time is
+ * simulated, so the rates printed are what the port allows, not host speed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unity.h>
+#include "config.h"
+#include "serial_shell.h"
+
+#define RX_BYTES        256
+#define TX_BYTES        2048
+#define POLL_MS         10
+#define WIRE_BYTES_MS   11.52   // 115200 baud, 10 bits per byte
+
+static void cmdEcho(Shell& sh, int argc, char** argv) {
+    if (argc != 2) {
+        shellPrintf(sh, "err usage: echo <n>");
+        return;
+    }
+    shellPrintf(sh, "ok echo %s", argv[1]);
+}
+
+static void cmdArgs(Shell& sh, int argc, char** argv) {
+    shellPrintf(sh, "ok args %d", argc - 1);
+}
+
+static const ShellCommand COMMANDS[] = {
+    {"echo", "<n>", cmdEcho},
+    {"args", "[words...]", cmdArgs},
+};
+
+static Shell shell;
+static std::string replies;     // Everything the host has read off the wire
+
+void setUp(void) {
+    shellInit(shell, COMMANDS, sizeof(COMMANDS) / sizeof(COMMANDS[0]));
+    replies.clear();
+}
+
+void tearDown(void) {}
+
+// Feed a string straight in, then drain everything the shell replied
+static std::string run(const char* input) {
+    for (const char* p = input; *p; p++) {
+        shellFeed(shell, *p);
+    }
+    char buf[SHELL_OUT_BYTES];
+    size_t n = shellDrain(shell, buf, sizeof(buf));
+    return std::string(buf, n);
+}
+
+struct Flood {
+    double seconds;             // Simulated time to get every reply
+    int replies;
+    int outOfOrder;
+};
+
+/**
+ * Send `commands` echo commands keeping `inFlight` unanswered at a time
+ */
+static Flood flood(int commands, int inFlight) {
+    std::string rx, tx, wire, pending;
+    int sent = 0, answered = 0, outOfOrder = 0;
+    double wireCredit = 0.0;
+    unsigned long now = 0;
+
+    while (answered < commands && now < 600000UL) {
+        // Host: queue commands while the window and the RX buffer allow
+        while (sent < commands && sent - answered < inFlight) {
+            char line[24];
+            snprintf(line, sizeof(line), "echo %d\r\n", sent);
+            if (rx.size() + strlen(line) > RX_BYTES) {
+                break;
+            }
+            rx += line;
+            sent++;
+        }
+
+        // Firmware: handleSerialInput() on its poll period
+        if (now % POLL_MS == 0) {
+            char chunk[SHELL_OUT_BYTES];
+            size_t n = shellDrain(shell, chunk, TX_BYTES - tx.size());
+            tx.append(chunk, n);
+            int lines = 0;
+            size_t used = 0;
+            while (used < rx.size() && lines < SHELL_LINES_PER_POLL &&
+                   shellOutputFree(shell) >= SHELL_REPLY_BYTES) {
+                if (shellFeed(shell, rx[used++])) {
+                    lines++;
+                }
+            }
+            rx.erase(0, used);
+            n = shellDrain(shell, chunk, TX_BYTES - tx.size());
+            tx.append(chunk, n);
+        }
+
+        // Wire: TX buffer to the host at line rate
+        wireCredit += WIRE_BYTES_MS;
+        size_t bytes = (size_t)wireCredit < tx.size() ? (size_t)wireCredit : tx.size();
+        wireCredit -= bytes;
+        pending.append(tx, 0, bytes);
+        tx.erase(0, bytes);
+
+        // Host: check complete reply lines
+        size_t nl;
+        while ((nl = pending.find('\n')) != std::string::npos) {
+            char expect[24];
+            snprintf(expect, sizeof(expect), "ok echo %d", answered);
+            outOfOrder += pending.compare(0, nl, expect) != 0;
+            answered++;
+            pending.erase(0, nl + 1);
+        }
+        now++;
+    }
+    return {now / 1000.0, answered, outOfOrder};
+}
+
+void test_flood_keeps_replies_in_order(void) {
+    const int commands = 3000;
+    for (int inFlight : {1, 8, 64}) {
+        setUp();
+        Flood f = flood(commands, inFlight);
+        printf("%2d in flight: %4.0f replies/s, %lu dropped\n", inFlight, f.replies / f.seconds,
+               (unsigned long)shell.stats.outputDropped);
+        TEST_ASSERT_EQUAL_INT(commands, f.replies);
+        TEST_ASSERT_EQUAL_INT(0, f.outOfOrder);
+        TEST_ASSERT_EQUAL_UINT32(0, shell.stats.outputDropped);
+        TEST_ASSERT_EQUAL_UINT32(commands, shell.stats.lines);
+    }
+}
+
+void test_line_endings(void) {
+    TEST_ASSERT_EQUAL_STRING("ok echo 1\nok echo 2\nok echo 3\n",
+                             run("echo 1\r\necho 2\recho 3\n").c_str());
+    // Blank lines and a lone LF after CR are not commands
+    TEST_ASSERT_EQUAL_STRING("", run("\r\n\n\r\r\n").c_str());
+    TEST_ASSERT_EQUAL_UINT32(3, shell.stats.lines);
+    TEST_ASSERT_EQUAL_UINT32(0, shell.stats.errors);
+}
+
+void test_overlong_line_is_rejected_whole(void) {
+    std::string longest(SHELL_LINE_BYTES - 1 - strlen("args "), 'x');
+    TEST_ASSERT_EQUAL_STRING("ok args 1\n", run(("args " + longest + "\n").c_str()).c_str());
+
+    char expect[64];
+    snprintf(expect, sizeof(expect), "err line longer than %d characters\n", SHELL_LINE_BYTES - 1);
+    std::string tooLong = "echo " + std::string(200, '7') + "\r\n";
+    TEST_ASSERT_EQUAL_STRING(expect, run(tooLong.c_str()).c_str());
+    // Nothing of it leaks into the next line
+    TEST_ASSERT_EQUAL_STRING("ok echo 5\n", run("echo 5\n").c_str());
+    TEST_ASSERT_EQUAL_UINT32(1, shell.stats.errors);
+}
+
+void test_editing_and_errors(void) {
+    TEST_ASSERT_EQUAL_STRING("ok echo 42\n", run("echo 49\b2\n").c_str());
+    TEST_ASSERT_EQUAL_STRING("ok args 2\n", run("  args\ta   b  \n").c_str());
+    TEST_ASSERT_EQUAL_STRING("err too many arguments\n", run("args 1 2 3 4 5 6\n").c_str());
+    TEST_ASSERT_EQUAL_STRING("err unknown command 'nope' (try help)\n", run("nope\n").c_str());
+    TEST_ASSERT_EQUAL_STRING("ok echo <n>\nok args [words...]\n", (shellHelp(shell), run("")).c_str());
+}
+
+/**
+ * A reply that doesn't fit the ring is dropped whole and counted, never cut
+ */
+void test_full_ring_drops_whole_replies(void) {
+    int queued = 0;
+    for (int i = 0; i < 200; i++) {
+        char line[16];
+        snprintf(line, sizeof(line), "echo %d\n", i % 10);
+        for (const char* p = line; *p; p++) {
+            shellFeed(shell, *p);
+        }
+        queued++;
+    }
+    char buf[SHELL_OUT_BYTES];
+    size_t n = shellDrain(shell, buf, sizeof(buf));
+    size_t reply = strlen("ok echo 0\n");
+    TEST_ASSERT_EQUAL_UINT32(SHELL_OUT_BYTES / reply, n / reply);
+    TEST_ASSERT_EQUAL_INT(0, (int)(n % reply));
+    TEST_ASSERT_EQUAL_UINT32(queued - n / reply, shell.stats.outputDropped);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_flood_keeps_replies_in_order);
+    RUN_TEST(test_line_endings);
+    RUN_TEST(test_overlong_line_is_rejected_whole);
+    RUN_TEST(test_editing_and_errors);
+    RUN_TEST(test_full_ring_drops_whole_replies);
+    return UNITY_END();
+}
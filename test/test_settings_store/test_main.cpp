@@ -0,0 +1,200 @@
+/**
+ * Settings store: record checks, schema migration and field validation
+ */
+
+#include <math.h>
+#include <string.h>
+#include <unity.h>
+#include "config.h"
+#include "settings_store.h"
+
+static KilnSettings custom;
+
+/**
+ * Header plus `length` payload bytes of s (zero-padded past the struct),
+ * CRC over what is written, as another build would store it
+ */
+static size_t record(uint8_t* out, uint16_t schema, uint16_t length, const KilnSettings& s) {
+    memset(out, 0, sizeof(SettingsHeader) + length);
+    memcpy(out + sizeof(SettingsHeader), &s, length < sizeof(s) ? length : sizeof(s));
+    SettingsHeader h;
+    h.magic = SETTINGS_MAGIC;
+    h.schema = schema;
+    h.length = length;
+    h.crc = settingsCrc32(out + sizeof(SettingsHeader), length);
+    memcpy(out, &h, sizeof(h));
+    return sizeof(h) + length;
+}
+
+static bool sameAsDefaults(const KilnSettings& s) {
+    KilnSettings d;
+    settingsDefaults(d);
+    return settingsDiff(s, d) == 0;
+}
+
+void setUp(void) {
+    settingsDefaults(custom);
+    custom.kp = 12.5f;
+    custom.ki = 0.25f;
+    custom.kd = 40.0f;
+    custom.wattage = 2400.0f;
+    custom.electricityRate = 0.31f;
+    custom.maxTemp = 1250.0f;
+    custom.tcOffset = -1.5f;
+    custom.ssrCycleMs = 4000;
+}
+
+void tearDown(void) {}
+
+void test_crc32_check_value(void) {
+    TEST_ASSERT_EQUAL_UINT32(0xCBF43926, settingsCrc32("123456789", 9));
+    TEST_ASSERT_EQUAL_UINT32(0x00000000, settingsCrc32("", 0));
+}
+
+void test_round_trip(void) {
+    uint8_t buf[SETTINGS_RECORD_BYTES];
+    settingsEncode(custom, buf);
+    KilnSettings out;
+    int fixed = -1;
+    TEST_ASSERT_EQUAL_INT(SETTINGS_LOADED, settingsDecode(buf, sizeof(buf), out, &fixed));
+    TEST_ASSERT_EQUAL_INT(0, fixed);
+    TEST_ASSERT_EQUAL_INT(0, settingsDiff(custom, out));
+}
+
+/**
+ * Every single-bit flip is caught and gives the defaults, except in the
+ * schema number, which the CRC doesn't cover: that reads as a migration
+ * with every value kept
+ */
+void test_corrupt_records_are_rejected(void) {
+    uint8_t good[SETTINGS_RECORD_BYTES];
+    settingsEncode(custom, good);
+    const size_t schemaAt = offsetof(SettingsHeader, schema);
+    for (size_t i = 0; i < sizeof(good); i++) {
+        for (int bit = 0; bit < 8; bit++) {
+            uint8_t bad[SETTINGS_RECORD_BYTES];
+            memcpy(bad, good, sizeof(bad));
+            bad[i] ^= (uint8_t)(1 << bit);
+            KilnSettings out;
+            int fixed;
+            SettingsLoad load = settingsDecode(bad, sizeof(bad), out, &fixed);
+            if (i >= schemaAt && i < schemaAt + 2) {
+                TEST_ASSERT_EQUAL_INT(SETTINGS_MIGRATED, load);
+                TEST_ASSERT_EQUAL_INT(0, settingsDiff(custom, out));
+            } else {
+                TEST_ASSERT_EQUAL_INT(SETTINGS_CORRUPT, load);
+                TEST_ASSERT_TRUE(sameAsDefaults(out));
+            }
+        }
+    }
+}
+
+void test_truncated_records_are_rejected(void) {
+    uint8_t buf[SETTINGS_RECORD_BYTES];
+    settingsEncode(custom, buf);
+    KilnSettings out;
+    int fixed;
+    TEST_ASSERT_EQUAL_INT(SETTINGS_EMPTY, settingsDecode(buf, 0, out, &fixed));
+    TEST_ASSERT_TRUE(sameAsDefaults(out));
+    for (size_t len = 1; len < sizeof(buf); len++) {
+        TEST_ASSERT_EQUAL_INT(SETTINGS_CORRUPT, settingsDecode(buf, len, out, &fixed));
+        TEST_ASSERT_TRUE(sameAsDefaults(out));
+    }
+}
+
+/**
+ * An older build's record (without ssrCycleMs) keeps its fields and takes
+ * the default for the new one
+ */
+void test_shorter_schema_is_migrated(void) {
+    uint8_t buf[SETTINGS_RECORD_BYTES];
+    size_t len = record(buf, SETTINGS_SCHEMA - 1, offsetof(KilnSettings, ssrCycleMs), custom);
+    KilnSettings out;
+    int fixed;
+    TEST_ASSERT_EQUAL_INT(SETTINGS_MIGRATED, settingsDecode(buf, len, out, &fixed));
+    TEST_ASSERT_EQUAL_INT(0, fixed);
+    TEST_ASSERT_EQUAL_FLOAT(custom.kp, out.kp);
+    TEST_ASSERT_EQUAL_FLOAT(custom.wattage, out.wattage);
+    TEST_ASSERT_EQUAL_FLOAT(custom.maxTemp, out.maxTemp);
+    TEST_ASSERT_EQUAL_FLOAT(custom.tcOffset, out.tcOffset);
+    TEST_ASSERT_EQUAL_UINT16(SSR_CYCLE_TIME_MS, out.ssrCycleMs);
+}
+
+/**
+ * A newer build's record (firmware downgrade) keeps the fields this build
+ * knows and ignores the rest
+ */
+void test_longer_schema_is_migrated(void) {
+    uint8_t buf[SETTINGS_RECORD_BYTES + 16];
+    size_t len = record(buf, SETTINGS_SCHEMA + 1, sizeof(KilnSettings) + 16, custom);
+    memset(buf + SETTINGS_RECORD_BYTES, 0xA5, 16);
+    SettingsHeader h;
+    memcpy(&h, buf, sizeof(h));
+    h.crc = settingsCrc32(buf + sizeof(h), h.length);
+    memcpy(buf, &h, sizeof(h));
+
+    KilnSettings out;
+    int fixed;
+    TEST_ASSERT_EQUAL_INT(SETTINGS_MIGRATED, settingsDecode(buf, len, out, &fixed));
+    TEST_ASSERT_EQUAL_INT(0, fixed);
+    TEST_ASSERT_EQUAL_INT(0, settingsDiff(custom, out));
+}
+
+/**
+ * A record that passes its CRC can still hold values no build would write:
+ * those fields are replaced with defaults and counted
+ */
+void test_bad_fields_take_defaults(void) {
+    KilnSettings bad = custom;
+    bad.kp = NAN;
+    bad.kd = -INFINITY;
+    bad.maxTemp = MAX_TEMP_LIMIT + 100.0f;
+    bad.ssrCycleMs = 0;
+    uint8_t buf[SETTINGS_RECORD_BYTES];
+    settingsEncode(bad, buf);
+
+    KilnSettings out;
+    int fixed;
+    TEST_ASSERT_EQUAL_INT(SETTINGS_LOADED, settingsDecode(buf, sizeof(buf), out, &fixed));
+    TEST_ASSERT_EQUAL_INT(4, fixed);
+    TEST_ASSERT_EQUAL_FLOAT(DEFAULT_KP, out.kp);
+    TEST_ASSERT_EQUAL_FLOAT(DEFAULT_KD, out.kd);
+    TEST_ASSERT_EQUAL_FLOAT(MAX_TEMP_LIMIT, out.maxTemp);
+    TEST_ASSERT_EQUAL_UINT16(SSR_CYCLE_TIME_MS, out.ssrCycleMs);
+    TEST_ASSERT_EQUAL_FLOAT(custom.ki, out.ki);     // Good fields kept
+    TEST_ASSERT_EQUAL_FLOAT(custom.tcOffset, out.tcOffset);
+}
+
+void test_set_checks_bounds(void) {
+    KilnSettings s = custom;
+    const SettingSpec* maxTemp = settingFind("max_temp");
+    const SettingSpec* ki = settingFind("ki");
+    const SettingSpec* cycle = settingFind("ssr_cycle");
+    TEST_ASSERT_NOT_NULL(maxTemp);
+    TEST_ASSERT_NULL(settingFind("nope"));
+
+    TEST_ASSERT_FALSE(settingSet(s, *maxTemp, MAX_TEMP_LIMIT + 1.0f));
+    TEST_ASSERT_FALSE(settingSet(s, *ki, NAN));
+    TEST_ASSERT_EQUAL_INT(0, settingsDiff(custom, s));
+    TEST_ASSERT_TRUE(settingSet(s, *maxTemp, 1000.0f));
+    TEST_ASSERT_EQUAL_FLOAT(1000.0f, settingsTempLimit(s));
+    TEST_ASSERT_TRUE(settingSet(s, *cycle, 2500.4f));
+    TEST_ASSERT_EQUAL_UINT16(2500, s.ssrCycleMs);
+
+    // Whatever RAM holds, the ceiling never passes the hard limit
+    s.maxTemp = 5000.0f;
+    TEST_ASSERT_EQUAL_FLOAT(MAX_TEMP_LIMIT, settingsTempLimit(s));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc32_check_value);
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_corrupt_records_are_rejected);
+    RUN_TEST(test_truncated_records_are_rejected);
+    RUN_TEST(test_shorter_schema_is_migrated);
+    RUN_TEST(test_longer_schema_is_migrated);
+    RUN_TEST(test_bad_fields_take_defaults);
+    RUN_TEST(test_set_checks_bounds);
+    return UNITY_END();
+}
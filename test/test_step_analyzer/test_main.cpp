@@ -0,0 +1,174 @@
+/**
+ * Step analyzer: replays of responses with known metrics
+ *
+ * Samples arrive once a second, as from the control loop's status tick, so
+ * crossing times are good to one sample.
+ */
+
+#include <math.h>
+#include <unity.h>
+#include "config.h"
+#include "step_analyzer.h"
+
+#define SAMPLE_MS   1000UL
+
+static StepAnalyzer analyzer;
+
+struct Replay {
+    int published;
+    StepResult last;
+};
+
+void setUp(void) {
+    stepAnalyzerReset(analyzer);
+}
+
+void tearDown(void) {}
+
+/**
+ * Feed `reference` and `measured(t)` from `start` to `end` (ms)
+ */
+template <typename Reference, typename Measured>
+static Replay replay(unsigned long start, unsigned long end, Reference reference, Measured measured) {
+    Replay r = {0, {}};
+    for (unsigned long now = start; now <= end; now += SAMPLE_MS) {
+        StepResult out;
+        if (stepAnalyzerUpdate(analyzer, reference(now), measured(now), now, out)) {
+            r.published++;
+            r.last = out;
+        }
+    }
+    return r;
+}
+
+/**
+ * 100 -> 400 °C with a 300 s first-order lag: rise is tau ln 9, no
+ * overshoot, and the response enters the 15 °C band (5% of the step) at
+ * tau ln 20. The result is published once it has stayed in band for
+ * STEP_SETTLE_CONFIRM_MS.
+ */
+void test_first_order_step(void) {
+    const float tau = 300.0f;
+    auto reference = [](unsigned long now) { return now < 10000UL ? 100.0f : 400.0f; };
+    auto measured = [&](unsigned long now) {
+        if (now < 10000UL) {
+            return 100.0f;
+        }
+        return 400.0f - 300.0f * expf(-(float)(now - 10000UL) / 1000.0f / tau);
+    };
+    Replay r = replay(0, 3UL * 3600UL * 1000UL, reference, measured);
+
+    TEST_ASSERT_EQUAL_INT(1, r.published);
+    TEST_ASSERT_TRUE(r.last.settled);
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, r.last.fromTemp);
+    TEST_ASSERT_EQUAL_FLOAT(400.0f, r.last.toTemp);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, tau * logf(9.0f), r.last.riseTimeSec);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, r.last.overshoot);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, tau * logf(20.0f), r.last.settlingTimeSec);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, r.last.settlingTimeSec + STEP_SETTLE_CONFIRM_MS / 1000.0f,
+                             r.last.durationSec);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f * 300.0f * tau, 300.0f * tau, r.last.iae);
+    // Still approaching from below, inside the band
+    TEST_ASSERT_GREATER_THAN_FLOAT(0.0f, r.last.steadyStateError);
+    TEST_ASSERT_LESS_THAN_FLOAT(15.0f, r.last.steadyStateError);
+}
+
+/**
+ * Underdamped second-order response (damping 0.5): the peak overshoot is
+ * exp(-pi z / sqrt(1 - z^2)) of the step, 16.3%
+ */
+void test_second_order_overshoot(void) {
+    const float zeta = 0.5f, wn = 2.0f * (float)M_PI / 1200.0f;   // rad/s
+    const float wd = wn * sqrtf(1.0f - zeta * zeta);
+    auto reference = [](unsigned long now) { return now < 10000UL ? 600.0f : 700.0f; };
+    auto measured = [&](unsigned long now) {
+        if (now < 10000UL) {
+            return 600.0f;
+        }
+        float t = (now - 10000UL) / 1000.0f;
+        float y = 1.0f - expf(-zeta * wn * t) *
+                             (cosf(wd * t) + zeta / sqrtf(1.0f - zeta * zeta) * sinf(wd * t));
+        return 600.0f + 100.0f * y;
+    };
+    Replay r = replay(0, 3UL * 3600UL * 1000UL, reference, measured);
+
+    float expect = 100.0f * expf(-(float)M_PI * zeta / sqrtf(1.0f - zeta * zeta));
+    TEST_ASSERT_EQUAL_INT(1, r.published);
+    TEST_ASSERT_TRUE(r.last.settled);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, expect, r.last.overshoot);
+    TEST_ASSERT_GREATER_THAN_FLOAT(0.0f, r.last.riseTimeSec);
+}
+
+/**
+ * Encoder detents a second apart merge into one step from the first
+ * reference to the last
+ */
+void test_encoder_detents_merge(void) {
+    auto reference = [](unsigned long now) {
+        if (now < 10000UL) return 100.0f;
+        if (now < 11000UL) return 105.0f;
+        if (now < 12000UL) return 110.0f;
+        return 115.0f;
+    };
+    auto measured = [](unsigned long now) {
+        return now < 10000UL ? 100.0f : 115.0f - 15.0f * expf(-(float)(now - 10000UL) / 60000.0f);
+    };
+    Replay r = replay(0, 3600UL * 1000UL, reference, measured);
+
+    TEST_ASSERT_EQUAL_INT(1, r.published);
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, r.last.fromTemp);
+    TEST_ASSERT_EQUAL_FLOAT(115.0f, r.last.toTemp);
+    TEST_ASSERT_TRUE(r.last.settled);
+}
+
+/**
+ * A new step before the first settles publishes the first as unsettled,
+ * measured up to the change, and starts over from its reference
+ */
+void test_superseded_step(void) {
+    auto reference = [](unsigned long now) {
+        if (now < 10000UL) return 100.0f;
+        if (now < 1010000UL) return 400.0f;
+        return 500.0f;
+    };
+    auto measured = [](unsigned long now) {
+        return now < 10000UL ? 100.0f : fminf(100.0f + (now - 10000UL) / 10000.0f, 500.0f);
+    };
+    Replay r = replay(0, 1010000UL, reference, measured);
+
+    TEST_ASSERT_EQUAL_INT(1, r.published);
+    TEST_ASSERT_FALSE(r.last.settled);
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, r.last.fromTemp);
+    TEST_ASSERT_EQUAL_FLOAT(400.0f, r.last.toTemp);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1000.0f, r.last.durationSec);
+    TEST_ASSERT_TRUE(analyzer.active);
+    TEST_ASSERT_EQUAL_FLOAT(400.0f, analyzer.fromTemp);
+    TEST_ASSERT_EQUAL_FLOAT(500.0f, analyzer.reference);
+}
+
+/**
+ * A kiln that never moves (dead elements) is given up on after
+ * STEP_MAX_DURATION_MS, unsettled and with no rise time
+ */
+void test_step_times_out(void) {
+    auto reference = [](unsigned long now) { return now < 10000UL ? 20.0f : 600.0f; };
+    auto measured = [](unsigned long now) { return 20.0f; };
+    Replay r = replay(0, 10000UL + STEP_MAX_DURATION_MS + 3600UL * 1000UL, reference, measured);
+
+    TEST_ASSERT_EQUAL_INT(1, r.published);
+    TEST_ASSERT_FALSE(r.last.settled);
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, r.last.riseTimeSec);
+    TEST_ASSERT_EQUAL_FLOAT(STEP_MAX_DURATION_MS / 1000.0f, r.last.durationSec);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 580.0f, r.last.steadyStateError);
+    TEST_ASSERT_FALSE(analyzer.active);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_order_step);
+    RUN_TEST(test_second_order_overshoot);
+    RUN_TEST(test_encoder_detents_merge);
+    RUN_TEST(test_superseded_step);
+    RUN_TEST(test_step_times_out);
+    return UNITY_END();
+}
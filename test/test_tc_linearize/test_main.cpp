@@ -0,0 +1,69 @@
+/**
+ * Type K linearization against NIST ITS-90 reference values
+ */
+
+#include <unity.h>
+#include "config.h"
+#include "tc_linearize.h"
+
+/**
+ * What the MAX31855 reports for a junction EMF (mV, referenced to 0 °C)
+ * with its cold junction at coldC whose EMF is coldMv
+ */
+static float chipReading(float emfMv, float coldC, float coldMv) {
+    return coldC + (emfMv - coldMv) * 1000.0f / TC_MAX31855_SEEBECK_UV;
+}
+
+void setUp(void) {
+    tcLinearizeBegin(0.0f);
+}
+
+void tearDown(void) {}
+
+void test_self_check_is_within_a_tenth_of_a_degree(void) {
+    TcLinearizeCheck c = tcLinearizeSelfCheck();
+    TEST_ASSERT_EQUAL_INT(16, c.points);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.1f, c.maxError);
+    // The chip's straight line is what this stage is for
+    TEST_ASSERT_GREATER_THAN_FLOAT(5.0f, c.maxChipError);
+}
+
+/**
+ * NIST E(20 °C) = 0.798 mV, E(30 °C) = 1.203 mV: the same 1000 °C junction
+ * read with the chip at 20 or 30 °C comes out the same
+ */
+void test_cold_junction_is_compensated(void) {
+    const float emf1000 = 41.276f;
+    float at20 = tcLinearize(chipReading(emf1000, 20.0f, 0.798f), 20.0f);
+    float at30 = tcLinearize(chipReading(emf1000, 30.0f, 1.203f), 30.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 1000.0f, at20);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 1000.0f, at30);
+}
+
+void test_offset_is_folded_in(void) {
+    float chip = chipReading(33.275f, 25.0f, 1.000f);   // 800 °C
+    float plain = tcLinearize(chip, 25.0f);
+    tcLinearizeSetOffset(-1.5f);
+    TEST_ASSERT_EQUAL_FLOAT(-1.5f, tcLinearizeOffset());
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, plain - 1.5f, tcLinearize(chip, 25.0f));
+    // The self-check excludes the offset
+    TEST_ASSERT_LESS_THAN_FLOAT(0.1f, tcLinearizeSelfCheck().maxError);
+}
+
+void test_monotonic_over_the_range(void) {
+    float last = tcLinearize(-60.0f, 25.0f);
+    for (float chip = -59.5f; chip <= 1400.0f; chip += 0.5f) {
+        float t = tcLinearize(chip, 25.0f);
+        TEST_ASSERT_GREATER_THAN_FLOAT(last, t);
+        last = t;
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_self_check_is_within_a_tenth_of_a_degree);
+    RUN_TEST(test_cold_junction_is_compensated);
+    RUN_TEST(test_offset_is_folded_in);
+    RUN_TEST(test_monotonic_over_the_range);
+    return UNITY_END();
+}
@@ -0,0 +1,193 @@
+/**
+ * Thermocouple sampler: reads scheduled between SSR edges
+ *
+ * A mock SSR switches on a 2 s time-proportional window, and the loop runs
+ * every 8-12 ms. A conversion that overlaps an edge (or starts while the
+ * last one is still ringing) reads a ±2 °C spike. The same run is replayed
+ * with plain fixed-period reads and with reads gated by the sampler.
+ */
+
+#include <math.h>
+#include <random>
+#include <unity.h>
+#include "config.h"
+#include "tc_sampler.h"
+
+#define WINDOW_MS   2000UL
+#define RUN_MS      600000UL
+#define LOOP_MAX_MS 12UL
+
+struct Run {
+    int reads;
+    int contaminated;           // Conversions that really overlapped an edge
+    int taggedEdge;             // Reads the sampler tagged TC_SAMPLE_EDGE
+    int missedEdge;             // Contaminated reads it tagged clean
+    unsigned long maxGap;       // Longest time between reads (ms)
+    TcSampler sampler;
+};
+
+static Run run(float duty, bool synchronous) {
+    std::mt19937 rng(1);
+    std::normal_distribution<float> base(0.0f, 0.1f);
+    std::normal_distribution<float> spike(0.0f, 2.0f);
+    std::uniform_int_distribution<int> loop(8, LOOP_MAX_MS);
+
+    Run r = {};
+    TcSampler& s = r.sampler;
+    tcSamplerReset(s);
+    unsigned long windowStart = 0, lastRead = 0, edges[2] = {0, 0};
+    bool on = false, started = false;
+
+    for (unsigned long now = 0; now < RUN_MS; now += loop(rng)) {
+        if (now - windowStart >= WINDOW_MS) {
+            windowStart = now;
+        }
+        unsigned long onTime = (unsigned long)(WINDOW_MS * duty);
+        tcSamplerSetSchedule(s, windowStart, WINDOW_MS, onTime);
+        bool want = now - windowStart < onTime;
+        if (want != on) {
+            on = want;
+            edges[0] = edges[1];
+            edges[1] = now;
+            tcSamplerNoteEdge(s, on, now);
+        }
+
+        bool due = synchronous ? tcSamplerShouldRead(s, now)
+                               : (!started || now - lastRead >= TC_SAMPLE_INTERVAL_MS);
+        if (!due) {
+            continue;
+        }
+        // The reading returned now is the conversion started at lastRead,
+        // which ran over [lastRead, lastRead + TC_CONVERSION_MS)
+        bool dirty = false;
+        for (unsigned long e : edges) {
+            dirty |= started && e != 0 && e < lastRead + TC_CONVERSION_MS &&
+                     e + TC_EDGE_SETTLE_MS > lastRead;
+        }
+        float temp = 500.0f + base(rng) + (dirty ? spike(rng) : 0.0f);
+        TcSampleTag tag = tcSamplerOnRead(s, now);
+        tcSamplerAddSample(s, tag, temp);
+
+        if (started) {
+            r.reads++;
+            r.contaminated += dirty;
+            r.taggedEdge += tag.cls == TC_SAMPLE_EDGE;
+            r.missedEdge += dirty && tag.cls != TC_SAMPLE_EDGE;
+            r.maxGap = now - lastRead > r.maxGap ? now - lastRead : r.maxGap;
+        }
+        lastRead = now;
+        started = true;
+    }
+    return r;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_sync_reads_dodge_edges(void) {
+    for (float duty : {0.03f, 0.25f, 0.5f, 0.9f, 0.97f}) {
+        Run fixed = run(duty, false);
+        Run sync = run(duty, true);
+        float fixedPct = 100.0f * fixed.contaminated / fixed.reads;
+        float syncPct = 100.0f * sync.contaminated / sync.reads;
+        TEST_ASSERT_GREATER_THAN_FLOAT(5.0f, fixedPct);
+        TEST_ASSERT_LESS_THAN_FLOAT(1.0f, syncPct);
+        // Deferring costs at most TC_MAX_DEFER_MS plus a loop pass
+        TEST_ASSERT_LESS_OR_EQUAL(TC_SAMPLE_INTERVAL_MS + TC_MAX_DEFER_MS + LOOP_MAX_MS, sync.maxGap);
+        // Still close to the nominal rate
+        TEST_ASSERT_GREATER_THAN(RUN_MS / (TC_SAMPLE_INTERVAL_MS + LOOP_MAX_MS) * 8 / 10, sync.reads);
+    }
+}
+
+/**
+ * Every conversion that really saw an edge is tagged as such (the tags
+ * are what the noise statistics are split on)
+ */
+void test_contaminated_reads_are_tagged(void) {
+    for (float duty : {0.25f, 0.5f, 0.9f}) {
+        for (bool synchronous : {false, true}) {
+            Run r = run(duty, synchronous);
+            TEST_ASSERT_EQUAL_INT(0, r.missedEdge);
+            TEST_ASSERT_GREATER_OR_EQUAL(r.contaminated, r.taggedEdge);
+        }
+    }
+}
+
+void test_steady_ssr_never_defers(void) {
+    for (float duty : {0.0f, 1.0f}) {
+        Run r = run(duty, true);
+        TEST_ASSERT_EQUAL_UINT32(0, r.sampler.forced);
+        TEST_ASSERT_EQUAL_INT(0, r.contaminated);
+        TEST_ASSERT_LESS_OR_EQUAL(TC_SAMPLE_INTERVAL_MS + LOOP_MAX_MS, r.maxGap);
+    }
+}
+
+/**
+ * Edge spikes land in the edge class, not in the steady-state noise
+ */
+void test_noise_is_split_by_class(void) {
+    Run r = run(0.5f, false);
+    const TcNoiseStats* n = r.sampler.noise;
+    TEST_ASSERT_GREATER_THAN(100, n[TC_SAMPLE_SSR_OFF].count);
+    TEST_ASSERT_GREATER_THAN(100, n[TC_SAMPLE_SSR_ON].count);
+    TEST_ASSERT_GREATER_THAN(100, n[TC_SAMPLE_EDGE].count);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.1f * sqrtf(2.0f), n[TC_SAMPLE_SSR_OFF].stddev());
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.1f * sqrtf(2.0f), n[TC_SAMPLE_SSR_ON].stddev());
+    TEST_ASSERT_GREATER_THAN_FLOAT(1.5f, n[TC_SAMPLE_EDGE].stddev());
+}
+
+/**
+ * With edges closer together than a conversion there is no quiet slot:
+ * the read is forced at TC_MAX_DEFER_MS
+ */
+void test_read_forced_when_no_quiet_slot(void) {
+    TcSampler s;
+    tcSamplerReset(s);
+    tcSamplerSetSchedule(s, 0, 60, 30);
+    TEST_ASSERT_TRUE(tcSamplerShouldRead(s, 0));
+    tcSamplerOnRead(s, 0);
+
+    unsigned long readAt = 0;
+    for (unsigned long now = 1; now < 1000 && readAt == 0; now++) {
+        if (tcSamplerShouldRead(s, now)) {
+            readAt = now;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(TC_SAMPLE_INTERVAL_MS + TC_MAX_DEFER_MS, readAt);
+    TEST_ASSERT_EQUAL_UINT32(1, s.forced);
+    TEST_ASSERT_EQUAL_UINT32(1, s.deferred);
+}
+
+void test_edge_during_conversion_tags_next_read(void) {
+    TcSampler s;
+    tcSamplerReset(s);
+    TcSampleTag tag = tcSamplerOnRead(s, 1000);
+    TEST_ASSERT_EQUAL_INT(TC_SAMPLE_EDGE, tag.cls);   // First read: unknown conversion
+
+    tag = tcSamplerOnRead(s, 1100);
+    TEST_ASSERT_EQUAL_INT(TC_SAMPLE_SSR_OFF, tag.cls);
+
+    tcSamplerNoteEdge(s, true, 1150);                 // Inside the conversion from 1100
+    tag = tcSamplerOnRead(s, 1200);
+    TEST_ASSERT_EQUAL_INT(TC_SAMPLE_EDGE, tag.cls);
+
+    tag = tcSamplerOnRead(s, 1300);                   // Conversion from 1200: settled, SSR on
+    TEST_ASSERT_EQUAL_INT(TC_SAMPLE_SSR_ON, tag.cls);
+    TEST_ASSERT_EQUAL_UINT32(50, tag.msSinceEdge);
+
+    tcSamplerNoteEdge(s, false, 1390);                // Still ringing when the next one starts
+    tcSamplerOnRead(s, 1400);
+    tag = tcSamplerOnRead(s, 1500);
+    TEST_ASSERT_TRUE(tag.edgeInWindow);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_sync_reads_dodge_edges);
+    RUN_TEST(test_contaminated_reads_are_tagged);
+    RUN_TEST(test_steady_ssr_never_defers);
+    RUN_TEST(test_noise_is_split_by_class);
+    RUN_TEST(test_read_forced_when_no_quiet_slot);
+    RUN_TEST(test_edge_during_conversion_tags_next_read);
+    return UNITY_END();
+}
@@ -0,0 +1,184 @@
+/**
+ * Dual-thermocouple voting: fault injection
+ *
+ * A kiln ramps at 150 °C/h to 1000 °C and holds. The primary reads 0.8 °C
+ * high, the backup 1.2 °C low, both with 0.3 °C noise and the MAX31855's
+ * 0.25 °C resolution, one read per zone every 100 ms.
+ */
+
+#include <math.h>
+#include <random>
+#include <unity.h>
+#include "config.h"
+#include "tc_vote.h"
+
+struct Fault {
+    double primaryFailAt;       // s, -1 = never
+    double primaryFailFor;      // s; PRIMARY_FLAKY = fail one read in three
+    double backupDriftAt;       // s, -1 = never
+    double backupDriftRate;     // °C/hour, backup reading falls away
+    double backupFailAt;        // s, -1 = never
+};
+
+#define PRIMARY_FLAKY   -2.0
+#define NEVER           -1.0
+
+struct Outcome {
+    TcVote vote;
+    double failoverAt;          // First read on the backup (s), -1 if none
+    double disagreeAt;
+    double warnAt;
+    float maxAgreeError;        // |output - primary truth| while agreeing
+    float maxStep;              // Largest output jump beyond the kiln's own change
+    float bump;                 // Mean error change across the primary failure
+    long sensorErrors;
+};
+
+static Outcome run(const Fault& f, double hours) {
+    std::mt19937 rng(7);
+    std::normal_distribution<float> noise(0.0f, 0.3f);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+    Outcome o = {};
+    tcVoteReset(o.vote);
+    o.failoverAt = o.disagreeAt = o.warnAt = -1;
+    float lastOut = NAN, lastTrue = NAN;
+    double preSum = 0, postSum = 0;
+    int preN = 0, postN = 0;
+
+    for (unsigned long ms = 100; ms <= (unsigned long)(hours * 3600000.0); ms += 100) {
+        double t = ms / 1000.0;
+        float kiln = fminf(20.0f + 150.0f * t / 3600.0f, 1000.0f);
+        float primary = roundf((kiln + 0.8f + noise(rng)) * 4.0f) / 4.0f;
+        float backup = roundf((kiln - 1.2f + noise(rng)) * 4.0f) / 4.0f;
+        if (f.backupDriftAt >= 0 && t > f.backupDriftAt) {
+            backup -= f.backupDriftRate * (t - f.backupDriftAt) / 3600.0;
+        }
+        bool primaryOk = true;
+        if (f.primaryFailAt >= 0 && t >= f.primaryFailAt) {
+            if (f.primaryFailFor == PRIMARY_FLAKY) {
+                primaryOk = uniform(rng) > 0.33f;
+            } else if (t < f.primaryFailAt + f.primaryFailFor) {
+                primaryOk = false;
+            }
+        }
+        bool backupOk = !(f.backupFailAt >= 0 && t >= f.backupFailAt);
+
+        float out;
+        if (!tcVoteUpdate(o.vote, primaryOk, primary, backupOk, backup, ms, out)) {
+            o.sensorErrors++;
+            continue;
+        }
+        if (o.failoverAt < 0 && o.vote.source == TC_VOTE_BACKUP) o.failoverAt = t;
+        if (o.disagreeAt < 0 && o.vote.disagree) o.disagreeAt = t;
+        if (o.warnAt < 0 && o.vote.driftWarning) o.warnAt = t;
+
+        float err = out - (kiln + 0.8f);
+        if (f.primaryFailAt >= 0 && t >= f.primaryFailAt - 5 && t < f.primaryFailAt) {
+            preSum += err;
+            preN++;
+        }
+        if (f.primaryFailAt >= 0 && t >= f.primaryFailAt && t < f.primaryFailAt + 5 &&
+            o.vote.source == TC_VOTE_BACKUP) {
+            postSum += err;
+            postN++;
+        }
+        if (!o.vote.disagree) {
+            o.maxAgreeError = fmaxf(o.maxAgreeError, fabsf(err));
+        }
+        if (!isnan(lastOut)) {
+            o.maxStep = fmaxf(o.maxStep, fabsf(out - lastOut - (kiln - lastTrue)));
+        }
+        lastOut = out;
+        lastTrue = kiln;
+    }
+    o.bump = (preN && postN) ? (float)(postSum / postN - preSum / preN) : 0.0f;
+    return o;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_clean_pair_never_disagrees(void) {
+    Outcome o = run({NEVER, 0, NEVER, 0, NEVER}, 10);
+    TEST_ASSERT_EQUAL_UINT32(0, o.vote.failovers);
+    TEST_ASSERT_TRUE(o.disagreeAt < 0);
+    TEST_ASSERT_FALSE(o.vote.driftWarning);
+    TEST_ASSERT_EQUAL(0, o.sensorErrors);
+    TEST_ASSERT_FLOAT_WITHIN(0.3f, 2.0f, o.vote.bias);
+}
+
+void test_primary_dropout_fails_over_and_back_without_a_bump(void) {
+    Outcome o = run({2 * 3600.0, 30, NEVER, 0, NEVER}, 3);
+    TEST_ASSERT_FLOAT_WITHIN(0.15, 2 * 3600.0, o.failoverAt);   // On the first bad read
+    TEST_ASSERT_EQUAL_UINT32(2, o.vote.failovers);              // Out and back
+    TEST_ASSERT_EQUAL(TC_VOTE_PRIMARY, o.vote.source);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 0.0f, o.bump);
+    TEST_ASSERT_LESS_THAN_FLOAT(2.5f, o.maxStep);               // Read noise, no offset step
+    TEST_ASSERT_EQUAL(0, o.sensorErrors);
+}
+
+void test_dead_primary_stays_on_backup(void) {
+    Outcome o = run({3 * 3600.0, 1e9, NEVER, 0, NEVER}, 10);
+    TEST_ASSERT_FLOAT_WITHIN(0.15, 3 * 3600.0, o.failoverAt);
+    TEST_ASSERT_EQUAL_UINT32(1, o.vote.failovers);
+    TEST_ASSERT_EQUAL(TC_VOTE_BACKUP, o.vote.source);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 0.0f, o.bump);
+    TEST_ASSERT_LESS_THAN_FLOAT(2.5f, o.maxAgreeError);         // Offset carried across
+}
+
+void test_flaky_primary_does_not_chatter(void) {
+    Outcome o = run({2 * 3600.0, PRIMARY_FLAKY, NEVER, 0, NEVER}, 6);
+    TEST_ASSERT_EQUAL_UINT32(1, o.vote.failovers);
+    TEST_ASSERT_EQUAL(TC_VOTE_BACKUP, o.vote.source);
+    TEST_ASSERT_EQUAL(0, o.sensorErrors);
+}
+
+void test_fast_drift_is_flagged_then_warned(void) {
+    Outcome o = run({NEVER, 0, 3600.0, 100, NEVER}, 3);
+    TEST_ASSERT_TRUE(o.disagreeAt > 3600.0);
+    TEST_ASSERT_LESS_THAN(3600 + 3 * TC_VOTE_RATE_WINDOW_MS / 1000, (long)o.disagreeAt);
+    TEST_ASSERT_TRUE(o.warnAt > o.disagreeAt);
+    TEST_ASSERT_LESS_THAN(3600 + 15 * 60, (long)o.warnAt);
+    TEST_ASSERT_TRUE(o.vote.driftWarning);
+}
+
+void test_slow_drift_is_caught_by_the_band(void) {
+    Outcome o = run({NEVER, 0, 3600.0, 30, NEVER}, 3);
+    TEST_ASSERT_TRUE(o.disagreeAt > 3600.0);
+    TEST_ASSERT_LESS_THAN(3600 + 45 * 60, (long)o.warnAt);
+    TEST_ASSERT_TRUE(o.warnAt > 0);
+}
+
+void test_disagreeing_pair_controls_on_the_higher_reading(void) {
+    TcVote v;
+    tcVoteReset(v);
+    float out;
+    for (unsigned long ms = 100; ms <= 10000; ms += 100) {
+        tcVoteUpdate(v, true, 500.0f, true, 499.0f, ms, out);   // Learns a 1 °C bias
+    }
+    TEST_ASSERT_TRUE(tcVoteUpdate(v, true, 500.0f, true, 560.0f, 10100, out));
+    TEST_ASSERT_EQUAL(TC_VOTE_HIGHER, v.source);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 561.0f, out);
+    TEST_ASSERT_TRUE(tcVoteUpdate(v, true, 600.0f, true, 520.0f, 10200, out));
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 600.0f, out);
+}
+
+void test_both_dead_is_a_sensor_error(void) {
+    Outcome o = run({4 * 3600.0, 1e9, NEVER, 0, 4 * 3600.0}, 5);
+    TEST_ASSERT_EQUAL(TC_VOTE_NONE, o.vote.source);
+    TEST_ASSERT_GREATER_OR_EQUAL(3600L * 10, o.sensorErrors);   // Every read from 4 h on
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_clean_pair_never_disagrees);
+    RUN_TEST(test_primary_dropout_fails_over_and_back_without_a_bump);
+    RUN_TEST(test_dead_primary_stays_on_backup);
+    RUN_TEST(test_flaky_primary_does_not_chatter);
+    RUN_TEST(test_fast_drift_is_flagged_then_warned);
+    RUN_TEST(test_slow_drift_is_caught_by_the_band);
+    RUN_TEST(test_disagreeing_pair_controls_on_the_higher_reading);
+    RUN_TEST(test_both_dead_is_a_sensor_error);
+    return UNITY_END();
+}
@@ -0,0 +1,183 @@
+/**
+ * Telemetry: frames built by the firmware encoder (src/telemetry_protocol.h)
+ * and read back by the host decoder (tools/telemetry/telemetry_decoder.cpp)
+ */
+
+#include <math.h>
+#include <string.h>
+#include <random>
+#include <string>
+#include <vector>
+#include <unity.h>
+#include "telemetry_decoder.h"
+
+struct Capture {
+    std::vector<TlmSample> samples;
+    std::string text;
+};
+
+static void onSample(const TlmSample& s, void* ctx) {
+    ((Capture*)ctx)->samples.push_back(s);
+}
+
+static void onText(const char* text, size_t len, void* ctx) {
+    ((Capture*)ctx)->text.append(text, len);
+}
+
+static TlmSample sample(uint16_t seq, int zones) {
+    TlmSample s;
+    memset(&s, 0, sizeof(s));
+    s.seq = seq;
+    s.timeMs = 123456 + seq * 100UL;
+    s.temp = 1000.3f + (seq % 100) * 0.1f;
+    s.hottest = 1003.1f;
+    s.target = NAN;             // Idle: no setpoint
+    s.wareTemp = -12.5f;
+    s.output = 37.25f;
+    s.mode = 2;
+    s.flags = TLM_FLAG_HEATING;
+    s.fault = 1;
+    s.profileState = 3;
+    s.profileSegment = 4;
+    s.faultResidual = -1.23f;
+    s.zoneCount = (uint8_t)zones;
+    for (int z = 0; z < zones; z++) {
+        s.zones[z].temp = z == 1 ? NAN : 900.0f + z;   // Zone 1's thermocouple open
+        s.zones[z].setpoint = 1000.0f - z;
+        s.zones[z].output = 99.99f;
+        s.zones[z].errors = (uint16_t)(z * 300);
+    }
+    return s;
+}
+
+static Capture capture;
+static TlmDecoder decoder;
+
+void setUp(void) {
+    capture = Capture();
+    tlmDecoderInit(decoder, onSample, onText, &capture);
+}
+
+void tearDown(void) {}
+
+void test_round_trip_every_zone_count(void) {
+    for (int zones = 1; zones <= TLM_MAX_ZONES; zones++) {
+        setUp();
+        TlmSample s = sample(7, zones);
+        uint8_t buf[TLM_MAX_ENCODED];
+        size_t n = tlmEncodeSample(s, buf);
+        TEST_ASSERT_EQUAL_UINT32(39 + 8 * (zones - 1), n);     // Sizes in the header comment
+        TEST_ASSERT_EQUAL_UINT8(0, buf[0]);
+        TEST_ASSERT_EQUAL_UINT8(0, buf[n - 1]);
+        for (size_t i = 1; i + 1 < n; i++) {
+            TEST_ASSERT_NOT_EQUAL(0, buf[i]);
+        }
+
+        tlmDecoderFeed(decoder, buf, n);
+        tlmDecoderFinish(decoder);
+        TEST_ASSERT_EQUAL_UINT32(1, capture.samples.size());
+        const TlmSample& d = capture.samples[0];
+        TEST_ASSERT_EQUAL_UINT16(7, d.seq);
+        TEST_ASSERT_EQUAL_UINT32(s.timeMs, d.timeMs);
+        TEST_ASSERT_FLOAT_WITHIN(0.05f, s.temp, d.temp);
+        TEST_ASSERT_FLOAT_WITHIN(0.05f, s.hottest, d.hottest);
+        TEST_ASSERT_TRUE(isnan(d.target));
+        TEST_ASSERT_FLOAT_WITHIN(0.05f, s.wareTemp, d.wareTemp);
+        TEST_ASSERT_FLOAT_WITHIN(0.005f, s.output, d.output);
+        TEST_ASSERT_EQUAL_UINT8(s.mode, d.mode);
+        TEST_ASSERT_EQUAL_UINT8(s.flags, d.flags);
+        TEST_ASSERT_EQUAL_UINT8(s.fault, d.fault);
+        TEST_ASSERT_EQUAL_UINT8(s.profileState, d.profileState);
+        TEST_ASSERT_EQUAL_UINT8(s.profileSegment, d.profileSegment);
+        TEST_ASSERT_FLOAT_WITHIN(0.005f, s.faultResidual, d.faultResidual);
+        TEST_ASSERT_EQUAL_UINT8(zones, d.zoneCount);
+        for (int z = 0; z < zones; z++) {
+            if (z == 1) {
+                TEST_ASSERT_TRUE(isnan(d.zones[z].temp));
+            } else {
+                TEST_ASSERT_FLOAT_WITHIN(0.05f, s.zones[z].temp, d.zones[z].temp);
+            }
+            TEST_ASSERT_FLOAT_WITHIN(0.05f, s.zones[z].setpoint, d.zones[z].setpoint);
+            TEST_ASSERT_FLOAT_WITHIN(0.005f, s.zones[z].output, d.zones[z].output);
+            TEST_ASSERT_EQUAL_UINT16(s.zones[z].errors, d.zones[z].errors);
+        }
+        TEST_ASSERT_EQUAL_UINT32(0, decoder.stats.badFrames);
+        TEST_ASSERT_EQUAL_UINT32(0, decoder.stats.textBytes);
+    }
+}
+
+void test_out_of_range_values_saturate(void) {
+    TlmSample s = sample(1, 1);
+    s.temp = 5000.0f;           // Past i16 at 0.1 °C
+    s.output = NAN;
+    s.zoneCount = TLM_MAX_ZONES + 3;
+    uint8_t buf[TLM_MAX_ENCODED];
+    size_t n = tlmEncodeSample(s, buf);
+    tlmDecoderFeed(decoder, buf, n);
+    tlmDecoderFinish(decoder);
+    TEST_ASSERT_EQUAL_UINT32(1, capture.samples.size());
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 3276.7f, capture.samples[0].temp);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, capture.samples[0].output);
+    TEST_ASSERT_EQUAL_UINT8(TLM_MAX_ZONES, capture.samples[0].zoneCount);
+}
+
+/**
+ * 20k three-zone frames as they'd arrive on a noisy port: status text
+ * between them, one frame in 333 with a flipped bit, one in 501 never sent,
+ * read back in random-sized chunks. Every intact frame decodes, every
+ * damaged one is counted bad and its sequence number lost, and the text
+ * comes through byte for byte.
+ */
+void test_stream_with_corruption_and_text(void) {
+    std::mt19937 rng(1);
+    std::vector<uint8_t> stream;
+    std::string text;
+    int sent = 0, corrupted = 0, skipped = 0;
+    for (int i = 0; i < 20000; i++) {
+        if (i % 97 == 0) {
+            const char* line = "[TLM] Binary telemetry on\r\n[PROFILE] Segment 2: 950C\n";
+            stream.insert(stream.end(), line, line + strlen(line));
+            text += line;
+        }
+        if (i % 501 == 0) {
+            skipped++;
+            continue;
+        }
+        uint8_t buf[TLM_MAX_ENCODED];
+        size_t n = tlmEncodeSample(sample((uint16_t)i, 3), buf);
+        if (i % 333 == 0) {
+            buf[1 + rng() % (n - 2)] ^= (uint8_t)(1 << (rng() % 8));
+            corrupted++;
+        }
+        stream.insert(stream.end(), buf, buf + n);
+        sent++;
+    }
+
+    for (size_t i = 0; i < stream.size();) {
+        size_t k = 1 + rng() % 200;
+        if (i + k > stream.size()) {
+            k = stream.size() - i;
+        }
+        tlmDecoderFeed(decoder, &stream[i], k);
+        i += k;
+    }
+    tlmDecoderFinish(decoder);
+
+    TEST_ASSERT_EQUAL_UINT32(sent - corrupted, decoder.stats.frames);
+    TEST_ASSERT_GREATER_OR_EQUAL(corrupted, (int)decoder.stats.badFrames);
+    // Skipped at 0 comes before the first frame, so no gap can show it
+    TEST_ASSERT_EQUAL_UINT32(skipped - 1 + corrupted, decoder.stats.lostFrames);
+    TEST_ASSERT_EQUAL_UINT64(stream.size(), decoder.stats.bytes);
+    TEST_ASSERT_TRUE(capture.text == text);
+    for (size_t i = 1; i < capture.samples.size(); i++) {
+        TEST_ASSERT_TRUE(capture.samples[i].seq > capture.samples[i - 1].seq);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip_every_zone_count);
+    RUN_TEST(test_out_of_range_values_saturate);
+    RUN_TEST(test_stream_with_corruption_and_text);
+    return UNITY_END();
+}
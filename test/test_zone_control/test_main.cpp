@@ -0,0 +1,227 @@
+/**
+ * Zone balancing against a simulated two-zone kiln
+ *
+ * Top and bottom zones (2.6 kW and 1.2 kW elements) share the kiln air
+ * through a 4 W/°C coupling. Each zone runs the firmware's PID (PID_v1's
+ * arithmetic, 1 s sample time) on a 2 s SSR window and follows a 300 °C/h
+ * ramp to 900 °C. The run is done once with every zone chasing the target
+ * and once with zoneBalancedSetpoint() trimming the zone that leads. Also
+ * the heat gate and a benchmark of the per-tick zone work.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include <initializer_list>
+#include <unity.h>
+#include "config.h"
+#include "zone_control.h"
+
+#define DT_MS       100UL
+#define WINDOW_MS   2000UL
+#define TARGET      900.0f
+
+/**
+ * PID_v1's Compute() on a fixed sample time (derivative on measurement,
+ * integral clamped to the output limits)
+ */
+struct HostPid {
+    double kp, ki, kd;          // ki, kd already scaled by the sample time
+    double integral;
+    double lastInput;
+    double output;
+
+    void begin(double p, double i, double d, double sampleS, double input) {
+        kp = p;
+        ki = i * sampleS;
+        kd = d / sampleS;
+        integral = 0.0;
+        lastInput = input;
+        output = 0.0;
+    }
+
+    void compute(double input, double setpoint) {
+        double error = setpoint - input;
+        integral = fmin(fmax(integral + ki * error, 0.0), 100.0);
+        output = fmin(fmax(kp * error + integral - kd * (input - lastInput), 0.0), 100.0);
+        lastInput = input;
+    }
+};
+
+struct Spread {
+    float peak;                 // Largest top/bottom difference after the first 10 min (°C)
+    float finalTemp[2];
+};
+
+static Spread fire(bool balanced) {
+    const double power[2] = {2600.0, 1200.0};   // W
+    const double capacity = 8000.0;             // J/°C per zone
+    const double loss = 1.0, coupling = 4.0;    // W/°C
+    double temp[2] = {20.0, 20.0};
+    HostPid pid[2];
+    for (HostPid& p : pid) {
+        p.begin(5.0, 0.5, 1.0, 1.0, 20.0);
+    }
+
+    Spread s = {0.0f, {0.0f, 0.0f}};
+    for (unsigned long now = 0; now < 8UL * 3600UL * 1000UL; now += DT_MS) {
+        float target = fminf(20.0f + 300.0f * now / 3600000.0f, TARGET);
+        if (now % 1000 == 0) {
+            float coldest = (float)fmin(temp[0], temp[1]);
+            for (int z = 0; z < 2; z++) {
+                float setpoint = balanced ? zoneBalancedSetpoint(target, (float)temp[z], coldest) : target;
+                pid[z].compute(temp[z], setpoint);
+            }
+        }
+        double next[2];
+        for (int z = 0; z < 2; z++) {
+            bool on = now % WINDOW_MS < WINDOW_MS * pid[z].output / 100.0;
+            double q = (on ? power[z] : 0.0) - loss * (temp[z] - 20.0) - coupling * (temp[z] - temp[1 - z]);
+            next[z] = temp[z] + q * (DT_MS / 1000.0) / capacity;
+        }
+        temp[0] = next[0];
+        temp[1] = next[1];
+        if (now > 600000UL) {
+            s.peak = fmaxf(s.peak, (float)fabs(temp[0] - temp[1]));
+        }
+    }
+    s.finalTemp[0] = (float)temp[0];
+    s.finalTemp[1] = (float)temp[1];
+    return s;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_trim_follows_lead_and_is_capped(void) {
+    TEST_ASSERT_EQUAL_FLOAT(TARGET, zoneBalancedSetpoint(TARGET, 700.0f, 700.0f));
+    TEST_ASSERT_EQUAL_FLOAT(TARGET - ZONE_BALANCE_GAIN * 5.0f, zoneBalancedSetpoint(TARGET, 705.0f, 700.0f));
+    TEST_ASSERT_EQUAL_FLOAT(TARGET - ZONE_BALANCE_MAX, zoneBalancedSetpoint(TARGET, 900.0f, 700.0f));
+}
+
+/**
+ * With one zone it is always the coldest: the setpoint is the target, so
+ * KILN_ZONE_COUNT 1 is the plain single loop
+ */
+void test_single_zone_gets_the_target(void) {
+    for (float t = 20.0f; t <= 1300.0f; t += 37.5f) {
+        TEST_ASSERT_EQUAL_FLOAT(TARGET, zoneBalancedSetpoint(TARGET, t, t));
+    }
+}
+
+/**
+ * Balancing at least halves the peak top/bottom spread on the ramp, and
+ * both zones still hold at target
+ */
+void test_balancing_narrows_the_spread(void) {
+    Spread plain = fire(false);
+    Spread balanced = fire(true);
+    TEST_ASSERT_GREATER_THAN_FLOAT(35.0f, plain.peak);
+    TEST_ASSERT_LESS_THAN_FLOAT(plain.peak / 2, balanced.peak);
+    for (int z = 0; z < 2; z++) {
+        TEST_ASSERT_FLOAT_WITHIN(3.0f, TARGET, plain.finalTemp[z]);
+        TEST_ASSERT_FLOAT_WITHIN(3.0f, TARGET, balanced.finalTemp[z]);
+    }
+}
+
+/**
+ * E-stop mid-firing, as applyCommand() does it: the target goes to 0 and the
+ * mode to idle. On every following tick the gate keeps every SSR off,
+ * though the target the PIDs were chasing is still far above the kiln.
+ */
+void test_estop_keeps_every_ssr_off(void) {
+    const float limit = MAX_TEMP_LIMIT;
+    double temp[2] = {20.0, 20.0};
+    HostPid pid[2];
+    for (HostPid& p : pid) {
+        p.begin(5.0, 0.5, 1.0, 1.0, 20.0);
+    }
+    bool idle = false;
+    float target = 1000.0f;
+    unsigned long estopAt = 2UL * 3600UL * 1000UL;
+    int onAfterEstop = 0;
+    double tempAtEstop = 0.0;
+
+    for (unsigned long now = 0; now < estopAt + 15UL * 60UL * 1000UL; now += DT_MS) {
+        if (now == estopAt) {
+            target = 0.0f;
+            idle = true;
+            tempAtEstop = temp[0];
+        }
+        float hottest = (float)fmax(temp[0], temp[1]);
+        bool allowed = zoneHeatGate(idle, false, false, target, hottest, limit) == ZONE_HEAT_OK;
+        for (int z = 0; z < 2; z++) {
+            if (!allowed) {
+                pid[z].output = 0.0;    // ZoneController::stop()
+            } else if (now % 1000 == 0) {
+                pid[z].compute(temp[z], target);
+            }
+            bool on = allowed && now % WINDOW_MS < WINDOW_MS * pid[z].output / 100.0;
+            if (now >= estopAt) {
+                onAfterEstop += on;
+            }
+            temp[z] += ((on ? 2000.0 : 0.0) - (temp[z] - 20.0)) * (DT_MS / 1000.0) / 8000.0;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(0, onAfterEstop);
+    TEST_ASSERT_GREATER_THAN_FLOAT(900.0f, (float)tempAtEstop);
+    TEST_ASSERT_LESS_THAN_FLOAT((float)tempAtEstop - 50.0f, (float)temp[0]);  // Cooling, not held
+
+    // Either half alone is not enough: a stale target outside idle heats
+    TEST_ASSERT_EQUAL_INT(ZONE_HEAT_OK, zoneHeatGate(false, false, false, 1000.0f, 700.0f, limit));
+    TEST_ASSERT_EQUAL_INT(ZONE_HEAT_IDLE, zoneHeatGate(true, false, false, 0.0f, 700.0f, limit));
+}
+
+void test_safety_conditions_block_heat(void) {
+    const float limit = 1200.0f;
+    TEST_ASSERT_EQUAL_INT(ZONE_HEAT_SENSOR_ERROR, zoneHeatGate(false, true, false, 500.0f, 400.0f, limit));
+    TEST_ASSERT_EQUAL_INT(ZONE_HEAT_STUCK_SSR, zoneHeatGate(false, false, true, 500.0f, 400.0f, limit));
+    TEST_ASSERT_EQUAL_INT(ZONE_HEAT_TARGET_LIMIT, zoneHeatGate(false, false, false, 1250.0f, 400.0f, limit));
+    TEST_ASSERT_EQUAL_INT(ZONE_HEAT_TEMP_LIMIT, zoneHeatGate(false, false, false, 1100.0f, 1200.0f, limit));
+    TEST_ASSERT_EQUAL_INT(ZONE_HEAT_OK, zoneHeatGate(false, false, false, 1200.0f, 1199.0f, limit));
+}
+
+/**
+ * Control tick cost for 1, 2, 4 and 8 zones: what zonesControlTick() does
+ * (coldest zone, balanced setpoint, one PID compute per zone), with the
+ * host PID standing in for PID_v1. Printed for comparison between builds,
+ * not asserted.
+ */
+void test_benchmark_control_tick(void) {
+    const int rounds = 200000;
+    for (int count : {1, 2, 4, 8}) {
+        HostPid pid[8];
+        float temp[8];
+        for (int z = 0; z < count; z++) {
+            pid[z].begin(5.0, 0.5, 1.0, 1.0, 500.0);
+            temp[z] = 500.0f + z;
+        }
+        double outputs = 0.0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            temp[r % count] += (r & 1) ? 0.25f : -0.25f;
+            float coldest = temp[0];
+            for (int z = 1; z < count; z++) {
+                coldest = fminf(coldest, temp[z]);
+            }
+            for (int z = 0; z < count; z++) {
+                pid[z].compute(temp[z], zoneBalancedSetpoint(600.0f, temp[z], coldest));
+            }
+            outputs += pid[0].output;
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / rounds;
+        printf("%d zone(s): %.0f ns/tick (%.0f ns/zone)\n", count, ns, ns / count);
+        TEST_ASSERT_FALSE(isnan(outputs));
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_trim_follows_lead_and_is_capped);
+    RUN_TEST(test_single_zone_gets_the_target);
+    RUN_TEST(test_balancing_narrows_the_spread);
+    RUN_TEST(test_estop_keeps_every_ssr_off);
+    RUN_TEST(test_safety_conditions_block_heat);
+    RUN_TEST(test_benchmark_control_tick);
+    return UNITY_END();
+}
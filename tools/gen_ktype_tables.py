@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+"""
+Generate the K-type thermocouple tables in src/tc_linearize.cpp.
+
+Both tables come from the NIST ITS-90 forward polynomial E(T) (NIST
+Monograph 175). The inverse table is found by bisection on E(T), so it stays
+consistent with the forward function instead of relying on NIST's inverse
+polynomial fits, which are split across ranges and only good to ~0.05 C.
+
+Usage: python3 tools/gen_ktype_tables.py
+Paste the output over the tables in src/tc_linearize.cpp.
+"""
+
+import math
+
+# NIST ITS-90 type K, E in mV, T in °C
+NEG = [0.0, 0.394501280250e-01, 0.236223735980e-04, -0.328589067840e-06,
+       -0.499048287770e-08, -0.675090591730e-10, -0.574103274280e-12,
+       -0.310888728940e-14, -0.104516093650e-16, -0.198892668780e-19,
+       -0.163226974860e-22]
+POS = [-0.176004136860e-01, 0.389212049750e-01, 0.185587700320e-04,
+       -0.994575928740e-07, 0.318409457190e-09, -0.560728448890e-12,
+       0.560750590590e-15, -0.320207200030e-18, 0.971511471520e-22,
+       -0.121047212750e-25]
+A0, A1, A2 = 0.118597600000e+00, -0.118343200000e-03, 0.126968600000e+03
+
+# Table layout (must match tc_linearize.cpp)
+INV_E_MIN = -2.0    # mV (about -52 °C)
+INV_E_STEP = 0.5    # mV
+INV_E_MAX = 55.0    # mV (about 1372 °C, top of the NIST range)
+CJ_T_MIN = -20      # °C
+CJ_T_STEP = 5       # °C
+CJ_T_MAX = 85       # °C (MAX31855 cold-junction operating range)
+
+
+def emf(t):
+    """Thermocouple EMF in mV for a hot junction at t °C, reference at 0 °C"""
+    if t < 0:
+        return sum(c * t ** i for i, c in enumerate(NEG))
+    return sum(c * t ** i for i, c in enumerate(POS)) + A0 * math.exp(A1 * (t - A2) ** 2)
+
+
+def temp_for_emf(e):
+    lo, hi = -270.0, 1500.0
+    for _ in range(80):
+        mid = 0.5 * (lo + hi)
+        if emf(mid) < e:
+            lo = mid
+        else:
+            hi = mid
+    return 0.5 * (lo + hi)
+
+
+def table(name, ctype, values, per_line=8):
+    print(f"static const {ctype} {name}[{len(values)}] = {{")
+    for i in range(0, len(values), per_line):
+        chunk = ", ".join(f"{v:9.3f}f" for v in values[i:i + per_line])
+        print(f"    {chunk},")
+    print("};")
+
+
+def main():
+    n_inv = int(round((INV_E_MAX - INV_E_MIN) / INV_E_STEP)) + 1
+    inv = [temp_for_emf(INV_E_MIN + i * INV_E_STEP) for i in range(n_inv)]
+    n_cj = (CJ_T_MAX - CJ_T_MIN) // CJ_T_STEP + 1
+    cj = [emf(CJ_T_MIN + i * CJ_T_STEP) * 1000.0 for i in range(n_cj)]  # µV
+
+    print("// Generated by tools/gen_ktype_tables.py - do not edit by hand")
+    print(f"// Inverse: T (°C) at E = {INV_E_MIN} + i * {INV_E_STEP} mV")
+    table("kInverseTable", "float", inv)
+    print()
+    print(f"// Cold junction: E (µV) at T = {CJ_T_MIN} + i * {CJ_T_STEP} °C")
+    table("kColdJunctionTable", "float", cj)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,392 @@
+/**
+ * firing_log_fetch - download firing logs over the USB serial port
+ *
+ * Speaks the sliding-window transfer in src/log_transfer.h: lists the logs
+ * on the controller, or downloads one at a negotiated baud rate, ACKing
+ * each block, and reports the effective throughput. An interrupted
+ * download resumes from the end of the partial file with --resume.
+ *
+ * Build:  g++ -std=c++17 -O2 -I../../src firing_log_fetch.cpp telemetry_decoder.cpp \
+ *             ../../src/log_transfer.cpp -o firing_log_fetch
+ * Usage:  ./firing_log_fetch /dev/ttyUSB0 --list
+ *         ./firing_log_fetch /dev/ttyUSB0 [index|latest] [-o file] [--resume]
+ *                            [--baud 921600] [--block 512] [--window 16]
+ * POSIX serial (termios); the rates above 115200 need Linux or a port that
+ * accepts them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <chrono>
+#include "telemetry_decoder.h"
+#include "log_transfer.h"
+
+static uint32_t nowMs() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ============================================================================
+// SERIAL PORT
+// ============================================================================
+
+static speed_t speedFor(uint32_t baud) {
+    switch (baud) {
+        case 115200: return B115200;
+        case 230400: return B230400;
+#ifdef B460800
+        case 460800: return B460800;
+#endif
+#ifdef B921600
+        case 921600: return B921600;
+#endif
+        default: return 0;
+    }
+}
+
+static bool setBaud(int fd, uint32_t baud) {
+    struct termios tio;
+    speed_t speed = speedFor(baud);
+    if (speed == 0 || tcgetattr(fd, &tio) != 0) {
+        return false;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    return tcsetattr(fd, TCSADRAIN, &tio) == 0;
+}
+
+static int openPort(const char* path) {
+    int fd = open(path, O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+    if (!setBaud(fd, 115200)) {
+        fprintf(stderr, "%s: cannot configure port\n", path);
+        close(fd);
+        return -1;
+    }
+    tcflush(fd, TCIOFLUSH);
+    return fd;
+}
+
+static void sendMessage(int fd, XferMessage& m) {
+    static uint16_t seq = 0;
+    uint8_t out[XFER_MAX_ENCODED];
+    m.seq = seq++;
+    size_t n = xferEncode(m, out);
+    if (write(fd, out, n) != (ssize_t)n) {
+        perror("write");
+    }
+}
+
+// ============================================================================
+// SESSION
+// ============================================================================
+
+struct Session {
+    int fd;
+    TlmDecoder decoder;
+    FILE* out;
+    XferReceiver receiver;
+    bool haveInfo;
+    XferMessage info;
+    bool listDone;
+    int latest;                 // Highest index listed
+    bool listing;
+    bool done;
+    XferMessage doneMsg;
+    bool dataSeen;
+    bool needAck;               // Send an ACK for what arrived in this read
+    bool needResend;
+    uint32_t lastDataMs;
+};
+
+static void onFrame(const uint8_t* frame, size_t len, void* ctx) {
+    Session& s = *(Session*)ctx;
+    XferMessage m;
+    if (!xferDecode(frame, len, m)) {
+        return;
+    }
+    switch (m.type) {
+        case TLM_MSG_XFER_ENTRY:
+            if (m.index == XFER_LIST_END) {
+                s.listDone = true;
+            } else {
+                if (s.listing) {
+                    printf("%4u  %8lu bytes\n", m.index, (unsigned long)m.size);
+                }
+                if ((int)m.index > s.latest) {
+                    s.latest = m.index;
+                }
+            }
+            break;
+        case TLM_MSG_XFER_INFO:
+            s.info = m;
+            s.haveInfo = true;
+            break;
+        case TLM_MSG_XFER_DATA: {
+            if (!s.haveInfo) {
+                break;
+            }
+            s.dataSeen = true;
+            XferVerdict v = xferReceive(s.receiver, m.offset, m.length);
+            if (v == XFER_ACCEPT) {
+                fseek(s.out, (long)m.offset, SEEK_SET);
+                fwrite(m.data, 1, m.length, s.out);
+                s.needAck = true;
+                s.lastDataMs = nowMs();
+            } else if (v == XFER_DISCARD_RESEND) {
+                s.needResend = true;
+            }
+            break;
+        }
+        case TLM_MSG_XFER_DONE:
+            s.doneMsg = m;
+            s.done = true;
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Read whatever arrives within waitMs and feed it to the decoder
+ */
+static void pump(Session& s, int waitMs) {
+    struct pollfd p = {s.fd, POLLIN, 0};
+    if (poll(&p, 1, waitMs) <= 0) {
+        return;
+    }
+    uint8_t buf[4096];
+    ssize_t n = read(s.fd, buf, sizeof(buf));
+    if (n > 0) {
+        tlmDecoderFeed(s.decoder, buf, (size_t)n);
+    }
+}
+
+static bool listLogs(Session& s, bool print) {
+    s.listing = print;
+    for (int attempt = 0; attempt < 3 && !s.listDone; attempt++) {
+        XferMessage req = {};
+        req.type = TLM_MSG_XFER_LIST;
+        sendMessage(s.fd, req);
+        uint32_t start = nowMs();
+        while (!s.listDone && nowMs() - start < 2000) {
+            pump(s, 50);
+        }
+    }
+    return s.listDone;
+}
+
+static void sendAck(Session& s, uint8_t flags) {
+    XferMessage ack = {};
+    ack.type = TLM_MSG_XFER_ACK;
+    ack.offset = s.receiver.expected;
+    ack.flags = flags;
+    sendMessage(s.fd, ack);
+}
+
+static int fetch(Session& s, int index, const char* path, bool resume, uint32_t baud,
+                 uint16_t block, uint8_t window) {
+    uint32_t offset = 0;
+    struct stat st;
+    if (resume && stat(path, &st) == 0) {
+        offset = (uint32_t)st.st_size;
+    }
+    s.out = fopen(path, resume && offset > 0 ? "r+b" : "wb");
+    if (s.out == nullptr) {
+        perror(path);
+        return 1;
+    }
+
+    // OPEN until INFO comes back (a controller still busy with an abandoned
+    // transfer returns to 115200 after XFER_IDLE_TIMEOUT_MS)
+    const int attempts = 2 + XFER_IDLE_TIMEOUT_MS / 1000;
+    for (int attempt = 0; attempt < attempts && !s.haveInfo; attempt++) {
+        XferMessage open = {};
+        open.type = TLM_MSG_XFER_OPEN;
+        open.index = (uint16_t)index;
+        open.offset = offset;
+        open.baud = baud;
+        open.blockSize = block;
+        open.window = window;
+        sendMessage(s.fd, open);
+        uint32_t start = nowMs();
+        while (!s.haveInfo && nowMs() - start < 1000) {
+            pump(s, 50);
+        }
+        if (s.haveInfo && s.info.status == XFER_BUSY && attempt + 1 < attempts) {
+            s.haveInfo = false;
+            while (nowMs() - start < 1000) {
+                pump(s, 50);
+            }
+        }
+    }
+    if (!s.haveInfo) {
+        fprintf(stderr, "No reply from the controller\n");
+        return 1;
+    }
+    if (s.info.status != XFER_OK) {
+        fprintf(stderr, "Log %d: %s\n", index,
+                s.info.status == XFER_NO_SUCH_LOG ? "no such log" : "controller busy");
+        return 1;
+    }
+    fprintf(stderr, "Log %d: %lu bytes from %lu at %lu baud, %u-byte blocks, window %u\n", index,
+            (unsigned long)s.info.size, (unsigned long)s.info.offset, (unsigned long)s.info.baud,
+            s.info.blockSize, s.info.window);
+
+    tcdrain(s.fd);
+    usleep(20000);  // Controller drains its TX buffer, then switches
+    if (!setBaud(s.fd, s.info.baud)) {
+        fprintf(stderr, "Port refuses %lu baud\n", (unsigned long)s.info.baud);
+        return 1;
+    }
+    tcflush(s.fd, TCIFLUSH);
+
+    xferReceiverStart(s.receiver, s.info.offset);
+    uint32_t startMs = nowMs();
+    uint32_t lastAckMs = 0;
+    s.lastDataMs = startMs;
+    uint32_t badAtStart = s.decoder.stats.badFrames;
+
+    while (s.receiver.expected < s.info.size) {
+        pump(s, 20);
+        uint32_t now = nowMs();
+        if (s.needResend) {
+            sendAck(s, XFER_ACK_RESEND);
+            lastAckMs = now;
+        } else if (s.needAck || now - lastAckMs >= 200) {
+            sendAck(s, 0);  // Also the sync until the first block, and a keep-alive
+            lastAckMs = now;
+        }
+        s.needAck = s.needResend = false;
+        if (now - s.lastDataMs > 5000) {
+            fprintf(stderr, "Stalled at %lu/%lu bytes; rerun with --resume\n",
+                    (unsigned long)s.receiver.expected, (unsigned long)s.info.size);
+            fclose(s.out);
+            setBaud(s.fd, 115200);
+            return 1;
+        }
+    }
+    uint32_t elapsedMs = nowMs() - startMs;
+    fclose(s.out);
+
+    for (int attempt = 0; attempt < 5 && !s.done; attempt++) {
+        XferMessage close = {};
+        close.type = TLM_MSG_XFER_CLOSE;
+        sendMessage(s.fd, close);
+        uint32_t start = nowMs();
+        while (!s.done && nowMs() - start < 300) {
+            pump(s, 20);
+        }
+    }
+    tcdrain(s.fd);
+    usleep(20000);
+    setBaud(s.fd, 115200);
+
+    uint32_t bytes = s.info.size - s.info.offset;
+    double seconds = elapsedMs > 0 ? elapsedMs / 1000.0 : 0.001;
+    double lineRate = s.info.baud / 10.0;   // 8N1: 10 bits per byte
+    fprintf(stderr, "%lu bytes in %.2f s: %.1f KB/s, %.0f%% of the %lu-baud line rate\n",
+            (unsigned long)bytes, seconds, bytes / seconds / 1024.0,
+            100.0 * bytes / seconds / lineRate, (unsigned long)s.info.baud);
+    fprintf(stderr, "blocks=%lu crc/format errors=%lu resend requests=%lu discarded=%lu\n",
+            (unsigned long)s.receiver.accepted,
+            (unsigned long)(s.decoder.stats.badFrames - badAtStart),
+            (unsigned long)s.receiver.resendRequests,
+            (unsigned long)(s.receiver.duplicates + s.receiver.outOfOrder));
+    if (s.done) {
+        fprintf(stderr, "controller: sent %lu bytes in %lu frames, %lu bytes resent\n",
+                (unsigned long)s.doneMsg.size, (unsigned long)s.doneMsg.frames,
+                (unsigned long)s.doneMsg.resent);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    const char* port = nullptr;
+    const char* which = "latest";
+    const char* path = nullptr;
+    bool list = false;
+    bool resume = false;
+    uint32_t baud = 921600;
+    int block = XFER_MAX_BLOCK;
+    int window = 16;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        bool more = i + 1 < argc;
+        if (strcmp(a, "--list") == 0) {
+            list = true;
+        } else if (strcmp(a, "--resume") == 0) {
+            resume = true;
+        } else if (strcmp(a, "-o") == 0 && more) {
+            path = argv[++i];
+        } else if (strcmp(a, "--baud") == 0 && more) {
+            baud = (uint32_t)atol(argv[++i]);
+        } else if (strcmp(a, "--block") == 0 && more) {
+            block = atoi(argv[++i]);
+        } else if (strcmp(a, "--window") == 0 && more) {
+            window = atoi(argv[++i]);
+        } else if (a[0] == '-') {
+            port = nullptr;
+            break;
+        } else if (port == nullptr) {
+            port = a;
+        } else {
+            which = a;
+        }
+    }
+    if (port == nullptr) {
+        fprintf(stderr, "usage: %s port --list\n"
+                        "       %s port [index|latest] [-o file] [--resume] [--baud n]"
+                        " [--block n] [--window n]\n", argv[0], argv[0]);
+        return 2;
+    }
+    if (speedFor(baud) == 0) {
+        fprintf(stderr, "Unsupported baud %lu\n", (unsigned long)baud);
+        return 2;
+    }
+
+    static Session s;
+    s.latest = -1;
+    s.fd = openPort(port);
+    if (s.fd < 0) {
+        return 1;
+    }
+    tlmDecoderInit(s.decoder, nullptr, nullptr, &s);
+    s.decoder.onFrame = onFrame;
+
+    if (list) {
+        return listLogs(s, true) ? 0 : 1;
+    }
+
+    int index;
+    if (strcmp(which, "latest") == 0) {
+        if (!listLogs(s, false) || s.latest < 0) {
+            fprintf(stderr, "No logs on the controller\n");
+            return 1;
+        }
+        index = s.latest;
+    } else {
+        index = atoi(which);
+    }
+    char defaultPath[32];
+    if (path == nullptr) {
+        snprintf(defaultPath, sizeof(defaultPath), "%04d.log", index);
+        path = defaultPath;
+    }
+    return fetch(s, index, path, resume, baud, (uint16_t)block, (uint8_t)window);
+}
@@ -0,0 +1,225 @@
+/**
+ * flight_decode - print a flight recorder record as a timeline
+ *
+ * Takes an archive copied off the controller (/flight/NNNN.bin), or a
+ * serial capture holding a "[FLIGHT] BEGIN ... [FLIGHT] END" hex dump: the
+ * one printed at boot after an unexpected reset, or the one the "flight"
+ * shell command prints. The last complete dump in a capture is used. Both
+ * rings are merged oldest first. Slots that fail their check byte
+ * (half-written when the reset hit) are counted and skipped.
+ *
+ * Build:  g++ -std=c++17 -O2 -I../../src flight_decode.cpp ../../src/flight_recorder.cpp \
+ *             ../../src/command_queue.cpp ../../src/fault_observer.cpp -o flight_decode
+ * Usage:  ./flight_decode capture.txt
+ *         ./flight_decode 0003.bin [--ticks]
+ *   --ticks  list every control tick (by default only the last 20 are shown)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "flight_recorder.h"
+#include "command_queue.h"
+#include "fault_observer.h"
+
+#define TICKS_SHOWN 20
+
+static bool readFile(const char* path, std::vector<uint8_t>& data) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        data.insert(data.end(), buf, buf + n);
+    }
+    fclose(f);
+    return true;
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * Rebuild the record from the last complete [FLIGHT] BEGIN/END hex dump
+ */
+static bool parseCapture(const std::vector<uint8_t>& text, std::vector<uint8_t>& record) {
+    std::vector<uint8_t> current;
+    size_t expected = 0;
+    bool inDump = false;
+    bool found = false;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = pos;
+        while (end < text.size() && text[end] != '\n') {
+            end++;
+        }
+        std::string line((const char*)&text[pos], end - pos);
+        pos = end + 1;
+
+        size_t tag = line.find("[FLIGHT] ");
+        if (tag == std::string::npos) {
+            continue;
+        }
+        const char* p = line.c_str() + tag + 9;
+        if (strncmp(p, "BEGIN ", 6) == 0) {
+            const char* size = strrchr(p, ' ');
+            expected = (size_t)strtoul(size + 1, nullptr, 10);
+            current.assign(expected, 0);
+            inDump = true;
+            continue;
+        }
+        if (strncmp(p, "END", 3) == 0) {
+            if (inDump) {
+                record = current;
+                found = true;
+            }
+            inDump = false;
+            continue;
+        }
+        if (!inDump) {
+            continue;
+        }
+        char* rest;
+        size_t offset = (size_t)strtoul(p, &rest, 16);
+        if (rest == p || *rest != ' ') {
+            continue;  // Summary line, not hex
+        }
+        rest++;
+        for (; hexValue(rest[0]) >= 0 && hexValue(rest[1]) >= 0; rest += 2) {
+            if (offset >= expected) {
+                inDump = false;  // Longer than announced: not a dump we can trust
+                break;
+            }
+            current[offset++] = (uint8_t)(hexValue(rest[0]) << 4 | hexValue(rest[1]));
+        }
+    }
+    return found;
+}
+
+static void printEvent(const FlightEvent& e) {
+    printf("%10lu  %-7s %7.1f  ", (unsigned long)e.timeMs, flightEventName(e.type), e.temp / 10.0f);
+    switch (e.type) {
+        case FLIGHT_EVT_BOOT:
+            printf("%s reset, boot %u", flightResetReasonName(e.a), e.b);
+            break;
+        case FLIGHT_EVT_MODE:
+            printf("mode %u", e.a);
+            break;
+        case FLIGHT_EVT_COMMAND:
+            printf("%s source %u value %.1f", commandName((CommandType)e.a), e.b, e.value / 10.0f);
+            break;
+        case FLIGHT_EVT_FAULT:
+            printf("%s innovation %.1f C", faultClassName((FaultClass)e.a), e.value / 10.0f);
+            break;
+        case FLIGHT_EVT_PROFILE:
+            printf("state %u segment %u", e.a, e.b);
+            break;
+        case FLIGHT_EVT_SENSOR:
+            printf(e.a ? "sensor error" : "sensor ok");
+            break;
+        case FLIGHT_EVT_TICK:
+            printf("target %.1f duty %.2f%% ssr 0x%02x%s%s", e.value / 10.0f, e.b / 100.0f, e.a,
+                   (e.flags & FLIGHT_FLAG_HEATING) ? " heating" : "",
+                   (e.flags & FLIGHT_FLAG_SENSOR_ERR) ? " sensor-error" : "");
+            break;
+        case FLIGHT_EVT_SSR:
+            printf("ssr 0x%02x", e.a);
+            break;
+        default:
+            break;
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    bool allTicks = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--ticks") == 0) {
+            allTicks = true;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (!path) {
+        fprintf(stderr, "usage: flight_decode <archive.bin|capture> [--ticks]\n");
+        return 2;
+    }
+
+    std::vector<uint8_t> data;
+    if (!readFile(path, data)) {
+        perror(path);
+        return 1;
+    }
+    std::vector<uint8_t> record;
+    uint32_t magic = 0;
+    if (data.size() >= 4) {
+        memcpy(&magic, data.data(), 4);
+    }
+    if (magic == FLIGHT_MAGIC) {
+        record = data;
+    } else if (!parseCapture(data, record)) {
+        fprintf(stderr, "%s: no flight record (neither an archive nor a capture with a complete dump)\n",
+                path);
+        return 1;
+    }
+
+    FlightHeader h;
+    if (record.size() < sizeof(h)) {
+        fprintf(stderr, "record too short\n");
+        return 1;
+    }
+    memcpy(&h, record.data(), sizeof(h));
+    size_t need = sizeof(h) + ((size_t)h.eventSlots + h.tickSlots) * sizeof(FlightEvent);
+    if (!flightRecordValid(h, h.eventSlots, h.tickSlots) || record.size() < need) {
+        fprintf(stderr, "bad record header (magic 0x%08lx version %u, %zu bytes)\n",
+                (unsigned long)h.magic, h.version, record.size());
+        return 1;
+    }
+    std::vector<FlightEvent> events(h.eventSlots), ticks(h.tickSlots);
+    memcpy(events.data(), record.data() + sizeof(h), h.eventSlots * sizeof(FlightEvent));
+    memcpy(ticks.data(), record.data() + sizeof(h) + h.eventSlots * sizeof(FlightEvent),
+           h.tickSlots * sizeof(FlightEvent));
+
+    std::vector<FlightEvent> sorted(h.eventSlots + h.tickSlots);
+    int torn;
+    int n = flightCollect(h, events.data(), ticks.data(), sorted.data(), (int)sorted.size(), &torn);
+
+    printf("# boot %lu, started by %s reset\n", (unsigned long)h.bootCount,
+           flightResetReasonName(h.resetReason));
+    printf("# %lu scheduler heartbeats, last at %lu ms\n", (unsigned long)h.heartbeats,
+           (unsigned long)h.lastHeartbeatMs);
+    if (h.runningJob >= 0) {
+        printf("# reset while job %d was running (since %lu ms)\n", h.runningJob,
+               (unsigned long)h.jobStartMs);
+    }
+    printf("# %d events, %d torn slots skipped\n", n, torn);
+
+    int ticksLeft = 0;
+    for (int i = 0; i < n; i++) {
+        ticksLeft += flightIsTick(sorted[i].type);
+    }
+    printf("#    time_ms  event    temp_c  detail\n");
+    int hidden = 0;
+    for (int i = 0; i < n; i++) {
+        bool tick = flightIsTick(sorted[i].type);
+        if (tick && !allTicks && ticksLeft-- > TICKS_SHOWN) {
+            hidden++;
+            continue;
+        }
+        if (hidden) {
+            printf("%10s  (%d earlier ticks; --ticks lists them)\n", "", hidden);
+            hidden = 0;
+        }
+        printEvent(sorted[i]);
+    }
+    return 0;
+}
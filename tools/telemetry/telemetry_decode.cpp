@@ -0,0 +1,117 @@
+/**
+ * telemetry_decode - binary kiln telemetry to CSV
+ *
+ * Reads a raw capture (or the serial device itself) and writes one CSV row
+ * per sample to stdout. Columns are fixed per zone count, units are in the
+ * header, and missing values (no reading) are empty fields, so the output
+ * loads straight into pandas/polars/DuckDB and converts to Parquet as is.
+ * A summary (frames, bad frames, lost frames, bytes per sample) goes to
+ * stderr at the end.
+ *
+ * Build:  g++ -std=c++17 -O2 -I../../src telemetry_decode.cpp telemetry_decoder.cpp \
+ *             -o telemetry_decode
+ * Usage:  stty -F /dev/ttyUSB0 115200 raw
+ *         ./telemetry_decode [--text] /dev/ttyUSB0 > firing.csv
+ *         ./telemetry_decode capture.bin > firing.csv
+ *   --text  copy the text that shares the port (status, debug log) to stderr
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "telemetry_decoder.h"
+
+struct CsvState {
+    bool headerWritten;
+    int zoneCount;
+    bool passText;
+};
+
+static void printValue(float v, int decimals) {
+    if (isnan(v)) {
+        putchar(',');
+    } else {
+        printf(",%.*f", decimals, v);
+    }
+}
+
+static void onSample(const TlmSample& s, void* ctx) {
+    CsvState& csv = *(CsvState*)ctx;
+    if (!csv.headerWritten) {
+        csv.zoneCount = s.zoneCount;
+        printf("seq,time_ms,temp_c,hottest_c,target_c,ware_c,output_pct,mode,heating,"
+               "sensor_error,fault,profile_state,profile_segment,fault_residual_c");
+        for (int z = 0; z < csv.zoneCount; z++) {
+            printf(",z%d_temp_c,z%d_setpoint_c,z%d_output_pct,z%d_errors", z, z, z, z);
+        }
+        printf("\n");
+        csv.headerWritten = true;
+    }
+
+    printf("%u,%lu", s.seq, (unsigned long)s.timeMs);
+    printValue(s.temp, 1);
+    printValue(s.hottest, 1);
+    printValue(s.target, 1);
+    printValue(s.wareTemp, 1);
+    printValue(s.output, 2);
+    printf(",%u,%d,%d,%u,%u,%u", s.mode, (s.flags & TLM_FLAG_HEATING) ? 1 : 0,
+           (s.flags & TLM_FLAG_SENSOR_ERROR) ? 1 : 0, s.fault, s.profileState,
+           s.profileSegment);
+    printValue(s.faultResidual, 2);
+    for (int z = 0; z < csv.zoneCount; z++) {
+        if (z < s.zoneCount) {
+            printValue(s.zones[z].temp, 1);
+            printValue(s.zones[z].setpoint, 1);
+            printValue(s.zones[z].output, 2);
+            printf(",%u", s.zones[z].errors);
+        } else {
+            printf(",,,,");
+        }
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+static void onText(const char* text, size_t len, void* ctx) {
+    if (((CsvState*)ctx)->passText) {
+        fwrite(text, 1, len, stderr);
+    }
+}
+
+int main(int argc, char** argv) {
+    CsvState csv = {};
+    const char* path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--text") == 0) {
+            csv.passText = true;
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            fprintf(stderr, "usage: %s [--text] [capture|device|-]\n", argv[0]);
+            return 2;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    FILE* in = (path && strcmp(path, "-") != 0) ? fopen(path, "rb") : stdin;
+    if (in == nullptr) {
+        perror(path);
+        return 1;
+    }
+
+    static TlmDecoder decoder;
+    tlmDecoderInit(decoder, onSample, onText, &csv);
+    uint8_t chunk[512];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0) {
+        tlmDecoderFeed(decoder, chunk, n);
+    }
+    tlmDecoderFinish(decoder);
+
+    const TlmDecoderStats& st = decoder.stats;
+    uint64_t frameBytes = st.bytes - st.textBytes;
+    fprintf(stderr, "frames=%lu bad=%lu lost=%lu text=%llu bytes, %.1f bytes/sample\n",
+            (unsigned long)st.frames, (unsigned long)st.badFrames,
+            (unsigned long)st.lostFrames, (unsigned long long)st.textBytes,
+            st.frames ? (double)frameBytes / st.frames : 0.0);
+    return (st.frames > 0) ? 0 : 1;
+}
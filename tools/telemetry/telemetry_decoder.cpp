@@ -0,0 +1,85 @@
+/**
+ * Host-side telemetry stream decoder
+ */
+
+#include <string.h>
+#include "telemetry_decoder.h"
+
+void tlmDecoderInit(TlmDecoder& d, void (*onSample)(const TlmSample&, void*),
+                    void (*onText)(const char*, size_t, void*), void* ctx) {
+    memset(&d, 0, sizeof(d));
+    d.onSample = onSample;
+    d.onText = onText;
+    d.ctx = ctx;
+}
+
+static void emitText(TlmDecoder& d) {
+    d.stats.textBytes += d.len;
+    if (d.onText) {
+        d.onText((const char*)d.buf, d.len, d.ctx);
+    }
+}
+
+/**
+ * Text on the port is printable (plus tab/CR/LF and UTF-8); a COBS frame
+ * almost never is
+ */
+static bool looksBinary(const uint8_t* p, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (p[i] < 0x20 && p[i] != '\t' && p[i] != '\r' && p[i] != '\n') {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void finishChunk(TlmDecoder& d) {
+    if (d.len == 0) {
+        return;
+    }
+    uint8_t frame[TLM_DECODER_BUFFER];
+    size_t n = tlmCobsDecode(d.buf, d.len, frame);
+    TlmSample s;
+
+    if (n > 0 && tlmDecodeSample(frame, n, s)) {
+        if (d.haveSeq) {
+            d.stats.lostFrames += (uint16_t)(s.seq - d.lastSeq - 1);
+        }
+        d.haveSeq = true;
+        d.lastSeq = s.seq;
+        d.stats.frames++;
+        if (d.onSample) {
+            d.onSample(s, d.ctx);
+        }
+    } else if (n > 1 && frame[1] != TLM_MSG_SAMPLE && tlmCheckFrame(frame, n)) {
+        d.stats.otherFrames++;
+        if (d.onFrame) {
+            d.onFrame(frame, n, d.ctx);
+        }
+    } else if ((n >= 2 && frame[0] == TLM_VERSION && frame[1] == TLM_MSG_SAMPLE) ||
+               looksBinary(d.buf, d.len)) {
+        d.stats.badFrames++;  // Corrupt frame, or a piece of one split by a flipped 0x00
+    } else {
+        emitText(d);
+    }
+    d.len = 0;
+}
+
+void tlmDecoderFeed(TlmDecoder& d, const uint8_t* data, size_t n) {
+    d.stats.bytes += n;
+    for (size_t i = 0; i < n; i++) {
+        if (data[i] == 0) {
+            finishChunk(d);
+            continue;
+        }
+        if (d.len == sizeof(d.buf)) {
+            emitText(d);  // Far longer than any frame: text
+            d.len = 0;
+        }
+        d.buf[d.len++] = data[i];
+    }
+}
+
+void tlmDecoderFinish(TlmDecoder& d) {
+    finishChunk(d);
+}
@@ -0,0 +1,54 @@
+#ifndef TELEMETRY_DECODER_H
+#define TELEMETRY_DECODER_H
+
+// Host-side telemetry stream decoder
+// Splits a raw serial capture at 0x00 delimiters. Each chunk is tried as a
+// COBS frame (src/telemetry_protocol.h). Chunks that decode to a sample go
+// to onSample, other intact frames (log transfer) to onFrame. Chunks that carry the telemetry version/type bytes but fail
+// the CRC or length check, or that hold control bytes no text line would,
+// are counted as bad frames. Anything else is the text sharing the port and
+// goes to onText. Sequence gaps are counted as
+// lost frames.
+
+#include <stdint.h>
+#include <stddef.h>
+#include "telemetry_protocol.h"
+
+#define TLM_DECODER_BUFFER 4096  // Longest text run kept between frames
+
+struct TlmDecoderStats {
+    uint32_t frames;            // Good samples
+    uint32_t otherFrames;       // Intact frames of other types
+    uint32_t badFrames;         // Corrupt frames and frame fragments
+    uint32_t lostFrames;        // Missing sequence numbers
+    uint64_t textBytes;
+    uint64_t bytes;             // Everything fed in
+};
+
+struct TlmDecoder {
+    uint8_t buf[TLM_DECODER_BUFFER];
+    size_t len;
+    bool haveSeq;
+    uint16_t lastSeq;
+    TlmDecoderStats stats;
+
+    void (*onSample)(const TlmSample& sample, void* ctx);
+    void (*onText)(const char* text, size_t len, void* ctx);
+    void (*onFrame)(const uint8_t* frame, size_t len, void* ctx);  // Optional, set after init
+    void* ctx;
+};
+
+void tlmDecoderInit(TlmDecoder& d, void (*onSample)(const TlmSample&, void*),
+                    void (*onText)(const char*, size_t, void*), void* ctx);
+
+/**
+ * Feed raw bytes; callbacks fire as chunks complete
+ */
+void tlmDecoderFeed(TlmDecoder& d, const uint8_t* data, size_t n);
+
+/**
+ * Flush whatever is buffered (end of input)
+ */
+void tlmDecoderFinish(TlmDecoder& d);
+
+#endif // TELEMETRY_DECODER_H